@@ -170,6 +170,7 @@ main (int argc, char *argv[])
   // LogComponentEnable ("ThreeGppHttpServer", LOG_INFO);
   LogComponentEnable ("ThreeGppHttpExample", LOG_INFO);
   // LogComponentEnable ("TcpD2tcp",LOG_INFO);
+  LogSetBuffered (true);
 
   std::string tcpTypeId = "TcpDctcp";
   Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue ("ns3::" + tcpTypeId));
@@ -206,7 +206,8 @@ RoutingTableEntry::Print (Ptr<OutputStreamWrapper> stream, Time::Unit unit /* =
  */
 
 RoutingTable::RoutingTable (Time t)
-  : m_badLinkLifetime (t)
+  : m_badLinkLifetime (t),
+    m_purgeTime (Time::Max ())
 {
 }
 
@@ -270,6 +271,10 @@ RoutingTable::AddRoute (RoutingTableEntry & rt)
     }
   std::pair<std::map<Ipv4Address, RoutingTableEntry>::iterator, bool> result =
     m_ipv4AddressEntry.insert (std::make_pair (rt.GetDestination (), rt));
+  if (result.second)
+    {
+      SchedulePurge (rt);
+    }
   return result.second;
 }
 
@@ -290,6 +295,7 @@ RoutingTable::Update (RoutingTableEntry & rt)
       NS_LOG_LOGIC ("Route update to " << rt.GetDestination () << " set RreqCnt to 0");
       i->second.SetRreqCnt (0);
     }
+  SchedulePurge (i->second);
   return true;
 }
 
@@ -306,6 +312,7 @@ RoutingTable::SetEntryState (Ipv4Address id, RouteFlags state)
     }
   i->second.SetFlag (state);
   i->second.SetRreqCnt (0);
+  SchedulePurge (i->second);
   NS_LOG_LOGIC ("Route set entry state to " << id << ": new state is " << state);
   return true;
 }
@@ -332,17 +339,16 @@ RoutingTable::InvalidateRoutesWithDst (const std::map<Ipv4Address, uint32_t> & u
 {
   NS_LOG_FUNCTION (this);
   Purge ();
-  for (std::map<Ipv4Address, RoutingTableEntry>::iterator i =
-         m_ipv4AddressEntry.begin (); i != m_ipv4AddressEntry.end (); ++i)
+  for (std::map<Ipv4Address, uint32_t>::const_iterator j =
+         unreachable.begin (); j != unreachable.end (); ++j)
     {
-      for (std::map<Ipv4Address, uint32_t>::const_iterator j =
-             unreachable.begin (); j != unreachable.end (); ++j)
+      std::map<Ipv4Address, RoutingTableEntry>::iterator i =
+        m_ipv4AddressEntry.find (j->first);
+      if (i != m_ipv4AddressEntry.end () && i->second.GetFlag () == VALID)
         {
-          if ((i->first == j->first) && (i->second.GetFlag () == VALID))
-            {
-              NS_LOG_LOGIC ("Invalidate route with destination address " << i->first);
-              i->second.Invalidate (m_badLinkLifetime);
-            }
+          NS_LOG_LOGIC ("Invalidate route with destination address " << i->first);
+          i->second.Invalidate (m_badLinkLifetime);
+          SchedulePurge (i->second);
         }
     }
 }
@@ -371,14 +377,24 @@ RoutingTable::DeleteAllRoutesFromInterface (Ipv4InterfaceAddress iface)
     }
 }
 
+void
+RoutingTable::SchedulePurge (const RoutingTableEntry & rt)
+{
+  if (rt.GetFlag () != IN_SEARCH)
+    {
+      m_purgeTime = std::min (m_purgeTime, rt.GetLifeTime () + Simulator::Now ());
+    }
+}
+
 void
 RoutingTable::Purge ()
 {
   NS_LOG_FUNCTION (this);
-  if (m_ipv4AddressEntry.empty ())
+  if (m_ipv4AddressEntry.empty () || Simulator::Now () <= m_purgeTime)
     {
       return;
     }
+  m_purgeTime = Time::Max ();
   for (std::map<Ipv4Address, RoutingTableEntry>::iterator i =
          m_ipv4AddressEntry.begin (); i != m_ipv4AddressEntry.end (); )
     {
@@ -394,6 +410,7 @@ RoutingTable::Purge ()
             {
               NS_LOG_LOGIC ("Invalidate route with destination address " << i->first);
               i->second.Invalidate (m_badLinkLifetime);
+              SchedulePurge (i->second);
               ++i;
             }
           else
@@ -403,6 +420,7 @@ RoutingTable::Purge ()
         }
       else
         {
+          SchedulePurge (i->second);
           ++i;
         }
     }
@@ -469,7 +469,11 @@ public:
   {
     m_ipv4AddressEntry.clear ();
   }
-  /// Delete all outdated entries and invalidate valid entry if Lifetime is expired
+  /**
+   * Delete all outdated entries and invalidate valid entry if Lifetime is expired.
+   * The entries are only scanned once the earliest lifetime of the valid and
+   * invalid entries has expired, so that the lookups do not scan the table.
+   */
   void Purge ();
   /** Mark entry as unidirectional (e.g. add this neighbor to "blacklist" for blacklistTimeout period)
    * \param neighbor - neighbor address link to which assumed to be unidirectional
@@ -488,6 +492,13 @@ private:
   std::map<Ipv4Address, RoutingTableEntry> m_ipv4AddressEntry;
   /// Deletion time for invalid routes
   Time m_badLinkLifetime;
+  /// Earliest lifetime of the valid and invalid entries, until which Purge has nothing to do
+  Time m_purgeTime;
+  /**
+   * Bring the time of the next purge forward to the lifetime of an entry
+   * \param rt the routing table entry
+   */
+  void SchedulePurge (const RoutingTableEntry & rt);
   /**
    * const version of Purge, for use by Print() method
    * \param table the routing table entry to purge
@@ -641,6 +641,64 @@ struct AodvRtableTest : public TestCase
   }
 };
 
+/**
+ * \ingroup aodv-test
+ * \ingroup tests
+ *
+ * \brief Unit test for the purges of the AODV routing table, which only scan
+ * the table once the earliest lifetime of its entries has expired
+ */
+struct AodvRtablePurgeTest : public TestCase
+{
+  AodvRtablePurgeTest () : TestCase ("Rtable purge"),
+                           m_rtable (Seconds (1))
+  {
+  }
+  virtual void DoRun ()
+  {
+    Ptr<NetDevice> dev;
+    Ipv4InterfaceAddress iface;
+    RoutingTableEntry rt (/*output device*/ dev, /*dst*/ Ipv4Address ("1.2.3.4"), /*validSeqNo*/ true, /*seqNo*/ 10,
+                                            /*interface*/ iface, /*hop*/ 5, /*next hop*/ Ipv4Address ("1.1.1.1"), /*lifetime*/ Seconds (3));
+    NS_TEST_EXPECT_MSG_EQ (m_rtable.AddRoute (rt), true, "trivial");
+    Simulator::Schedule (Seconds (0.5), &AodvRtablePurgeTest::AddShortRoute, this);
+    Simulator::Schedule (Seconds (1), &AodvRtablePurgeTest::CheckRoute, this, Ipv4Address ("1.2.3.4"), true, VALID);
+    Simulator::Schedule (Seconds (1), &AodvRtablePurgeTest::CheckRoute, this, Ipv4Address ("4.3.2.1"), true, INVALID);
+    Simulator::Schedule (Seconds (2.5), &AodvRtablePurgeTest::CheckRoute, this, Ipv4Address ("4.3.2.1"), false, INVALID);
+    Simulator::Schedule (Seconds (2.5), &AodvRtablePurgeTest::CheckRoute, this, Ipv4Address ("1.2.3.4"), true, VALID);
+    Simulator::Schedule (Seconds (3.5), &AodvRtablePurgeTest::CheckRoute, this, Ipv4Address ("1.2.3.4"), true, INVALID);
+    Simulator::Schedule (Seconds (5), &AodvRtablePurgeTest::CheckRoute, this, Ipv4Address ("1.2.3.4"), false, INVALID);
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+  /// Add a route, which expires before the first one
+  void AddShortRoute ()
+  {
+    Ptr<NetDevice> dev;
+    Ipv4InterfaceAddress iface;
+    RoutingTableEntry rt (/*output device*/ dev, /*dst*/ Ipv4Address ("4.3.2.1"), /*validSeqNo*/ true, /*seqNo*/ 10,
+                                            /*interface*/ iface, /*hop*/ 5, /*next hop*/ Ipv4Address ("1.1.1.1"), /*lifetime*/ Seconds (0.25));
+    NS_TEST_EXPECT_MSG_EQ (m_rtable.AddRoute (rt), true, "trivial");
+  }
+  /**
+   * Check a route
+   * \param dst the destination of the route
+   * \param found whether the route must be found
+   * \param flag the flag of the route, if found
+   */
+  void CheckRoute (Ipv4Address dst, bool found, RouteFlags flag)
+  {
+    RoutingTableEntry rt;
+    NS_TEST_EXPECT_MSG_EQ (m_rtable.LookupRoute (dst, rt), found, "Route to " << dst << " at " << Simulator::Now ().As (Time::S));
+    if (found)
+      {
+        NS_TEST_EXPECT_MSG_EQ (rt.GetFlag (), flag, "Flag of the route to " << dst << " at " << Simulator::Now ().As (Time::S));
+      }
+  }
+  /// Routing table
+  RoutingTable m_rtable;
+};
+
 /**
  * \ingroup aodv-test
  * \ingroup tests
@@ -662,6 +720,7 @@ public:
     AddTestCase (new AodvRqueueTest, TestCase::QUICK);
     AddTestCase (new AodvRtableEntryTest, TestCase::QUICK);
     AddTestCase (new AodvRtableTest, TestCase::QUICK);
+    AddTestCase (new AodvRtablePurgeTest, TestCase::QUICK);
   }
 } g_aodvTestSuite; ///< the test suite
 
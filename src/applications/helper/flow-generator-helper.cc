@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-generator-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include <fstream>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowGeneratorHelper");
+
+FlowGeneratorHelper::FlowGeneratorHelper (uint16_t port)
+  : m_port (port)
+{
+  m_factory.SetTypeId ("ns3::FlowGenerator");
+  m_factory.Set ("Port", UintegerValue (port));
+}
+
+void
+FlowGeneratorHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+ApplicationContainer
+FlowGeneratorHelper::Install (NodeContainer c)
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Ipv4> ipv4 = (*i)->GetObject<Ipv4> ();
+      NS_ABORT_MSG_IF (ipv4 == 0 || ipv4->GetNInterfaces () < 2,
+                       "FlowGenerator requires an IPv4 address on node " << (*i)->GetId ());
+      Ptr<FlowGenerator> app = m_factory.Create<FlowGenerator> ();
+      (*i)->AddApplication (app);
+      apps.Add (app);
+      m_generators[(*i)->GetId ()] = app;
+      m_addresses[(*i)->GetId ()] = InetSocketAddress (ipv4->GetAddress (1, 0).GetLocal (), m_port);
+    }
+
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<FlowGenerator> app = m_generators[(*i)->GetId ()];
+      for (NodeContainer::Iterator j = c.Begin (); j != c.End (); ++j)
+        {
+          if (i != j)
+            {
+              app->AddPeer (m_addresses[(*j)->GetId ()]);
+            }
+        }
+    }
+  return apps;
+}
+
+uint32_t
+FlowGeneratorHelper::LoadTrace (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream trace (filename.c_str ());
+  if (!trace.good ())
+    {
+      NS_FATAL_ERROR ("Cannot open flow trace " << filename);
+    }
+
+  uint32_t flows = 0;
+  uint32_t lineNumber = 0;
+  std::string line;
+  while (std::getline (trace, line))
+    {
+      lineNumber++;
+      std::istringstream iss (line);
+      double start;
+      uint32_t src;
+      uint32_t dst;
+      uint64_t size;
+      double deadline = 0;
+      if (!(iss >> start))
+        {
+          // empty line or comment
+          NS_ABORT_MSG_UNLESS (line.find_first_not_of (" \t\r") == std::string::npos
+                               || line[line.find_first_not_of (" \t\r")] == '#',
+                               "Invalid line " << lineNumber << " in " << filename);
+          continue;
+        }
+      if (!(iss >> src >> dst >> size))
+        {
+          NS_FATAL_ERROR ("Invalid line " << lineNumber << " in " << filename);
+        }
+      iss >> deadline;
+
+      std::map<uint32_t, Ptr<FlowGenerator> >::const_iterator generator = m_generators.find (src);
+      std::map<uint32_t, Address>::const_iterator peer = m_addresses.find (dst);
+      if (generator == m_generators.end () || peer == m_addresses.end ())
+        {
+          NS_FATAL_ERROR ("No FlowGenerator on node " << (generator == m_generators.end () ? src : dst)
+                          << " (line " << lineNumber << " in " << filename << ")");
+        }
+      generator->second->AddFlow (Seconds (start), peer->second, size, Seconds (deadline));
+      flows++;
+    }
+  NS_LOG_INFO ("Loaded " << flows << " flows from " << filename);
+  return flows;
+}
+
+uint32_t
+FlowGeneratorHelper::GetNCompletedFlows (void) const
+{
+  uint32_t completed = 0;
+  for (std::map<uint32_t, Ptr<FlowGenerator> >::const_iterator i = m_generators.begin ();
+       i != m_generators.end (); ++i)
+    {
+      completed += i->second->GetNCompletedFlows ();
+    }
+  return completed;
+}
+
+uint32_t
+FlowGeneratorHelper::GetNDeadlinesMet (void) const
+{
+  uint32_t met = 0;
+  for (std::map<uint32_t, Ptr<FlowGenerator> >::const_iterator i = m_generators.begin ();
+       i != m_generators.end (); ++i)
+    {
+      met += i->second->GetNDeadlinesMet ();
+    }
+  return met;
+}
+
+Ptr<EmpiricalRandomVariable>
+FlowGeneratorHelper::CreateWebSearchFlowSize (void)
+{
+  // flow sizes in 1460 byte packets
+  static const double cdf[][2] = {
+    {6, 0}, {6, 0.15}, {13, 0.2}, {19, 0.3}, {33, 0.4}, {53, 0.53},
+    {133, 0.6}, {667, 0.7}, {1333, 0.8}, {3333, 0.9}, {6667, 0.97}, {20000, 1}
+  };
+  Ptr<EmpiricalRandomVariable> size = CreateObject<EmpiricalRandomVariable> ();
+  size->SetInterpolate (true);
+  for (std::size_t i = 0; i < sizeof (cdf) / sizeof (cdf[0]); i++)
+    {
+      size->CDF (cdf[i][0] * 1460, cdf[i][1]);
+    }
+  return size;
+}
+
+Ptr<EmpiricalRandomVariable>
+FlowGeneratorHelper::CreateDataMiningFlowSize (void)
+{
+  // flow sizes in 1460 byte packets
+  static const double cdf[][2] = {
+    {1, 0}, {1, 0.5}, {2, 0.6}, {3, 0.7}, {7, 0.8}, {267, 0.9},
+    {2107, 0.95}, {66667, 0.99}, {666667, 1}
+  };
+  Ptr<EmpiricalRandomVariable> size = CreateObject<EmpiricalRandomVariable> ();
+  size->SetInterpolate (true);
+  for (std::size_t i = 0; i < sizeof (cdf) / sizeof (cdf[0]); i++)
+    {
+      size->CDF (cdf[i][0] * 1460, cdf[i][1]);
+    }
+  return size;
+}
+
+} // namespace ns3
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_GENERATOR_HELPER_H
+#define FLOW_GENERATOR_HELPER_H
+
+#include <stdint.h>
+#include <string>
+#include <map>
+#include "ns3/object-factory.h"
+#include "ns3/address.h"
+#include "ns3/attribute.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/flow-generator.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup flowgenerator
+ * \brief A helper to make it easier to instantiate FlowGenerator
+ * applications on a set of nodes and to feed them a workload.
+ */
+class FlowGeneratorHelper
+{
+public:
+  /**
+   * Create a FlowGeneratorHelper to make it easier to work with FlowGenerator
+   * applications.
+   *
+   * \param port the port on which the generators receive the flows.
+   */
+  FlowGeneratorHelper (uint16_t port = 5000);
+
+  /**
+   * Helper function used to set the underlying application attributes,
+   * _not_ the socket attributes.
+   *
+   * \param name the name of the application attribute to set
+   * \param value the value of the application attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * Install a FlowGenerator on each node of the input container,
+   * configured with all the attributes set with SetAttribute.
+   *
+   * The nodes must have an IPv4 address: the generators send the flows
+   * to the first address of the first non-loopback interface of their
+   * destination.  All the other nodes of the container are the peers
+   * of the sampled flows of a generator.
+   *
+   * \param c NodeContainer of the set of nodes on which a FlowGenerator
+   * will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (NodeContainer c);
+
+  /**
+   * Load a flow trace and give each flow to the generator of its source.
+   *
+   * Each line of the trace describes a flow by five fields separated by
+   * white space: the start time in seconds, the ids of the source and
+   * destination nodes, the size in bytes and the deadline in seconds,
+   * relative to the start (zero if none; the field can be omitted).
+   * Empty lines and lines starting with '#' are ignored.  The source and
+   * destination must have a generator installed by this helper.
+   *
+   * \param filename The name of the trace file.
+   * \returns The number of flows loaded.
+   */
+  uint32_t LoadTrace (std::string filename);
+
+  /**
+   * \returns The number of flows completed by all the generators.
+   */
+  uint32_t GetNCompletedFlows (void) const;
+  /**
+   * \returns The number of flows of all the generators which completed
+   * before their deadline, or had none.
+   */
+  uint32_t GetNDeadlinesMet (void) const;
+
+  /**
+   * Create the flow size distribution of the web search workload
+   * (Alizadeh et al., "Data Center TCP (DCTCP)", SIGCOMM 2010).
+   *
+   * \returns A random variable drawing the flow sizes in bytes.
+   */
+  static Ptr<EmpiricalRandomVariable> CreateWebSearchFlowSize (void);
+  /**
+   * Create the flow size distribution of the data mining workload
+   * (Greenberg et al., "VL2: A Scalable and Flexible Data Center
+   * Network", SIGCOMM 2009).
+   *
+   * \returns A random variable drawing the flow sizes in bytes.
+   */
+  static Ptr<EmpiricalRandomVariable> CreateDataMiningFlowSize (void);
+
+private:
+  ObjectFactory m_factory;   //!< Object factory.
+  uint16_t m_port;           //!< Port on which the generators receive the flows.
+  std::map<uint32_t, Ptr<FlowGenerator> > m_generators;  //!< Generators, by node id.
+  std::map<uint32_t, Address> m_addresses;               //!< Addresses of the generators, by node id.
+};
+
+} // namespace ns3
+
+#endif /* FLOW_GENERATOR_HELPER_H */
@@ -0,0 +1,620 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/node.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "flow-generator.h"
+#include <algorithm>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED (FlowGenerator);
+
+TypeId
+FlowGenerator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FlowGenerator")
+    .SetParent<Application> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<FlowGenerator> ()
+    .AddAttribute ("Port",
+                   "The port on which the flows of the peers are received.",
+                   UintegerValue (5000),
+                   MakeUintegerAccessor (&FlowGenerator::m_port),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("Protocol", "The type of protocol to use.",
+                   TypeIdValue (TcpSocketFactory::GetTypeId ()),
+                   MakeTypeIdAccessor (&FlowGenerator::m_tid),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("MaxActiveFlows",
+                   "The maximum number of flows sent at the same time; "
+                   "the other flows wait for one of them to complete. "
+                   "The value zero means that there is no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FlowGenerator::m_maxActive),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("FlowSize",
+                   "The size of the sampled flows, in bytes. "
+                   "If not set, only the flows added with AddFlow are sent.",
+                   PointerValue (),
+                   MakePointerAccessor (&FlowGenerator::m_flowSize),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("InterArrival",
+                   "The time between two sampled flows, in seconds.",
+                   StringValue ("ns3::ExponentialRandomVariable[Mean=0.001]"),
+                   MakePointerAccessor (&FlowGenerator::m_interArrival),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Deadline",
+                   "The deadline of the sampled flows, relative to their start, "
+                   "in seconds. The value zero means no deadline.",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=0]"),
+                   MakePointerAccessor (&FlowGenerator::m_deadline),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("MaxFlows",
+                   "The number of flows to sample. "
+                   "The value zero means that there is no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FlowGenerator::m_maxFlows),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddTraceSource ("FlowCompleted", "All the bytes of a flow have been acknowledged",
+                     MakeTraceSourceAccessor (&FlowGenerator::m_completedTrace),
+                     "ns3::FlowGenerator::CompletedTracedCallback")
+  ;
+  return tid;
+}
+
+FlowGenerator::FlowGenerator ()
+  : m_nTraceFlows (0),
+    m_nextFlow (0),
+    m_nSampled (0),
+    m_connections (0),
+    m_completed (0),
+    m_deadlinesMet (0),
+    m_totalRx (0),
+    m_started (false),
+    m_listener (0),
+    m_listener6 (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_peerChoice = CreateObject<UniformRandomVariable> ();
+}
+
+FlowGenerator::~FlowGenerator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FlowGenerator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_listener = 0;
+  m_listener6 = 0;
+  m_accepted.clear ();
+  m_slots.clear ();
+  m_slotOf.clear ();
+  m_idle.clear ();
+  m_flowSize = 0;
+  m_interArrival = 0;
+  m_deadline = 0;
+  m_peerChoice = 0;
+  // chain up
+  Application::DoDispose ();
+}
+
+uint32_t
+FlowGenerator::AddPeer (const Address &peer)
+{
+  NS_LOG_FUNCTION (this << peer);
+  std::map<Address, uint32_t>::const_iterator it = m_peerIndex.find (peer);
+  if (it != m_peerIndex.end ())
+    {
+      return it->second;
+    }
+  uint32_t index = m_peers.size ();
+  m_peers.push_back (peer);
+  m_peerIndex[peer] = index;
+  return index;
+}
+
+uint32_t
+FlowGenerator::GetNPeers (void) const
+{
+  return m_peers.size ();
+}
+
+Address
+FlowGenerator::GetPeer (uint32_t i) const
+{
+  NS_ASSERT (i < m_peers.size ());
+  return m_peers[i];
+}
+
+void
+FlowGenerator::AddFlow (Time start, const Address &peer, uint64_t size, Time deadline)
+{
+  NS_LOG_FUNCTION (this << start << peer << size << deadline);
+  NS_ABORT_MSG_IF (!CanAddFlows (), "Flows must be added before the application starts");
+  NS_ABORT_MSG_IF (size == 0, "A flow must carry at least one byte");
+  Flow flow;
+  flow.start = start;
+  flow.deadline = deadline;
+  flow.finish = Time (0);
+  flow.size = size;
+  flow.peer = AddPeer (peer);
+  m_flows.push_back (flow);
+  m_nTraceFlows++;
+}
+
+bool
+FlowGenerator::CanAddFlows (void) const
+{
+  return !m_started;
+}
+
+uint32_t
+FlowGenerator::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+const FlowGenerator::Flow &
+FlowGenerator::GetFlow (uint32_t i) const
+{
+  NS_ASSERT (i < m_flows.size ());
+  return m_flows[i];
+}
+
+uint32_t
+FlowGenerator::GetNSampledFlows (void) const
+{
+  return m_nSampled;
+}
+
+uint32_t
+FlowGenerator::GetNConnections (void) const
+{
+  return m_connections;
+}
+
+uint32_t
+FlowGenerator::GetNCompletedFlows (void) const
+{
+  return m_completed;
+}
+
+uint32_t
+FlowGenerator::GetNDeadlinesMet (void) const
+{
+  return m_deadlinesMet;
+}
+
+uint64_t
+FlowGenerator::GetTotalRx (void) const
+{
+  return m_totalRx;
+}
+
+int64_t
+FlowGenerator::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_peerChoice->SetStream (stream);
+  m_interArrival->SetStream (stream + 1);
+  m_deadline->SetStream (stream + 2);
+  if (m_flowSize)
+    {
+      m_flowSize->SetStream (stream + 3);
+    }
+  return 4;
+}
+
+void
+FlowGenerator::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_started = true;
+
+  // The peers are expected to reach the node with the address family it
+  // uses to reach them
+  bool ipv4 = m_peers.empty ();
+  bool ipv6 = m_peers.empty ();
+  for (std::vector<Address>::const_iterator it = m_peers.begin (); it != m_peers.end (); ++it)
+    {
+      if (Inet6SocketAddress::IsMatchingType (*it))
+        {
+          ipv6 = true;
+        }
+      else
+        {
+          ipv4 = true;
+        }
+    }
+  if (ipv4 && !m_listener)
+    {
+      m_listener = Listen (InetSocketAddress (Ipv4Address::GetAny (), m_port));
+    }
+  if (ipv6 && !m_listener6)
+    {
+      m_listener6 = Listen (Inet6SocketAddress (Ipv6Address::GetAny (), m_port));
+    }
+
+  std::stable_sort (m_flows.begin (), m_flows.begin () + m_nTraceFlows,
+                    [] (const Flow &a, const Flow &b) { return a.start < b.start; });
+  StartFlows ();
+
+  if (m_flowSize)
+    {
+      NS_ABORT_MSG_IF (m_peers.empty (), "No peer to send the sampled flows to");
+      m_sampleEvent = Simulator::Schedule (Seconds (m_interArrival->GetValue ()),
+                                           &FlowGenerator::SampleFlow, this);
+    }
+}
+
+Ptr<Socket>
+FlowGenerator::Listen (const Address &local)
+{
+  NS_LOG_FUNCTION (this << local);
+  Ptr<Socket> listener = Socket::CreateSocket (GetNode (), m_tid);
+  if (listener->GetSocketType () != Socket::NS3_SOCK_STREAM
+      && listener->GetSocketType () != Socket::NS3_SOCK_SEQPACKET)
+    {
+      NS_FATAL_ERROR ("Using FlowGenerator with an incompatible socket type. "
+                      "FlowGenerator requires SOCK_STREAM or SOCK_SEQPACKET. "
+                      "In other words, use TCP instead of UDP.");
+    }
+  if (listener->Bind (local) == -1)
+    {
+      NS_FATAL_ERROR ("Failed to bind socket");
+    }
+  listener->Listen ();
+  listener->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                               MakeCallback (&FlowGenerator::HandleAccept, this));
+  return listener;
+}
+
+void
+FlowGenerator::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Simulator::Cancel (m_startEvent);
+  Simulator::Cancel (m_sampleEvent);
+  m_waiting.clear ();
+  for (std::map<Ptr<Socket>, uint32_t>::iterator it = m_slotOf.begin (); it != m_slotOf.end (); ++it)
+    {
+      CloseSocket (it->first);
+      m_slots[it->second].socket = 0;
+      m_freeSlots.push_back (it->second);
+    }
+  m_slotOf.clear ();
+  for (std::vector<std::vector<Ptr<Socket> > >::iterator it = m_idle.begin (); it != m_idle.end (); ++it)
+    {
+      for (std::vector<Ptr<Socket> >::iterator socket = it->begin (); socket != it->end (); ++socket)
+        {
+          CloseSocket (*socket);
+        }
+      it->clear ();
+    }
+  Ptr<Socket> listeners[2] = { m_listener, m_listener6 };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      if (listeners[i])
+        {
+          listeners[i]->Close ();
+          listeners[i]->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                                           MakeNullCallback<void, Ptr<Socket>, const Address &> ());
+        }
+    }
+  for (std::set<Ptr<Socket> >::iterator it = m_accepted.begin (); it != m_accepted.end (); ++it)
+    {
+      (*it)->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+      (*it)->SetCloseCallbacks (MakeNullCallback<void, Ptr<Socket> > (),
+                                MakeNullCallback<void, Ptr<Socket> > ());
+      (*it)->Close ();
+    }
+  m_accepted.clear ();
+}
+
+void
+FlowGenerator::CloseSocket (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  socket->SetSendCallback (MakeNullCallback<void, Ptr<Socket>, uint32_t> ());
+  socket->SetCloseCallbacks (MakeNullCallback<void, Ptr<Socket> > (),
+                             MakeNullCallback<void, Ptr<Socket> > ());
+  socket->Close ();
+}
+
+void
+FlowGenerator::StartFlows (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_nextFlow < m_nTraceFlows && m_flows[m_nextFlow].start <= Simulator::Now ())
+    {
+      OpenFlow (m_nextFlow++);
+    }
+  if (m_nextFlow < m_nTraceFlows)
+    {
+      m_startEvent = Simulator::Schedule (m_flows[m_nextFlow].start - Simulator::Now (),
+                                          &FlowGenerator::StartFlows, this);
+    }
+}
+
+void
+FlowGenerator::SampleFlow (void)
+{
+  NS_LOG_FUNCTION (this);
+  Flow flow;
+  flow.start = Simulator::Now ();
+  flow.deadline = Seconds (m_deadline->GetValue ());
+  flow.finish = Time (0);
+  flow.size = std::max<uint64_t> (m_flowSize->GetValue (), 1);
+  flow.peer = m_peerChoice->GetInteger (0, m_peers.size () - 1);
+  m_flows.push_back (flow);
+  OpenFlow (m_flows.size () - 1);
+
+  m_nSampled++;
+  if (m_maxFlows == 0 || m_nSampled < m_maxFlows)
+    {
+      m_sampleEvent = Simulator::Schedule (Seconds (m_interArrival->GetValue ()),
+                                           &FlowGenerator::SampleFlow, this);
+    }
+}
+
+void
+FlowGenerator::OpenFlow (uint32_t flow)
+{
+  NS_LOG_FUNCTION (this << flow);
+  if (m_maxActive > 0 && m_slotOf.size () >= m_maxActive)
+    {
+      NS_LOG_LOGIC ("All the slots are used, flow " << flow << " waits");
+      m_waiting.push_back (flow);
+      return;
+    }
+
+  uint32_t slot;
+  if (!m_freeSlots.empty ())
+    {
+      slot = m_freeSlots.back ();
+      m_freeSlots.pop_back ();
+    }
+  else
+    {
+      slot = m_slots.size ();
+      m_slots.push_back (Slot ());
+    }
+
+  const Flow &f = m_flows[flow];
+  const Address &peer = m_peers[f.peer];
+  if (m_idle.size () < m_peers.size ())
+    {
+      m_idle.resize (m_peers.size ());
+    }
+  std::vector<Ptr<Socket> > &idle = m_idle[f.peer];
+  Ptr<Socket> socket;
+  bool reused = !idle.empty ();
+  if (reused)
+    {
+      NS_LOG_LOGIC ("Flow " << flow << " reuses an idle connection");
+      socket = idle.back ();
+      idle.pop_back ();
+    }
+  else
+    {
+      socket = Socket::CreateSocket (GetNode (), m_tid);
+      int ret = Inet6SocketAddress::IsMatchingType (peer) ? socket->Bind6 () : socket->Bind ();
+      if (ret == -1)
+        {
+          NS_FATAL_ERROR ("Failed to bind socket");
+        }
+      socket->SetConnectCallback (MakeCallback (&FlowGenerator::ConnectionSucceeded, this),
+                                  MakeCallback (&FlowGenerator::ConnectionFailed, this));
+      socket->SetSendCallback (MakeCallback (&FlowGenerator::DataSend, this));
+      socket->SetCloseCallbacks (MakeCallback (&FlowGenerator::HandleClose, this),
+                                 MakeCallback (&FlowGenerator::HandleClose, this));
+      socket->ShutdownRecv ();
+      m_connections++;
+    }
+  socket->SetDeadline (f.deadline.IsZero () ? Time (0) : f.start + f.deadline);
+  socket->SetTxTotal (std::min<uint64_t> (f.size, std::numeric_limits<uint32_t>::max ()));
+
+  m_slots[slot].socket = socket;
+  m_slots[slot].flow = flow;
+  m_slots[slot].sent = 0;
+  m_slots[slot].txSpace = socket->GetTxAvailable ();
+  m_slotOf[socket] = slot;
+
+  if (!reused)
+    {
+      // the data is buffered until the connection is established
+      socket->Connect (peer);
+    }
+  SendData (slot);
+}
+
+void
+FlowGenerator::SendData (uint32_t slot)
+{
+  NS_LOG_FUNCTION (this << slot);
+  Slot &s = m_slots[slot];
+  const Flow &f = m_flows[s.flow];
+  while (s.sent < f.size)
+    {
+      uint32_t toSend = std::min<uint64_t> (f.size - s.sent, s.socket->GetTxAvailable ());
+      if (toSend == 0)
+        {
+          break;
+        }
+      int actual = s.socket->Send (Create<Packet> (toSend));
+      if (actual <= 0)
+        {
+          break;
+        }
+      s.sent += actual;
+    }
+  if (s.sent == f.size && s.socket->GetTxAvailable () == s.txSpace)
+    {
+      CompleteFlow (slot);
+    }
+}
+
+void
+FlowGenerator::CompleteFlow (uint32_t slot)
+{
+  NS_LOG_FUNCTION (this << slot);
+  Flow &f = m_flows[m_slots[slot].flow];
+  f.finish = Simulator::Now ();
+  bool deadlineMet = f.deadline.IsZero () || f.finish <= f.start + f.deadline;
+  m_completed++;
+  if (deadlineMet)
+    {
+      m_deadlinesMet++;
+    }
+  NS_LOG_INFO ("Flow of " << f.size << " bytes completed in " << (f.finish - f.start).As (Time::US)
+                          << (deadlineMet ? "" : ", deadline missed"));
+  m_completedTrace (f.size, f.finish - f.start, deadlineMet);
+
+  ReleaseSlot (slot, true);
+}
+
+void
+FlowGenerator::ReleaseSlot (uint32_t slot, bool reuse)
+{
+  NS_LOG_FUNCTION (this << slot << reuse);
+  Ptr<Socket> socket = m_slots[slot].socket;
+  if (reuse)
+    {
+      m_idle[m_flows[m_slots[slot].flow].peer].push_back (socket);
+    }
+  else
+    {
+      CloseSocket (socket);
+    }
+  m_slotOf.erase (socket);
+  m_slots[slot].socket = 0;
+  m_freeSlots.push_back (slot);
+
+  if (!m_waiting.empty ())
+    {
+      uint32_t next = m_waiting.front ();
+      m_waiting.pop_front ();
+      OpenFlow (next);
+    }
+}
+
+void
+FlowGenerator::ConnectionSucceeded (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+}
+
+void
+FlowGenerator::ConnectionFailed (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  std::map<Ptr<Socket>, uint32_t>::iterator it = m_slotOf.find (socket);
+  if (it == m_slotOf.end ())
+    {
+      return;
+    }
+  NS_LOG_WARN ("Connection of flow " << m_slots[it->second].flow << " failed");
+  ReleaseSlot (it->second, false);
+}
+
+void
+FlowGenerator::DataSend (Ptr<Socket> socket, uint32_t available)
+{
+  NS_LOG_FUNCTION (this << socket << available);
+  std::map<Ptr<Socket>, uint32_t>::const_iterator it = m_slotOf.find (socket);
+  if (it != m_slotOf.end ())
+    {
+      SendData (it->second);
+    }
+}
+
+void
+FlowGenerator::HandleClose (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  std::map<Ptr<Socket>, uint32_t>::iterator it = m_slotOf.find (socket);
+  if (it != m_slotOf.end ())
+    {
+      NS_LOG_WARN ("Connection of flow " << m_slots[it->second].flow << " closed by the peer");
+      ReleaseSlot (it->second, false);
+      return;
+    }
+  // an idle connection closed by the peer cannot send the next flows
+  for (std::vector<std::vector<Ptr<Socket> > >::iterator idle = m_idle.begin (); idle != m_idle.end (); ++idle)
+    {
+      std::vector<Ptr<Socket> >::iterator pos = std::find (idle->begin (), idle->end (), socket);
+      if (pos != idle->end ())
+        {
+          idle->erase (pos);
+          CloseSocket (socket);
+          return;
+        }
+    }
+}
+
+void
+FlowGenerator::HandleAccept (Ptr<Socket> socket, const Address &from)
+{
+  NS_LOG_FUNCTION (this << socket << from);
+  m_accepted.insert (socket);
+  socket->SetRecvCallback (MakeCallback (&FlowGenerator::HandleRead, this));
+  socket->SetCloseCallbacks (MakeCallback (&FlowGenerator::HandlePeerClose, this),
+                             MakeNullCallback<void, Ptr<Socket> > ());
+}
+
+void
+FlowGenerator::HandleRead (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      if (packet->GetSize () == 0)
+        { //EOF
+          break;
+        }
+      m_totalRx += packet->GetSize ();
+    }
+}
+
+void
+FlowGenerator::HandlePeerClose (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  m_accepted.erase (socket);
+  socket->Close ();
+}
+
+} // Namespace ns3
@@ -0,0 +1,323 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_GENERATOR_H
+#define FLOW_GENERATOR_H
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+#include "ns3/random-variable-stream.h"
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+class Socket;
+
+/**
+ * \ingroup applications
+ * \defgroup flowgenerator FlowGenerator
+ *
+ * Workload generator for datacenter simulations, where every node sends
+ * and receives many short flows (e.g., partition-aggregate incast).
+ */
+
+/**
+ * \ingroup flowgenerator
+ *
+ * \brief Send the flows of a workload and receive the flows of the peers.
+ *
+ * A single FlowGenerator per node replaces one application per request.
+ * The flows sent by the node are described by a start time, a
+ * destination, a size in bytes and an optional deadline.  They either
+ * come from a flow trace (see FlowGeneratorHelper::LoadTrace) or are
+ * sampled on the fly when the FlowSize attribute is set: the flows
+ * then arrive after the intervals drawn from InterArrival, go to a peer
+ * chosen uniformly, and have the size and relative deadline drawn from
+ * FlowSize and Deadline.  FlowGeneratorHelper provides the empirical
+ * flow size distributions of the web search and data mining workloads.
+ *
+ * Each flow opens a TCP connection to the Port of its destination when
+ * it starts.  Its deadline and size are given to the socket through
+ * Socket::SetDeadline and Socket::SetTxTotal, for the deadline-aware
+ * congestion controls.  The flow completes when all its bytes have been
+ * acknowledged.  Its connection then goes back to a pool of idle
+ * connections to the same destination, which are reused by the next flows
+ * to that destination instead of opening new connections.  At most
+ * MaxActiveFlows flows are sent at a time: the other flows wait for a free
+ * slot.
+ *
+ * The generator also listens on Port, and discards the data of the flows
+ * sent to the node.  It listens for the address families of its
+ * destinations, or for both IPv4 and IPv6 if it has no destination.
+ *
+ * The flows are kept in a flat array of compact records, which holds
+ * the flow completion time (FCT) and deadline outcome of every flow.
+ * Only the next flow start is scheduled at any time, so the number of
+ * flows is only limited by the size of these records.
+ */
+class FlowGenerator : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  FlowGenerator ();
+  virtual ~FlowGenerator ();
+
+  /**
+   * \brief A flow sent by the generator.
+   */
+  struct Flow
+  {
+    Time start;         //!< Time the flow starts
+    Time deadline;      //!< Deadline, relative to the start; zero if none
+    Time finish;        //!< Time the last byte was acknowledged; zero if not completed
+    uint64_t size;      //!< Size of the flow in bytes
+    uint32_t peer;      //!< Index of the destination, see GetPeer()
+  };
+
+  /**
+   * TracedCallback signature for completed flows.
+   *
+   * \param [in] size The size of the flow in bytes.
+   * \param [in] fct The flow completion time.
+   * \param [in] deadlineMet Whether the flow completed before its deadline
+   *             (true for flows without a deadline).
+   */
+  typedef void (* CompletedTracedCallback)
+    (uint64_t size, Time fct, bool deadlineMet);
+
+  /**
+   * \brief Add a destination for the sampled flows.
+   * \param peer The address of a node running a FlowGenerator.
+   * \return The index of the peer.
+   */
+  uint32_t AddPeer (const Address &peer);
+  /**
+   * \return The number of peers.
+   */
+  uint32_t GetNPeers (void) const;
+  /**
+   * \param i The index of a peer.
+   * \return The address of the peer.
+   */
+  Address GetPeer (uint32_t i) const;
+
+  /**
+   * \brief Add a flow to send.
+   *
+   * The flows can be added in any order, but before the application starts.
+   *
+   * \param start The time the flow starts.
+   * \param peer The address of the destination, running a FlowGenerator.
+   * \param size The size of the flow in bytes.
+   * \param deadline The deadline, relative to the start; zero if none.
+   */
+  void AddFlow (Time start, const Address &peer, uint64_t size, Time deadline = Time (0));
+  /**
+   * \return Whether flows can still be added with AddFlow, i.e. whether the
+   * application has not started yet.
+   */
+  bool CanAddFlows (void) const;
+
+  /**
+   * \return The number of flows, started or not.
+   */
+  uint32_t GetNFlows (void) const;
+  /**
+   * The flows added with AddFlow come first, sorted by start time once
+   * the application has started, followed by the sampled flows.
+   *
+   * \param i The index of a flow.
+   * \return The flow.
+   */
+  const Flow & GetFlow (uint32_t i) const;
+  /**
+   * \return The number of sampled flows, which follow the flows added with
+   * AddFlow.
+   */
+  uint32_t GetNSampledFlows (void) const;
+  /**
+   * \return The number of connections opened to send the flows.
+   */
+  uint32_t GetNConnections (void) const;
+  /**
+   * \return The number of completed flows.
+   */
+  uint32_t GetNCompletedFlows (void) const;
+  /**
+   * \return The number of completed flows which met their deadline, or had none.
+   */
+  uint32_t GetNDeadlinesMet (void) const;
+  /**
+   * \return The total number of bytes received from the peers.
+   */
+  uint64_t GetTotalRx (void) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream The first stream index to use.
+   * \return The number of stream indices assigned by this model.
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief A connection sending a flow.
+   */
+  struct Slot
+  {
+    Ptr<Socket> socket;  //!< The socket, null if the slot is free
+    uint32_t flow;       //!< Index of the flow
+    uint64_t sent;       //!< Bytes of the flow given to the socket
+    uint32_t txSpace;    //!< Size of the send buffer of the socket
+  };
+
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * \brief Create a socket listening for the flows of the peers.
+   * \param local The local address and port.
+   * \return The socket.
+   */
+  Ptr<Socket> Listen (const Address &local);
+  /**
+   * \brief Start the flows whose start time has come and schedule the next one.
+   */
+  void StartFlows (void);
+  /**
+   * \brief Sample a new flow, start it and schedule the next arrival.
+   */
+  void SampleFlow (void);
+  /**
+   * \brief Open a connection for a flow, or queue the flow if all the slots are used.
+   * \param flow The index of the flow.
+   */
+  void OpenFlow (uint32_t flow);
+  /**
+   * \brief Give as much data as possible of a flow to its socket.
+   * \param slot The slot of the flow.
+   */
+  void SendData (uint32_t slot);
+  /**
+   * \brief Record the completion of a flow and release its slot.
+   * \param slot The slot of the flow.
+   */
+  void CompleteFlow (uint32_t slot);
+  /**
+   * \brief Release the connection of a slot and give the slot to a waiting flow.
+   * \param slot The slot.
+   * \param reuse Whether the connection goes back to the pool of its
+   * destination, rather than being closed.
+   */
+  void ReleaseSlot (uint32_t slot, bool reuse);
+  /**
+   * \brief Close a socket and clear its callbacks.
+   * \param socket The socket.
+   */
+  void CloseSocket (Ptr<Socket> socket);
+  /**
+   * \brief Connection succeeded (called by Socket through a callback).
+   * \param socket The connected socket.
+   */
+  void ConnectionSucceeded (Ptr<Socket> socket);
+  /**
+   * \brief Connection failed (called by Socket through a callback).
+   * \param socket The socket.
+   */
+  void ConnectionFailed (Ptr<Socket> socket);
+  /**
+   * \brief Space is available in the send buffer (called by Socket through a callback).
+   * \param socket The socket.
+   * \param available The number of bytes available.
+   */
+  void DataSend (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief A connection sending the flows was closed (called by Socket through a callback).
+   * \param socket The socket.
+   */
+  void HandleClose (Ptr<Socket> socket);
+  /**
+   * \brief Accept a connection from a peer.
+   * \param socket The new socket.
+   * \param from The address of the peer.
+   */
+  void HandleAccept (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief Discard the data received from a peer.
+   * \param socket The socket.
+   */
+  void HandleRead (Ptr<Socket> socket);
+  /**
+   * \brief Close a connection closed by a peer.
+   * \param socket The socket.
+   */
+  void HandlePeerClose (Ptr<Socket> socket);
+
+  uint16_t m_port;                          //!< Port to listen on and to send to
+  TypeId m_tid;                             //!< Socket factory type
+  uint32_t m_maxActive;                     //!< Maximum number of open connections
+  uint32_t m_maxFlows;                      //!< Number of flows to sample
+  Ptr<RandomVariableStream> m_flowSize;     //!< Size of the sampled flows, in bytes
+  Ptr<RandomVariableStream> m_interArrival; //!< Time between sampled flows, in seconds
+  Ptr<RandomVariableStream> m_deadline;     //!< Deadline of the sampled flows, in seconds
+  Ptr<UniformRandomVariable> m_peerChoice;  //!< Destination of the sampled flows
+
+  std::vector<Address> m_peers;             //!< Destinations
+  std::map<Address, uint32_t> m_peerIndex;  //!< Index of the destinations
+  std::vector<Flow> m_flows;                //!< All the flows
+  uint32_t m_nTraceFlows;                   //!< Number of flows added with AddFlow
+  uint32_t m_nextFlow;                      //!< Next flow added with AddFlow to start
+  uint32_t m_nSampled;                      //!< Number of sampled flows
+  std::deque<uint32_t> m_waiting;           //!< Flows waiting for a slot
+  std::vector<Slot> m_slots;                //!< Connections
+  std::vector<uint32_t> m_freeSlots;        //!< Unused connections
+  std::map<Ptr<Socket>, uint32_t> m_slotOf; //!< Slot of the open sockets
+  std::vector<std::vector<Ptr<Socket> > > m_idle; //!< Idle connections, per destination
+  uint32_t m_connections;                   //!< Number of connections opened
+  uint32_t m_completed;                     //!< Number of completed flows
+  uint32_t m_deadlinesMet;                  //!< Number of completed flows meeting their deadline
+  uint64_t m_totalRx;                       //!< Total bytes received
+  bool m_started;                           //!< Whether the application has started
+  Ptr<Socket> m_listener;                   //!< Listening IPv4 socket
+  Ptr<Socket> m_listener6;                  //!< Listening IPv6 socket
+  std::set<Ptr<Socket> > m_accepted;        //!< Connections accepted from the peers
+  EventId m_startEvent;                     //!< Next start of a flow added with AddFlow
+  EventId m_sampleEvent;                    //!< Next arrival of a sampled flow
+
+  /// Traced Callback: completed flows
+  TracedCallback<uint64_t, Time, bool> m_completedTrace;
+};
+
+} // namespace ns3
+
+#endif /* FLOW_GENERATOR_H */
@@ -27,6 +27,7 @@
 #include <ns3/pointer.h>
 #include <ns3/uinteger.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 #include <ns3/three-gpp-http-variables.h>
 #include <ns3/packet.h>
 #include <ns3/socket.h>
@@ -34,6 +35,7 @@
 #include <ns3/inet-socket-address.h>
 #include <ns3/inet6-socket-address.h>
 #include <ns3/unused.h>
+#include <algorithm>
 
 
 NS_LOG_COMPONENT_DEFINE ("ThreeGppHttpClient");
@@ -54,6 +56,7 @@ ThreeGppHttpClient::ThreeGppHttpClient ()
   m_delay (MicroSeconds(1000000)),
   m_deadline(Seconds(0)),
   m_begin(Seconds(0)),
+  m_requestsSent (0),
   m_httpVariables (CreateObject<ThreeGppHttpVariables> ())
 {
   NS_LOG_FUNCTION (this);
@@ -97,6 +100,24 @@ ThreeGppHttpClient::GetTypeId ()
                    UintegerValue (80), // the default HTTP port
                    MakeUintegerAccessor (&ThreeGppHttpClient::m_remoteServerPort),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("KeepAlive",
+                   "Keep the connection open and request successive main objects "
+                   "on it, instead of stopping after the first web page.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ThreeGppHttpClient::m_keepAlive),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxRequests",
+                   "The number of main objects requested in keep-alive mode "
+                   "before the client stops (zero means no limit).",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppHttpClient::m_maxRequests),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("PipelineDepth",
+                   "The number of main objects requested back to back in "
+                   "keep-alive mode, without waiting for the responses.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&ThreeGppHttpClient::m_pipelineDepth),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddTraceSource ("ConnectionEstablished",
                      "Connection to the destination web server has been established.",
                      MakeTraceSourceAccessor (&ThreeGppHttpClient::m_connectionEstablishedTrace),
@@ -149,6 +170,10 @@ ThreeGppHttpClient::GetTypeId ()
                      "Trace fired upon every HTTP client state transition.",
                      MakeTraceSourceAccessor (&ThreeGppHttpClient::m_stateTransitionTrace),
                      "ns3::Application::StateTransitionCallback")
+    .AddTraceSource ("RequestCompleted",
+                     "The object of a request has been completely received.",
+                     MakeTraceSourceAccessor (&ThreeGppHttpClient::m_requestCompletedTrace),
+                     "ns3::ThreeGppHttpClient::RequestTracedCallback")
   ;
   return tid;
 }
@@ -369,6 +394,12 @@ ThreeGppHttpClient::ReceivedDataCallback (Ptr<Socket> socket)
 
       m_rxTrace (packet, from);
 
+      if (m_keepAlive)
+        {
+          ReceivePipelinedData (packet, from);
+          continue;
+        }
+
       switch (m_state)
         {
         case EXPECTING_MAIN_OBJECT:
@@ -468,30 +499,50 @@ ThreeGppHttpClient::RequestMainObject ()
 
   if (m_state == CONNECTING || m_state == READING)
     {
-      ThreeGppHttpHeader header;
-      header.SetContentLength (0); // Request does not need any content length.
-      header.SetContentType (ThreeGppHttpHeader::MAIN_OBJECT);
-      header.SetClientTs (Simulator::Now ());
-      header.SetDeadline (Simulator::Now () + m_delay);
-      m_deadline = Simulator::Now() + m_delay;
-
-      const uint32_t requestSize = m_httpVariables->GetRequestSize ();
-      Ptr<Packet> packet = Create<Packet> (requestSize);
-      packet->AddHeader (header);
-      const uint32_t packetSize = packet->GetSize ();
-      m_txMainObjectRequestTrace (packet);
-      m_txTrace (packet);
-      const int actualBytes = m_socket->Send (packet);
-      NS_LOG_DEBUG (this << " Send() packet " << packet
-                         << " of " << packet->GetSize () << " bytes,"
-                         << " return value= " << actualBytes << ".");
-      if (actualBytes != static_cast<int> (packetSize))
+      // Several requests are pipelined in keep-alive mode.
+      uint32_t burst = 1;
+      if (m_keepAlive)
         {
-          NS_LOG_ERROR (this << " Failed to send request for embedded object,"
-                             << " GetErrNo= " << m_socket->GetErrno () << ","
-                             << " waiting for another Tx opportunity.");
+          burst = m_pipelineDepth;
+          if (m_maxRequests > 0)
+            {
+              NS_ASSERT (m_requestsSent < m_maxRequests);
+              burst = std::min (burst, m_maxRequests - m_requestsSent);
+            }
         }
-      else
+
+      for (uint32_t i = 0; i < burst; i++)
+        {
+          const uint32_t requestSize = m_httpVariables->GetRequestSize ();
+          ThreeGppHttpHeader header;
+          // The content length lets the server find the end of the request.
+          header.SetContentLength (requestSize);
+          header.SetContentType (ThreeGppHttpHeader::MAIN_OBJECT);
+          header.SetClientTs (Simulator::Now ());
+          header.SetDeadline (Simulator::Now () + m_delay);
+          m_deadline = Simulator::Now() + m_delay;
+
+          Ptr<Packet> packet = Create<Packet> (requestSize);
+          packet->AddHeader (header);
+          const uint32_t packetSize = packet->GetSize ();
+          m_txMainObjectRequestTrace (packet);
+          m_txTrace (packet);
+          const int actualBytes = m_socket->Send (packet);
+          NS_LOG_DEBUG (this << " Send() packet " << packet
+                             << " of " << packet->GetSize () << " bytes,"
+                             << " return value= " << actualBytes << ".");
+          if (actualBytes != static_cast<int> (packetSize))
+            {
+              NS_LOG_ERROR (this << " Failed to send request for main object,"
+                                 << " GetErrNo= " << m_socket->GetErrno () << ","
+                                 << " waiting for another Tx opportunity.");
+              break;
+            }
+          m_pendingDeadlines.push_back (m_deadline);
+          m_requestsSent++;
+        }
+
+      if (!m_pendingDeadlines.empty ())
         {
           SwitchToState (EXPECTING_MAIN_OBJECT);
         }
@@ -515,14 +566,15 @@ ThreeGppHttpClient::RequestEmbeddedObject ()
     {
       if (m_embeddedObjectsToBeRequested > 0)
         {
+          const uint32_t requestSize = m_httpVariables->GetRequestSize ();
           ThreeGppHttpHeader header;
-          header.SetContentLength (0); // Request does not need any content length.
+          // The content length lets the server find the end of the request.
+          header.SetContentLength (requestSize);
           header.SetContentType (ThreeGppHttpHeader::EMBEDDED_OBJECT);
           header.SetClientTs (Simulator::Now ());
           header.SetDeadline (Simulator::Now () + m_delay);
           m_deadline = Simulator::Now() + m_delay;
 
-          const uint32_t requestSize = m_httpVariables->GetRequestSize ();
           Ptr<Packet> packet = Create<Packet> (requestSize);
           packet->AddHeader (header);
           const uint32_t packetSize = packet->GetSize ();
@@ -542,6 +594,7 @@ ThreeGppHttpClient::RequestEmbeddedObject ()
           else
             {
               m_embeddedObjectsToBeRequested--;
+              m_pendingDeadlines.push_back (m_deadline);
               SwitchToState (EXPECTING_EMBEDDED_OBJECT);
             }
         }
@@ -594,6 +647,7 @@ ThreeGppHttpClient::ReceiveMainObject (Ptr<Packet> packet, const Address &from)
            */
           NS_LOG_INFO (this << " Finished receiving a main object.");
           m_rxMainObjectTrace (this, m_constructedPacket);
+          CompleteRequest ();
 
           if (!m_objectServerTs.IsZero ())
             {
@@ -607,7 +661,15 @@ ThreeGppHttpClient::ReceiveMainObject (Ptr<Packet> packet, const Address &from)
               m_objectClientTs = MilliSeconds (0); // Reset back to zero.
             }
 
-          EnterParsingTime ();
+          if (!m_keepAlive)
+            {
+              EnterParsingTime ();
+            }
+          else if (m_pendingDeadlines.empty ())
+            {
+              // The last object of the burst; the next one follows the reading time.
+              EnterReadingTime ();
+            }
 
         } // end of else of `if (m_objectBytesToBeReceived > 0)`
 
@@ -655,6 +717,7 @@ ThreeGppHttpClient::ReceiveEmbeddedObject (Ptr<Packet> packet, const Address &fr
            */
           NS_LOG_INFO (this << " Finished receiving an embedded object.");
           m_rxEmbeddedObjectTrace (this, m_constructedPacket);
+          CompleteRequest ();
 
           if (!m_objectServerTs.IsZero ())
             {
@@ -754,6 +817,69 @@ ThreeGppHttpClient::Receive (Ptr<Packet> packet)
 } // end of `void Receive (packet)`
 
 
+void
+ThreeGppHttpClient::ReceivePipelinedData (Ptr<Packet> packet, const Address &from)
+{
+  NS_LOG_FUNCTION (this << packet << from);
+
+  if (m_rxPending != 0)
+    {
+      m_rxPending->AddAtEnd (packet);
+      packet = m_rxPending;
+      m_rxPending = 0;
+    }
+
+  while (packet->GetSize () > 0)
+    {
+      uint32_t objectBytes = m_objectBytesToBeReceived;
+      if (objectBytes == 0)
+        {
+          // The beginning of a new object.
+          ThreeGppHttpHeader httpHeader;
+          if (packet->GetSize () < httpHeader.GetSerializedSize ())
+            {
+              m_rxPending = packet;
+              return;
+            }
+          packet->PeekHeader (httpHeader);
+          objectBytes = httpHeader.GetSerializedSize () + httpHeader.GetContentLength ();
+        }
+
+      if (packet->GetSize () <= objectBytes)
+        {
+          ReceiveMainObject (packet, from);
+          return;
+        }
+
+      // The packet also holds the beginning of the next pipelined object.
+      ReceiveMainObject (packet->CreateFragment (0, objectBytes), from);
+      packet = packet->CreateFragment (objectBytes, packet->GetSize () - objectBytes);
+    }
+
+} // end of `void ReceivePipelinedData (Ptr<Packet> packet, const Address &from)`
+
+
+void
+ThreeGppHttpClient::CompleteRequest ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_pendingDeadlines.empty ())
+    {
+      NS_LOG_WARN (this << " Received an object which was not requested.");
+      return;
+    }
+
+  const Time deadline = m_pendingDeadlines.front ();
+  m_pendingDeadlines.pop_front ();
+  const Time latency = Simulator::Now () - m_objectClientTs;
+  const bool deadlineMet = (Simulator::Now () <= deadline);
+  NS_LOG_INFO (this << " Request completed after " << latency.As (Time::S)
+                    << (deadlineMet ? ", deadline met." : ", deadline missed."));
+  m_requestCompletedTrace (this, latency, deadlineMet);
+}
+
+
 void
 ThreeGppHttpClient::EnterParsingTime ()
 {
@@ -824,7 +950,26 @@ ThreeGppHttpClient::EnterReadingTime ()
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_state == EXPECTING_EMBEDDED_OBJECT || m_state == PARSING_MAIN_OBJECT)
+  if (m_keepAlive && m_state == EXPECTING_MAIN_OBJECT)
+    {
+      if (m_maxRequests > 0 && m_requestsSent >= m_maxRequests)
+        {
+          NS_LOG_INFO (this << " Received all the " << m_requestsSent
+                            << " requested main objects.");
+          m_eventRequestMainObject = Simulator::ScheduleNow (
+              &ThreeGppHttpClient::StopApplication, this);
+        }
+      else
+        {
+          const Time readingTime = m_httpVariables->GetReadingTime ();
+          NS_LOG_INFO (this << " Client will request the next main object in "
+                            << readingTime.As (Time::S) << ".");
+          m_eventRequestMainObject = Simulator::Schedule (
+              readingTime, &ThreeGppHttpClient::RequestMainObject, this);
+        }
+      SwitchToState (READING);
+    }
+  else if (m_state == EXPECTING_EMBEDDED_OBJECT || m_state == PARSING_MAIN_OBJECT)
     {
       const Time readingTime = m_httpVariables->GetReadingTime ();
       NS_LOG_INFO (this << " Client will finish reading this web page in "
@@ -26,6 +26,7 @@
 #include <ns3/address.h>
 #include <ns3/traced-callback.h>
 #include <ns3/three-gpp-http-header.h>
+#include <deque>
 
 
 namespace ns3 {
@@ -104,6 +105,20 @@ class ThreeGppHttpVariables;
  * such as the content type requested (either main object or embedded object)
  * and the timestamp when the packet is transmitted (which will be used to
  * compute the delay and RTT of the packet).
+ *
+ * Each request carries the absolute deadline of its response (the delay set
+ * by SetDelay() after the request is sent), which the server gives to its
+ * socket. The `RequestCompleted` trace source reports the latency of every
+ * request and whether its deadline was met.
+ *
+ * By default, the client stops after the first web page. When the
+ * `KeepAlive` attribute is set, the client instead keeps its connection open
+ * and requests successive main objects on it, so that each request does not
+ * pay for a new TCP handshake and slow start. The main objects are requested
+ * in bursts of `PipelineDepth` requests, sent without waiting for the
+ * responses (HTTP pipelining); the next burst follows a reading time after
+ * the last response of a burst. The client stops after `MaxRequests`
+ * requests. Embedded objects are not requested in this mode.
  */
 class ThreeGppHttpClient : public Application
 {
@@ -179,6 +194,18 @@ public:
    */
   typedef void (*TracedCallback)(Ptr<const ThreeGppHttpClient> httpClient);
 
+  /**
+   * Callback signature for `RequestCompleted` trace source.
+   * \param httpClient Pointer to this instance of ThreeGppHttpClient,
+   *                   which is where the trace originated.
+   * \param latency The time between the request and the complete reception
+   *                of the object.
+   * \param deadlineMet True if the object was received before the deadline
+   *                    of the request.
+   */
+  typedef void (*RequestTracedCallback)(Ptr<const ThreeGppHttpClient> httpClient,
+                                        const Time &latency, bool deadlineMet);
+
 protected:
   // Inherited from Object base class.
   virtual void DoDispose ();
@@ -309,6 +336,20 @@ private:
    *               then it must have a ThreeGppHttpHeader attached to it.
    */
   void Receive (Ptr<Packet> packet);
+  /**
+   * Split the data received in keep-alive mode into the main objects of the
+   * pipelined requests, and give them to ReceiveMainObject(). The beginning
+   * of an object which is too short to hold its ThreeGppHttpHeader is kept in
+   * #m_rxPending until more data arrives.
+   * \param packet The received packet.
+   * \param from Address of the sender.
+   */
+  void ReceivePipelinedData (Ptr<Packet> packet, const Address &from);
+  /**
+   * Fires the `RequestCompleted` trace source for the oldest pending request,
+   * once its object has been completely received.
+   */
+  void CompleteRequest ();
 
   // OFF-TIME-RELATED METHODS
 
@@ -368,6 +409,12 @@ private:
   Time m_delay;
   Time m_deadline;
   Time m_begin;
+  /// Number of main objects requested on the connection.
+  uint32_t     m_requestsSent;
+  /// Deadlines of the requests whose object is not completely received yet.
+  std::deque<Time> m_pendingDeadlines;
+  /// Beginning of an object too short to hold its header (keep-alive mode).
+  Ptr<Packet>  m_rxPending;
 
   // ATTRIBUTES
 
@@ -377,6 +424,12 @@ private:
   Address                               m_remoteServerAddress;
   /// The `RemoteServerPort` attribute.
   uint16_t                              m_remoteServerPort;
+  /// The `KeepAlive` attribute.
+  bool                                  m_keepAlive;
+  /// The `MaxRequests` attribute.
+  uint32_t                              m_maxRequests;
+  /// The `PipelineDepth` attribute.
+  uint32_t                              m_pipelineDepth;
 
   
 
@@ -408,6 +461,8 @@ private:
   ns3::TracedCallback<const Time &, const Address &>  m_rxRttTrace;
   /// The `StateTransition` trace source.
   ns3::TracedCallback<const std::string &, const std::string &> m_stateTransitionTrace;
+  /// The `RequestCompleted` trace source.
+  ns3::TracedCallback<Ptr<const ThreeGppHttpClient>, const Time &, bool> m_requestCompletedTrace;
 
   // EVENTS
 
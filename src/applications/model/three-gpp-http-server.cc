@@ -441,57 +441,80 @@ ThreeGppHttpServer::ReceivedDataCallback (Ptr<Socket> socket)
         }
 #endif /* NS3_LOG_ENABLE */
 
-      // Check the header. No need to remove it, since it is not a "real" header.
-      ThreeGppHttpHeader httpHeader;
-      packet->PeekHeader (httpHeader);
-      Time deadline = httpHeader.GetDeadline();
-      NS_LOG_INFO(this <<" from is : " << from
-                       <<" , packet is : "<< packet
-                       <<" , head is : " << httpHeader
-                       <<" , socket is : "<< socket
-                       <<" , deadline is : " << deadline
-                       <<" , type is : "<< httpHeader.GetContentType());
-      socket->SetDeadline(deadline);
-
-      // Fire trace sources.
-      m_rxTrace (packet, from);
-      m_rxDelayTrace (Simulator::Now () - httpHeader.GetClientTs (), from);
-
-      Time processingDelay;
-      switch (httpHeader.GetContentType ())
+      /*
+       * TCP does not preserve the boundaries of the requests: a packet may
+       * hold a part of a request, or several pipelined requests. The requests
+       * are extracted using the content length in their header.
+       */
+      m_txBuffer->AddRxData (socket, packet);
+      Ptr<Packet> request;
+
+      while ((request = m_txBuffer->ExtractRequest (socket)))
         {
-        case ThreeGppHttpHeader::MAIN_OBJECT:
-          processingDelay = m_httpVariables->GetMainObjectGenerationDelay ();
-          NS_LOG_INFO (this << " Will finish generating a main object"
-                            << " in " << processingDelay.As (Time::S) << ".");
-          m_txBuffer->RecordNextServe (socket,
-                                       Simulator::Schedule (processingDelay,
-                                                            &ThreeGppHttpServer::ServeNewMainObject,
-                                                            this, socket),
-                                       httpHeader.GetClientTs ());
-          break;
-
-        case ThreeGppHttpHeader::EMBEDDED_OBJECT:
-          processingDelay = m_httpVariables->GetEmbeddedObjectGenerationDelay ();
-          NS_LOG_INFO (this << " Will finish generating an embedded object"
-                            << " in " << processingDelay.As (Time::S) << ".");
-          m_txBuffer->RecordNextServe (socket,
-                                       Simulator::Schedule (processingDelay,
-                                                            &ThreeGppHttpServer::ServeNewEmbeddedObject,
-                                                            this, socket),
-                                       httpHeader.GetClientTs ());
-          break;
-
-        default:
-          NS_FATAL_ERROR ("Invalid packet.");
-          break;
+          // Check the header. No need to remove it, since it is not a "real" header.
+          ThreeGppHttpHeader httpHeader;
+          request->PeekHeader (httpHeader);
+          NS_LOG_INFO (this << " Received a request of " << request->GetSize ()
+                            << " bytes from " << from << ": " << httpHeader);
+
+          // Fire trace sources.
+          m_rxTrace (request, from);
+          m_rxDelayTrace (Simulator::Now () - httpHeader.GetClientTs (), from);
+
+          m_txBuffer->EnqueueRequest (socket, httpHeader);
         }
 
     } // end of `while ((packet = socket->RecvFrom (from)))`
 
+  if (m_txBuffer->IsSocketAvailable (socket)
+      && !m_txBuffer->IsServing (socket) && m_txBuffer->HasPendingRequest (socket))
+    {
+      ServeNextRequest (socket);
+    }
+
 } // end of `void ReceivedDataCallback (Ptr<Socket> socket)`
 
 
+void
+ThreeGppHttpServer::ServeNextRequest (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+
+  const ThreeGppHttpHeader httpHeader = m_txBuffer->DequeueRequest (socket);
+  Time processingDelay;
+  switch (httpHeader.GetContentType ())
+    {
+    case ThreeGppHttpHeader::MAIN_OBJECT:
+      processingDelay = m_httpVariables->GetMainObjectGenerationDelay ();
+      NS_LOG_INFO (this << " Will finish generating a main object"
+                        << " in " << processingDelay.As (Time::S) << ".");
+      m_txBuffer->RecordNextServe (socket,
+                                   Simulator::Schedule (processingDelay,
+                                                        &ThreeGppHttpServer::ServeNewMainObject,
+                                                        this, socket),
+                                   httpHeader.GetClientTs (),
+                                   httpHeader.GetDeadline ());
+      break;
+
+    case ThreeGppHttpHeader::EMBEDDED_OBJECT:
+      processingDelay = m_httpVariables->GetEmbeddedObjectGenerationDelay ();
+      NS_LOG_INFO (this << " Will finish generating an embedded object"
+                        << " in " << processingDelay.As (Time::S) << ".");
+      m_txBuffer->RecordNextServe (socket,
+                                   Simulator::Schedule (processingDelay,
+                                                        &ThreeGppHttpServer::ServeNewEmbeddedObject,
+                                                        this, socket),
+                                   httpHeader.GetClientTs (),
+                                   httpHeader.GetDeadline ());
+      break;
+
+    default:
+      NS_FATAL_ERROR ("Invalid packet.");
+      break;
+    }
+}
+
+
 void
 ThreeGppHttpServer::SendCallback (Ptr<Socket> socket, uint32_t availableBufferSize)
 {
@@ -557,6 +580,8 @@ ThreeGppHttpServer::ServeNewMainObject (Ptr<Socket> socket)
   NS_LOG_INFO (this << " Main object to be served is "
                     << objectSize << " bytes.");
   m_mainObjectTrace (objectSize);
+  // The deadline of the request being served, when several are pipelined.
+  socket->SetDeadline (m_txBuffer->GetDeadline (socket));
   m_txBuffer->WriteNewObject (socket, ThreeGppHttpHeader::MAIN_OBJECT,
                               objectSize);
   const uint32_t actualSent = ServeFromTxBuffer (socket);
@@ -582,6 +607,8 @@ ThreeGppHttpServer::ServeNewEmbeddedObject (Ptr<Socket> socket)
   NS_LOG_INFO (this << " Embedded object to be served is "
                     << objectSize << " bytes.");
   m_embeddedObjectTrace (objectSize);
+  // The deadline of the request being served, when several are pipelined.
+  socket->SetDeadline (m_txBuffer->GetDeadline (socket));
   m_txBuffer->WriteNewObject (socket, ThreeGppHttpHeader::EMBEDDED_OBJECT,
                               objectSize);
   const uint32_t actualSent = ServeFromTxBuffer (socket);
@@ -664,8 +691,18 @@ ThreeGppHttpServer::ServeFromTxBuffer (Ptr<Socket> socket)
     {
       // The packet goes through successfully.
       m_txBuffer->DepleteBufferSize (socket, contentSize);
+      if (!m_txBuffer->IsSocketAvailable (socket))
+        {
+          // The socket was closed by DepleteBufferSize().
+          return packetSize;
+        }
       NS_LOG_INFO (this << " Remaining object to be sent "
                         << m_txBuffer->GetBufferSize (socket) << " bytes.");
+      if (!m_txBuffer->IsServing (socket) && m_txBuffer->HasPendingRequest (socket))
+        {
+          // The object is in the socket; serve the next pipelined request.
+          ServeNextRequest (socket);
+        }
       return packetSize;
     }
   else
@@ -900,9 +937,10 @@ ThreeGppHttpServerTxBuffer::WriteNewObject (Ptr<Socket> socket,
 void
 ThreeGppHttpServerTxBuffer::RecordNextServe (Ptr<Socket>    socket,
                                              const EventId  &eventId,
-                                             const Time     &clientTs)
+                                             const Time     &clientTs,
+                                             const Time     &deadline)
 {
-  NS_LOG_FUNCTION (this << socket << clientTs.As (Time::S));
+  NS_LOG_FUNCTION (this << socket << clientTs.As (Time::S) << deadline.As (Time::S));
 
   std::map<Ptr<Socket>, TxBuffer_t>::iterator it;
   it = m_txBuffer.find (socket);
@@ -910,6 +948,7 @@ ThreeGppHttpServerTxBuffer::RecordNextServe (Ptr<Socket>    socket,
                  "Socket " << socket << " cannot be found.");
   it->second.nextServe = eventId;
   it->second.clientTs = clientTs;
+  it->second.deadline = deadline;
 }
 
 
@@ -953,4 +992,127 @@ ThreeGppHttpServerTxBuffer::PrepareClose (Ptr<Socket> socket)
 }
 
 
+Time
+ThreeGppHttpServerTxBuffer::GetDeadline (Ptr<Socket> socket) const
+{
+  std::map<Ptr<Socket>, TxBuffer_t>::const_iterator it;
+  it = m_txBuffer.find (socket);
+  NS_ASSERT_MSG (it != m_txBuffer.end (),
+                 "Socket " << socket << " cannot be found.");
+  return it->second.deadline;
+}
+
+
+bool
+ThreeGppHttpServerTxBuffer::IsServing (Ptr<Socket> socket) const
+{
+  std::map<Ptr<Socket>, TxBuffer_t>::const_iterator it;
+  it = m_txBuffer.find (socket);
+  NS_ASSERT_MSG (it != m_txBuffer.end (),
+                 "Socket " << socket << " cannot be found.");
+  return !Simulator::IsExpired (it->second.nextServe)
+         || (it->second.txBufferSize > 0);
+}
+
+
+void
+ThreeGppHttpServerTxBuffer::AddRxData (Ptr<Socket> socket, Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (this << socket << packet);
+
+  std::map<Ptr<Socket>, TxBuffer_t>::iterator it;
+  it = m_txBuffer.find (socket);
+  NS_ASSERT_MSG (it != m_txBuffer.end (),
+                 "Socket " << socket << " cannot be found.");
+  if (it->second.rxBuffer == 0)
+    {
+      it->second.rxBuffer = packet;
+    }
+  else
+    {
+      it->second.rxBuffer->AddAtEnd (packet);
+    }
+}
+
+
+Ptr<Packet>
+ThreeGppHttpServerTxBuffer::ExtractRequest (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+
+  std::map<Ptr<Socket>, TxBuffer_t>::iterator it;
+  it = m_txBuffer.find (socket);
+  NS_ASSERT_MSG (it != m_txBuffer.end (),
+                 "Socket " << socket << " cannot be found.");
+
+  Ptr<Packet> rxBuffer = it->second.rxBuffer;
+  ThreeGppHttpHeader httpHeader;
+  if (rxBuffer == 0 || rxBuffer->GetSize () < httpHeader.GetSerializedSize ())
+    {
+      return 0;
+    }
+
+  rxBuffer->PeekHeader (httpHeader);
+  const uint32_t requestSize = httpHeader.GetSerializedSize ()
+    + httpHeader.GetContentLength ();
+  if (rxBuffer->GetSize () < requestSize)
+    {
+      NS_LOG_LOGIC (this << " Waiting for the rest of a request of "
+                         << requestSize << " bytes.");
+      return 0;
+    }
+
+  if (rxBuffer->GetSize () == requestSize)
+    {
+      it->second.rxBuffer = 0;
+      return rxBuffer;
+    }
+  it->second.rxBuffer = rxBuffer->CreateFragment (requestSize,
+                                                  rxBuffer->GetSize () - requestSize);
+  return rxBuffer->CreateFragment (0, requestSize);
+}
+
+
+void
+ThreeGppHttpServerTxBuffer::EnqueueRequest (Ptr<Socket> socket,
+                                            const ThreeGppHttpHeader &httpHeader)
+{
+  NS_LOG_FUNCTION (this << socket);
+
+  std::map<Ptr<Socket>, TxBuffer_t>::iterator it;
+  it = m_txBuffer.find (socket);
+  NS_ASSERT_MSG (it != m_txBuffer.end (),
+                 "Socket " << socket << " cannot be found.");
+  it->second.pendingRequests.push_back (httpHeader);
+}
+
+
+bool
+ThreeGppHttpServerTxBuffer::HasPendingRequest (Ptr<Socket> socket) const
+{
+  std::map<Ptr<Socket>, TxBuffer_t>::const_iterator it;
+  it = m_txBuffer.find (socket);
+  NS_ASSERT_MSG (it != m_txBuffer.end (),
+                 "Socket " << socket << " cannot be found.");
+  return !it->second.pendingRequests.empty ();
+}
+
+
+ThreeGppHttpHeader
+ThreeGppHttpServerTxBuffer::DequeueRequest (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+
+  std::map<Ptr<Socket>, TxBuffer_t>::iterator it;
+  it = m_txBuffer.find (socket);
+  NS_ASSERT_MSG (it != m_txBuffer.end (),
+                 "Socket " << socket << " cannot be found.");
+  NS_ASSERT_MSG (!it->second.pendingRequests.empty (),
+                 "No pending request on socket " << socket << ".");
+  const ThreeGppHttpHeader httpHeader = it->second.pendingRequests.front ();
+  it->second.pendingRequests.pop_front ();
+  return httpHeader;
+}
+
+
 } // end of `namespace ns3`
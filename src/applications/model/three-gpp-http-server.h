@@ -31,6 +31,7 @@
 #include <ns3/address.h>
 #include <ns3/traced-callback.h>
 #include <map>
+#include <deque>
 #include <ostream>
 
 
@@ -65,6 +66,12 @@ class ThreeGppHttpServerTxBuffer;
  *
  * The application accepts connection request from clients. Every connection is
  * kept open until the client disconnects.
+ *
+ * A client may send several requests on a connection without waiting for the
+ * responses (pipelining, see the `PipelineDepth` attribute of
+ * ThreeGppHttpClient). The requests are then served one after the other, in
+ * the order of their arrival. The deadline carried by a request is given to
+ * the socket when its object is served.
  */
 class ThreeGppHttpServer : public Application
 {
@@ -190,11 +197,12 @@ private:
    */
   void ErrorCloseCallback (Ptr<Socket> socket);
   /**
-   * Invoked when #m_initialSocket receives some packet data. It will check the
-   * packet for ThreeGppHttpHeader. It also fires the `Rx` trace source.
+   * Invoked when #m_initialSocket receives some packet data. It will extract
+   * the requests, each starting with a ThreeGppHttpHeader, from the received
+   * data. It also fires the `Rx` trace source for every request.
    *
-   * Depending on the type of object requested, the method will trigger
-   * ServeMainObject() or ServeEmbeddedObject() after some delays.
+   * The requests are queued in the Tx buffer, and ServeNextRequest() is
+   * triggered if the socket is not serving a previous request.
    *
    * \param socket Pointer to the socket where the event originates from.
    */
@@ -211,6 +219,20 @@ private:
 
   // TX-RELATED METHODS
 
+  /**
+   * Takes the oldest pending request of a socket from the Tx buffer and
+   * triggers ServeNewMainObject() or ServeNewEmbeddedObject() after the
+   * object generation delay.
+   *
+   * The method is invoked when a request is received while the socket is not
+   * serving another one, and when the previous object has been completely
+   * given to the socket.
+   *
+   * \param socket Pointer to the socket which is associated with the
+   *               destination client.
+   */
+  void ServeNextRequest (Ptr<Socket> socket);
+
   /**
    * Generates a new main object and push it into the Tx buffer.
    *
@@ -472,13 +494,15 @@ public:
    * \param eventId the event to be recorded, e.g., the return value of
    *                Simulator::Schedule function
    * \param clientTs client time stamp
+   * \param deadline absolute deadline of the request being served
    *
    * \warning Must be called only when IsSocketAvailable() for the given socket
    *          is true.
    */
   void RecordNextServe (Ptr<Socket>   socket,
                         const EventId &eventId,
-                        const Time    &clientTs);
+                        const Time    &clientTs,
+                        const Time    &deadline);
 
   /**
    * Decrements a buffer size by a given amount.
@@ -511,6 +535,75 @@ public:
    */
   void PrepareClose (Ptr<Socket> socket);
 
+  /**
+   * \param socket Pointer to the socket which is associated with the
+   *               transmission buffer of interest.
+   * \return The deadline of the request being served, as given to
+   *         RecordNextServe().
+   * \warning Must be called only when IsSocketAvailable() for the given socket
+   *          is true.
+   */
+  Time GetDeadline (Ptr<Socket> socket) const;
+
+  /**
+   * \param socket Pointer to the socket which is associated with the
+   *               transmission buffer of interest.
+   * \return True if an object is being generated or remains to be sent.
+   * \warning Must be called only when IsSocketAvailable() for the given socket
+   *          is true.
+   */
+  bool IsServing (Ptr<Socket> socket) const;
+
+  // REQUEST MANAGEMENT
+
+  /**
+   * Append data received on a socket to its reception buffer.
+   * \param socket Pointer to the socket where the data was received.
+   * \param packet The received data.
+   * \warning Must be called only when IsSocketAvailable() for the given socket
+   *          is true.
+   */
+  void AddRxData (Ptr<Socket> socket, Ptr<Packet> packet);
+
+  /**
+   * Remove the oldest complete request from the reception buffer of a
+   * socket. A request is a ThreeGppHttpHeader followed by the number of bytes
+   * given by its content length.
+   * \param socket Pointer to the socket where the data was received.
+   * \return The request, including its header, or 0 if the reception buffer
+   *         does not hold a complete request.
+   * \warning Must be called only when IsSocketAvailable() for the given socket
+   *          is true.
+   */
+  Ptr<Packet> ExtractRequest (Ptr<Socket> socket);
+
+  /**
+   * Add a request to the queue of the requests waiting to be served.
+   * \param socket Pointer to the socket where the request was received.
+   * \param httpHeader The header of the request.
+   * \warning Must be called only when IsSocketAvailable() for the given socket
+   *          is true.
+   */
+  void EnqueueRequest (Ptr<Socket> socket, const ThreeGppHttpHeader &httpHeader);
+
+  /**
+   * \param socket Pointer to the socket of interest.
+   * \return True if some requests received on the socket have not been
+   *         served yet.
+   * \warning Must be called only when IsSocketAvailable() for the given socket
+   *          is true.
+   */
+  bool HasPendingRequest (Ptr<Socket> socket) const;
+
+  /**
+   * Remove the oldest request waiting to be served.
+   * \param socket Pointer to the socket of interest.
+   * \return The header of the request.
+   * \warning Must be called only when HasPendingRequest() for the given socket
+   *          is true.
+   */
+  ThreeGppHttpHeader DequeueRequest (Ptr<Socket> socket);
+
 private:
   /**
    * Set of fields representing a single transmission buffer, which will be
@@ -550,6 +643,15 @@ private:
      *        Accessible using the HasTxedPartOfObject() method.
      */
     bool hasTxedPartOfObject;
+    /**
+     * The absolute deadline of the request being served, given to the socket
+     * together with the object. Accessible using the GetDeadline() method.
+     */
+    Time deadline;
+    /// The requests received and not served yet, in the order of their arrival.
+    std::deque<ThreeGppHttpHeader> pendingRequests;
+    /// The received data which does not form a complete request yet.
+    Ptr<Packet> rxBuffer;
   };
 
   /// Collection of accepted sockets and its individual transmission buffer.
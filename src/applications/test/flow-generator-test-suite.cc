@@ -0,0 +1,402 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/nstime.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv6-interface-container.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/flow-generator.h"
+#include "ns3/flow-generator-helper.h"
+#include "ns3/simulator.h"
+#include <fstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Base class of the FlowGenerator tests: three nodes on a 10 Mbps channel
+ */
+class FlowGeneratorTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param name the name of the test case
+   */
+  FlowGeneratorTestCase (std::string name);
+
+protected:
+  /// Create the nodes and assign their addresses
+  void CreateNodes (void);
+  NodeContainer m_nodes;             ///< the nodes
+  Ipv4InterfaceContainer m_ifaces;   ///< the interfaces of the nodes
+};
+
+FlowGeneratorTestCase::FlowGeneratorTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+FlowGeneratorTestCase::CreateNodes (void)
+{
+  m_nodes.Create (3);
+  SimpleNetDeviceHelper simpleHelper;
+  simpleHelper.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  simpleHelper.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = simpleHelper.Install (m_nodes);
+  InternetStackHelper internet;
+  internet.Install (m_nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  m_ifaces = ipv4.Assign (devices);
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Check the flows of a trace, their completion and deadlines
+ */
+class FlowGeneratorTraceTestCase : public FlowGeneratorTestCase
+{
+public:
+  FlowGeneratorTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record a completed flow
+   * \param size the size of the flow
+   * \param fct the flow completion time
+   * \param deadlineMet whether the deadline was met
+   */
+  void Completed (uint64_t size, Time fct, bool deadlineMet);
+  uint64_t m_completedBytes {0}; ///< bytes of the completed flows
+};
+
+FlowGeneratorTraceTestCase::FlowGeneratorTraceTestCase ()
+  : FlowGeneratorTestCase ("Check the flows of a trace")
+{
+}
+
+void
+FlowGeneratorTraceTestCase::Completed (uint64_t size, Time fct, bool deadlineMet)
+{
+  m_completedBytes += size;
+}
+
+void
+FlowGeneratorTraceTestCase::DoRun (void)
+{
+  CreateNodes ();
+  uint32_t n0 = m_nodes.Get (0)->GetId ();
+  uint32_t n1 = m_nodes.Get (1)->GetId ();
+  uint32_t n2 = m_nodes.Get (2)->GetId ();
+
+  std::string filename = CreateTempDirFilename ("flows.tr");
+  std::ofstream trace (filename.c_str ());
+  trace << "# start src dst size deadline" << std::endl
+        << "0.1 " << n1 << " " << n0 << " 100000 10" << std::endl
+        << std::endl
+        << "0.1 " << n2 << " " << n0 << " 100000 0.001" << std::endl
+        << "0.5 " << n0 << " " << n1 << " 1000" << std::endl;
+  trace.close ();
+
+  FlowGeneratorHelper helper (5000);
+  ApplicationContainer apps = helper.Install (m_nodes);
+  NS_TEST_ASSERT_MSG_EQ (helper.LoadTrace (filename), 3, "Three flows in the trace");
+  apps.Start (Seconds (0));
+  apps.Stop (Seconds (10));
+  for (uint32_t i = 0; i < apps.GetN (); i++)
+    {
+      apps.Get (i)->TraceConnectWithoutContext ("FlowCompleted",
+                                                MakeCallback (&FlowGeneratorTraceTestCase::Completed, this));
+    }
+
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (helper.GetNCompletedFlows (), 3, "All the flows should complete");
+  NS_TEST_EXPECT_MSG_EQ (helper.GetNDeadlinesMet (), 2, "The second flow cannot meet its deadline");
+  NS_TEST_EXPECT_MSG_EQ (m_completedBytes, 201000, "All the bytes should be acknowledged");
+
+  Ptr<FlowGenerator> g0 = DynamicCast<FlowGenerator> (apps.Get (0));
+  Ptr<FlowGenerator> g1 = DynamicCast<FlowGenerator> (apps.Get (1));
+  NS_TEST_EXPECT_MSG_EQ (g0->GetTotalRx (), 200000, "Node 0 receives two flows");
+  NS_TEST_EXPECT_MSG_EQ (g1->GetTotalRx (), 1000, "Node 1 receives one flow");
+  NS_TEST_ASSERT_MSG_EQ (g1->GetNFlows (), 1, "Node 1 sends one flow");
+  const FlowGenerator::Flow &flow = g1->GetFlow (0);
+  NS_TEST_EXPECT_MSG_EQ (flow.start, Seconds (0.1), "Start time of the flow");
+  NS_TEST_EXPECT_MSG_EQ (flow.deadline, Seconds (10), "Deadline of the flow");
+  NS_TEST_EXPECT_MSG_EQ (flow.size, 100000, "Size of the flow");
+  NS_TEST_EXPECT_MSG_EQ (g1->GetPeer (flow.peer), Address (InetSocketAddress (m_ifaces.GetAddress (0), 5000)),
+                         "Destination of the flow");
+  // 100 KB at 10 Mbps
+  NS_TEST_EXPECT_MSG_GT (flow.finish - flow.start, MilliSeconds (80), "Flow completion time");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Check that the flows wait for a free connection
+ */
+class FlowGeneratorMaxActiveTestCase : public FlowGeneratorTestCase
+{
+public:
+  FlowGeneratorMaxActiveTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FlowGeneratorMaxActiveTestCase::FlowGeneratorMaxActiveTestCase ()
+  : FlowGeneratorTestCase ("Check the limit on the number of connections")
+{
+}
+
+void
+FlowGeneratorMaxActiveTestCase::DoRun (void)
+{
+  CreateNodes ();
+  FlowGeneratorHelper helper (5000);
+  helper.SetAttribute ("MaxActiveFlows", UintegerValue (1));
+  ApplicationContainer apps = helper.Install (m_nodes);
+  Ptr<FlowGenerator> g0 = DynamicCast<FlowGenerator> (apps.Get (0));
+  Address peer = InetSocketAddress (m_ifaces.GetAddress (1), 5000);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      g0->AddFlow (Seconds (0.1), peer, 50000);
+    }
+  apps.Start (Seconds (0));
+  apps.Stop (Seconds (10));
+
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (g0->GetNCompletedFlows (), 3, "All the flows should complete");
+  NS_TEST_EXPECT_MSG_EQ (g0->GetNConnections (), 1, "The flows should reuse the same connection");
+  for (uint32_t i = 1; i < 3; i++)
+    {
+      // 50 KB at 10 Mbps
+      NS_TEST_EXPECT_MSG_GT (g0->GetFlow (i).finish - g0->GetFlow (i - 1).finish, MilliSeconds (40),
+                             "The flows should be sent one after the other");
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Check the sampled flows
+ */
+class FlowGeneratorSampleTestCase : public FlowGeneratorTestCase
+{
+public:
+  FlowGeneratorSampleTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FlowGeneratorSampleTestCase::FlowGeneratorSampleTestCase ()
+  : FlowGeneratorTestCase ("Check the sampled flows")
+{
+}
+
+void
+FlowGeneratorSampleTestCase::DoRun (void)
+{
+  CreateNodes ();
+  FlowGeneratorHelper helper (5000);
+  helper.SetAttribute ("FlowSize", StringValue ("ns3::ConstantRandomVariable[Constant=10000]"));
+  helper.SetAttribute ("InterArrival", StringValue ("ns3::ConstantRandomVariable[Constant=0.05]"));
+  helper.SetAttribute ("MaxFlows", UintegerValue (5));
+  ApplicationContainer apps = helper.Install (m_nodes);
+  apps.Start (Seconds (0));
+  apps.Stop (Seconds (10));
+
+  Simulator::Run ();
+
+  uint64_t rx = 0;
+  for (uint32_t i = 0; i < apps.GetN (); i++)
+    {
+      Ptr<FlowGenerator> g = DynamicCast<FlowGenerator> (apps.Get (i));
+      NS_TEST_EXPECT_MSG_EQ (g->GetNPeers (), 2, "The other nodes are the peers");
+      NS_TEST_EXPECT_MSG_EQ (g->GetNFlows (), 5, "Five flows are sampled");
+      rx += g->GetTotalRx ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (helper.GetNCompletedFlows (), 15, "All the flows should complete");
+  NS_TEST_EXPECT_MSG_EQ (rx, 150000, "All the bytes should be received");
+  Simulator::Destroy ();
+
+  Ptr<EmpiricalRandomVariable> webSearch = FlowGeneratorHelper::CreateWebSearchFlowSize ();
+  Ptr<EmpiricalRandomVariable> dataMining = FlowGeneratorHelper::CreateDataMiningFlowSize ();
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      double size = webSearch->GetValue ();
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (size, 6 * 1460, "Web search flows are at least 6 packets");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (size, 20000 * 1460, "Web search flows are at most 20000 packets");
+      size = dataMining->GetValue ();
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (size, 1460, "Data mining flows are at least 1 packet");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (size, 666667 * 1460, "Data mining flows are at most 666667 packets");
+    }
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Check the flows sampled without limit, and that no flow can be
+ * added once the application started
+ */
+class FlowGeneratorUnlimitedTestCase : public FlowGeneratorTestCase
+{
+public:
+  FlowGeneratorUnlimitedTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FlowGeneratorUnlimitedTestCase::FlowGeneratorUnlimitedTestCase ()
+  : FlowGeneratorTestCase ("Check the flows sampled without limit")
+{
+}
+
+void
+FlowGeneratorUnlimitedTestCase::DoRun (void)
+{
+  CreateNodes ();
+  FlowGeneratorHelper helper (5000);
+  helper.SetAttribute ("FlowSize", StringValue ("ns3::ConstantRandomVariable[Constant=10000]"));
+  helper.SetAttribute ("InterArrival", StringValue ("ns3::ConstantRandomVariable[Constant=0.05]"));
+  helper.SetAttribute ("MaxFlows", UintegerValue (0));
+  ApplicationContainer apps = helper.Install (m_nodes);
+  apps.Start (Seconds (0));
+  apps.Stop (Seconds (0.22));
+  Ptr<FlowGenerator> g0 = DynamicCast<FlowGenerator> (apps.Get (0));
+  NS_TEST_EXPECT_MSG_EQ (g0->CanAddFlows (), true, "Flows can be added before the start");
+
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (g0->CanAddFlows (), false, "No flow can be added after the start");
+  NS_TEST_EXPECT_MSG_EQ (g0->GetNSampledFlows (), 4, "A flow is sampled every 50 ms");
+  NS_TEST_ASSERT_MSG_EQ (g0->GetNFlows (), g0->GetNSampledFlows (), "All the flows are sampled");
+  for (uint32_t i = 0; i < g0->GetNFlows (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (g0->GetFlow (i).start, MilliSeconds (50 * (i + 1)), "Start time of the sampled flow " << i);
+      NS_TEST_EXPECT_MSG_EQ (g0->GetFlow (i).size, 10000, "Size of the sampled flow " << i);
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Check the flows sent to IPv6 peers
+ */
+class FlowGeneratorIpv6TestCase : public TestCase
+{
+public:
+  FlowGeneratorIpv6TestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FlowGeneratorIpv6TestCase::FlowGeneratorIpv6TestCase ()
+  : TestCase ("Check the flows sent to IPv6 peers")
+{
+}
+
+void
+FlowGeneratorIpv6TestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simpleHelper;
+  simpleHelper.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  simpleHelper.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = simpleHelper.Install (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv6AddressHelper ipv6;
+  ipv6.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer ifaces = ipv6.Assign (devices);
+
+  // The receiver has no destination, and listens for both address families
+  Ptr<FlowGenerator> sender = CreateObject<FlowGenerator> ();
+  Ptr<FlowGenerator> receiver = CreateObject<FlowGenerator> ();
+  nodes.Get (0)->AddApplication (sender);
+  nodes.Get (1)->AddApplication (receiver);
+  Address peer = Inet6SocketAddress (ifaces.GetAddress (1, 1), 5000);
+  // after the duplicate address detection
+  sender->AddFlow (Seconds (2), peer, 20000);
+  sender->AddFlow (Seconds (3), peer, 20000);
+  sender->SetStartTime (Seconds (0));
+  sender->SetStopTime (Seconds (10));
+  receiver->SetStartTime (Seconds (0));
+  receiver->SetStopTime (Seconds (10));
+
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (sender->GetNCompletedFlows (), 2, "All the flows should complete");
+  NS_TEST_EXPECT_MSG_EQ (sender->GetNConnections (), 1, "The flows should reuse the same connection");
+  NS_TEST_EXPECT_MSG_EQ (receiver->GetTotalRx (), 40000, "All the bytes should be received");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief FlowGenerator TestSuite
+ */
+class FlowGeneratorTestSuite : public TestSuite
+{
+public:
+  FlowGeneratorTestSuite ();
+};
+
+FlowGeneratorTestSuite::FlowGeneratorTestSuite ()
+  : TestSuite ("flow-generator", UNIT)
+{
+  AddTestCase (new FlowGeneratorTraceTestCase, TestCase::QUICK);
+  AddTestCase (new FlowGeneratorMaxActiveTestCase, TestCase::QUICK);
+  AddTestCase (new FlowGeneratorSampleTestCase, TestCase::QUICK);
+  AddTestCase (new FlowGeneratorUnlimitedTestCase, TestCase::QUICK);
+  AddTestCase (new FlowGeneratorIpv6TestCase, TestCase::QUICK);
+}
+
+static FlowGeneratorTestSuite g_flowGeneratorTestSuite; //!< Static variable for test initialization
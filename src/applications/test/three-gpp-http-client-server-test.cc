@@ -25,6 +25,9 @@
 #include <ns3/ptr.h>
 #include <ns3/nstime.h>
 #include <ns3/integer.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
+#include <ns3/pointer.h>
 
 #include <ns3/simple-channel.h>
 #include <ns3/node.h>
@@ -35,6 +38,9 @@
 #include <ns3/ipv4-address-helper.h>
 #include <ns3/ipv6-address-helper.h>
 #include <ns3/internet-stack-helper.h>
+#include <ns3/ipv4-interface-container.h>
+#include <ns3/node-container.h>
+#include <ns3/application-container.h>
 #include <ns3/tcp-l4-protocol.h>
 
 #include <ns3/tcp-congestion-ops.h>
@@ -43,6 +49,7 @@
 #include <ns3/three-gpp-http-server.h>
 #include <ns3/three-gpp-http-helper.h>
 #include <ns3/three-gpp-http-header.h>
+#include <ns3/three-gpp-http-variables.h>
 
 #include <ns3/basic-data-calculators.h>
 #include <list>
@@ -906,3 +913,232 @@ private:
 /// The global instance of the `three-gpp-http-client-server` system test.
 static ThreeGppHttpClientServerTestSuite g_httpClientServerTestSuiteInstance;
 
+
+
+// HTTP KEEP-ALIVE TEST CASE //////////////////////////////////////////////////
+
+/**
+ * \ingroup http
+ * \ingroup applications-test
+ * A test class which verifies that a client in keep-alive mode requests all
+ * its main objects on a single connection, that the pipelined requests are
+ * served in order, and that the latency and deadline of every request are
+ * reported.
+ */
+class ThreeGppHttpKeepAliveTestCase : public TestCase
+{
+public:
+  /**
+   * \param name A textual label to briefly describe the test.
+   * \param pipelineDepth The number of requests sent back to back.
+   * \param delay The deadline of the requests, relative to their sending.
+   * \param expectDeadlinesMet Whether the deadlines should all be met.
+   */
+  ThreeGppHttpKeepAliveTestCase (const std::string &name,
+                                 uint32_t pipelineDepth,
+                                 const Time &delay,
+                                 bool expectDeadlinesMet);
+
+private:
+  // Inherited from TestCase base class.
+  virtual void DoRun ();
+
+  /**
+   * Connected with `ConnectionEstablished` trace source of the client.
+   * \param httpClient Pointer to the client.
+   */
+  void ClientConnectionEstablishedCallback (Ptr<const ThreeGppHttpClient> httpClient);
+  /**
+   * Connected with `RxMainObject` trace source of the client.
+   * \param httpClient Pointer to the client.
+   * \param packet The main object, with its header.
+   */
+  void ClientRxMainObjectCallback (Ptr<const ThreeGppHttpClient> httpClient,
+                                   Ptr<const Packet> packet);
+  /**
+   * Connected with `RequestCompleted` trace source of the client.
+   * \param httpClient Pointer to the client.
+   * \param latency The latency of the request.
+   * \param deadlineMet Whether the deadline of the request was met.
+   */
+  void ClientRequestCompletedCallback (Ptr<const ThreeGppHttpClient> httpClient,
+                                       const Time &latency, bool deadlineMet);
+  /**
+   * Connected with `Rx` trace source of the server.
+   * \param packet The request received.
+   * \param from The address of the client.
+   */
+  void ServerRxCallback (Ptr<const Packet> packet, const Address &from);
+  /**
+   * Connected with `MainObject` trace source of the server.
+   * \param size The size of the main object generated.
+   */
+  void ServerMainObjectCallback (uint32_t size);
+
+  uint32_t m_pipelineDepth;               ///< The `PipelineDepth` of the client.
+  Time m_delay;                           ///< The relative deadline of the requests.
+  bool m_expectDeadlinesMet;              ///< Whether the deadlines should be met.
+  uint32_t m_numOfConnections;            ///< Connections established by the client.
+  uint32_t m_numOfRequestsReceived;       ///< Requests received by the server.
+  uint32_t m_numOfRequestsCompleted;      ///< Requests completed at the client.
+  uint32_t m_numOfRequestsBeforeFirstObject; ///< Requests received before the first object.
+  std::list<uint32_t> m_objectSizes;      ///< Sizes of the main objects not received yet.
+};
+
+ThreeGppHttpKeepAliveTestCase::ThreeGppHttpKeepAliveTestCase (const std::string &name,
+                                                              uint32_t pipelineDepth,
+                                                              const Time &delay,
+                                                              bool expectDeadlinesMet)
+  : TestCase (name),
+  m_pipelineDepth (pipelineDepth),
+  m_delay (delay),
+  m_expectDeadlinesMet (expectDeadlinesMet),
+  m_numOfConnections (0),
+  m_numOfRequestsReceived (0),
+  m_numOfRequestsCompleted (0),
+  m_numOfRequestsBeforeFirstObject (0)
+{
+}
+
+void
+ThreeGppHttpKeepAliveTestCase::DoRun ()
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (10)));
+  NodeContainer nodes;
+  nodes.Create (2);
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+      dev->SetAddress (Mac48Address::Allocate ());
+      dev->SetChannel (channel);
+      nodes.Get (i)->AddDevice (dev);
+      devices.Add (dev);
+    }
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices);
+  Address serverAddress = interfaces.GetAddress (0);
+
+  ThreeGppHttpServerHelper serverHelper (serverAddress);
+  ApplicationContainer serverApplications = serverHelper.Install (nodes.Get (0));
+  Ptr<ThreeGppHttpServer> httpServer = serverApplications.Get (0)->GetObject<ThreeGppHttpServer> ();
+  httpServer->SetMtuSize (1460);
+  httpServer->TraceConnectWithoutContext (
+    "Rx", MakeCallback (&ThreeGppHttpKeepAliveTestCase::ServerRxCallback, this));
+  httpServer->TraceConnectWithoutContext (
+    "MainObject", MakeCallback (&ThreeGppHttpKeepAliveTestCase::ServerMainObjectCallback, this));
+
+  ThreeGppHttpClientHelper clientHelper (serverAddress);
+  clientHelper.SetAttribute ("KeepAlive", BooleanValue (true));
+  clientHelper.SetAttribute ("MaxRequests", UintegerValue (6));
+  clientHelper.SetAttribute ("PipelineDepth", UintegerValue (m_pipelineDepth));
+  ApplicationContainer clientApplications = clientHelper.Install (nodes.Get (1));
+  Ptr<ThreeGppHttpClient> httpClient = clientApplications.Get (0)->GetObject<ThreeGppHttpClient> ();
+  httpClient->SetDelay (m_delay);
+  PointerValue variables;
+  httpClient->GetAttribute ("Variables", variables);
+  variables.Get<ThreeGppHttpVariables> ()->SetAttribute ("ReadingTimeMean",
+                                                         TimeValue (MilliSeconds (100)));
+  httpClient->TraceConnectWithoutContext (
+    "ConnectionEstablished",
+    MakeCallback (&ThreeGppHttpKeepAliveTestCase::ClientConnectionEstablishedCallback, this));
+  httpClient->TraceConnectWithoutContext (
+    "RxMainObject",
+    MakeCallback (&ThreeGppHttpKeepAliveTestCase::ClientRxMainObjectCallback, this));
+  httpClient->TraceConnectWithoutContext (
+    "RequestCompleted",
+    MakeCallback (&ThreeGppHttpKeepAliveTestCase::ClientRequestCompletedCallback, this));
+
+  Simulator::Stop (Seconds (100));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_numOfConnections, 1, "All the requests should use one connection");
+  NS_TEST_EXPECT_MSG_EQ (m_numOfRequestsReceived, 6, "The server should receive all the requests");
+  NS_TEST_EXPECT_MSG_EQ (m_numOfRequestsCompleted, 6, "The client should receive all the objects");
+  NS_TEST_EXPECT_MSG_EQ (m_objectSizes.size (), 0, "The client should receive all the objects");
+  NS_TEST_EXPECT_MSG_EQ (m_numOfRequestsBeforeFirstObject, m_pipelineDepth,
+                         "The requests of a burst should be pipelined");
+  NS_TEST_EXPECT_MSG_EQ (httpClient->GetState (), ThreeGppHttpClient::STOPPED,
+                         "The client should stop after the last request");
+
+  Simulator::Destroy ();
+}
+
+void
+ThreeGppHttpKeepAliveTestCase::ClientConnectionEstablishedCallback (Ptr<const ThreeGppHttpClient> httpClient)
+{
+  m_numOfConnections++;
+}
+
+void
+ThreeGppHttpKeepAliveTestCase::ClientRxMainObjectCallback (Ptr<const ThreeGppHttpClient> httpClient,
+                                                           Ptr<const Packet> packet)
+{
+  ThreeGppHttpHeader httpHeader;
+  packet->PeekHeader (httpHeader);
+  NS_TEST_ASSERT_MSG_EQ (m_objectSizes.empty (), false,
+                         "Client receives one too many main object");
+  NS_TEST_EXPECT_MSG_EQ (httpHeader.GetContentLength (), m_objectSizes.front (),
+                         "The main objects should be received in the order of the requests");
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), httpHeader.GetSerializedSize () + m_objectSizes.front (),
+                         "Transmitted size and received size of main object differ");
+  m_objectSizes.pop_front ();
+}
+
+void
+ThreeGppHttpKeepAliveTestCase::ClientRequestCompletedCallback (Ptr<const ThreeGppHttpClient> httpClient,
+                                                               const Time &latency, bool deadlineMet)
+{
+  if (m_numOfRequestsCompleted == 0)
+    {
+      m_numOfRequestsBeforeFirstObject = m_numOfRequestsReceived;
+    }
+  m_numOfRequestsCompleted++;
+  NS_TEST_EXPECT_MSG_GT (latency, MilliSeconds (20), "The latency includes a round trip");
+  NS_TEST_EXPECT_MSG_EQ (deadlineMet, m_expectDeadlinesMet, "Unexpected deadline outcome");
+}
+
+void
+ThreeGppHttpKeepAliveTestCase::ServerRxCallback (Ptr<const Packet> packet, const Address &from)
+{
+  ThreeGppHttpHeader httpHeader;
+  packet->PeekHeader (httpHeader);
+  NS_TEST_EXPECT_MSG_EQ (httpHeader.GetContentType (), ThreeGppHttpHeader::MAIN_OBJECT,
+                         "Only main objects are requested in keep-alive mode");
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), httpHeader.GetSerializedSize () + httpHeader.GetContentLength (),
+                         "The server should receive whole requests");
+  m_numOfRequestsReceived++;
+}
+
+void
+ThreeGppHttpKeepAliveTestCase::ServerMainObjectCallback (uint32_t size)
+{
+  m_objectSizes.push_back (size);
+}
+
+/**
+ * \ingroup http
+ * \ingroup applications-test
+ * Test suite of the keep-alive mode of ThreeGppHttpClient.
+ */
+class ThreeGppHttpKeepAliveTestSuite : public TestSuite
+{
+public:
+  /// Instantiate the test suite.
+  ThreeGppHttpKeepAliveTestSuite () : TestSuite ("three-gpp-http-keep-alive", UNIT)
+  {
+    AddTestCase (new ThreeGppHttpKeepAliveTestCase ("Sequential requests", 1, Seconds (10), true),
+                 TestCase::QUICK);
+    AddTestCase (new ThreeGppHttpKeepAliveTestCase ("Pipelined requests", 3, Seconds (10), true),
+                 TestCase::QUICK);
+    AddTestCase (new ThreeGppHttpKeepAliveTestCase ("Missed deadlines", 3, MilliSeconds (1), false),
+                 TestCase::QUICK);
+  }
+};
+
+/// The global instance of the `three-gpp-http-keep-alive` test suite.
+static ThreeGppHttpKeepAliveTestSuite g_httpKeepAliveTestSuiteInstance;
@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "checkpoint.h"
+#include "simulator.h"
+#include "fatal-error.h"
+#include "log.h"
+#include "ns3/core-config.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <vector>
+
+#ifdef HAVE_SYS_WAIT_H
+# include <sys/types.h>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Checkpoint");
+
+namespace {
+
+/** The variant run by this process. */
+uint32_t g_variant = 0;
+
+#ifdef HAVE_SYS_WAIT_H
+/** The processes of the other variants forked by this process. */
+std::vector<pid_t> g_children;
+/** The number of these processes which failed. */
+uint32_t g_failed = 0;
+#endif
+
+} // unnamed namespace
+
+bool
+Checkpoint::IsSupported (void)
+{
+#ifdef HAVE_SYS_WAIT_H
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+Checkpoint::Schedule (Time const &delay, uint32_t n, Callback<void, uint32_t> variant)
+{
+  NS_LOG_FUNCTION (delay << n);
+  NS_ASSERT_MSG (n > 0, "A checkpoint needs at least one variant");
+  if (n > 1 && !IsSupported ())
+    {
+      NS_FATAL_ERROR ("Checkpoints are not supported on this system");
+    }
+  Simulator::Schedule (delay, &Checkpoint::Fork, n, variant);
+}
+
+uint32_t
+Checkpoint::GetVariant (void)
+{
+  return g_variant;
+}
+
+void
+Checkpoint::Fork (uint32_t n, Callback<void, uint32_t> variant)
+{
+  NS_LOG_FUNCTION (n);
+  uint32_t id = 0;
+#ifdef HAVE_SYS_WAIT_H
+  // Do not write the pending output once per process
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (0);
+  for (uint32_t i = 1; i < n; i++)
+    {
+      pid_t pid = fork ();
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("Cannot fork the variant " << i << ": " << std::strerror (errno));
+        }
+      if (pid == 0)
+        {
+          id = i;
+          g_children.clear ();
+          g_failed = 0;
+          break;
+        }
+      NS_LOG_LOGIC ("variant " << i << " runs in process " << pid);
+      if (g_children.empty ())
+        {
+          Simulator::ScheduleDestroy (&Checkpoint::DoWait);
+        }
+      g_children.push_back (pid);
+    }
+#endif
+  g_variant = id;
+  NS_LOG_INFO ("run the variant " << id << " of " << n << " at " << Simulator::Now ().As (Time::S));
+  if (!variant.IsNull ())
+    {
+      variant (id);
+    }
+}
+
+uint32_t
+Checkpoint::Wait (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+#ifdef HAVE_SYS_WAIT_H
+  for (std::vector<pid_t>::const_iterator i = g_children.begin (); i != g_children.end (); ++i)
+    {
+      int status;
+      pid_t pid;
+      do
+        {
+          pid = waitpid (*i, &status, 0);
+        }
+      while (pid < 0 && errno == EINTR);
+      if (pid != *i || !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          NS_LOG_WARN ("process " << *i << " of a variant failed");
+          g_failed++;
+        }
+    }
+  g_children.clear ();
+  return g_failed;
+#else
+  return 0;
+#endif
+}
+
+void
+Checkpoint::DoWait (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Wait ();
+}
+
+} // namespace ns3
@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "nstime.h"
+#include "callback.h"
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Continue a simulation from a point in time with several
+ * variants of its configuration.
+ *
+ * Simulations which explore many parameter points often share the same
+ * first seconds: routes are populated, connections are established and
+ * the congestion windows ramp up identically in every run.  A checkpoint
+ * runs these first seconds once: when the checkpoint expires, the
+ * simulation process is forked into one process per variant, which all
+ * start from the state of the simulation at this time, including the
+ * scheduled events, the objects of the nodes and the states of the random
+ * number generators.  Each process then calls the variant callback with
+ * its variant number, from 0 to n-1, to alter the configuration, for
+ * instance with Config::Set or with a ConfigStore file, and runs the rest
+ * of the simulation.
+ *
+ * The state is restored by copy-on-write of the memory of the process,
+ * not through a file, because the scheduled events hold arbitrary C++
+ * functions and objects which cannot be serialized.  As a consequence,
+ * the variants run concurrently, they must be started from the same
+ * program, and a checkpoint is only supported on POSIX systems.
+ *
+ * The process which scheduled the checkpoint runs the variant 0, and waits
+ * for the processes of the other variants in Simulator::Destroy, or in
+ * Wait.  The processes of the other variants continue the program after
+ * Simulator::Run like the first one, so they typically report their
+ * results, with GetVariant to tell them apart, and return from main.
+ *
+ * Example usage:
+ *
+ * \code
+ *     static void
+ *     SetBottleneck (uint32_t variant)
+ *     {
+ *       Config::Set ("/NodeList/0/DeviceList/1/$ns3::PointToPointNetDevice/DataRate",
+ *                    DataRateValue (DataRate ((variant + 1) * 1000000000ULL)));
+ *     }
+ *
+ *     int main (int argc, char *argv[])
+ *     {
+ *       // Create your model
+ *
+ *       Checkpoint::Schedule (Seconds (5), 4, MakeCallback (&SetBottleneck));
+ *       Simulator::Stop (Seconds (30));
+ *       Simulator::Run ();
+ *       std::cout << "variant " << Checkpoint::GetVariant () << ": "
+ *                 << sink->GetTotalRx () << " bytes" << std::endl;
+ *       Simulator::Destroy ();
+ *       return 0;
+ *     }
+ * \endcode
+ *
+ * The files opened before the checkpoint, such as the ascii and pcap
+ * traces, are shared by all the variants: the traces of each variant
+ * should be opened by the variant callback, and the captures of the
+ * asynchronous pcap writer, whose thread is not forked, must not be
+ * active when the checkpoint expires.  The random variables of the
+ * variants draw the same numbers unless their streams are changed by the
+ * variant callback.
+ */
+class Checkpoint
+{
+public:
+  /**
+   * \returns \c true if the checkpoints are supported on this system.
+   */
+  static bool IsSupported (void);
+
+  /**
+   * Schedule a checkpoint.
+   *
+   * \param [in] delay The delay after which the checkpoint expires.
+   * \param [in] n The number of variants, at least 1.
+   * \param [in] variant The callback invoked with the variant number by
+   *             each process, or a null callback.
+   */
+  static void Schedule (Time const &delay, uint32_t n, Callback<void, uint32_t> variant);
+
+  /**
+   * \returns The variant run by this process: 0 before the checkpoint
+   *          expires, and in the process which scheduled the checkpoint.
+   */
+  static uint32_t GetVariant (void);
+
+  /**
+   * Wait for the processes of the other variants to terminate.
+   *
+   * This is done by Simulator::Destroy when it was not done before.
+   *
+   * \returns The number of the variants forked by this process which did
+   *          not terminate with a zero exit status.
+   */
+  static uint32_t Wait (void);
+
+private:
+  /**
+   * Fork the processes of the variants.
+   *
+   * \param [in] n The number of variants.
+   * \param [in] variant The variant callback.
+   */
+  static void Fork (uint32_t n, Callback<void, uint32_t> variant);
+  /** Wait for the other variants when the simulator is destroyed. */
+  static void DoWait (void);
+};
+
+} // namespace ns3
+
+#endif /* CHECKPOINT_H */
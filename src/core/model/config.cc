@@ -24,9 +24,11 @@
 #include "object-ptr-container.h"
 #include "names.h"
 #include "pointer.h"
+#include "trace-source-accessor.h"
 #include "log.h"
 
 #include <sstream>
+#include <algorithm>
 
 /**
  * \file
@@ -40,6 +42,50 @@ NS_LOG_COMPONENT_DEFINE ("Config");
 
 namespace Config {
 
+/**
+ * \ingroup config-impl
+ * Helper to look up a trace source of a set of objects: since the
+ * objects matching a Config path usually share their TypeId, the trace
+ * source is searched by name only when the TypeId changes.
+ */
+class TraceSourceLookup
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] name The name of the trace source.
+   */
+  TraceSourceLookup (std::string name)
+    : m_name (name),
+      m_valid (false)
+  {}
+  /**
+   * Get the trace source of an object.
+   *
+   * \param [in] object The object.
+   * \returns The accessor of the trace source, or null if the object
+   *          has no such trace source.
+   */
+  Ptr<const TraceSourceAccessor> Get (Ptr<Object> object)
+  {
+    TypeId tid = object->GetInstanceTypeId ();
+    if (!m_valid || tid != m_tid)
+      {
+        m_accessor = tid.LookupTraceSourceByName (m_name);
+        m_tid = tid;
+        m_valid = true;
+      }
+    return m_accessor;
+  }
+
+private:
+  std::string m_name;                        //!< The name of the trace source
+  bool m_valid;                              //!< Whether m_tid is set
+  TypeId m_tid;                              //!< The TypeId of the last object
+  Ptr<const TraceSourceAccessor> m_accessor; //!< The trace source of m_tid
+};
+
 MatchContainer::MatchContainer ()
 {
   NS_LOG_FUNCTION (this);
@@ -127,11 +173,15 @@ MatchContainer::ConnectFailSafe (std::string name, const CallbackBase &cb)
   NS_LOG_FUNCTION (this << name << &cb);
   NS_ASSERT (m_objects.size () == m_contexts.size ());
   bool ok = false;
+  TraceSourceLookup lookup (name);
   for (uint32_t i = 0; i < m_objects.size (); ++i)
     {
       Ptr<Object> object = m_objects[i];
-      std::string ctx = m_contexts[i] + name;
-      ok |= object->TraceConnect (name, ctx, cb);
+      Ptr<const TraceSourceAccessor> accessor = lookup.Get (object);
+      if (accessor != 0)
+        {
+          ok |= accessor->Connect (PeekPointer (object), m_contexts[i] + name, cb);
+        }
     }
   return ok;
 }
@@ -148,10 +198,15 @@ MatchContainer::ConnectWithoutContextFailSafe (std::string name, const CallbackB
 {
   NS_LOG_FUNCTION (this << name << &cb);
   bool ok = false;
+  TraceSourceLookup lookup (name);
   for (Iterator tmp = Begin (); tmp != End (); ++tmp)
     {
       Ptr<Object> object = *tmp;
-      ok |= object->TraceConnectWithoutContext (name, cb);
+      Ptr<const TraceSourceAccessor> accessor = lookup.Get (object);
+      if (accessor != 0)
+        {
+          ok |= accessor->ConnectWithoutContext (PeekPointer (object), cb);
+        }
     }
   return ok;
 }
@@ -182,6 +237,9 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, at construction, into a list of
+ * ranges of indices.
  */
 class ArrayMatcher
 {
@@ -199,8 +257,22 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (std::size_t i) const;
+  /**
+   * Get the matching indices, provided that they are few.
+   *
+   * \param [in] max The maximum number of indices.
+   * \param [out] indices The matching indices, in increasing order.
+   * \returns \c false if more than \pname{max} indices match.
+   */
+  bool GetIndices (std::size_t max, std::vector<std::size_t> *indices) const;
 
 private:
+  /**
+   * Parse one of the alternatives of the Config path specification.
+   *
+   * \param [in] element The alternative.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -211,79 +283,112 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** Whether all the indices match. */
+  bool m_all;
+  /** The ranges of matching indices (both bounds included). */
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 
 };  // class ArrayMatcher
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
-}
-bool
-ArrayMatcher::Matches (std::size_t i) const
-{
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  std::string::size_type start = 0;
+  std::string::size_type tmp;
+  while ((tmp = element.find ("|", start)) != std::string::npos)
     {
-      NS_LOG_DEBUG ("Array " << i << " matches *");
-      return true;
+      Parse (element.substr (start, tmp - start));
+      start = tmp + 1;
     }
-  std::string::size_type tmp;
-  tmp = m_element.find ("|");
-  if (tmp != std::string::npos)
+  Parse (element.substr (start));
+}
+void
+ArrayMatcher::Parse (std::string element)
+{
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      std::string left = m_element.substr (0, tmp - 0);
-      std::string right = m_element.substr (tmp + 1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
-      return false;
+      m_all = true;
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1
       && dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min)
           && StringToUint32 (upperBound, &max)
-          && i >= min && i <= max)
+          && min <= max)
         {
-          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
-          return true;
-        }
-      else
-        {
-          NS_LOG_DEBUG ("Array " << i << " does not " << m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value)
-      && i == value)
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
     {
       NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
       return true;
     }
+  for (const auto &range : m_ranges)
+    {
+      if (i >= range.first && i <= range.second)
+        {
+          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
+          return true;
+        }
+    }
   NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
   return false;
 }
 
+bool
+ArrayMatcher::GetIndices (std::size_t max, std::vector<std::size_t> *indices) const
+{
+  NS_LOG_FUNCTION (this << max << indices);
+  if (m_all)
+    {
+      return false;
+    }
+  uint64_t n = 0;
+  for (const auto &range : m_ranges)
+    {
+      n += static_cast<uint64_t> (range.second) - range.first + 1;
+    }
+  if (n > max)
+    {
+      return false;
+    }
+  indices->clear ();
+  for (const auto &range : m_ranges)
+    {
+      for (uint64_t i = range.first; i <= range.second; i++)
+        {
+          indices->push_back (i);
+        }
+    }
+  std::sort (indices->begin (), indices->end ());
+  indices->erase (std::unique (indices->begin (), indices->end ()), indices->end ());
+  return true;
+}
+
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 {
@@ -294,9 +399,21 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * \ingroup config-impl
+ * Maximum number of indices of a Config path element that are looked up
+ * directly in an object container, rather than matched against all the
+ * objects of the container.
+ */
+static const std::size_t MAX_DIRECT_INDICES = 1024;
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The Config path is split once into its elements, and the attributes
+ * matching an element are cached for each TypeId, so that resolving
+ * a path does not search the attributes of every object by name.
  */
 class Resolver
 {
@@ -320,23 +437,57 @@ public:
   void Resolve (Ptr<Object> root);
 
 private:
+  /** An attribute matching an element of a Config path. */
+  struct MatchedAttribute
+  {
+    struct TypeId::AttributeInformation info; //!< The attribute
+    bool isVector;                            //!< Object container (or pointer) attribute
+    bool gettable;                            //!< Whether the attribute can be read
+  };
+  /** The attributes matching a path element. */
+  struct MatchedAttributes
+  {
+    uint32_t nAttributes;                            //!< Attributes of the TypeId and its parents when matched
+    std::vector<struct MatchedAttribute> attributes; //!< The matching attributes
+  };
+  /** Cache of the attributes matching a path element, per TypeId. */
+  typedef std::map<std::pair<uint16_t, std::string>, struct MatchedAttributes> AttributeCache;
+
   /** Ensure the Config path starts and ends with a '/'. */
   void Canonicalize (void);
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] element The index of the next element of the Config path.
    * \param [in] root The object corresponding to the current position
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t element, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] element The index of the array element of the Config path.
+   * \param [in] root The object holding the container attribute.
+   * \param [in] attribute The container attribute.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::size_t element, Ptr<Object> root, const struct MatchedAttribute &attribute);
+  /**
+   * Get the value of an attribute found on the path.
+   *
+   * \param [in] object The object holding the attribute.
+   * \param [in] attribute The attribute.
+   * \param [out] value The value.
+   */
+  void GetAttribute (Ptr<Object> object, const struct MatchedAttribute &attribute, AttributeValue &value) const;
+  /**
+   * Get the attributes of a TypeId (and of its parents) matching
+   * an element of the Config path.
+   *
+   * \param [in] tid The TypeId.
+   * \param [in] item The Config path element.
+   * \returns The matching pointer and object container attributes.
+   */
+  static const std::vector<struct MatchedAttribute> & GetAttributes (TypeId tid, std::string item);
   /**
    * Handle one object found on the path.
    *
@@ -361,6 +512,10 @@ private:
   std::vector<std::string> m_workStack;
   /** The Config path. */
   std::string m_path;
+  /** The elements of the Config path. */
+  std::vector<std::string> m_elements;
+  /** The array matchers of the elements of the Config path. */
+  std::vector<ArrayMatcher> m_matchers;
 
 };  // class Resolver
 
@@ -369,6 +524,14 @@ Resolver::Resolver (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
   Canonicalize ();
+  std::string::size_type start = 1;
+  std::string::size_type next;
+  while ((next = m_path.find ("/", start)) != std::string::npos)
+    {
+      m_elements.push_back (m_path.substr (start, next - start));
+      m_matchers.push_back (ArrayMatcher (m_elements.back ()));
+      start = next + 1;
+    }
 }
 Resolver::~Resolver ()
 {
@@ -399,7 +562,7 @@ Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -424,14 +587,89 @@ Resolver::DoResolveOne (Ptr<Object> object)
   DoOne (object, GetResolvedPath ());
 }
 
+const std::vector<struct Resolver::MatchedAttribute> &
+Resolver::GetAttributes (TypeId tid, std::string item)
+{
+  NS_LOG_FUNCTION (tid << item);
+  static AttributeCache cache;
+
+  // Attributes can be added to a TypeId after its first lookup, so the
+  // entry is refilled when the number of attributes changes
+  uint32_t nAttributes = 0;
+  TypeId nextTid = tid;
+  TypeId parent;
+  do
+    {
+      parent = nextTid;
+      nAttributes += parent.GetAttributeN ();
+      nextTid = parent.GetParent ();
+    }
+  while (nextTid != parent);
+
+  std::pair<AttributeCache::iterator, bool> ret;
+  ret = cache.insert (std::make_pair (std::make_pair (tid.GetUid (), item),
+                                      MatchedAttributes ()));
+  MatchedAttributes &entry = ret.first->second;
+  std::vector<struct MatchedAttribute> &attributes = entry.attributes;
+  if (!ret.second && entry.nAttributes == nAttributes)
+    {
+      return attributes;
+    }
+  entry.nAttributes = nAttributes;
+  attributes.clear ();
+
+  nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct MatchedAttribute attribute;
+          attribute.info = tid.GetAttribute (i);
+          if (attribute.info.name != item && item != "*")
+            {
+              continue;
+            }
+          attribute.gettable = (attribute.info.flags & TypeId::ATTR_GET)
+            && attribute.info.accessor->HasGetter ();
+          // attempt to cast to a pointer checker.
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (attribute.info.checker)) != 0)
+            {
+              attribute.isVector = false;
+              attributes.push_back (attribute);
+            }
+          // attempt to cast to an object vector.
+          if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (attribute.info.checker)) != 0)
+            {
+              attribute.isVector = true;
+              attributes.push_back (attribute);
+            }
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+        }
+      nextTid = tid.GetParent ();
+    }
+  while (nextTid != tid);
+  return attributes;
+}
+
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::GetAttribute (Ptr<Object> object, const struct MatchedAttribute &attribute, AttributeValue &value) const
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << object << &value);
+  if (!attribute.gettable || !attribute.info.accessor->Get (PeekPointer (object), value))
+    {
+      // let ObjectBase::GetAttribute raise any errors
+      object->GetAttribute (attribute.info.name, value);
+    }
+}
 
-  if (next == std::string::npos)
+void
+Resolver::DoResolve (std::size_t element, Ptr<Object> root)
+{
+  NS_LOG_FUNCTION (this << element << root);
+
+  if (element == m_elements.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name
@@ -447,8 +685,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  const std::string &item = m_elements[element];
 
   //
   // If root is zero, we're beginning to see if we can use the object name
@@ -459,11 +696,11 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
+      std::string::size_type offset = item.find ("Names");
       if (offset == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (element + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -480,7 +717,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (element + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -510,68 +747,44 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (element + 1, object);
       m_workStack.pop_back ();
     }
   else
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      const std::vector<struct MatchedAttribute> &attributes = GetAttributes (root->GetInstanceTypeId (), item);
       bool foundMatch = false;
 
-      do
+      for (const struct MatchedAttribute &attribute : attributes)
         {
-          tid = nextTid;
-
-          for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+          if (!attribute.isVector)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute (i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)=" << attribute.info.name << " on path=" << GetResolvedPath ());
+              PointerValue pValue;
+              GetAttribute (root, attribute, pValue);
+              Ptr<Object> object = pValue.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\"" << item <<
+                                "\" exists on path=\"" << GetResolvedPath () << "\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (pChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)=" << info.name << " on path=" << GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\"" << item <<
-                                    "\" exists on path=\"" << GetResolvedPath () << "\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker =
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)=" << info.name << " on path=" << GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              m_workStack.push_back (attribute.info.name);
+              DoResolve (element + 1, object);
+              m_workStack.pop_back ();
+            }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)=" << attribute.info.name << " on path=" << GetResolvedPath ());
+              foundMatch = true;
+              m_workStack.push_back (attribute.info.name);
+              DoArrayResolve (element + 1, root, attribute);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
         }
-      while (nextTid != tid);
 
       if (!foundMatch)
         {
@@ -582,29 +795,54 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (std::size_t element, Ptr<Object> root, const struct MatchedAttribute &attribute)
 {
-  NS_LOG_FUNCTION (this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << element << root);
+  if (element == m_elements.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  const ArrayMatcher &matcher = m_matchers[element];
+
+  //
+  // Paths such as /NodeList/3/ name a few objects of a (possibly large)
+  // container: look them up directly rather than retrieving the whole
+  // container.
+  //
+  const ObjectPtrContainerAccessor *accessor =
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (attribute.info.accessor));
+  std::vector<std::size_t> indices;
+  if (attribute.gettable && accessor != 0 && matcher.GetIndices (MAX_DIRECT_INDICES, &indices))
+    {
+      std::vector<Ptr<Object> > objects;
+      bool found = true;
+      for (std::size_t i = 0; i < indices.size () && found; i++)
+        {
+          Ptr<Object> object;
+          found = accessor->GetIndexed (PeekPointer (root), indices[i], &object);
+          objects.push_back (object);
+        }
+      if (found)
+        {
+          for (std::size_t i = 0; i < indices.size (); i++)
+            {
+              m_workStack.push_back (std::to_string (indices[i]));
+              DoResolve (element + 1, objects[i]);
+              m_workStack.pop_back ();
+            }
+          return;
+        }
+    }
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  ObjectPtrContainerValue container;
+  GetAttribute (root, attribute, container);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
       if (matcher.Matches ((*it).first))
         {
-          std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          m_workStack.push_back (std::to_string ((*it).first));
+          DoResolve (element + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
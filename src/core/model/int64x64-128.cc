@@ -114,10 +114,31 @@ int64x64_t::Div (const int64x64_t & o)
 {
   uint128_t a, b;
   bool negative = output_sign (_v, o._v, a, b);
-  int128_t result = Udiv (a, b);
+  int128_t result = (b & HP_MASK_LO) == 0 ? UdivInteger (a, b >> 64) : Udiv (a, b);
   _v = negative ? -result : result;
 }
 
+uint128_t
+int64x64_t::UdivInteger (const uint128_t a, const uint64_t d)
+{
+  // With no fraction bits in the divisor, Udiv skips 64 trailing zeros,
+  // then takes all the fraction digits in one round:  its result is
+  // (a / (d 2^64)) 2^64 + (a % (d 2^64)) / d, which is the integer part
+  // of a / d.  The first division leaves a remainder less than d, so the
+  // second one fits the 128 by 64 bits division of the processor.
+  const uint64_t hi = a >> 64;
+  const uint64_t lo = a;
+  const uint64_t quoHi = hi / d;
+  uint64_t rem = hi % d;
+#if defined (__x86_64__) && defined (__GNUC__)
+  uint64_t quoLo;
+  __asm__ ("divq %4" : "=a" (quoLo), "=d" (rem) : "a" (lo), "d" (rem), "rm" (d));
+#else
+  const uint64_t quoLo = ((static_cast<uint128_t> (rem) << 64) | lo) / d;
+#endif
+  return (static_cast<uint128_t> (quoHi) << 64) | quoLo;
+}
+
 uint128_t
 int64x64_t::Udiv (const uint128_t a, const uint128_t b)
 {
@@ -24,6 +24,8 @@
 
 #include <stdint.h>
 #include <cmath>  // pow
+#include <cstring>  // memcpy
+#include <limits>
 
 #if defined(HAVE___UINT128_T) && !defined(HAVE_UINT128_T)
 typedef __uint128_t uint128_t;
@@ -95,6 +97,24 @@ public:
   /**@{*/
   inline int64x64_t (const double value)
   {
+    // When the lowest bit of the mantissa weighs at least 2^-64 and the
+    // value fits, the double is exact in Q64.64:  shifting the mantissa
+    // gives the same bits as the long double conversion below, whose
+    // rounding term then never carries, without its modf.
+    if (std::numeric_limits<long double>::digits >= 64)
+      {
+        uint64_t bits;
+        std::memcpy (&bits, &value, sizeof (bits));
+        // value = mantissa * 2^(shift - 64)
+        const int shift = (int)((bits >> 52) & 0x7ff) - 1075 + 64;
+        if (shift >= 0 && shift <= 74)
+          {
+            const uint128_t mantissa = (bits & 0xfffffffffffffULL) | (1ULL << 52);
+            _v = mantissa << shift;
+            _v = (bits >> 63) ? -_v : _v;
+            return;
+          }
+      }
     const int64x64_t tmp ((long double)value);
     _v = tmp._v;
   }
@@ -343,6 +363,18 @@ private:
    * \return The Q64.64 representation of `a / b`.
    */
   static uint128_t Udiv         (const uint128_t a, const uint128_t b);
+  /**
+   * Unsigned division of a Q64.64 value by an integer.
+   *
+   * This is the fast path of Div() for the divisors without fraction,
+   * such as the ratio of two Time values:  it gives the same result as
+   * Udiv() with two hardware divisions.
+   *
+   * \param [in] a Numerator.
+   * \param [in] d Integer denominator.
+   * \return The Q64.64 representation of `a / d`.
+   */
+  static uint128_t UdivInteger  (const uint128_t a, const uint64_t d);
   /**
    * Unsigned multiplication of Q64.64 and Q0.128 values.
    *
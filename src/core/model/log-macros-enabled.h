@@ -75,6 +75,22 @@
 
 #ifdef NS3_LOG_ENABLE
 
+/**
+ * \ingroup logging
+ * The log levels compiled in.
+ * \internal
+ * Set by the \c --log-level configure option, per module
+ * (\c NS3_LOG_MODULE_LEVELS) or globally (\c NS3_LOG_LEVELS).
+ * The log statements of the other levels are removed by the compiler.
+ */
+#if defined (NS3_LOG_MODULE_LEVELS)
+#define NS_LOG_COMPILED_LEVELS NS3_LOG_MODULE_LEVELS
+#elif defined (NS3_LOG_LEVELS)
+#define NS_LOG_COMPILED_LEVELS NS3_LOG_LEVELS
+#else
+#define NS_LOG_COMPILED_LEVELS ns3::LOG_LEVEL_ALL
+#endif
+
 /**
  * \ingroup logging
  * Append the simulation time to a log message.
@@ -187,14 +203,15 @@
 #define NS_LOG(level, msg)                                      \
   NS_LOG_CONDITION                                              \
   do {                                                          \
-      if (g_log.IsEnabled (level))                              \
+      if (((level) & NS_LOG_COMPILED_LEVELS)                    \
+          && g_log.IsEnabled (level))                           \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
           NS_LOG_APPEND_CONTEXT;                                \
           NS_LOG_APPEND_FUNC_PREFIX;                            \
           NS_LOG_APPEND_LEVEL_PREFIX (level);                   \
-          std::clog << msg << std::endl;                        \
+          std::clog << msg << ns3::LogEndLine;                  \
         }                                                       \
     } while (false)
 
@@ -209,13 +226,14 @@
 #define NS_LOG_FUNCTION_NOARGS()                                \
   NS_LOG_CONDITION                                              \
   do {                                                          \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if ((ns3::LOG_FUNCTION & NS_LOG_COMPILED_LEVELS)          \
+          && g_log.IsEnabled (ns3::LOG_FUNCTION))               \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
           NS_LOG_APPEND_CONTEXT;                                \
           std::clog << g_log.Name () << ":"                     \
-                    << __FUNCTION__ << "()" << std::endl;       \
+                    << __FUNCTION__ << "()" << ns3::LogEndLine; \
         }                                                       \
     } while (false)
 
@@ -245,7 +263,8 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if ((ns3::LOG_FUNCTION & NS_LOG_COMPILED_LEVELS)          \
+          && g_log.IsEnabled (ns3::LOG_FUNCTION))               \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -253,7 +272,7 @@
           std::clog << g_log.Name () << ":"                     \
                     << __FUNCTION__ << "(";                     \
           ns3::ParameterLogger (std::clog) << parameters;       \
-          std::clog << ")" << std::endl;                        \
+          std::clog << ")" << ns3::LogEndLine;                  \
         }                                                       \
     }                                                           \
   while (false)
@@ -266,10 +285,10 @@
  *
  * \param [in] msg The message to log
  */
-#define NS_LOG_UNCOND(msg)              \
-  NS_LOG_CONDITION                      \
-  do {                                  \
-      std::clog << msg << std::endl;    \
+#define NS_LOG_UNCOND(msg)                     \
+  NS_LOG_CONDITION                             \
+  do {                                         \
+      std::clog << msg << ns3::LogEndLine;     \
     } while (false)
 
 
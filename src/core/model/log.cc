@@ -24,6 +24,7 @@
 #include <iostream>
 #include "assert.h"
 #include <stdexcept>
+#include <streambuf>
 #include "ns3/core-config.h"
 #include "fatal-error.h"
 
@@ -278,13 +279,6 @@ LogComponent::EnvVarCheck (void)
 }
 
 
-bool
-LogComponent::IsEnabled (const enum LogLevel level) const
-{
-  //  LogComponentEnableEnvVar ();
-  return (level & m_levels) ? 1 : 0;
-}
-
 bool
 LogComponent::IsNoneEnabled (void) const
 {
@@ -640,6 +634,145 @@ NodePrinter LogGetNodePrinter (void)
   return g_logNodePrinter;
 }
 
+/**
+ * \ingroup logging
+ * Buffer installed in \c std::clog by LogSetBuffered().
+ * This is private to the logging implementation.
+ *
+ * The log messages are accumulated and forwarded in large blocks to the
+ * stream buffer previously used by \c std::clog.  Flushing \c std::clog
+ * (which NS_FATAL_ERROR does) forwards the pending messages.
+ */
+class LogBuffer : public std::streambuf
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] sink The stream buffer the messages are forwarded to.
+   */
+  LogBuffer (std::streambuf *sink);
+  virtual ~LogBuffer ();
+  /**
+   * \returns The stream buffer the messages are forwarded to.
+   */
+  std::streambuf * GetSink (void) const;
+
+private:
+  virtual int_type overflow (int_type c);
+  virtual int sync (void);
+  /**
+   * Forward the pending messages to the sink.
+   * \returns \c true on success.
+   */
+  bool Forward (void);
+
+  std::streambuf *m_sink;      //!< The stream buffer written to.
+  std::vector<char> m_buffer;  //!< The pending messages.
+};
+
+LogBuffer::LogBuffer (std::streambuf *sink)
+  : m_sink (sink),
+    m_buffer (1 << 16)
+{
+  setp (m_buffer.data (), m_buffer.data () + m_buffer.size ());
+}
+
+LogBuffer::~LogBuffer ()
+{
+  Forward ();
+}
+
+std::streambuf *
+LogBuffer::GetSink (void) const
+{
+  return m_sink;
+}
+
+bool
+LogBuffer::Forward (void)
+{
+  std::streamsize n = pptr () - pbase ();
+  bool ok = (m_sink->sputn (pbase (), n) == n);
+  setp (m_buffer.data (), m_buffer.data () + m_buffer.size ());
+  return ok;
+}
+
+LogBuffer::int_type
+LogBuffer::overflow (int_type c)
+{
+  if (!Forward ())
+    {
+      return traits_type::eof ();
+    }
+  if (!traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      return sputc (traits_type::to_char_type (c));
+    }
+  return traits_type::not_eof (c);
+}
+
+int
+LogBuffer::sync (void)
+{
+  return (Forward () && m_sink->pubsync () == 0) ? 0 : -1;
+}
+
+/**
+ * \ingroup logging
+ * The buffer installed in \c std::clog, if any.
+ */
+static LogBuffer *g_logBuffer = 0;
+
+/**
+ * \ingroup logging
+ * Remove the log buffer at program exit, before \c std::clog is destroyed.
+ * This is private to the logging implementation.
+ */
+class LogBufferCleanup
+{
+public:
+  ~LogBufferCleanup ()
+  {
+    LogSetBuffered (false);
+  }
+};
+
+void
+LogSetBuffered (bool buffered)
+{
+  if (buffered && g_logBuffer == 0)
+    {
+      // constructed after std::clog, hence destroyed before it
+      static LogBufferCleanup cleanup;
+      g_logBuffer = new LogBuffer (std::clog.rdbuf ());
+      std::clog.rdbuf (g_logBuffer);
+    }
+  else if (!buffered && g_logBuffer != 0)
+    {
+      std::clog.flush ();
+      std::clog.rdbuf (g_logBuffer->GetSink ());
+      delete g_logBuffer;
+      g_logBuffer = 0;
+    }
+}
+
+bool
+LogIsBuffered (void)
+{
+  return g_logBuffer != 0;
+}
+
+std::ostream &
+LogEndLine (std::ostream & os)
+{
+  os.put ('\n');
+  if (g_logBuffer == 0)
+    {
+      os.flush ();
+    }
+  return os;
+}
+
 
 ParameterLogger::ParameterLogger (std::ostream &os)
   : m_first (true),
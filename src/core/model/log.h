@@ -51,6 +51,14 @@
  * messages, use the ns3::LogComponentEnable
  * function or use the NS_LOG environment variable
  *
+ * The levels compiled in can be restricted at configure time with
+ * \c --log-level, globally or per module, for instance
+ * \code
+ *   $ ./waf configure --enable-logs --log-level=warn,internet=logic
+ * \endcode
+ * keeps only the warnings and errors, except in the internet module.
+ * The statements of the other levels cost nothing at run time.
+ *
  * Use the environment variable NS_LOG to define a ':'-separated list of
  * logging components to enable. For example (using bash syntax),
  * \code
@@ -329,6 +337,34 @@ void LogSetNodePrinter (NodePrinter np);
  */
 NodePrinter LogGetNodePrinter (void);
 
+/**
+ * Buffer the log messages written to \c std::clog.
+ *
+ * By default, every log message is flushed as soon as it is complete,
+ * which costs a system call per message.  When buffering is enabled,
+ * the messages are accumulated in memory and written in large blocks.
+ * The buffer is flushed when it is full, when buffering is disabled,
+ * on NS_FATAL_ERROR and at program exit.
+ *
+ * \param [in] buffered Whether to buffer the log messages.
+ */
+void LogSetBuffered (bool buffered);
+/**
+ * Check whether the log messages are buffered.
+ * \returns \c true if the log messages are buffered.
+ */
+bool LogIsBuffered (void);
+/**
+ * Terminate a log message.
+ *
+ * Like \c std::endl, but the stream is flushed only if the log
+ * messages are not buffered.
+ *
+ * \param [in,out] os The output stream.
+ * \returns The output stream.
+ */
+std::ostream & LogEndLine (std::ostream & os);
+
 
 /**
  * A single log component configuration.
@@ -351,10 +387,18 @@ public:
   /**
    * Check if this LogComponent is enabled for \c level
    *
+   * This is evaluated by every log statement, hence inlined.  The
+   * prefix flags are separate bits, so a component with only prefixes
+   * enabled (as set by LogComponentEnableAll (LOG_PREFIX_TIME)) fails
+   * this test for every message level.
+   *
    * \param [in] level The level to check for.
    * \return \c true if we are enabled at \c level.
    */
-  bool IsEnabled (const enum LogLevel level) const;
+  inline bool IsEnabled (const enum LogLevel level) const
+  {
+    return (level & m_levels) != 0;
+  }
   /**
    * Check if all levels are disabled.
    *
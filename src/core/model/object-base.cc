@@ -26,6 +26,8 @@
 
 #include <cstdlib>  // getenv
 #include <cstring>  // strlen
+#include <memory>   // shared_ptr
+#include <vector>
 
 /**
  * \file
@@ -76,93 +78,155 @@ ObjectBase::NotifyConstructionCompleted (void)
   NS_LOG_FUNCTION (this);
 }
 
+namespace {
+
+/** An attribute set by ObjectBase::ConstructSelf(). */
+struct ConstructionAttribute
+{
+  TypeId tid;                                //!< The TypeId of the attribute
+  struct TypeId::AttributeInformation info;  //!< The attribute
+};
+
+/** The attributes of a TypeId and of its parents, in construction order. */
+typedef std::vector<struct ConstructionAttribute> ConstructionAttributes;
+
+/** The cached attributes of a TypeId. */
+struct ConstructionCache
+{
+  uint32_t version;  //!< The version of the attributes cached
+  /** The attributes, shared with the constructions in progress. */
+  std::shared_ptr<const ConstructionAttributes> attributes;
+};
+
+/**
+ * Get the attributes set by the construction of the instances of a
+ * TypeId, copied once from the TypeId and its parents, until the
+ * attributes or their initial values change.
+ *
+ * \param [in] tid The TypeId.
+ * \return The attributes, in construction order.
+ */
+std::shared_ptr<const ConstructionAttributes>
+GetConstructionAttributes (TypeId tid)
+{
+  static std::vector<struct ConstructionCache> cache;
+  uint16_t uid = tid.GetUid ();
+  uint32_t version = TypeId::GetAttributeVersion ();
+  if (uid >= cache.size ())
+    {
+      cache.resize (uid + 1);
+    }
+  struct ConstructionCache &entry = cache[uid];
+  if (entry.attributes == 0 || entry.version != version)
+    {
+      std::shared_ptr<ConstructionAttributes> attributes = std::make_shared<ConstructionAttributes> ();
+      // loop over the inheritance tree back to the Object base class.
+      do
+        {
+          for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
+            {
+              struct ConstructionAttribute attribute;
+              attribute.tid = tid;
+              attribute.info = tid.GetAttribute (i);
+              attributes->push_back (attribute);
+            }
+          tid = tid.GetParent ();
+        }
+      while (tid != ObjectBase::GetTypeId ());
+      entry.version = version;
+      entry.attributes = attributes;
+    }
+  return entry.attributes;
+}
+
+} // unnamed namespace
+
 void
 ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
 {
-  // loop over the inheritance tree back to the Object base class.
   NS_LOG_FUNCTION (this << &attributes);
-  TypeId tid = GetInstanceTypeId ();
-  do
+  // The attributes of the TypeId and of its parents are cached, rather
+  // than copied from the TypeIds for each construction.  The reference
+  // keeps them alive if setting an attribute changes the defaults.
+  std::shared_ptr<const ConstructionAttributes> construction =
+    GetConstructionAttributes (GetInstanceTypeId ());
+  bool hasAttributes = attributes.Begin () != attributes.End ();
+  const char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+  bool hasEnvVar = envVar != 0 && std::strlen (envVar) > 0;
+  for (const struct ConstructionAttribute &attribute : *construction)
     {
-      // loop over all attributes in object type
-      NS_LOG_DEBUG ("construct tid=" << tid.GetName () << ", params=" << tid.GetAttributeN ());
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+      TypeId tid = attribute.tid;
+      const struct TypeId::AttributeInformation &info = attribute.info;
+      NS_LOG_DEBUG ("try to construct \"" << tid.GetName () << "::" <<
+                    info.name << "\"");
+      // is this attribute stored in this AttributeConstructionList instance ?
+      Ptr<AttributeValue> value = hasAttributes ? attributes.Find (info.checker) : 0;
+      // See if this attribute should not be set here in the
+      // constructor.
+      if (!(info.flags & TypeId::ATTR_CONSTRUCT))
         {
-          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
-          NS_LOG_DEBUG ("try to construct \"" << tid.GetName () << "::" <<
-                        info.name << "\"");
-          // is this attribute stored in this AttributeConstructionList instance ?
-          Ptr<AttributeValue> value = attributes.Find (info.checker);
-          // See if this attribute should not be set here in the
-          // constructor.
-          if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+          // Handle this attribute if it should not be
+          // set here.
+          if (value == 0)
             {
-              // Handle this attribute if it should not be
-              // set here.
-              if (value == 0)
-                {
-                  // Skip this attribute if it's not in the
-                  // AttributeConstructionList.
-                  continue;
-                }
-              else
-                {
-                  // This is an error because this attribute is not
-                  // settable in its constructor but is present in
-                  // the AttributeConstructionList.
-                  NS_FATAL_ERROR ("Attribute name=" << info.name << " tid=" << tid.GetName () << ": initial value cannot be set using attributes");
-                }
+              // Skip this attribute if it's not in the
+              // AttributeConstructionList.
+              continue;
+            }
+          else
+            {
+              // This is an error because this attribute is not
+              // settable in its constructor but is present in
+              // the AttributeConstructionList.
+              NS_FATAL_ERROR ("Attribute name=" << info.name << " tid=" << tid.GetName () << ": initial value cannot be set using attributes");
             }
+        }
 
-          if (value != 0)
+      if (value != 0)
+        {
+          // We have a matching attribute value.
+          if (DoSet (info.accessor, info.checker, *value))
             {
-              // We have a matching attribute value.
-              if (DoSet (info.accessor, info.checker, *value))
-                {
-                  NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
-                                info.name << "\"");
-                  continue;
-                }
+              NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
+                            info.name << "\"");
+              continue;
             }
+        }
 
-          // No matching attribute value so we try to look at the env var.
-          const char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
-          if (envVar != 0 && std::strlen (envVar) > 0)
+      // No matching attribute value so we try to look at the env var.
+      if (hasEnvVar)
+        {
+          std::string env = envVar;
+          std::string::size_type cur = 0;
+          std::string::size_type next = 0;
+          while (next != std::string::npos)
             {
-              std::string env = envVar;
-              std::string::size_type cur = 0;
-              std::string::size_type next = 0;
-              while (next != std::string::npos)
+              next = env.find (";", cur);
+              std::string tmp = std::string (env, cur, next - cur);
+              std::string::size_type equal = tmp.find ("=");
+              if (equal != std::string::npos)
                 {
-                  next = env.find (";", cur);
-                  std::string tmp = std::string (env, cur, next - cur);
-                  std::string::size_type equal = tmp.find ("=");
-                  if (equal != std::string::npos)
+                  std::string name = tmp.substr (0, equal);
+                  std::string envval = tmp.substr (equal + 1, tmp.size () - equal - 1);
+                  if (name == tid.GetName () + "::" + info.name)
                     {
-                      std::string name = tmp.substr (0, equal);
-                      std::string envval = tmp.substr (equal + 1, tmp.size () - equal - 1);
-                      if (name == tid.GetAttributeFullName (i))
+                      if (DoSet (info.accessor, info.checker, StringValue (envval)))
                         {
-                          if (DoSet (info.accessor, info.checker, StringValue (envval)))
-                            {
-                              NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
-                                            info.name << "\" from env var");
-                              break;
-                            }
+                          NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
+                                        info.name << "\" from env var");
+                          break;
                         }
                     }
-                  cur = next + 1;
                 }
+              cur = next + 1;
             }
-
-          // No matching attribute value so we try to set the default value.
-          DoSet (info.accessor, info.checker, *info.initialValue);
-          NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
-                        info.name << "\" from initial value.");
         }
-      tid = tid.GetParent ();
+
+      // No matching attribute value so we try to set the default value.
+      DoSet (info.accessor, info.checker, *info.initialValue);
+      NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
+                    info.name << "\" from initial value.");
     }
-  while (tid != ObjectBase::GetTypeId ());
   NotifyConstructionCompleted ();
 }
 
@@ -128,6 +128,24 @@ ObjectPtrContainerAccessor::Get (const ObjectBase * object, AttributeValue &valu
   return true;
 }
 bool
+ObjectPtrContainerAccessor::GetIndexed (const ObjectBase *object, std::size_t index, Ptr<Object> *found) const
+{
+  NS_LOG_FUNCTION (this << object << index << found);
+  std::size_t n;
+  if (!DoGetN (object, &n) || index >= n)
+    {
+      return false;
+    }
+  std::size_t objectIndex;
+  Ptr<Object> o = DoGet (object, index, &objectIndex);
+  if (objectIndex != index)
+    {
+      return false;
+    }
+  *found = o;
+  return true;
+}
+bool
 ObjectPtrContainerAccessor::HasGetter (void) const
 {
   NS_LOG_FUNCTION (this);
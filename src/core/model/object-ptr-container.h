@@ -229,6 +229,19 @@ public:
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
 
+  /**
+   * Get the instance of the container having a given index, without
+   * retrieving all the instances as Get() does.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the requested instance.
+   * \param [out] found The requested instance.
+   * \returns \c false if the instance could not be found directly
+   *          (e.g., the container is a map whose keys are not the
+   *          positions of the instances), in which case Get() must be used.
+   */
+  bool GetIndexed (const ObjectBase *object, std::size_t index, Ptr<Object> *found) const;
+
 private:
   /**
    * Get the number of instances in the container.
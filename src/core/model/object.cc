@@ -46,6 +46,15 @@ NS_LOG_COMPONENT_DEFINE ("Object");
 
 NS_OBJECT_ENSURE_REGISTERED (Object);
 
+namespace {
+
+/** The number of lookups answered by the cache of the aggregates. */
+uint64_t g_cacheHits = 0;
+/** The number of lookups which searched the aggregates. */
+uint64_t g_cacheMisses = 0;
+
+} // unnamed namespace
+
 Object::AggregateIterator::AggregateIterator ()
   : m_object (0),
     m_current (0)
@@ -103,6 +112,7 @@ Object::Object ()
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
+  ClearCache (m_aggregates);
 }
 Object::~Object ()
 {
@@ -120,6 +130,7 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  ClearCache (m_aggregates);
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
@@ -137,6 +148,7 @@ Object::Object (const Object &o)
 {
   m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
+  ClearCache (m_aggregates);
 }
 void
 Object::Construct (const AttributeConstructionList &attributes)
@@ -151,6 +163,35 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  // The cache of the aggregates saves walking the parents of the TypeId
+  // of each aggregate.  A hit updates the sort of the array like a
+  // search does, so that the aggregates are iterated in the same order.
+  // Only the TypeIds matched by at most one aggregate are cached, since
+  // the first match of the others depends on the sort.
+  uint16_t uid = tid.GetUid ();
+  uint32_t slot = 0;
+  while (slot < AGGREGATES_CACHE_SIZE && m_aggregates->cacheUid[slot] != uid)
+    {
+      slot++;
+    }
+  if (uid != 0 && slot < AGGREGATES_CACHE_SIZE)
+    {
+      g_cacheHits++;
+      Object *current = m_aggregates->cache[slot];
+      if (current != 0)
+        {
+          uint32_t i = 0;
+          while (m_aggregates->buffer[i] != current)
+            {
+              i++;
+            }
+          current->m_getObjectCount++;
+          UpdateSortedArray (m_aggregates, i);
+        }
+      return current;
+    }
+  g_cacheMisses++;
+
   uint32_t n = m_aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
@@ -163,6 +204,16 @@ Object::DoGetObject (TypeId tid) const
         }
       if (cur == tid)
         {
+          bool unique = true;
+          for (uint32_t j = i + 1; j < n && unique; j++)
+            {
+              cur = m_aggregates->buffer[j]->GetInstanceTypeId ();
+              while (cur != tid && cur != objectTid)
+                {
+                  cur = cur.GetParent ();
+                }
+              unique = cur != tid;
+            }
           // This is an attempt to 'cache' the result of this lookup.
           // the idea is that if we perform a lookup for a TypeId on this object,
           // we are likely to perform the same lookup later so, we make sure
@@ -174,9 +225,14 @@ Object::DoGetObject (TypeId tid) const
           // then, update the sort
           UpdateSortedArray (m_aggregates, i);
           // finally, return the match
+          if (unique)
+            {
+              Cache (m_aggregates, uid, current);
+            }
           return const_cast<Object *> (current);
         }
     }
+  Cache (m_aggregates, uid, 0);
   return 0;
 }
 void
@@ -249,6 +305,20 @@ Object::UpdateSortedArray (struct Aggregates *aggregates, uint32_t j) const
     }
 }
 void
+Object::ClearCache (struct Aggregates *aggregates)
+{
+  std::memset (aggregates->cacheUid, 0, sizeof (aggregates->cacheUid));
+  aggregates->cacheNext = 0;
+}
+void
+Object::Cache (struct Aggregates *aggregates, uint16_t uid, Object *object)
+{
+  uint32_t slot = aggregates->cacheNext;
+  aggregates->cacheUid[slot] = uid;
+  aggregates->cache[slot] = object;
+  aggregates->cacheNext = (slot + 1) % AGGREGATES_CACHE_SIZE;
+}
+void
 Object::AggregateObject (Ptr<Object> o)
 {
   NS_LOG_FUNCTION (this << o);
@@ -263,6 +333,7 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates =
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates) + (total - 1) * sizeof(Object*));
   aggregates->n = total;
+  ClearCache (aggregates);
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0],
@@ -334,12 +405,25 @@ Object::GetAggregateIterator (void) const
   return AggregateIterator (this);
 }
 
+uint64_t
+Object::GetNCacheHits (void)
+{
+  return g_cacheHits;
+}
+
+uint64_t
+Object::GetNCacheMisses (void)
+{
+  return g_cacheMisses;
+}
+
 void
 Object::SetTypeId (TypeId tid)
 {
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (Check ());
   m_tid = tid;
+  ClearCache (m_aggregates);
 }
 
 void
@@ -210,6 +210,24 @@ public:
    */
   AggregateIterator GetAggregateIterator (void) const;
 
+  /**
+   * Get the number of lookups of aggregated Objects by TypeId answered
+   * by the lookup cache of the aggregates, in all the Objects.
+   *
+   * The lookups of GetObject() whose first aggregate has the requested
+   * type are not counted, since they do not search the aggregates.
+   *
+   * \returns The number of cache hits.
+   */
+  static uint64_t GetNCacheHits (void);
+  /**
+   * Get the number of lookups of aggregated Objects by TypeId which
+   * searched the aggregates, in all the Objects.
+   *
+   * \returns The number of cache misses.
+   */
+  static uint64_t GetNCacheMisses (void);
+
   /**
    * Invoke DoInitialize on all Objects aggregated to this one.
    *
@@ -330,6 +348,9 @@ private:
   friend struct ObjectDeleter;
   /**@}*/
 
+  /** The number of entries of the lookup cache of the aggregates. */
+  static const uint32_t AGGREGATES_CACHE_SIZE = 8;
+
   /**
    * The list of Objects aggregated to this one.
    *
@@ -341,9 +362,20 @@ private:
    * chunk of memory than the struct to allow space for a larger
    * variable sized buffer whose size is indicated by the element
    * \c n
+   *
+   * The structure also holds a small cache of the results of DoGetObject(),
+   * searched by the uid of the TypeId looked up and replaced in round
+   * robin.  A new aggregation allocates a new structure, whose cache is
+   * empty.
    */
   struct Aggregates
   {
+    /** The uids of the TypeIds of the \c cache entries, 0 if empty. */
+    uint16_t cacheUid[AGGREGATES_CACHE_SIZE];
+    /** The aggregated Objects of these TypeIds, 0 if there is none. */
+    Object *cache[AGGREGATES_CACHE_SIZE];
+    /** The next entry of the cache to replace. */
+    uint32_t cacheNext;
     /** The number of entries in \c buffer. */
     uint32_t n;
     /** The array of Objects. */
@@ -404,6 +436,20 @@ private:
    * \param [in] i The most recently used entry in the list.
    */
   void UpdateSortedArray (struct Aggregates *aggregates, uint32_t i) const;
+  /**
+   * Empty the lookup cache of a list of aggregates.
+   *
+   * \param [in,out] aggregates The list of aggregated Objects.
+   */
+  static void ClearCache (struct Aggregates *aggregates);
+  /**
+   * Add the result of a lookup to the cache of a list of aggregates.
+   *
+   * \param [in,out] aggregates The list of aggregated Objects.
+   * \param [in] uid The uid of the TypeId looked up.
+   * \param [in] object The aggregated Object of this TypeId, or 0.
+   */
+  static void Cache (struct Aggregates *aggregates, uint16_t uid, Object *object);
   /**
    * Attempt to delete this Object.
    *
@@ -139,6 +139,16 @@ RandomVariableStream::Peek (void) const
   return m_rng;
 }
 
+void
+RandomVariableStream::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      values[i] = GetValue ();
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED (UniformRandomVariable);
 
 TypeId
@@ -203,6 +213,22 @@ UniformRandomVariable::GetValue (void)
   NS_LOG_FUNCTION (this);
   return GetValue (m_min, m_max);
 }
+void
+UniformRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  Peek ()->RandU01 (values, n);
+  const bool antithetic = IsAntithetic ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      double v = m_min + values[i] * (m_max - m_min);
+      if (antithetic)
+        {
+          v = m_min + (m_max - v);
+        }
+      values[i] = v;
+    }
+}
 uint32_t
 UniformRandomVariable::GetInteger (void)
 {
@@ -258,6 +284,12 @@ ConstantRandomVariable::GetValue (void)
   NS_LOG_FUNCTION (this);
   return GetValue (m_constant);
 }
+void
+ConstantRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  std::fill (values, values + n, m_constant);
+}
 uint32_t
 ConstantRandomVariable::GetInteger (void)
 {
@@ -439,6 +471,28 @@ ExponentialRandomVariable::GetValue (void)
   NS_LOG_FUNCTION (this);
   return GetValue (m_mean, m_bound);
 }
+void
+ExponentialRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  if (m_bound != 0)
+    {
+      // The rejected values draw a variable number of random numbers
+      RandomVariableStream::GetValues (values, n);
+      return;
+    }
+  Peek ()->RandU01 (values, n);
+  const bool antithetic = IsAntithetic ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      double v = values[i];
+      if (antithetic)
+        {
+          v = (1 - v);
+        }
+      values[i] = -m_mean*std::log (v);
+    }
+}
 uint32_t
 ExponentialRandomVariable::GetInteger (void)
 {
@@ -1288,6 +1342,10 @@ ZipfRandomVariable::GetTypeId (void)
   return tid;
 }
 ZipfRandomVariable::ZipfRandomVariable ()
+  : m_cdfN (0),
+    m_cdfAlpha (0),
+    m_cdfMemberN (0),
+    m_cdfMemberAlpha (0)
 {
   // m_n and m_alpha are initialized after constructor by attributes
   NS_LOG_FUNCTION (this);
@@ -1310,6 +1368,28 @@ double
 ZipfRandomVariable::GetValue (uint32_t n, double alpha)
 {
   NS_LOG_FUNCTION (this << n << alpha);
+  UpdateCdf (n, alpha);
+
+  // Get a uniform random variable in [0,1].
+  double u = Peek ()->RandU01 ();
+  if (IsAntithetic ())
+    {
+      u = (1 - u);
+    }
+  return Sample (u);
+}
+
+void
+ZipfRandomVariable::UpdateCdf (uint32_t n, double alpha)
+{
+  NS_LOG_FUNCTION (this << n << alpha);
+  if (n == m_cdfN && alpha == m_cdfAlpha
+      && m_n == m_cdfMemberN && m_alpha == m_cdfMemberAlpha
+      && m_cdf.size () == m_n)
+    {
+      return;
+    }
+
   // Calculate the normalization constant c.
   m_c = 0.0;
   for (uint32_t i = 1; i <= n; i++)
@@ -1318,24 +1398,30 @@ ZipfRandomVariable::GetValue (uint32_t n, double alpha)
     }
   m_c = 1.0 / m_c;
 
-  // Get a uniform random variable in [0,1].
-  double u = Peek ()->RandU01 ();
-  if (IsAntithetic ())
+  // The sums of the linear search over the values, whose result is the
+  // first value whose sum is greater than the uniform random variable.
+  m_cdf.resize (m_n);
+  double sum_prob = 0;
+  for (uint32_t i = 1; i <= m_n; i++)
     {
-      u = (1 - u);
+      sum_prob += m_c / std::pow ((double)i,m_alpha);
+      m_cdf[i - 1] = sum_prob;
     }
+  m_cdfN = n;
+  m_cdfAlpha = alpha;
+  m_cdfMemberN = m_n;
+  m_cdfMemberAlpha = m_alpha;
+}
 
-  double sum_prob = 0,zipf_value = 0;
-  for (uint32_t i = 1; i <= m_n; i++)
+double
+ZipfRandomVariable::Sample (double u) const
+{
+  std::vector<double>::const_iterator bound = std::upper_bound (m_cdf.begin (), m_cdf.end (), u);
+  if (bound == m_cdf.end ())
     {
-      sum_prob += m_c / std::pow ((double)i,m_alpha);
-      if (sum_prob > u)
-        {
-          zipf_value = i;
-          break;
-        }
+      return 0;
     }
-  return zipf_value;
+  return (bound - m_cdf.begin ()) + 1;
 }
 
 uint32_t
@@ -1351,6 +1437,18 @@ ZipfRandomVariable::GetValue (void)
   NS_LOG_FUNCTION (this);
   return GetValue (m_n, m_alpha);
 }
+void
+ZipfRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  UpdateCdf (m_n, m_alpha);
+  Peek ()->RandU01 (values, n);
+  const bool antithetic = IsAntithetic ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      values[i] = Sample (antithetic ? 1 - values[i] : values[i]);
+    }
+}
 uint32_t
 ZipfRandomVariable::GetInteger (void)
 {
@@ -1634,6 +1732,37 @@ EmpiricalRandomVariable::GetValue (void)
   return value;
 }
 
+void
+EmpiricalRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  if (!m_validated)
+    {
+      Validate ();
+    }
+  Peek ()->RandU01 (values, n);
+  const bool antithetic = IsAntithetic ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      values[i] = DoSample (antithetic ? 1 - values[i] : values[i]);
+    }
+}
+
+double
+EmpiricalRandomVariable::DoSample (double r)
+{
+  // Same steps as PreSample and GetValue
+  if (r <= m_emp.front ().cdf)
+    {
+      return m_emp.front ().value;
+    }
+  else if (r >= m_emp.back ().cdf)
+    {
+      return m_emp.back ().value;
+    }
+  return m_interpolate ? DoInterpolate (r) : DoSampleCDF (r);
+}
+
 double
 EmpiricalRandomVariable::DoSampleCDF (double r)
 {
@@ -30,6 +30,7 @@
 #include "object.h"
 #include "attribute-helper.h"
 #include <stdint.h>
+#include <vector>
 
 /**
  * \file
@@ -149,6 +150,20 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Fill an array with the next random values drawn from the distribution.
+   *
+   * The values are those of \pname{n} successive calls to GetValue(),
+   * so a stream draws the same sequence however it is sampled.  The
+   * distributions sampled in bulk for workloads (uniform, constant,
+   * exponential, Zipf and empirical) override this method to draw the
+   * uniform random numbers in one batch.
+   *
+   * \param [out] values The array of the values.
+   * \param [in] n The number of values.
+   */
+  virtual void GetValues (double *values, uint32_t n);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RngStream.
@@ -288,6 +303,11 @@ public:
    * \note The upper limit is excluded from the output range.
   */
   virtual double GetValue (void);
+
+  /**
+   * \copydoc RandomVariableStream::GetValues()
+   */
+  virtual void GetValues (double *values, uint32_t n);
   /**
    * \brief Get the next random value as an integer drawn from the distribution.
    * \return  An integer random value.
@@ -351,6 +371,11 @@ public:
   // Inherited from RandomVariableStream
   /* \note This RNG always returns the same value. */
   virtual double GetValue (void);
+
+  /**
+   * \copydoc RandomVariableStream::GetValues()
+   */
+  virtual void GetValues (double *values, uint32_t n);
   /* \note This RNG always returns the same value. */
   virtual uint32_t GetInteger (void);
 
@@ -585,6 +610,11 @@ public:
 
   // Inherited from RandomVariableStream
   virtual double GetValue (void);
+
+  /**
+   * \copydoc RandomVariableStream::GetValues()
+   */
+  virtual void GetValues (double *values, uint32_t n);
   virtual uint32_t GetInteger (void);
 
 private:
@@ -2165,6 +2195,11 @@ public:
    */
   virtual double GetValue (void);
 
+  /**
+   * \copydoc RandomVariableStream::GetValues()
+   */
+  virtual void GetValues (double *values, uint32_t n);
+
   /**
    * \brief Returns a random unsigned integer from a Zipf distribution with the current n and alpha.
    * \return A random unsigned integer value.
@@ -2179,6 +2214,24 @@ public:
   virtual uint32_t GetInteger (void);
 
 private:
+  /**
+   * \brief Compute the cumulative probabilities, unless they are
+   * cached already.
+   *
+   * \param [in] n The n value of the normalization constant.
+   * \param [in] alpha The alpha value of the normalization constant.
+   */
+  void UpdateCdf (uint32_t n, double alpha);
+  /**
+   * \brief Find the value of a uniform random number in the cumulative
+   * probabilities.
+   *
+   * \param [in] u The uniform random number.
+   * \return The smallest value whose cumulative probability is greater
+   * than \pname{u}, or 0.
+   */
+  double Sample (double u) const;
+
   /** The n value for the Zipf distribution returned by this RNG stream. */
   uint32_t m_n;
 
@@ -2188,6 +2241,16 @@ private:
   /** The normalization constant. */
   double m_c;
 
+  /**
+   * The cumulative probabilities of the values 1 to m_n, summed in the
+   * order of the linear search they replace.
+   */
+  std::vector<double> m_cdf;
+  uint32_t m_cdfN;           //!< n value of the cached normalization
+  double m_cdfAlpha;         //!< alpha value of the cached normalization
+  uint32_t m_cdfMemberN;     //!< m_n value of the cached probabilities
+  double m_cdfMemberAlpha;   //!< m_alpha value of the cached probabilities
+
 };  // class ZipfRandomVariable
 
 
@@ -2517,6 +2580,11 @@ public:
    */
   virtual double GetValue (void);
 
+  /**
+   * \copydoc RandomVariableStream::GetValues()
+   */
+  virtual void GetValues (double *values, uint32_t n);
+
   /**
    * \brief Returns the next value in the empirical distribution.
    * \return The integer next value in the empirical distribution.
@@ -2608,6 +2676,14 @@ private:
    * \returns The interpolated CDF at \pname{r}
    */
   double DoInterpolate (double r);
+  /**
+   * \brief Find the value of a uniform random number, checking the
+   * extrema then sampling or interpolating the CDF.
+   *
+   * \param [in] r The uniform random number.
+   * \return The value.
+   */
+  double DoSample (double r);
 
   /**
    * \brief Comparison operator, for use by std::upper_bound
@@ -70,6 +70,16 @@ public:
    * \returns The next random.
    */
   double RandU01 (void);
+  /**
+   * Generate the next \pname{n} random numbers of this stream,
+   * which are the values of \pname{n} successive calls to RandU01().
+   *
+   * The state vector is kept in local variables for the whole batch.
+   *
+   * \param [out] u The array of the random numbers.
+   * \param [in] n The number of random numbers.
+   */
+  void RandU01 (double *u, uint32_t n);
 
 private:
   /**
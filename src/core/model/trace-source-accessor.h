@@ -115,6 +115,24 @@ public:
 template <typename T>
 Ptr<const TraceSourceAccessor> MakeTraceSourceAccessor (T a);
 
+/**
+ * \ingroup tracing
+ *
+ * Create a TraceSourceAccessor which will control access to the underlying
+ * trace source and notify the object every time a Callback is connected.
+ *
+ * This allows an object to defer the work needed to feed a trace source
+ * (e.g., chaining it to the trace source of another object) until somebody
+ * listens to it, so that unconnected trace sources cost nothing.
+ *
+ * \param [in] a The trace source
+ * \param [in] notify The method of the object invoked after a Callback
+ *             has been connected to the trace source
+ * \returns The TraceSourceAccessor
+ */
+template <typename T, typename SOURCE>
+Ptr<const TraceSourceAccessor> MakeTraceSourceAccessor (SOURCE T::*a, void (T::*notify)(void));
+
 /**
  * \ingroup tracing
  *
@@ -204,6 +222,62 @@ Ptr<const TraceSourceAccessor> MakeTraceSourceAccessor (T a)
   return DoMakeTraceSourceAccessor (a);
 }
 
+template <typename T, typename SOURCE>
+Ptr<const TraceSourceAccessor>
+MakeTraceSourceAccessor (SOURCE T::*a, void (T::*notify)(void))
+{
+  struct Accessor : public TraceSourceAccessor
+  {
+    virtual bool ConnectWithoutContext (ObjectBase *obj, const CallbackBase &cb) const
+    {
+      T *p = dynamic_cast<T*> (obj);
+      if (p == 0)
+        {
+          return false;
+        }
+      (p->*m_source).ConnectWithoutContext (cb);
+      (p->*m_notify)();
+      return true;
+    }
+    virtual bool Connect (ObjectBase *obj, std::string context, const CallbackBase &cb) const
+    {
+      T *p = dynamic_cast<T*> (obj);
+      if (p == 0)
+        {
+          return false;
+        }
+      (p->*m_source).Connect (cb, context);
+      (p->*m_notify)();
+      return true;
+    }
+    virtual bool DisconnectWithoutContext (ObjectBase *obj, const CallbackBase &cb) const
+    {
+      T *p = dynamic_cast<T*> (obj);
+      if (p == 0)
+        {
+          return false;
+        }
+      (p->*m_source).DisconnectWithoutContext (cb);
+      return true;
+    }
+    virtual bool Disconnect (ObjectBase *obj, std::string context, const CallbackBase &cb) const
+    {
+      T *p = dynamic_cast<T*> (obj);
+      if (p == 0)
+        {
+          return false;
+        }
+      (p->*m_source).Disconnect (cb, context);
+      return true;
+    }
+    SOURCE T::*m_source;
+    void (T::*m_notify)(void);
+  } *accessor = new Accessor ();
+  accessor->m_source = a;
+  accessor->m_notify = notify;
+  return Ptr<const TraceSourceAccessor> (accessor, false);
+}
+
 } // namespace ns3
 
 
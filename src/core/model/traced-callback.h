@@ -83,6 +83,15 @@ public:
    * \param [in] path Context path which was used to connect the Callback.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * \brief Check whether no Callback is connected.
+   *
+   * This can be used to skip the computation of the arguments
+   * of a trace nobody is listening to.
+   *
+   * \returns \c true if the chain of Callbacks is empty.
+   */
+  bool IsEmpty (void) const;
   /**
    * \brief Functor which invokes the chain of Callbacks.
    * \tparam Ts \deduced Types of the functor arguments.
@@ -178,6 +187,12 @@ TracedCallback<Ts...>::Disconnect (const CallbackBase & callback, std::string pa
   DisconnectWithoutContext (realCb);
 }
 template<typename... Ts>
+bool
+TracedCallback<Ts...>::IsEmpty (void) const
+{
+  return m_callbackList.empty ();
+}
+template<typename... Ts>
 void
 TracedCallback<Ts...>::operator() (Ts... args) const
 {
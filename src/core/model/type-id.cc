@@ -172,6 +172,12 @@ public:
    * \returns The total number.
    */
   uint16_t GetRegisteredN (void) const;
+  /**
+   * Get the version of the attributes of all the type ids.
+   * \returns The number of changes of the attributes and of their
+   *          initial values.
+   */
+  uint32_t GetAttributeVersion (void) const;
   /**
    * Get a type id by index.
    *
@@ -344,6 +350,9 @@ private:
   /** The by-hash index. */
   hashmap_t m_hashmap;
 
+  /** The number of changes of the attributes and of their initial values. */
+  uint32_t m_attributeVersion;
+
 
   /** IidManager constants. */
   enum
@@ -605,6 +614,11 @@ IidManager::GetRegisteredN (void) const
   NS_LOG_FUNCTION (IID << m_information.size ());
   return static_cast<uint16_t> (m_information.size ());
 }
+uint32_t
+IidManager::GetAttributeVersion (void) const
+{
+  return m_attributeVersion;
+}
 uint16_t
 IidManager::GetRegistered (uint16_t i) const
 {
@@ -681,6 +695,7 @@ IidManager::AddAttribute (uint16_t uid,
   info.supportLevel = supportLevel;
   info.supportMsg = supportMsg;
   information->attributes.push_back (info);
+  m_attributeVersion++;
   NS_LOG_LOGIC (IIDL << information->attributes.size () - 1);
 }
 void
@@ -692,6 +707,7 @@ IidManager::SetAttributeInitialValue (uint16_t uid,
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
+  m_attributeVersion++;
 }
 
 
@@ -872,6 +888,11 @@ TypeId::GetRegisteredN (void)
   NS_LOG_FUNCTION_NOARGS ();
   return IidManager::Get ()->GetRegisteredN ();
 }
+uint32_t
+TypeId::GetAttributeVersion (void)
+{
+  return IidManager::Get ()->GetAttributeVersion ();
+}
 TypeId
 TypeId::GetRegistered (uint16_t i)
 {
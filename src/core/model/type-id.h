@@ -160,6 +160,17 @@ public:
    * \returns The number of TypeId instances registered.
    */
   static uint16_t GetRegisteredN (void);
+  /**
+   * Get the version of the attributes of all the TypeIds.
+   *
+   * The version changes each time an attribute is added to a TypeId,
+   * or the initial value of an attribute is changed, for instance by
+   * Config::SetDefault().  The information on the attributes cached
+   * with a version is valid as long as the version does not change.
+   *
+   * \returns The version of the attributes.
+   */
+  static uint32_t GetAttributeVersion (void);
   /**
    * Get a TypeId by index.
    *
@@ -1467,6 +1467,58 @@ CallbackValueTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_gotCbValue, 2, "Callback Attribute set to null callback unexpectedly fired");
 }
 
+// ===========================================================================
+// Test that the constructions see the changes of the initial values.
+// ===========================================================================
+class ConstructionDefaultsTestCase : public TestCase
+{
+public:
+  ConstructionDefaultsTestCase (std::string description);
+  virtual ~ConstructionDefaultsTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+};
+
+ConstructionDefaultsTestCase::ConstructionDefaultsTestCase (std::string description)
+  : TestCase (description)
+{}
+
+void
+ConstructionDefaultsTestCase::DoRun (void)
+{
+  struct TypeId::AttributeInformation info;
+  AttributeObjectTest::GetTypeId ().LookupAttributeByName ("TestInt16", &info);
+  Ptr<const AttributeValue> initial = info.initialValue;
+
+  //
+  // The attributes of a type are cached by its first construction.  Each
+  // change of an initial value must be seen by the next construction.
+  //
+  for (int16_t i = 0; i < 4; i++)
+    {
+      Config::SetDefault ("ns3::AttributeObjectTest::TestInt16", IntegerValue (i));
+      for (uint32_t j = 0; j < 2; j++)
+        {
+          Ptr<AttributeObjectTest> p = CreateObject<AttributeObjectTest> ();
+          IntegerValue value;
+          p->GetAttribute ("TestInt16", value);
+          NS_TEST_ASSERT_MSG_EQ (value.Get (), i, "Construction did not see the new initial value");
+        }
+    }
+
+  //
+  // A value given to the construction still takes precedence.
+  //
+  Ptr<AttributeObjectTest> p = CreateObjectWithAttributes<AttributeObjectTest> ("TestInt16", IntegerValue (-5));
+  IntegerValue value;
+  p->GetAttribute ("TestInt16", value);
+  NS_TEST_ASSERT_MSG_EQ (value.Get (), -5, "Construction did not use the value of the attribute list");
+
+  Config::SetDefault ("ns3::AttributeObjectTest::TestInt16", *initial);
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -1490,6 +1542,7 @@ AttributesTestSuite::AttributesTestSuite ()
   AddTestCase (new ObjectMapAttributeTestCase ("Check Attributes of type ObjectMapValue"), TestCase::QUICK);
   AddTestCase (new PointerAttributeTestCase ("Check Attributes of type PointerValue"), TestCase::QUICK);
   AddTestCase (new CallbackValueTestCase ("Check Attributes of type CallbackValue"), TestCase::QUICK);
+  AddTestCase (new ConstructionDefaultsTestCase ("Check the constructions after changes of the initial values"), TestCase::QUICK);
   AddTestCase (new IntegerTraceSourceAttributeTestCase ("Ensure TracedValue<uint8_t> can be set like IntegerValue"), TestCase::QUICK);
   AddTestCase (new IntegerTraceSourceTestCase ("Ensure TracedValue<uint8_t> also works as trace source"), TestCase::QUICK);
   AddTestCase (new TracedCallbackTestCase ("Ensure TracedCallback<double, int, float> works as trace source"), TestCase::QUICK);
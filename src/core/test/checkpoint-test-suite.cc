@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/checkpoint.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/double.h"
+#include "ns3/test.h"
+#include "ns3/core-config.h"
+
+#ifdef HAVE_SYS_WAIT_H
+# include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * Checkpoint test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that the variants of a checkpoint continue from the state of the
+ * simulation: the events scheduled before the checkpoint are run by every
+ * variant, with the attributes altered by the variant callback, and the
+ * random variables draw the same numbers.
+ */
+class CheckpointTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  CheckpointTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /** The result of a variant, sent to the first variant through a pipe. */
+  struct Result
+  {
+    uint32_t variant;   //!< The variant.
+    double sum;         //!< The sum of the values of m_constant.
+    double uniform;     //!< The value drawn after the checkpoint.
+  };
+  /** Add the value of m_constant to m_sum. */
+  void Add (void);
+  /**
+   * The variant callback.
+   * \param [in] variant The variant.
+   */
+  void SetVariant (uint32_t variant);
+
+  Ptr<ConstantRandomVariable> m_constant;  //!< The altered object.
+  Ptr<UniformRandomVariable> m_uniform;    //!< The inherited stream.
+  double m_sum;                            //!< The sum of the values.
+  uint32_t m_called;                       //!< The variant callback invocations.
+};
+
+CheckpointTestCase::CheckpointTestCase ()
+  : TestCase ("Check the variants of a checkpoint")
+{}
+
+void
+CheckpointTestCase::Add (void)
+{
+  m_sum += m_constant->GetValue ();
+}
+
+void
+CheckpointTestCase::SetVariant (uint32_t variant)
+{
+  m_called++;
+  m_constant->SetAttribute ("Constant", DoubleValue (variant + 1));
+}
+
+void
+CheckpointTestCase::DoRun (void)
+{
+#ifdef HAVE_SYS_WAIT_H
+  const uint32_t n = 3;
+  int fds[2];
+  NS_TEST_ASSERT_MSG_EQ (pipe (fds), 0, "Cannot create the pipe");
+
+  m_constant = CreateObject<ConstantRandomVariable> ();
+  m_constant->SetAttribute ("Constant", DoubleValue (1));
+  m_uniform = CreateObject<UniformRandomVariable> ();
+  m_uniform->SetStream (1);
+  m_sum = 0;
+  m_called = 0;
+  for (uint32_t i = 1; i <= 10; i++)
+    {
+      Simulator::Schedule (MilliSeconds (i), &CheckpointTestCase::Add, this);
+    }
+  Checkpoint::Schedule (MicroSeconds (5500), n,
+                        MakeCallback (&CheckpointTestCase::SetVariant, this));
+  NS_TEST_ASSERT_MSG_EQ (Checkpoint::GetVariant (), 0, "No variant before the checkpoint");
+  Simulator::Run ();
+
+  Result result;
+  result.variant = Checkpoint::GetVariant ();
+  result.sum = m_sum;
+  result.uniform = m_uniform->GetValue ();
+  if (result.variant != 0)
+    {
+      // Report to the first variant, and leave the test runner to it
+      Simulator::Destroy ();
+      ssize_t written = write (fds[1], &result, sizeof (result));
+      _exit (written == sizeof (result) && m_called == 1 ? 0 : 1);
+    }
+  close (fds[1]);
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (Checkpoint::Wait (), 0, "A variant failed");
+
+  NS_TEST_EXPECT_MSG_EQ (m_called, 1, "The variant callback was not invoked once");
+  NS_TEST_EXPECT_MSG_EQ (m_sum, 5 * 1 + 5 * 1, "Wrong sum of the variant 0");
+  std::vector<bool> seen (n, false);
+  seen[0] = true;
+  Result other;
+  while (read (fds[0], &other, sizeof (other)) == sizeof (other))
+    {
+      NS_TEST_ASSERT_MSG_LT (other.variant, n, "Unexpected variant");
+      NS_TEST_EXPECT_MSG_EQ (seen[other.variant], false, "Variant reported twice");
+      seen[other.variant] = true;
+      NS_TEST_EXPECT_MSG_EQ (other.sum, 5 * 1 + 5 * (other.variant + 1.0),
+                             "Wrong sum of the variant " << other.variant);
+      NS_TEST_EXPECT_MSG_EQ (other.uniform, result.uniform,
+                             "Different random numbers in the variant " << other.variant);
+    }
+  close (fds[0]);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (seen[i], true, "Variant " << i << " did not report");
+    }
+#endif /* HAVE_SYS_WAIT_H */
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that a checkpoint with a single variant runs in the same process.
+ */
+class CheckpointSingleVariantTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  CheckpointSingleVariantTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * The variant callback.
+   * \param [in] variant The variant.
+   */
+  void SetVariant (uint32_t variant);
+
+  Time m_time;         //!< The time of the checkpoint.
+  uint32_t m_variant;  //!< The variant of the callback.
+};
+
+CheckpointSingleVariantTestCase::CheckpointSingleVariantTestCase ()
+  : TestCase ("Check a checkpoint with a single variant")
+{}
+
+void
+CheckpointSingleVariantTestCase::SetVariant (uint32_t variant)
+{
+  m_time = Simulator::Now ();
+  m_variant = variant;
+}
+
+void
+CheckpointSingleVariantTestCase::DoRun (void)
+{
+  m_time = Seconds (0);
+  m_variant = 1;
+  Checkpoint::Schedule (Seconds (2), 1,
+                        MakeCallback (&CheckpointSingleVariantTestCase::SetVariant, this));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_time, Seconds (2), "Wrong time of the checkpoint");
+  NS_TEST_EXPECT_MSG_EQ (m_variant, 0, "Wrong variant");
+  NS_TEST_EXPECT_MSG_EQ (Checkpoint::GetVariant (), 0, "Wrong variant of the process");
+  NS_TEST_EXPECT_MSG_EQ (Checkpoint::Wait (), 0, "No other variant to wait for");
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Checkpoint test suite.
+ */
+class CheckpointTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  CheckpointTestSuite ();
+};
+
+CheckpointTestSuite::CheckpointTestSuite ()
+  : TestSuite ("checkpoint", UNIT)
+{
+  AddTestCase (new CheckpointSingleVariantTestCase (), TestCase::QUICK);
+  if (Checkpoint::IsSupported ())
+    {
+      AddTestCase (new CheckpointTestCase (), TestCase::QUICK);
+    }
+}
+
+static CheckpointTestSuite g_checkpointTestSuite; //!< Static variable for test initialization
+
+
+}    // namespace tests
+
+}  // namespace ns3
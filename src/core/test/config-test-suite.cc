@@ -27,6 +27,7 @@
 #include "ns3/singleton.h"
 #include "ns3/object.h"
 #include "ns3/object-vector.h"
+#include "ns3/object-map.h"
 #include "ns3/names.h"
 #include "ns3/pointer.h"
 #include "ns3/log.h"
@@ -840,6 +841,171 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * An object holding a map of objects, whose keys are not their positions.
+ */
+class ConfigMapTestObject : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ConfigMapTestObject")
+      .SetParent<Object> ()
+      .AddAttribute ("Nodes", "",
+                     ObjectMapValue (),
+                     MakeObjectMapAccessor (&ConfigMapTestObject::m_nodes),
+                     MakeObjectMapChecker<ConfigTestObject> ())
+    ;
+    return tid;
+  }
+  std::map<uint32_t, Ptr<ConfigTestObject> > m_nodes; //!< Nodes attribute target.
+};
+
+/**
+ * \ingroup config-tests
+ * Test for the objects of a container named by their index.
+ */
+class ObjectContainerIndexConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ObjectContainerIndexConfigTestCase ();
+  /** Destructor. */
+  virtual ~ObjectContainerIndexConfigTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+};
+
+ObjectContainerIndexConfigTestCase::ObjectContainerIndexConfigTestCase ()
+  : TestCase ("Check that the objects of large vectors and of maps are found by index")
+{}
+
+void
+ObjectContainerIndexConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      objects.push_back (CreateObject<ConfigTestObject> ());
+      root->AddNodeA (objects.back ());
+    }
+
+  //
+  // A single index of a large vector.
+  //
+  Config::Set ("/NodesA/57/A", IntegerValue (-11));
+  objects[57]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -11, "Object Attribute \"A\" not set as expected");
+  objects[56]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 10, "Object Attribute \"A\" unexpectedly set");
+
+  //
+  // Out of range indices and mixed alternatives: the matches are sorted by
+  // index and reported with their context.
+  //
+  NS_TEST_ASSERT_MSG_EQ (Config::LookupMatches ("/NodesA/100").GetN (), 0, "Unexpected match");
+  Config::MatchContainer matches = Config::LookupMatches ("/NodesA/98|[3-4]|250|3");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 3, "Unexpected number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodesA/3/", "Unexpected match");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (1), "/NodesA/4/", "Unexpected match");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (2), "/NodesA/98/", "Unexpected match");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (2), objects[98], "Unexpected object");
+  NS_TEST_ASSERT_MSG_EQ (Config::LookupMatches ("/NodesA/*").GetN (), 100, "Unexpected number of matches");
+
+  //
+  // The keys of a map are not the positions of its objects.
+  //
+  Ptr<ConfigMapTestObject> map = CreateObject<ConfigMapTestObject> ();
+  map->m_nodes[5] = objects[0];
+  map->m_nodes[1] = objects[1];
+  Config::UnregisterRootNamespaceObject (root);
+  Config::RegisterRootNamespaceObject (map);
+  matches = Config::LookupMatches ("/Nodes/1");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Unexpected number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objects[1], "Unexpected object");
+  matches = Config::LookupMatches ("/Nodes/5");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Unexpected number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objects[0], "Unexpected object");
+  NS_TEST_ASSERT_MSG_EQ (Config::LookupMatches ("/Nodes/0").GetN (), 0, "Unexpected match");
+  Config::UnregisterRootNamespaceObject (map);
+}
+
+/**
+ * \ingroup config-tests
+ * An object whose pointer attribute is added after its first lookup.
+ */
+class ConfigLateAttributeTestObject : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ConfigLateAttributeTestObject")
+      .SetParent<Object> ()
+    ;
+    return tid;
+  }
+  Ptr<ConfigTestObject> m_node; //!< Late attribute target.
+};
+
+/**
+ * \ingroup config-tests
+ * Test for the attributes added to a TypeId after a path lookup.
+ */
+class LateAttributeConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  LateAttributeConfigTestCase ();
+  /** Destructor. */
+  virtual ~LateAttributeConfigTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+};
+
+LateAttributeConfigTestCase::LateAttributeConfigTestCase ()
+  : TestCase ("Check that the attributes added after a lookup are found")
+{}
+
+void
+LateAttributeConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigLateAttributeTestObject> root = CreateObject<ConfigLateAttributeTestObject> ();
+  root->m_node = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  NS_TEST_ASSERT_MSG_EQ (Config::LookupMatches ("/Late").GetN (), 0, "Unexpected match");
+
+  TypeId tid = ConfigLateAttributeTestObject::GetTypeId ();
+  struct TypeId::AttributeInformation info;
+  if (!tid.LookupAttributeByName ("Late", &info))
+    {
+      tid.AddAttribute ("Late", "",
+                        PointerValue (),
+                        MakePointerAccessor (&ConfigLateAttributeTestObject::m_node),
+                        MakePointerChecker<ConfigTestObject> ());
+    }
+  Config::MatchContainer matches = Config::LookupMatches ("/Late");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "The attribute added after the lookup was not found");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), root->m_node, "Unexpected object");
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -858,6 +1024,8 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new ObjectContainerIndexConfigTestCase);
+  AddTestCase (new LateAttributeConfigTestCase);
 }
 
 /**
@@ -1173,6 +1173,130 @@ Int64x64DoubleTestCase::DoRun (void)
 }
 
 
+/**
+ * \internal
+ *
+ * Test the fast paths of the conversion from double and of the division
+ * by an integer against their reference:  the long double conversion, and
+ * a bit by bit long division.
+ */
+class Int64x64FastPathTestCase : public TestCase
+{
+public:
+  Int64x64FastPathTestCase ();
+  virtual void DoRun (void);
+  void CheckDouble (const double value);
+  void CheckDivide (const int64x64_t & a, const int64_t d);
+};
+
+Int64x64FastPathTestCase::Int64x64FastPathTestCase ()
+  : TestCase ("Fast paths of the conversion from double and of the division")
+{}
+
+void
+Int64x64FastPathTestCase::CheckDouble (const double value)
+{
+  const int64x64_t result = int64x64_t (value);
+  const int64x64_t expect = int64x64_t ((long double)value);
+  NS_TEST_EXPECT_MSG_EQ (result.GetHigh (), expect.GetHigh (),
+                         "int64x64_t (double) high part of " << value);
+  NS_TEST_EXPECT_MSG_EQ (result.GetLow (), expect.GetLow (),
+                         "int64x64_t (double) low part of " << value);
+}
+
+void
+Int64x64FastPathTestCase::CheckDivide (const int64x64_t & a, const int64_t d)
+{
+  const bool negative = (a < 0) != (d < 0);
+  const int64x64_t ua = a < 0 ? -a : a;
+  const uint64_t ud = d < 0 ? -d : d;
+  const uint64_t hi = ua.GetHigh ();
+  const uint64_t lo = ua.GetLow ();
+  uint64_t quoHi = 0;
+  uint64_t quoLo = 0;
+  uint64_t rem = 0;
+  for (int i = 127; i >= 0; --i)
+    {
+      const uint64_t bit = i >= 64 ? (hi >> (i - 64)) & 1 : (lo >> i) & 1;
+      rem = (rem << 1) | bit;
+      if (rem >= ud)
+        {
+          rem -= ud;
+          if (i >= 64)
+            {
+              quoHi |= 1ULL << (i - 64);
+            }
+          else
+            {
+              quoLo |= 1ULL << i;
+            }
+        }
+    }
+  int64x64_t expect = int64x64_t (quoHi, quoLo);
+  expect = negative ? -expect : expect;
+  const int64x64_t result = a / int64x64_t (d);
+  NS_TEST_EXPECT_MSG_EQ (result, expect,
+                         "division of " << Printer (a) << " by " << d);
+}
+
+void
+Int64x64FastPathTestCase::DoRun (void)
+{
+  std::cout << std::endl;
+  std::cout << GetParent ()->GetName () << " Fast path: " << GetName ()
+            << std::endl;
+
+  // Valgrind uses 64-bit doubles for long doubles, see ns-3 bug 1882
+  if (RUNNING_ON_VALGRIND == 0)
+    {
+      const double values[] = {
+        0.0, -0.0, 1.0, -1.0, 0.5, 0.1, -0.1, 1.0 / 3, 2.0 / 3, 0.875,
+        1e-3, 1e-6, 1e-9, 1e-12, 1e-20, 5e-324, 1.5, -2.5, 1e9, 1e18,
+        -1e18, 9.2e18, 9.3e18, 4503599627370497.0, 9007199254740993.0
+      };
+      for (uint32_t i = 0; i < sizeof (values) / sizeof (values[0]); ++i)
+        {
+          CheckDouble (values[i]);
+        }
+      // Sweep the mantissas and exponents around the exact range
+      uint64_t seed = 1;
+      for (int exponent = -80; exponent <= 62; ++exponent)
+        {
+          for (uint32_t i = 0; i < 16; ++i)
+            {
+              seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+              const double mantissa = 1.0 + (seed >> 12) / 4503599627370496.0;
+              CheckDouble (std::ldexp (mantissa, exponent));
+              CheckDouble (-std::ldexp (mantissa, exponent));
+            }
+        }
+    }
+
+  // The long double implementation rounds the quotient
+  if (int64x64_t::implementation != int64x64_t::ld_impl)
+    {
+      const int64x64_t numerators[] = {
+        int64x64_t (0), int64x64_t (1), int64x64_t (3), int64x64_t (-7),
+        int64x64_t (1000000007), int64x64_t (4611686018427387903LL),
+        int64x64_t (-4611686018427387903LL), int64x64_t (0, 1),
+        int64x64_t (12, 0x8000000000000001ULL), int64x64_t (-12345, 987654321),
+        int64x64_t (0x7fffffffffffffffLL, 0xffffffffffffffffULL)
+      };
+      const int64_t divisors[] = {
+        1, -1, 2, 3, 7, 10, 1000, 1000000, -1000000, 1000000007,
+        4294967297LL, 4611686018427387907LL
+      };
+      for (uint32_t i = 0; i < sizeof (numerators) / sizeof (numerators[0]); ++i)
+        {
+          for (uint32_t j = 0; j < sizeof (divisors) / sizeof (divisors[0]); ++j)
+            {
+              CheckDivide (numerators[i], divisors[j]);
+            }
+        }
+    }
+}
+
+
 class Int64x64ImplTestCase : public TestCase
 {
 public:
@@ -1233,6 +1357,7 @@ public:
     AddTestCase (new Int64x64Bug1786TestCase (), TestCase::QUICK);
     AddTestCase (new Int64x64InvertTestCase (), TestCase::QUICK);
     AddTestCase (new Int64x64DoubleTestCase (), TestCase::QUICK);
+    AddTestCase (new Int64x64FastPathTestCase (), TestCase::QUICK);
   }
 }  g_int64x64TestSuite;
 
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup logging
+ * \ingroup logging-tests
+ * Log test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup logging-tests Logging tests
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+NS_LOG_COMPONENT_DEFINE ("LogTestSuite");
+
+/**
+ * \ingroup logging-tests
+ *
+ * Check the log levels enabled for a component.
+ */
+class LogLevelTestCase : public TestCase
+{
+public:
+  LogLevelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  std::streambuf *m_clog;    //!< The original buffer of std::clog.
+  std::ostringstream m_os;   //!< The log messages.
+};
+
+LogLevelTestCase::LogLevelTestCase ()
+  : TestCase ("Check the log levels enabled with and without prefixes"),
+    m_clog (0)
+{}
+
+void
+LogLevelTestCase::DoRun (void)
+{
+  m_clog = std::clog.rdbuf (m_os.rdbuf ());
+
+  LogComponentEnable ("LogTestSuite", LOG_PREFIX_TIME);
+  NS_TEST_EXPECT_MSG_EQ (g_log.IsNoneEnabled (), false, "A prefix is enabled");
+  NS_TEST_EXPECT_MSG_EQ (g_log.IsEnabled (LOG_PREFIX_TIME), true, "The time prefix is enabled");
+  NS_TEST_EXPECT_MSG_EQ (g_log.IsEnabled (LOG_LOGIC), false, "A prefix does not enable any level");
+  NS_TEST_EXPECT_MSG_EQ (g_log.IsEnabled (LOG_FUNCTION), false, "A prefix does not enable any level");
+  NS_LOG_LOGIC ("not printed");
+  NS_LOG_FUNCTION (this);
+  NS_TEST_EXPECT_MSG_EQ (m_os.str (), "", "Nothing is printed with only a prefix");
+
+  LogComponentDisable ("LogTestSuite", LOG_PREFIX_TIME);
+  LogComponentEnable ("LogTestSuite", LOG_LOGIC);
+  NS_TEST_EXPECT_MSG_EQ (g_log.IsEnabled (LOG_LOGIC), true, "The logic level is enabled");
+  NS_TEST_EXPECT_MSG_EQ (g_log.IsEnabled (LOG_FUNCTION), false, "The function level is not enabled");
+  NS_LOG_LOGIC ("printed " << 1);
+#ifdef NS3_LOG_ENABLE
+  NS_TEST_EXPECT_MSG_EQ (m_os.str (), "printed 1\n", "The logic message is printed");
+#endif
+}
+
+void
+LogLevelTestCase::DoTeardown (void)
+{
+  LogComponentDisable ("LogTestSuite", LOG_LEVEL_ALL);
+  LogComponentDisable ("LogTestSuite", LOG_PREFIX_ALL);
+  std::clog.rdbuf (m_clog);
+}
+
+/**
+ * \ingroup logging-tests
+ *
+ * Check the buffering of the log messages.
+ */
+class LogBufferTestCase : public TestCase
+{
+public:
+  LogBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  std::streambuf *m_clog;    //!< The original buffer of std::clog.
+  std::ostringstream m_os;   //!< The log messages.
+};
+
+LogBufferTestCase::LogBufferTestCase ()
+  : TestCase ("Check that buffered log messages are written on flush"),
+    m_clog (0)
+{}
+
+void
+LogBufferTestCase::DoRun (void)
+{
+  m_clog = std::clog.rdbuf (m_os.rdbuf ());
+  LogComponentEnable ("LogTestSuite", LOG_INFO);
+
+  LogSetBuffered (true);
+  NS_TEST_EXPECT_MSG_EQ (LogIsBuffered (), true, "The log messages are buffered");
+  NS_LOG_INFO ("first");
+  NS_LOG_INFO ("second");
+  NS_TEST_EXPECT_MSG_EQ (m_os.str (), "", "The messages are kept in the buffer");
+  std::clog.flush ();
+#ifdef NS3_LOG_ENABLE
+  NS_TEST_EXPECT_MSG_EQ (m_os.str (), "first\nsecond\n", "The messages are written on flush");
+#endif
+
+  NS_LOG_INFO ("third");
+  LogSetBuffered (false);
+  NS_TEST_EXPECT_MSG_EQ (LogIsBuffered (), false, "The log messages are not buffered");
+  NS_TEST_EXPECT_MSG_EQ ((std::clog.rdbuf () == m_os.rdbuf ()), true, "The stream buffer is restored");
+  NS_LOG_INFO ("fourth");
+#ifdef NS3_LOG_ENABLE
+  NS_TEST_EXPECT_MSG_EQ (m_os.str (), "first\nsecond\nthird\nfourth\n",
+                         "The pending messages are written when buffering is disabled");
+#endif
+}
+
+void
+LogBufferTestCase::DoTeardown (void)
+{
+  LogSetBuffered (false);
+  LogComponentDisable ("LogTestSuite", LOG_LEVEL_ALL);
+  LogComponentDisable ("LogTestSuite", LOG_PREFIX_ALL);
+  std::clog.rdbuf (m_clog);
+}
+
+/**
+ * \ingroup logging-tests
+ *
+ * Log test suite.
+ */
+class LogTestSuite : public TestSuite
+{
+public:
+  LogTestSuite ();
+};
+
+LogTestSuite::LogTestSuite ()
+  : TestSuite ("log", UNIT)
+{
+  AddTestCase (new LogLevelTestCase);
+  AddTestCase (new LogBufferTestCase);
+}
+
+/**
+ * \ingroup logging-tests
+ * LogTestSuite instance variable.
+ */
+static LogTestSuite g_logTestSuite;
+
+}  // namespace tests
+
+}  // namespace ns3
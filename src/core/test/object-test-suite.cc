@@ -402,6 +402,71 @@ AggregateObjectTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
 }
 
+/**
+ * \ingroup object-tests
+ * Test the lookup cache of the aggregated Objects.
+ */
+class AggregateObjectCacheTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  AggregateObjectCacheTestCase ();
+  /** Destructor. */
+  virtual ~AggregateObjectCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+AggregateObjectCacheTestCase::AggregateObjectCacheTestCase ()
+  : TestCase ("Check the lookup cache of the aggregated Objects")
+{}
+
+AggregateObjectCacheTestCase::~AggregateObjectCacheTestCase ()
+{}
+
+void
+AggregateObjectCacheTestCase::DoRun (void)
+{
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<BaseB> baseB = CreateObject<BaseB> ();
+  baseA->AggregateObject (baseB);
+
+  //
+  // The second lookup of a TypeId is answered by the cache.
+  //
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (BaseB::GetTypeId ()), baseB, "Cannot GetObject for BaseB");
+  uint64_t hits = Object::GetNCacheHits ();
+  uint64_t misses = Object::GetNCacheMisses ();
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (BaseB::GetTypeId ()), baseB, "Cached GetObject for BaseB");
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<BaseB> (BaseB::GetTypeId ()), baseB, "Cache shared by the aggregates");
+  NS_TEST_ASSERT_MSG_EQ (Object::GetNCacheHits (), hits + 2, "Lookups not answered by the cache");
+  NS_TEST_ASSERT_MSG_EQ (Object::GetNCacheMisses (), misses, "Lookups not answered by the cache");
+
+  //
+  // A failed lookup is cached too, until a new aggregation.
+  //
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedA> (DerivedA::GetTypeId ()), 0, "Unexpectedly found a DerivedA");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedA> (DerivedA::GetTypeId ()), 0, "Unexpectedly found a cached DerivedA");
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  baseB->AggregateObject (derivedA);
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedA> (DerivedA::GetTypeId ()), derivedA, "Cannot GetObject for the new DerivedA");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (BaseB::GetTypeId ()), baseB, "Cannot GetObject for BaseB after the aggregation");
+
+  //
+  // Both BaseA and DerivedA match BaseA:  this lookup is not cached, and
+  // returns the most accessed aggregate.
+  //
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<DerivedA> (DerivedA::GetTypeId ()), derivedA, "Cannot GetObject for DerivedA");
+    }
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseA> (BaseA::GetTypeId ()), derivedA, "BaseA lookup does not return the most accessed aggregate");
+  misses = Object::GetNCacheMisses ();
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseA> (BaseA::GetTypeId ()), derivedA, "Second BaseA lookup differs");
+  NS_TEST_ASSERT_MSG_EQ (Object::GetNCacheMisses (), misses + 1, "BaseA lookup answered by the cache");
+}
+
 /**
  * \ingroup object-tests
  * Test an Object factory can create Objects
@@ -491,6 +556,7 @@ ObjectTestSuite::ObjectTestSuite ()
 {
   AddTestCase (new CreateObjectTestCase);
   AddTestCase (new AggregateObjectTestCase);
+  AddTestCase (new AggregateObjectCacheTestCase);
   AddTestCase (new ObjectFactoryTestCase);
 }
 
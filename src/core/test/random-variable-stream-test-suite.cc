@@ -28,11 +28,15 @@
 #include <ctime>
 #include <fstream>
 #include <cmath>
+#include <sstream>
+#include <vector>
+#include <algorithm>
 
 #include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/integer.h"
+#include "ns3/object-factory.h"
 #include "ns3/test.h"
 #include "ns3/log.h"
 #include "ns3/rng-seed-manager.h"
@@ -2402,6 +2406,152 @@ EmpiricalAntitheticTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (valueMean, expectedMean, expectedMean * TOLERANCE, "Wrong mean value.");
 }
 
+/**
+ * Test case for the batch sampling of the random variable streams:
+ * GetValues must return the values of successive GetValue calls.
+ */
+class BatchTestCase : public TestCaseBase
+{
+public:
+  // Constructor
+  BatchTestCase ();
+
+private:
+  // Inherited
+  virtual void DoRun (void);
+
+  /**
+   * Compare the values of two random variables on the same stream, the
+   * first one sampled by GetValue and the second one by GetValues.
+   * \param [in] single The random variable sampled one value at a time.
+   * \param [in] batch The random variable sampled by batch.
+   * \param [in] name The name of the distribution.
+   */
+  void Compare (Ptr<RandomVariableStream> single,
+                Ptr<RandomVariableStream> batch,
+                std::string name);
+
+  /** Number of values to compare. */
+  static const uint32_t N_VALUES {2000};
+};
+
+BatchTestCase::BatchTestCase ()
+  : TestCaseBase ("Batch sampling of the Random Variable Streams")
+{}
+
+void
+BatchTestCase::Compare (Ptr<RandomVariableStream> single,
+                        Ptr<RandomVariableStream> batch,
+                        std::string name)
+{
+  single->SetStream (7);
+  batch->SetStream (7);
+  std::vector<double> values (N_VALUES);
+  // Batches of various sizes, including empty ones
+  uint32_t done = 0;
+  for (uint32_t size = 0; done < N_VALUES; ++size)
+    {
+      uint32_t n = std::min (size, N_VALUES - done);
+      batch->GetValues (&values[done], n);
+      done += n;
+    }
+  for (uint32_t i = 0; i < N_VALUES; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (values[i], single->GetValue (),
+                             name << " value " << i << " differs");
+    }
+}
+
+void
+BatchTestCase::DoRun (void)
+{
+  NS_LOG_FUNCTION (this);
+  SetTestSuiteSeed ();
+
+  for (uint32_t antithetic = 0; antithetic < 2; ++antithetic)
+    {
+      std::ostringstream oss;
+      oss << (antithetic ? " (antithetic)" : "");
+      std::string suffix = oss.str ();
+
+      Ptr<RandomVariableStream> x[2];
+      for (uint32_t j = 0; j < 2; ++j)
+        {
+          x[j] = CreateObjectWithAttributes<UniformRandomVariable> ("Min", DoubleValue (-3),
+                                                                    "Max", DoubleValue (5));
+          x[j]->SetAntithetic (antithetic);
+        }
+      Compare (x[0], x[1], "Uniform" + suffix);
+
+      for (uint32_t j = 0; j < 2; ++j)
+        {
+          x[j] = CreateObjectWithAttributes<ConstantRandomVariable> ("Constant", DoubleValue (4));
+          x[j]->SetAntithetic (antithetic);
+        }
+      Compare (x[0], x[1], "Constant" + suffix);
+
+      for (uint32_t j = 0; j < 2; ++j)
+        {
+          x[j] = CreateObjectWithAttributes<ExponentialRandomVariable> ("Mean", DoubleValue (2),
+                                                                        "Bound", DoubleValue (0));
+          x[j]->SetAntithetic (antithetic);
+        }
+      Compare (x[0], x[1], "Exponential" + suffix);
+
+      for (uint32_t j = 0; j < 2; ++j)
+        {
+          x[j] = CreateObjectWithAttributes<ExponentialRandomVariable> ("Mean", DoubleValue (2),
+                                                                        "Bound", DoubleValue (3));
+          x[j]->SetAntithetic (antithetic);
+        }
+      Compare (x[0], x[1], "Bounded exponential" + suffix);
+
+      for (uint32_t j = 0; j < 2; ++j)
+        {
+          x[j] = CreateObjectWithAttributes<ZipfRandomVariable> ("N", IntegerValue (500),
+                                                                 "Alpha", DoubleValue (1.2));
+          x[j]->SetAntithetic (antithetic);
+        }
+      Compare (x[0], x[1], "Zipf" + suffix);
+
+      for (uint32_t j = 0; j < 2; ++j)
+        {
+          x[j] = CreateObjectWithAttributes<NormalRandomVariable> ("Mean", DoubleValue (1),
+                                                                   "Variance", DoubleValue (2));
+          x[j]->SetAntithetic (antithetic);
+        }
+      Compare (x[0], x[1], "Normal" + suffix);
+
+      for (uint32_t interpolate = 0; interpolate < 2; ++interpolate)
+        {
+          for (uint32_t j = 0; j < 2; ++j)
+            {
+              Ptr<EmpiricalRandomVariable> e = CreateObject<EmpiricalRandomVariable> ();
+              e->SetInterpolate (interpolate);
+              e->CDF (1.0, 0.1);
+              e->CDF (5.0, 0.25);
+              e->CDF (10.0, 0.9);
+              e->CDF (20.0, 1.0);
+              e->SetAntithetic (antithetic);
+              x[j] = e;
+            }
+          Compare (x[0], x[1], (interpolate ? "Interpolated empirical" : "Empirical") + suffix);
+        }
+    }
+
+  // The Zipf probabilities follow the changes of the attributes
+  Ptr<ZipfRandomVariable> zipf = CreateObjectWithAttributes<ZipfRandomVariable> ("N", IntegerValue (10),
+                                                                                 "Alpha", DoubleValue (1.0));
+  double value = 0;
+  zipf->GetValues (&value, 1);
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (value, 10, "Zipf value out of range");
+  zipf->SetAttribute ("N", IntegerValue (1));
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (zipf->GetValue (), 1, "Zipf value with N=1");
+    }
+}
+
 /**
  * RandomVariableStream test suite, covering all random number variable
  * stream generator types.
@@ -2451,6 +2601,7 @@ RandomVariableSuite::RandomVariableSuite ()
   AddTestCase (new DeterministicTestCase);
   AddTestCase (new EmpiricalTestCase);
   AddTestCase (new EmpiricalAntitheticTestCase);
+  AddTestCase (new BatchTestCase);
 }
 
 static RandomVariableSuite randomVariableSuite;
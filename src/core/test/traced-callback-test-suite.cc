@@ -18,6 +18,9 @@
 
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/object.h"
 #include "ns3/unused.h"
 
 using namespace ns3;
@@ -67,6 +70,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   // these methods do is to set corresponding member variables m_one and m_two.
   //
   TracedCallback<uint8_t, double> trace;
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "No callback connected yet");
 
   //
   // Connect both callbacks to their respective test methods.  If we hit the
@@ -75,6 +79,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   //
   trace.ConnectWithoutContext (MakeCallback (&BasicTracedCallbackTestCase::CbOne, this));
   trace.ConnectWithoutContext (MakeCallback (&BasicTracedCallbackTestCase::CbTwo, this));
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), false, "Callbacks connected");
   m_one = false;
   m_two = false;
   trace (1, 2);
@@ -95,6 +100,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   // If we now disconnect callback two then neither callback should be called.
   //
   trace.DisconnectWithoutContext (MakeCallback (&BasicTracedCallbackTestCase::CbTwo, this));
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "All callbacks disconnected");
   m_one = false;
   m_two = false;
   trace (1, 2);
@@ -113,6 +119,114 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+/**
+ * Object whose trace source is chained to a traced value only once
+ * it is connected.
+ */
+class ChainedTraceObject : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ChainedTraceObject")
+      .SetParent<Object> ()
+      .AddTraceSource ("Value",
+                       "The value, chained to the internal traced value.",
+                       MakeTraceSourceAccessor (&ChainedTraceObject::m_trace,
+                                                &ChainedTraceObject::Chain),
+                       "ns3::TracedValueCallback::Uint32")
+    ;
+    return tid;
+  }
+  ChainedTraceObject ()
+    : m_chained (0)
+  {}
+  /** Chain the traced value to the trace source, if not done yet. */
+  void Chain (void)
+  {
+    m_chained++;
+    if (m_chained == 1)
+      {
+        m_value.ConnectWithoutContext (MakeCallback (&ChainedTraceObject::Forward, this));
+      }
+  }
+  /**
+   * Forward the changes of the traced value.
+   * \param oldValue The old value.
+   * \param newValue The new value.
+   */
+  void Forward (uint32_t oldValue, uint32_t newValue)
+  {
+    m_trace (oldValue, newValue);
+  }
+  TracedValue<uint32_t> m_value;               //!< The internal traced value
+  TracedCallback<uint32_t, uint32_t> m_trace;  //!< The trace source
+  uint32_t m_chained;                          //!< Number of connections notified
+};
+
+class NotifyingAccessorTestCase : public TestCase
+{
+public:
+  NotifyingAccessorTestCase ();
+  virtual ~NotifyingAccessorTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+
+  void Sink (uint32_t oldValue, uint32_t newValue);
+
+  uint32_t m_old;
+  uint32_t m_new;
+};
+
+NotifyingAccessorTestCase::NotifyingAccessorTestCase ()
+  : TestCase ("Check the trace source accessor notifying the connections")
+{}
+
+void
+NotifyingAccessorTestCase::Sink (uint32_t oldValue, uint32_t newValue)
+{
+  m_old = oldValue;
+  m_new = newValue;
+}
+
+void
+NotifyingAccessorTestCase::DoRun (void)
+{
+  Ptr<ChainedTraceObject> obj = CreateObject<ChainedTraceObject> ();
+
+  //
+  // Nothing is chained until the trace source is connected, yet the value
+  // is stored.
+  //
+  obj->m_value = 5;
+  NS_TEST_ASSERT_MSG_EQ (obj->m_chained, 0, "Unexpected notification");
+  NS_TEST_ASSERT_MSG_EQ (obj->m_value.Get (), 5, "Value not stored");
+
+  m_old = 0;
+  m_new = 0;
+  bool ok = obj->TraceConnectWithoutContext ("Value", MakeCallback (&NotifyingAccessorTestCase::Sink, this));
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Could not connect the trace source");
+  NS_TEST_ASSERT_MSG_EQ (obj->m_chained, 1, "Connection not notified");
+  obj->m_value = 7;
+  NS_TEST_ASSERT_MSG_EQ (m_old, 5, "Wrong old value");
+  NS_TEST_ASSERT_MSG_EQ (m_new, 7, "Wrong new value");
+
+  //
+  // Disconnecting is not notified and the sink is no longer called.
+  //
+  ok = obj->TraceDisconnectWithoutContext ("Value", MakeCallback (&NotifyingAccessorTestCase::Sink, this));
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Could not disconnect the trace source");
+  NS_TEST_ASSERT_MSG_EQ (obj->m_chained, 1, "Unexpected notification");
+  obj->m_value = 9;
+  NS_TEST_ASSERT_MSG_EQ (m_new, 7, "Sink unexpectedly called");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -123,6 +237,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new NotifyingAccessorTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
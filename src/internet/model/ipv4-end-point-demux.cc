@@ -22,6 +22,7 @@
 #include "ipv4-end-point.h"
 #include "ipv4-interface-address.h"
 #include "ns3/log.h"
+#include <algorithm>
 
 
 namespace ns3 {
@@ -40,23 +41,20 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_positions.clear ();
+  m_index.clear ();
+  m_ports.clear ();
 }
 
 bool
 Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort  () == port) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
@@ -85,8 +83,7 @@ Ipv4EndPointDemux::Allocate (void)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
+  Ipv4EndPoint *endPoint = Insert (new Ipv4EndPoint (Ipv4Address::GetAny (), port));
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -101,8 +98,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Ipv4EndPoint *endPoint = Insert (new Ipv4EndPoint (address, port));
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -124,8 +120,7 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv4Address address,
       NS_LOG_WARN ("Duplicated endpoint.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Ipv4EndPoint *endPoint = Insert (new Ipv4EndPoint (address, port));
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -136,21 +131,21 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  auto same = m_index.find (MakeFourTuple (localAddress, localPort, peerAddress, peerPort));
+  if (same != m_index.end ())
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress &&
-          ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+      for (Ipv4EndPoint *endPoint : same->second)
         {
-          NS_LOG_WARN ("Duplicated endpoint.");
-          return 0;
+          if (endPoint->GetBoundNetDevice () == boundNetDevice || endPoint->GetBoundNetDevice () == 0)
+            {
+              NS_LOG_WARN ("Duplicated endpoint.");
+              return 0;
+            }
         }
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
 
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
 
@@ -161,15 +156,21 @@ void
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  auto position = m_positions.find (endPoint);
+  if (position == m_positions.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
+    }
+  Unindex (endPoint);
+  auto port = m_ports.find (endPoint->GetLocalPort ());
+  if (--port->second == 0)
+    {
+      m_ports.erase (port);
     }
+  m_endPoints.erase (position->second);
+  m_positions.erase (position);
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -208,7 +209,47 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr << ":" << dport);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+
+  // Only the endpoints with a local address equal to daddr, to Any or to
+  // the network part of an address of the interface, and with a peer
+  // either equal to saddr:sport or to Any:0, can match: they are found
+  // through the index rather than by scanning all the endpoints.
+  std::vector<Ipv4Address> localAddresses;
+  localAddresses.push_back (daddr);
+  localAddresses.push_back (Ipv4Address::GetAny ());
+  if (incomingInterface)
+    {
+      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+        {
+          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+          localAddresses.push_back (addr.GetLocal ().CombineMask (addr.GetMask ()));
+        }
+    }
+  EndPoints candidates;
+  for (std::size_t i = 0; i < localAddresses.size (); i++)
+    {
+      if (std::find (localAddresses.begin (), localAddresses.begin () + i, localAddresses[i])
+          != localAddresses.begin () + i)
+        {
+          continue;
+        }
+      auto exact = m_index.find (MakeFourTuple (localAddresses[i], dport, saddr, sport));
+      if (exact != m_index.end ())
+        {
+          candidates.insert (candidates.end (), exact->second.begin (), exact->second.end ());
+        }
+      if (saddr == Ipv4Address::GetAny () && sport == 0)
+        {
+          continue;
+        }
+      auto wildcard = m_index.find (MakeFourTuple (localAddresses[i], dport, Ipv4Address::GetAny (), 0));
+      if (wildcard != m_index.end ())
+        {
+          candidates.insert (candidates.end (), wildcard->second.begin (), wildcard->second.end ());
+        }
+    }
+
+  for (EndPointsI i = candidates.begin (); i != candidates.end (); i++) 
     {
       Ipv4EndPoint* endP = *i;
 
@@ -377,6 +418,67 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
     }
   return generic;
 }
+bool
+Ipv4EndPointDemux::FourTuple::operator == (const FourTuple &other) const
+{
+  return localAddress == other.localAddress && peerAddress == other.peerAddress
+         && localPort == other.localPort && peerPort == other.peerPort;
+}
+
+std::size_t
+Ipv4EndPointDemux::FourTupleHash::operator () (const FourTuple &tuple) const
+{
+  uint64_t h = (static_cast<uint64_t> (tuple.localAddress) << 32) | tuple.peerAddress;
+  h ^= ((static_cast<uint64_t> (tuple.localPort) << 16) | tuple.peerPort) * 0x9e3779b97f4a7c15ULL;
+  return static_cast<std::size_t> (h ^ (h >> 29));
+}
+
+Ipv4EndPointDemux::FourTuple
+Ipv4EndPointDemux::MakeFourTuple (Ipv4Address localAddress, uint16_t localPort,
+                                  Ipv4Address peerAddress, uint16_t peerPort)
+{
+  FourTuple tuple;
+  tuple.localAddress = localAddress.Get ();
+  tuple.peerAddress = peerAddress.Get ();
+  tuple.localPort = localPort;
+  tuple.peerPort = peerPort;
+  return tuple;
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_positions[endPoint] = m_endPoints.insert (m_endPoints.end (), endPoint);
+  m_ports[endPoint->GetLocalPort ()]++;
+  endPoint->m_demux = this;
+  Index (endPoint);
+  return endPoint;
+}
+
+void
+Ipv4EndPointDemux::Index (Ipv4EndPoint *endPoint)
+{
+  FourTuple tuple = MakeFourTuple (endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                                   endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+  m_index[tuple].push_back (endPoint);
+}
+
+void
+Ipv4EndPointDemux::Unindex (Ipv4EndPoint *endPoint)
+{
+  FourTuple tuple = MakeFourTuple (endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                                   endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+  auto it = m_index.find (tuple);
+  NS_ASSERT (it != m_index.end ());
+  std::vector<Ipv4EndPoint *> &endPoints = it->second;
+  endPoints.erase (std::find (endPoints.begin (), endPoints.end (), endPoint));
+  if (endPoints.empty ())
+    {
+      m_index.erase (it);
+    }
+}
+
 uint16_t
 Ipv4EndPointDemux::AllocateEphemeralPort (void)
 {
@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
+#include <unordered_map>
 #include "ns3/ipv4-address.h"
 #include "ipv4-interface.h"
 
@@ -40,6 +42,10 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are also indexed by their four-tuple, kept up to date by
+ * the endpoints when their addresses change, so that the lookups of a
+ * server with many connections on the same port do not scan all of them.
  */
 
 class Ipv4EndPointDemux {
@@ -166,6 +172,68 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief The four-tuple of an end point, key of the index.
+   */
+  struct FourTuple
+  {
+    uint32_t localAddress; //!< Local address
+    uint32_t peerAddress;  //!< Peer address
+    uint16_t localPort;    //!< Local port
+    uint16_t peerPort;     //!< Peer port
+
+    /**
+     * \brief Equality operator.
+     * \param [in] other The other four-tuple.
+     * \return true if the four-tuples are equal.
+     */
+    bool operator == (const FourTuple &other) const;
+  };
+
+  /**
+   * \brief Hash function of the four-tuples.
+   */
+  struct FourTupleHash
+  {
+    /**
+     * \brief Hash a four-tuple.
+     * \param [in] tuple The four-tuple.
+     * \return The hash.
+     */
+    std::size_t operator () (const FourTuple &tuple) const;
+  };
+
+  /**
+   * \brief Make a four-tuple.
+   * \param localAddress local address
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return the four-tuple
+   */
+  static FourTuple MakeFourTuple (Ipv4Address localAddress, uint16_t localPort,
+                                  Ipv4Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Add an end point to the list and to the indexes.
+   * \param endPoint the end point
+   * \return the end point
+   */
+  Ipv4EndPoint *Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Index an end point by its current four-tuple.
+   * \param endPoint the end point
+   */
+  void Index (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the index of its current four-tuple.
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv4EndPoint *endPoint);
 
   /**
    * \brief Allocate an ephemeral port.
@@ -192,6 +260,21 @@ private:
    * \brief A list of IPv4 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The position of the end points in the list.
+   */
+  std::unordered_map<Ipv4EndPoint *, EndPointsI> m_positions;
+
+  /**
+   * \brief The end points, by four-tuple.
+   */
+  std::unordered_map<FourTuple, std::vector<Ipv4EndPoint *>, FourTupleHash> m_index;
+
+  /**
+   * \brief The number of end points, by local port.
+   */
+  std::unordered_map<uint16_t, uint32_t> m_ports;
 };
 
 } // namespace ns3
@@ -510,15 +510,14 @@ private:
 
   /**
    * \brief Make a copy of the packet, add the header and invoke the TX trace callback
+   *
+   * Nothing is done if no callback is connected to the TX trace.
+   *
    * \param ipHeader the IP header that will be added to the packet
    * \param packet the packet
-   * \param ipv6 the Ipv6 protocol
    * \param interface the interface index
-   *
-   * Note: If the TracedCallback API ever is extended, we could consider
-   * to check for connected functions before adding the header
    */
-  void CallTxTrace (const Ipv6Header & ipHeader, Ptr<Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface);
+  void CallTxTrace (const Ipv6Header & ipHeader, Ptr<Packet> packet, uint32_t interface);
 
   /**
    * \brief Callback to trace TX (transmission) packets.
@@ -161,6 +161,7 @@ TcpL4Protocol::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_sockets.clear ();
+  m_socketSet.clear ();
 
   if (m_endPoints != 0)
     {
@@ -209,6 +210,7 @@ TcpL4Protocol::CreateSocket (TypeId congestionTypeId, TypeId recoveryTypeId)
   socket->SetRecoveryAlgorithm (recovery);
 
   m_sockets.push_back (socket);
+  m_socketSet.insert (PeekPointer (socket));
   return socket;
 }
 
@@ -706,16 +708,11 @@ void
 TcpL4Protocol::AddSocket (Ptr<TcpSocketBase> socket)
 {
   NS_LOG_FUNCTION (this << socket);
-  std::vector<Ptr<TcpSocketBase> >::iterator it = m_sockets.begin ();
-
-  while (it != m_sockets.end ())
+  // A socket is added by each Bind and by each connection accepted: check
+  // the membership without scanning the list.
+  if (!m_socketSet.insert (PeekPointer (socket)).second)
     {
-      if (*it == socket)
-        {
-          return;
-        }
-
-      ++it;
+      return;
     }
 
   m_sockets.push_back (socket);
@@ -725,6 +722,10 @@ bool
 TcpL4Protocol::RemoveSocket (Ptr<TcpSocketBase> socket)
 {
   NS_LOG_FUNCTION (this << socket);
+  if (m_socketSet.erase (PeekPointer (socket)) == 0)
+    {
+      return false;
+    }
   std::vector<Ptr<TcpSocketBase> >::iterator it = m_sockets.begin ();
 
   while (it != m_sockets.end ())
@@ -131,7 +131,7 @@ public:
    */
   struct TcpRateSample
   {
-    DataRate      m_deliveryRate   {DataRate ("0bps")};//!< The delivery rate sample
+    DataRate      m_deliveryRate   {DataRate (0)};     //!< The delivery rate sample
     bool          m_isAppLimited   {false};            //!< Indicates whether the rate sample is application-limited
     Time          m_interval       {Seconds (0.0)};    //!< The length of the sampling interval
     int32_t       m_delivered      {0};                //!< The amount of data marked as delivered over the sampling interval
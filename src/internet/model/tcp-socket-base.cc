@@ -43,6 +43,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/data-rate.h"
 #include "ns3/object.h"
+#include "ns3/unused.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
 #include "ipv4-end-point.h"
@@ -154,15 +155,18 @@ TcpSocketBase::GetTypeId (void)
                      "ns3::TracedValueCallback::Time")
     .AddTraceSource ("RTT",
                      "Last RTT sample",
-                     MakeTraceSourceAccessor (&TcpSocketBase::m_lastRttTrace),
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_lastRttTrace,
+                                              &TcpSocketBase::ConnectTcbTraces),
                      "ns3::TracedValueCallback::Time")
     .AddTraceSource ("NextTxSequence",
                      "Next sequence number to send (SND.NXT)",
-                     MakeTraceSourceAccessor (&TcpSocketBase::m_nextTxSequenceTrace),
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_nextTxSequenceTrace,
+                                              &TcpSocketBase::ConnectTcbTraces),
                      "ns3::SequenceNumber32TracedValueCallback")
     .AddTraceSource ("HighestSequence",
                      "Highest sequence number ever sent in socket's life time",
-                     MakeTraceSourceAccessor (&TcpSocketBase::m_highTxMarkTrace),
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_highTxMarkTrace,
+                                              &TcpSocketBase::ConnectTcbTraces),
                      "ns3::TracedValueCallback::SequenceNumber32")
     .AddTraceSource ("State",
                      "TCP state",
@@ -170,11 +174,13 @@ TcpSocketBase::GetTypeId (void)
                      "ns3::TcpStatesTracedValueCallback")
     .AddTraceSource ("CongState",
                      "TCP Congestion machine state",
-                     MakeTraceSourceAccessor (&TcpSocketBase::m_congStateTrace),
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_congStateTrace,
+                                              &TcpSocketBase::ConnectTcbTraces),
                      "ns3::TcpSocketState::TcpCongStatesTracedValueCallback")
     .AddTraceSource ("EcnState",
                      "Trace ECN state change of socket",
-                     MakeTraceSourceAccessor (&TcpSocketBase::m_ecnStateTrace),
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_ecnStateTrace,
+                                              &TcpSocketBase::ConnectTcbTraces),
                      "ns3::TcpSocketState::EcnStatesTracedValueCallback")
     .AddTraceSource ("AdvWND",
                      "Advertised Window Size",
@@ -186,7 +192,8 @@ TcpSocketBase::GetTypeId (void)
                      "ns3::TracedValueCallback::Uint32")
     .AddTraceSource ("BytesInFlight",
                      "Socket estimation of bytes in flight",
-                     MakeTraceSourceAccessor (&TcpSocketBase::m_bytesInFlightTrace),
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_bytesInFlightTrace,
+                                              &TcpSocketBase::ConnectTcbTraces),
                      "ns3::TracedValueCallback::Uint32")
     .AddTraceSource ("HighestRxSequence",
                      "Highest sequence number received from peer",
@@ -198,19 +205,23 @@ TcpSocketBase::GetTypeId (void)
                      "ns3::TracedValueCallback::SequenceNumber32")
     .AddTraceSource ("PacingRate",
                      "The current TCP pacing rate",
-                     MakeTraceSourceAccessor (&TcpSocketBase::m_pacingRateTrace),
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_pacingRateTrace,
+                                              &TcpSocketBase::ConnectTcbTraces),
                      "ns3::TracedValueCallback::DataRate")
     .AddTraceSource ("CongestionWindow",
                      "The TCP connection's congestion window",
-                     MakeTraceSourceAccessor (&TcpSocketBase::m_cWndTrace),
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_cWndTrace,
+                                              &TcpSocketBase::ConnectTcbTraces),
                      "ns3::TracedValueCallback::Uint32")
     .AddTraceSource ("CongestionWindowInflated",
                      "The TCP connection's congestion window inflates as in older RFC",
-                     MakeTraceSourceAccessor (&TcpSocketBase::m_cWndInflTrace),
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_cWndInflTrace,
+                                              &TcpSocketBase::ConnectTcbTraces),
                      "ns3::TracedValueCallback::Uint32")
     .AddTraceSource ("SlowStartThreshold",
                      "TCP slow start threshold (bytes)",
-                     MakeTraceSourceAccessor (&TcpSocketBase::m_ssThTrace),
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_ssThTrace,
+                                              &TcpSocketBase::ConnectTcbTraces),
                      "ns3::TracedValueCallback::Uint32")
     .AddTraceSource ("Tx",
                      "Send tcp packet to IP protocol",
@@ -257,48 +268,6 @@ TcpSocketBase::TcpSocketBase (void)
   m_pacingTimer.SetFunction (&TcpSocketBase::NotifyPacingPerformed, this);
 
   m_tcb->m_sendEmptyPacketCallback = MakeCallback (&TcpSocketBase::SendEmptyPacket, this);
-
-  bool ok;
-
-  ok = m_tcb->TraceConnectWithoutContext ("PacingRate",
-                                          MakeCallback (&TcpSocketBase::UpdatePacingRateTrace, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("CongestionWindow",
-                                          MakeCallback (&TcpSocketBase::UpdateCwnd, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("CongestionWindowInflated",
-                                          MakeCallback (&TcpSocketBase::UpdateCwndInfl, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("SlowStartThreshold",
-                                          MakeCallback (&TcpSocketBase::UpdateSsThresh, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("CongState",
-                                          MakeCallback (&TcpSocketBase::UpdateCongState, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("EcnState",
-                                          MakeCallback (&TcpSocketBase::UpdateEcnState, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("NextTxSequence",
-                                          MakeCallback (&TcpSocketBase::UpdateNextTxSequence, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("HighestSequence",
-                                          MakeCallback (&TcpSocketBase::UpdateHighTxMark, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("BytesInFlight",
-                                          MakeCallback (&TcpSocketBase::UpdateBytesInFlight, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("RTT",
-                                          MakeCallback (&TcpSocketBase::UpdateRtt, this));
-  NS_ASSERT (ok == true);
 }
 
 TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
@@ -393,46 +362,8 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
       m_tcb->m_sendEmptyPacketCallback = MakeCallback (&TcpSocketBase::SendEmptyPacket, this);
     }
 
-  bool ok;
-
-  ok = m_tcb->TraceConnectWithoutContext ("PacingRate",
-                                          MakeCallback (&TcpSocketBase::UpdatePacingRateTrace, this));
-
-  ok = m_tcb->TraceConnectWithoutContext ("CongestionWindow",
-                                          MakeCallback (&TcpSocketBase::UpdateCwnd, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("CongestionWindowInflated",
-                                          MakeCallback (&TcpSocketBase::UpdateCwndInfl, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("SlowStartThreshold",
-                                          MakeCallback (&TcpSocketBase::UpdateSsThresh, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("CongState",
-                                          MakeCallback (&TcpSocketBase::UpdateCongState, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("EcnState",
-                                          MakeCallback (&TcpSocketBase::UpdateEcnState, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("NextTxSequence",
-                                          MakeCallback (&TcpSocketBase::UpdateNextTxSequence, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("HighestSequence",
-                                          MakeCallback (&TcpSocketBase::UpdateHighTxMark, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("BytesInFlight",
-                                          MakeCallback (&TcpSocketBase::UpdateBytesInFlight, this));
-  NS_ASSERT (ok == true);
-
-  ok = m_tcb->TraceConnectWithoutContext ("RTT",
-                                          MakeCallback (&TcpSocketBase::UpdateRtt, this));
-  NS_ASSERT (ok == true);
+  // chain the new TcpSocketState to the trace sources copied from sock
+  ConnectTcbTraces ();
 }
 
 TcpSocketBase::~TcpSocketBase (void)
@@ -4379,6 +4310,44 @@ TcpSocketBase::UpdateRtt (Time oldValue, Time newValue)
   m_lastRttTrace (oldValue, newValue);
 }
 
+void
+TcpSocketBase::ConnectTcbTraces (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  auto chain = [this] (uint16_t bit, bool connected, std::string name, const CallbackBase &cb)
+    {
+      if (connected && (m_tcbTraces & (1 << bit)) == 0)
+        {
+          bool ok = m_tcb->TraceConnectWithoutContext (name, cb);
+          NS_ASSERT (ok == true);
+          NS_UNUSED (ok);
+          m_tcbTraces |= (1 << bit);
+        }
+    };
+
+  chain (0, !m_pacingRateTrace.IsEmpty (), "PacingRate",
+         MakeCallback (&TcpSocketBase::UpdatePacingRateTrace, this));
+  chain (1, !m_cWndTrace.IsEmpty (), "CongestionWindow",
+         MakeCallback (&TcpSocketBase::UpdateCwnd, this));
+  chain (2, !m_cWndInflTrace.IsEmpty (), "CongestionWindowInflated",
+         MakeCallback (&TcpSocketBase::UpdateCwndInfl, this));
+  chain (3, !m_ssThTrace.IsEmpty (), "SlowStartThreshold",
+         MakeCallback (&TcpSocketBase::UpdateSsThresh, this));
+  chain (4, !m_congStateTrace.IsEmpty (), "CongState",
+         MakeCallback (&TcpSocketBase::UpdateCongState, this));
+  chain (5, !m_ecnStateTrace.IsEmpty (), "EcnState",
+         MakeCallback (&TcpSocketBase::UpdateEcnState, this));
+  chain (6, !m_nextTxSequenceTrace.IsEmpty (), "NextTxSequence",
+         MakeCallback (&TcpSocketBase::UpdateNextTxSequence, this));
+  chain (7, !m_highTxMarkTrace.IsEmpty (), "HighestSequence",
+         MakeCallback (&TcpSocketBase::UpdateHighTxMark, this));
+  chain (8, !m_bytesInFlightTrace.IsEmpty (), "BytesInFlight",
+         MakeCallback (&TcpSocketBase::UpdateBytesInFlight, this));
+  chain (9, !m_lastRttTrace.IsEmpty (), "RTT",
+         MakeCallback (&TcpSocketBase::UpdateRtt, this));
+}
+
 void
 TcpSocketBase::SetCongestionControlAlgorithm (Ptr<TcpCongestionOps> algo)
 {
@@ -448,6 +448,17 @@ public:
    */
   void UpdateRtt (Time oldValue, Time newValue);
 
+  /**
+   * \brief Chain the TcpSocketState traced values to the connected trace
+   * sources of the socket
+   *
+   * The changes of the TcpSocketState traced values are forwarded only to
+   * the trace sources of the socket having at least a callback connected,
+   * so that the unconnected ones do not cost a callback invocation.
+   * This is invoked every time a callback is connected to such sources.
+   */
+  void ConnectTcbTraces (void);
+
   /**
    * \brief Install a congestion control algorithm on this socket
    *
@@ -1329,6 +1340,7 @@ protected:
 
   // Transmission Control Block
   Ptr<TcpSocketState>    m_tcb;               //!< Congestion control information
+  uint16_t               m_tcbTraces {0};     //!< TcpSocketState traced values already chained (bitmap)
   Ptr<TcpCongestionOps>  m_congestionControl; //!< Congestion control
   Ptr<TcpRecoveryOps>    m_recoveryOps;       //!< Recovery Algorithm
   Ptr<TcpRateOps>        m_rateOps;           //!< Rate operations
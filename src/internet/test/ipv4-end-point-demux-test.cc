@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4EndPointDemux lookups of a server with many connections.
+ *
+ * The lookups go through the index of the endpoints by four-tuple, which
+ * must follow the changes of the addresses of the endpoints.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Lookup the endpoint of a packet.
+   * \param demux The demux.
+   * \param daddr The destination address.
+   * \param dport The destination port.
+   * \param saddr The source address.
+   * \param sport The source port.
+   * \return The endpoint found, or 0 if none or more than one.
+   */
+  Ipv4EndPoint *Lookup (Ipv4EndPointDemux &demux, Ipv4Address daddr, uint16_t dport,
+                        Ipv4Address saddr, uint16_t sport);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Ipv4EndPointDemux lookups through the four-tuple index")
+{}
+
+Ipv4EndPoint *
+Ipv4EndPointDemuxTestCase::Lookup (Ipv4EndPointDemux &demux, Ipv4Address daddr, uint16_t dport,
+                                   Ipv4Address saddr, uint16_t sport)
+{
+  Ipv4EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, 0);
+  return endPoints.size () == 1 ? endPoints.front () : 0;
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv4EndPointDemux demux;
+  Ipv4Address server ("10.1.1.1");
+  Ipv4Address client ("10.1.1.2");
+
+  Ipv4EndPoint *listener = demux.Allocate (0, 80);
+  NS_TEST_ASSERT_MSG_NE (listener, 0, "Could not allocate the listener");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (80), true, "Port 80 not in use");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (81), false, "Port 81 in use");
+
+  // The connections accepted by the listener
+  std::vector<Ipv4EndPoint *> connections;
+  for (uint16_t port = 1000; port < 1100; port++)
+    {
+      Ipv4EndPoint *connection = demux.Allocate (0, server, 80, client, port);
+      NS_TEST_ASSERT_MSG_NE (connection, 0, "Could not allocate a connection");
+      connections.push_back (connection);
+    }
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (0, server, 80, client, 1000), 0,
+                         "Allocated a duplicated connection");
+
+  for (uint16_t port = 1000; port < 1100; port++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (Lookup (demux, server, 80, client, port), connections[port - 1000],
+                             "Packet not delivered to its connection");
+    }
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, server, 80, client, 2000), listener,
+                         "SYN not delivered to the listener");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, server, 81, client, 1000), 0,
+                         "Packet delivered to a closed port");
+
+  // A connection closed: its packets go to the listener again
+  demux.DeAllocate (connections[10]);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, server, 80, client, 1010), listener,
+                         "Packet delivered to a closed connection");
+
+  // An endpoint of a client, connected once allocated
+  Ipv4EndPoint *active = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_NE (active, 0, "Could not allocate an ephemeral port");
+  uint16_t ephemeral = active->GetLocalPort ();
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (ephemeral), true, "Ephemeral port not in use");
+  active->SetPeer (server, 8080);
+  active->SetLocalAddress (client);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, client, ephemeral, server, 8080), active,
+                         "Packet not delivered to the connected endpoint");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, client, ephemeral, server, 8081), 0,
+                         "Packet delivered to the endpoint connected to another peer");
+  active->SetPeer (server, 8081);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, client, ephemeral, server, 8080), 0,
+                         "Packet delivered to the endpoint of the former peer");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, client, ephemeral, server, 8081), active,
+                         "Packet not delivered to the endpoint of the new peer");
+  demux.DeAllocate (active);
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (ephemeral), false, "Ephemeral port still in use");
+  NS_TEST_ASSERT_MSG_EQ (demux.GetAllEndPoints ().size (), 100, "Wrong number of endpoints");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4EndPointDemux TestSuite
+ */
+class Ipv4EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  Ipv4EndPointDemuxTestSuite () : TestSuite ("ipv4-end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+  }
+};
+
+static Ipv4EndPointDemuxTestSuite g_ipv4EndPointDemuxTestSuite; //!< Static variable for test initialization
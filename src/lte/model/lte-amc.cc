@@ -381,10 +381,18 @@ LteAmc::CreateCqiFeedbacks (const SpectrumValue& sinr, uint8_t rbgSize)
          {
             uint8_t mcs = 0;
             TbStats_t tbStats;
+            // the MI of the RBG only depends on the modulation of the MCS,
+            // so it is computed once per modulation
+            double mib[3] = { -1, -1, -1 };
+            HarqProcessInfoList_t harqInfoList;
             while (mcs <= 28)
               {
-                HarqProcessInfoList_t harqInfoList;
-                tbStats = LteMiErrorModel::GetTbDecodificationStats (sinr, rbgMap, (uint16_t)GetDlTbSizeFromMcs (mcs, rbgSize) / 8, mcs, harqInfoList);
+                int modulation = (mcs <= MI_QPSK_MAX_ID) ? 0 : ((mcs <= MI_16QAM_MAX_ID) ? 1 : 2);
+                if (mib[modulation] < 0)
+                  {
+                    mib[modulation] = LteMiErrorModel::Mib (sinr, rbgMap, mcs);
+                  }
+                tbStats = LteMiErrorModel::GetTbDecodificationStats (mib[modulation], (uint16_t)GetDlTbSizeFromMcs (mcs, rbgSize) / 8, mcs, harqInfoList);
                 if (tbStats.tbler > 0.1)
                   {
                     break;
@@ -147,6 +147,9 @@ protected:
                                        * m_TotalPower
                                        */
 
+  SpectrumValue m_interf; ///< interference and noise of the last chunk, reused by each chunk
+  SpectrumValue m_sinr; ///< SINR of the last chunk, reused by each chunk
+
   uint32_t m_lastSignalId {0}; ///< the last signal ID
   uint32_t m_lastSignalIdBeforeReset {0}; ///< the last signal ID before reset
 
@@ -153,6 +153,7 @@ PfFfMacScheduler::DoCschedCellConfigReq (const struct FfMacCschedSapProvider::Cs
   // Read the subset of parameters used
   m_cschedCellConfig = params;
   m_rachAllocationMap.resize (m_cschedCellConfig.m_ulBandwidth, 0);
+  UpdateDlRbgRates (GetRbgSize (m_cschedCellConfig.m_dlBandwidth));
   FfMacCschedSapUser::CschedUeConfigCnfParameters cnf;
   cnf.m_result = SUCCESS;
   m_cschedSapUser->CschedUeConfigCnf (cnf);
@@ -354,24 +355,35 @@ PfFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
   std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
   unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
+  for (it = m_rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0));
+       it != m_rlcBufferReq.end () && (*it).first.m_rnti == rnti; it++)
     {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
+      if (((*it).second.m_rlcTransmissionQueueSize > 0)
+          || ((*it).second.m_rlcRetransmissionQueueSize > 0)
+          || ((*it).second.m_rlcStatusPduSize > 0))
         {
           lcActive++;
         }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
     }
   return (lcActive);
 
 }
 
 
+void
+PfFfMacScheduler::UpdateDlRbgRates (int rbgSize)
+{
+  NS_LOG_FUNCTION (this << rbgSize);
+  m_dlRbgRates.resize (16);
+  for (int cqi = 0; cqi < 16; cqi++)
+    {
+      uint8_t mcs = m_amc->GetMcsFromCqi (cqi);
+      m_dlRbgRates[cqi] = ((m_amc->GetDlTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001);   // = TB size / TTI
+    }
+  m_dlRbgRateNoSubband = ((m_amc->GetDlTbSizeFromMcs (0, rbgSize) / 8) / 0.001);
+}
+
+
 uint8_t
 PfFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
@@ -920,116 +932,130 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
 
 
 
+  // Collect once the UEs which may get RBGs in this TTI, in the order of
+  // the flows, so that the loop over the RBGs only computes their metrics
+  std::vector <pfsDlCandidate_t> candidates;
+  candidates.reserve (m_flowStatsDl.size ());
+  for (std::map <uint16_t, pfsFlowPerf_t>::iterator it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+    {
+      std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
+      bool harqAvailable = HarqProcessAvailability ((*it).first);
+      if ((itRnti != rntiAllocated.end ())||(!harqAvailable))
+        {
+          // UE already allocated for HARQ or without HARQ process available -> drop it
+          if (itRnti != rntiAllocated.end ())
+            {
+              NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
+            }
+          if (!harqAvailable)
+            {
+              NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
+            }
+          continue;
+        }
+      std::map <uint16_t,uint8_t>::iterator itTxMode;
+      itTxMode = m_uesTxMode.find ((*it).first);
+      if (itTxMode == m_uesTxMode.end ())
+        {
+          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
+        }
+      if (LcActivePerFlow ((*it).first) == 0)
+        {
+          // this UE has no data to transmit
+          continue;
+        }
+      pfsDlCandidate_t candidate;
+      candidate.flow = it;
+      candidate.nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+      std::map <uint16_t,SbMeasResult_s>::iterator itCqi = m_a30CqiRxed.find ((*it).first);
+      candidate.sbCqi = itCqi == m_a30CqiRxed.end () ? 0 : &(*itCqi).second.m_higherLayerSelected;
+      candidates.push_back (candidate);
+    }
+
   for (int i = 0; i < rbgNum; i++)
     {
       NS_LOG_INFO (this << " ALLOCATION for RBG " << i << " of " << rbgNum);
       if (rbgMap.at (i) == false)
         {
-          std::map <uint16_t, pfsFlowPerf_t>::iterator it;
-          std::map <uint16_t, pfsFlowPerf_t>::iterator itMax = m_flowStatsDl.end ();
+          std::vector <pfsDlCandidate_t>::const_iterator it;
+          std::vector <pfsDlCandidate_t>::const_iterator itMax = candidates.end ();
           double rcqiMax = 0.0;
-          for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+          for (it = candidates.begin (); it != candidates.end (); it++)
             {
-              if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, (*it).first)) == false)
+              uint16_t rnti = (*(*it).flow).first;
+              if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, rnti)) == false)
                 continue;
 
-              std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-              if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
+              double achievableRate = 0.0;
+              if ((*it).sbCqi == 0)
                 {
-                  // UE already allocated for HARQ or without HARQ process available -> drop it
-                  if (itRnti != rntiAllocated.end ())
+                  // start with lowest value
+                  for (uint8_t k = 0; k < (*it).nLayer; k++)
                     {
-                      NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
+                      achievableRate += m_dlRbgRates.at (1);
                     }
-                  if (!HarqProcessAvailability ((*it).first))
-                    {
-                      NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
-                    }
-                  continue;
                 }
-              std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-              itCqi = m_a30CqiRxed.find ((*it).first);
-              std::map <uint16_t,uint8_t>::iterator itTxMode;
-              itTxMode = m_uesTxMode.find ((*it).first);
-              if (itTxMode == m_uesTxMode.end ())
-                {
-                  NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                }
-              int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-              std::vector <uint8_t> sbCqi;
-              if (itCqi == m_a30CqiRxed.end ())
+              else
                 {
-                  for (uint8_t k = 0; k < nLayer; k++)
+                  const std::vector <uint8_t> &sbCqi = (*it).sbCqi->at (i).m_sbCqi;
+                  uint8_t cqi1 = sbCqi.at (0);
+                  uint8_t cqi2 = 0;
+                  if (sbCqi.size () > 1)
                     {
-                      sbCqi.push_back (1);  // start with lowest value
+                      cqi2 = sbCqi.at (1);
                     }
-                }
-              else
-                {
-                  sbCqi = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                }
-              uint8_t cqi1 = sbCqi.at (0);
-              uint8_t cqi2 = 0;
-              if (sbCqi.size () > 1)
-                {
-                  cqi2 = sbCqi.at (1);
-                }
-
-              if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-                {
-                  if (LcActivePerFlow ((*it).first) > 0)
+                  if ((cqi1 == 0)&&(cqi2 == 0))
                     {
-                      // this UE has data to transmit
-                      double achievableRate = 0.0;
-                      uint8_t mcs = 0;
-                      for (uint8_t k = 0; k < nLayer; k++)
+                      // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+                      continue;
+                    }
+                  for (uint8_t k = 0; k < (*it).nLayer; k++)
+                    {
+                      if (sbCqi.size () > k)
                         {
-                          if (sbCqi.size () > k)
-                            {
-                              mcs = m_amc->GetMcsFromCqi (sbCqi.at (k));
-                            }
-                          else
-                            {
-                              // no info on this subband -> worst MCS
-                              mcs = 0;
-                            }
-                          achievableRate += ((m_amc->GetDlTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001);   // = TB size / TTI
+                          achievableRate += m_dlRbgRates.at (sbCqi.at (k));
                         }
-
-                      double rcqi = achievableRate / (*it).second.lastAveragedThroughput;
-                      NS_LOG_INFO (this << " RNTI " << (*it).first << " MCS " << (uint32_t)mcs << " achievableRate " << achievableRate << " avgThr " << (*it).second.lastAveragedThroughput << " RCQI " << rcqi);
-
-                      if (rcqi > rcqiMax)
+                      else
                         {
-                          rcqiMax = rcqi;
-                          itMax = it;
+                          // no info on this subband -> worst MCS
+                          achievableRate += m_dlRbgRateNoSubband;
                         }
                     }
-                }   // end if cqi
-            } // end for m_rlcBufferReq
+                }
+
+              double rcqi = achievableRate / (*(*it).flow).second.lastAveragedThroughput;
+              NS_LOG_INFO (this << " RNTI " << rnti << " achievableRate " << achievableRate << " avgThr " << (*(*it).flow).second.lastAveragedThroughput << " RCQI " << rcqi);
+
+              if (rcqi > rcqiMax)
+                {
+                  rcqiMax = rcqi;
+                  itMax = it;
+                }
+            } // end for candidates
 
-          if (itMax == m_flowStatsDl.end ())
+          if (itMax == candidates.end ())
             {
               // no UE available for this RB
               NS_LOG_INFO (this << " any UE found");
             }
           else
             {
+              uint16_t rntiMax = (*(*itMax).flow).first;
               rbgMap.at (i) = true;
               std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
-              itMap = allocationMap.find ((*itMax).first);
+              itMap = allocationMap.find (rntiMax);
               if (itMap == allocationMap.end ())
                 {
                   // insert new element
                   std::vector <uint16_t> tempMap;
                   tempMap.push_back (i);
-                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > ((*itMax).first, tempMap));
+                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > (rntiMax, tempMap));
                 }
               else
                 {
                   (*itMap).second.push_back (i);
                 }
-              NS_LOG_INFO (this << " UE assigned " << (*itMax).first);
+              NS_LOG_INFO (this << " UE assigned " << rntiMax);
             }
         } // end for RBG free
     } // end for RBGs
@@ -61,6 +61,14 @@ struct pfsFlowPerf_t
   double lastAveragedThroughput; ///< last averaged throughput
 };
 
+/// pfsDlCandidate_t structure: a UE which may get RBGs in the current TTI
+struct pfsDlCandidate_t
+{
+  std::map <uint16_t, pfsFlowPerf_t>::iterator flow; ///< flow stats of the UE
+  const std::vector <HigherLayerSelected_s> *sbCqi; ///< A30 CQI per RBG, or 0 if none
+  int nLayer; ///< number of layers of the UE
+};
+
 
 /**
  * \ingroup ff-api
@@ -254,6 +262,13 @@ private:
    */
   unsigned int LcActivePerFlow (uint16_t rnti);
 
+  /**
+   * \brief Compute the achievable rates of an RBG for each CQI
+   *
+   * \param rbgSize the RBG size
+   */
+  void UpdateDlRbgRates (int rbgSize);
+
   /**
    * \brief Estimate UL SINR
    *
@@ -383,6 +398,9 @@ private:
 
   uint32_t m_cqiTimersThreshold; ///< # of TTIs for which a CQI can be considered valid
 
+  std::vector <double> m_dlRbgRates; ///< achievable rate of an RBG per CQI, in bytes/s
+  double m_dlRbgRateNoSubband; ///< achievable rate of an RBG with MCS 0, in bytes/s
+
   std::map <uint16_t,uint8_t> m_uesTxMode; ///< txMode of the UEs
 
   // HARQ attributes
@@ -288,4 +288,18 @@ MobilityHelper::GetDistanceSquaredBetween (Ptr<Node> n1, Ptr<Node> n2)
   return distSq;
 }
 
+void
+MobilityHelper::GetPositions (NodeContainer c, std::vector<Vector> &positions)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  positions.resize (c.GetN ());
+  uint32_t i = 0;
+  for (NodeContainer::Iterator it = c.Begin (); it != c.End (); ++it, ++i)
+    {
+      Ptr<MobilityModel> mobility = (*it)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != 0, "Node " << (*it)->GetId () << " has no mobility model");
+      positions[i] = mobility->GetPosition ();
+    }
+}
+
 } // namespace ns3
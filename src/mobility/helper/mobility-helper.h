@@ -267,6 +267,17 @@ public:
    */
   static double GetDistanceSquaredBetween (Ptr<Node> n1, Ptr<Node> n2);
 
+  /**
+   * Get the current positions of a set of nodes, in one contiguous array,
+   * for instance to compute the distances between all the nodes without
+   * querying each mobility model several times.
+   *
+   * \param c the nodes, which must all have a mobility model
+   * \param positions the positions of the nodes, in the order of the
+   * container, resized to the number of nodes
+   */
+  static void GetPositions (NodeContainer c, std::vector<Vector> &positions);
+
 private:
 
   /**
@@ -71,16 +71,26 @@ ConstantVelocityHelper::GetVelocity (void) const
 void 
 ConstantVelocityHelper::SetVelocity (const Vector &vel)
 {
-  NS_LOG_FUNCTION (this << vel);
+  SetVelocity (vel, Simulator::Now ());
+}
+void
+ConstantVelocityHelper::SetVelocity (const Vector &vel, Time now)
+{
+  NS_LOG_FUNCTION (this << vel << now);
   m_velocity = vel;
-  m_lastUpdate = Simulator::Now ();
+  m_lastUpdate = now;
 }
 
 void
 ConstantVelocityHelper::Update (void) const
 {
-  NS_LOG_FUNCTION (this);
-  Time now = Simulator::Now ();
+  Update (Simulator::Now ());
+}
+
+void
+ConstantVelocityHelper::Update (Time now) const
+{
+  NS_LOG_FUNCTION (this << now);
   NS_ASSERT (m_lastUpdate <= now);
   Time deltaTime = now - m_lastUpdate;
   m_lastUpdate = now;
@@ -97,8 +107,14 @@ ConstantVelocityHelper::Update (void) const
 void
 ConstantVelocityHelper::UpdateWithBounds (const Rectangle &bounds) const
 {
-  NS_LOG_FUNCTION (this << bounds);
-  Update ();
+  UpdateWithBounds (bounds, Simulator::Now ());
+}
+
+void
+ConstantVelocityHelper::UpdateWithBounds (const Rectangle &bounds, Time now) const
+{
+  NS_LOG_FUNCTION (this << bounds << now);
+  Update (now);
   m_position.x = std::min (bounds.xMax, m_position.x);
   m_position.x = std::max (bounds.xMin, m_position.x);
   m_position.y = std::min (bounds.yMax, m_position.y);
@@ -108,8 +124,14 @@ ConstantVelocityHelper::UpdateWithBounds (const Rectangle &bounds) const
 void
 ConstantVelocityHelper::UpdateWithBounds (const Box &bounds) const
 {
-  NS_LOG_FUNCTION (this << bounds);
-  Update ();
+  UpdateWithBounds (bounds, Simulator::Now ());
+}
+
+void
+ConstantVelocityHelper::UpdateWithBounds (const Box &bounds, Time now) const
+{
+  NS_LOG_FUNCTION (this << bounds << now);
+  Update (now);
   m_position.x = std::min (bounds.xMax, m_position.x);
   m_position.x = std::max (bounds.xMin, m_position.x);
   m_position.y = std::min (bounds.yMax, m_position.y);
@@ -70,6 +70,12 @@ public:
    * \param vel Velocity vector
    */
   void SetVelocity (const Vector &vel);
+  /**
+   * Set new velocity vector at a given time, which may be in the past
+   * \param vel Velocity vector
+   * \param now Time at which the velocity is set
+   */
+  void SetVelocity (const Vector &vel, Time now);
   /**
    * Pause mobility at current position
    */
@@ -93,6 +99,26 @@ public:
    * Update position, if not paused, from last position and time of last update
    */
   void Update (void) const;
+  /**
+   * Update position, if not paused, up to a given time, which may be in
+   * the past but not before the last update
+   * \param rectangle 2D bounding rectangle for resulting position; object will not move outside the rectangle
+   * \param now Time of the update
+   */
+  void UpdateWithBounds (const Rectangle &rectangle, Time now) const;
+  /**
+   * Update position, if not paused, up to a given time, which may be in
+   * the past but not before the last update
+   * \param bounds 3D bounding box for resulting position; object will not move outside the box
+   * \param now Time of the update
+   */
+  void UpdateWithBounds (const Box &bounds, Time now) const;
+  /**
+   * Update position, if not paused, up to a given time, which may be in
+   * the past but not before the last update
+   * \param now Time of the update
+   */
+  void Update (Time now) const;
 private:
   mutable Time m_lastUpdate; //!< time of last update
   mutable Vector m_position; //!< state variable for current position
@@ -20,6 +20,7 @@
 #include <cmath>
 #include "ns3/simulator.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
 #include "gauss-markov-mobility-model.h"
@@ -80,12 +81,20 @@ GaussMarkovMobilityModel::GetTypeId (void)
                    "A gaussian random variable used to calculate the next pitch value.",
                    StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),
                    MakePointerAccessor (&GaussMarkovMobilityModel::m_normalPitch),
-                   MakePointerChecker<NormalRandomVariable> ());
+                   MakePointerChecker<NormalRandomVariable> ())
+    .AddAttribute ("Lazy",
+                   "Replay the time steps when the position or velocity is queried, "
+                   "instead of scheduling an event at the end of each step.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&GaussMarkovMobilityModel::m_lazy),
+                   MakeBooleanChecker ());
 
   return tid;
 }
 
 GaussMarkovMobilityModel::GaussMarkovMobilityModel ()
+  : m_lazy (false),
+    m_next (Time::Max ())
 {
   m_meanVelocity = 0.0;
   m_meanDirection = 0.0;
@@ -96,6 +105,13 @@ GaussMarkovMobilityModel::GaussMarkovMobilityModel ()
 
 void
 GaussMarkovMobilityModel::Start (void)
+{
+  DoStart (Simulator::Now ());
+  NotifyCourseChange ();
+}
+
+void
+GaussMarkovMobilityModel::DoStart (Time now)
 {
   if (m_meanVelocity == 0.0)
     {
@@ -112,9 +128,9 @@ GaussMarkovMobilityModel::Start (void)
       m_Direction = m_meanDirection;
       m_Pitch = m_meanPitch;
       //Set the velocity vector to give to the constant velocity helper
-      m_helper.SetVelocity (Vector (m_Velocity*cosD*cosP, m_Velocity*sinD*cosP, m_Velocity*sinP));
+      m_helper.SetVelocity (Vector (m_Velocity*cosD*cosP, m_Velocity*sinD*cosP, m_Velocity*sinP), now);
     }
-  m_helper.Update ();
+  m_helper.Update (now);
 
   //Get the next values from the gaussian distributions for velocity, direction, and pitch
   double rv = m_normalVelocity->GetValue ();
@@ -138,17 +154,17 @@ GaussMarkovMobilityModel::Start (void)
   double vx = m_Velocity * cosDir * cosPit;
   double vy = m_Velocity * sinDir * cosPit;
   double vz = m_Velocity * sinPit;
-  m_helper.SetVelocity (Vector (vx, vy, vz));
+  m_helper.SetVelocity (Vector (vx, vy, vz), now);
 
   m_helper.Unpause ();
 
-  DoWalk (m_timeStep);
+  DoWalk (m_timeStep, now);
 }
 
 void
-GaussMarkovMobilityModel::DoWalk (Time delayLeft)
+GaussMarkovMobilityModel::DoWalk (Time delayLeft, Time now)
 {
-  m_helper.UpdateWithBounds (m_bounds);
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   Vector speed = m_helper.GetVelocity ();
   Vector nextPosition = position;
@@ -159,11 +175,7 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
 
   // Make sure that the position by the next time step is still within the boundary.
   // If out of bounds, then alter the velocity vector and average direction to keep the position in bounds
-  if (m_bounds.IsInside (nextPosition))
-    {
-      m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
-    }
-  else
+  if (!m_bounds.IsInside (nextPosition))
     {
       if (nextPosition.x > m_bounds.xMax || nextPosition.x < m_bounds.xMin) 
         {
@@ -185,16 +197,45 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
 
       m_Direction = m_meanDirection;
       m_Pitch = m_meanPitch;
-      m_helper.SetVelocity (speed);
+      m_helper.SetVelocity (speed, now);
       m_helper.Unpause ();
+    }
+  if (m_lazy)
+    {
+      m_next = now + delayLeft;
+    }
+  else
+    {
       m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
     }
-  NotifyCourseChange ();
+}
+
+void
+GaussMarkovMobilityModel::Advance (void)
+{
+  Time now = Simulator::Now ();
+  if (m_next > now)
+    {
+      return;
+    }
+  while (m_next <= now)
+    {
+      Time next = m_next;
+      m_next = Time::Max ();
+      DoStart (next);
+    }
+  // Notify the new course once the caller is done with the model
+  if (!m_notify.IsRunning ())
+    {
+      m_notify = Simulator::ScheduleNow (&GaussMarkovMobilityModel::NotifyCourseChange, this);
+    }
 }
 
 void
 GaussMarkovMobilityModel::DoDispose (void)
 {
+  m_event.Cancel ();
+  m_notify.Cancel ();
   // chain up
   MobilityModel::DoDispose ();
 }
@@ -202,6 +243,8 @@ GaussMarkovMobilityModel::DoDispose (void)
 Vector
 GaussMarkovMobilityModel::DoGetPosition (void) const
 {
+  // Replaying the steps does not change the trajectory
+  const_cast<GaussMarkovMobilityModel *> (this)->Advance ();
   m_helper.Update ();
   return m_helper.GetCurrentPosition ();
 }
@@ -210,11 +253,19 @@ GaussMarkovMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
   m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
+  if (m_lazy)
+    {
+      m_next = Simulator::Now ();
+    }
+  else
+    {
+      m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
+    }
 }
 Vector
 GaussMarkovMobilityModel::DoGetVelocity (void) const
 {
+  const_cast<GaussMarkovMobilityModel *> (this)->Advance ();
   return m_helper.GetVelocity ();
 }
 
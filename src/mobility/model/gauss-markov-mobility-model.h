@@ -76,6 +76,12 @@ namespace ns3 {
  * [1] Tracy Camp, Jeff Boleng, Vanessa Davies, "A Survey of Mobility Models
  * for Ad Hoc Network Research", Wireless Communications and Mobile Computing,
  * Wiley, vol.2 iss.5, September 2002, pp.483-502
+ *
+ * With the Lazy attribute, the time steps are not driven by events: the
+ * end of the current step is only recorded, and the steps which ended
+ * before a query of the position or velocity are replayed, in order and at
+ * their own times, by that query.  The CourseChange trace is then only
+ * fired once the new course is observed, just after the current event.
  */
 class GaussMarkovMobilityModel : public MobilityModel
 {
@@ -91,11 +97,21 @@ private:
    * Initialize the model and calculate new velocity, direction, and pitch
    */
   void Start (void);
+  /**
+   * Compute the velocity of the step starting at a given time, and walk
+   * \param now the time at which the step starts
+   */
+  void DoStart (Time now);
   /**
    * Perform a walk operation
    * \param timeLeft time until Start method is called again
+   * \param now the time at which the walk starts
+   */
+  void DoWalk (Time timeLeft, Time now);
+  /**
+   * In lazy mode, replay the steps which ended before now.
    */
-  void DoWalk (Time timeLeft);
+  void Advance (void);
   virtual void DoDispose (void);
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
@@ -118,6 +134,9 @@ private:
   Ptr<NormalRandomVariable> m_normalPitch; //!< Gaussian rv for next pitch
   EventId m_event; //!< event id of scheduled start
   Box m_bounds; //!< bounding box
+  bool m_lazy; //!< Whether the steps are replayed on demand instead of scheduled
+  Time m_next; //!< In lazy mode, the end of the current step
+  EventId m_notify; //!< In lazy mode, the pending CourseChange notification
 };
 
 } // namespace ns3
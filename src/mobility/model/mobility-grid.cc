@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mobility-grid.h"
+#include "mobility-model.h"
+#include "ns3/callback.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityGrid");
+
+MobilityGrid::MobilityGrid (double cellSize)
+  : m_cellSize (cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ASSERT_MSG (cellSize > 0, "The cells of a grid must have a positive size");
+}
+
+MobilityGrid::~MobilityGrid ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t id = 0; id < m_entries.size (); id++)
+    {
+      if (m_entries[id].mobility != 0)
+        {
+          m_entries[id].mobility->TraceDisconnectWithoutContext
+            ("CourseChange", MakeBoundCallback (&MobilityGrid::CourseChanged, this, id));
+        }
+    }
+}
+
+uint32_t
+MobilityGrid::Add (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  uint32_t id = m_entries.size ();
+  Entry entry;
+  entry.mobility = mobility;
+  entry.inCell = false;
+  entry.cell = 0;
+  entry.slot = 0;
+  m_entries.push_back (entry);
+  Insert (id);
+  if (mobility != 0)
+    {
+      mobility->TraceConnectWithoutContext
+        ("CourseChange", MakeBoundCallback (&MobilityGrid::CourseChanged, this, id));
+    }
+  return id;
+}
+
+uint32_t
+MobilityGrid::GetN (void) const
+{
+  return m_entries.size ();
+}
+
+uint64_t
+MobilityGrid::GetKey (int64_t x, int64_t y)
+{
+  return (static_cast<uint64_t> (static_cast<uint32_t> (x)) << 32) | static_cast<uint32_t> (y);
+}
+
+int64_t
+MobilityGrid::GetCell (double coordinate) const
+{
+  double cell = std::floor (coordinate / m_cellSize);
+  cell = std::max (cell, static_cast<double> (std::numeric_limits<int32_t>::min ()));
+  cell = std::min (cell, static_cast<double> (std::numeric_limits<int32_t>::max ()));
+  return static_cast<int64_t> (cell);
+}
+
+void
+MobilityGrid::Insert (uint32_t id)
+{
+  Entry &entry = m_entries[id];
+  Vector velocity;
+  if (entry.mobility != 0)
+    {
+      velocity = entry.mobility->GetVelocity ();
+    }
+  if (entry.mobility != 0 && velocity.x == 0 && velocity.y == 0 && velocity.z == 0)
+    {
+      Vector position = entry.mobility->GetPosition ();
+      entry.inCell = true;
+      entry.cell = GetKey (GetCell (position.x), GetCell (position.y));
+      std::vector<uint32_t> &cell = m_cells[entry.cell];
+      entry.slot = cell.size ();
+      cell.push_back (id);
+      NS_LOG_LOGIC ("model " << id << " at " << position << " in cell " << entry.cell);
+    }
+  else
+    {
+      entry.inCell = false;
+      entry.slot = m_moving.size ();
+      m_moving.push_back (id);
+      NS_LOG_LOGIC ("model " << id << " is moving");
+    }
+}
+
+void
+MobilityGrid::Erase (uint32_t id)
+{
+  Entry &entry = m_entries[id];
+  std::unordered_map<uint64_t, std::vector<uint32_t> >::iterator it;
+  std::vector<uint32_t> *ids = &m_moving;
+  if (entry.inCell)
+    {
+      it = m_cells.find (entry.cell);
+      NS_ASSERT (it != m_cells.end ());
+      ids = &it->second;
+    }
+  NS_ASSERT ((*ids)[entry.slot] == id);
+  uint32_t last = ids->back ();
+  (*ids)[entry.slot] = last;
+  m_entries[last].slot = entry.slot;
+  ids->pop_back ();
+  if (entry.inCell && ids->empty ())
+    {
+      m_cells.erase (it);
+    }
+}
+
+void
+MobilityGrid::CourseChanged (MobilityGrid *grid, uint32_t id, Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (grid << id << mobility);
+  grid->Erase (id);
+  grid->Insert (id);
+}
+
+void
+MobilityGrid::Find (const Vector &position, double range, std::vector<uint32_t> &ids) const
+{
+  NS_LOG_FUNCTION (this << position << range);
+  ids.clear ();
+  int64_t minX = GetCell (position.x - range);
+  int64_t maxX = GetCell (position.x + range);
+  int64_t minY = GetCell (position.y - range);
+  int64_t maxY = GetCell (position.y + range);
+  std::unordered_map<uint64_t, std::vector<uint32_t> >::const_iterator it;
+  if (static_cast<double> (maxX - minX + 1) * (maxY - minY + 1) > m_cells.size ())
+    {
+      // Fewer cells are occupied than covered by the range
+      for (it = m_cells.begin (); it != m_cells.end (); ++it)
+        {
+          for (std::vector<uint32_t>::const_iterator i = it->second.begin (); i != it->second.end (); ++i)
+            {
+              if (CalculateDistance (m_entries[*i].mobility->GetPosition (), position) <= range)
+                {
+                  ids.push_back (*i);
+                }
+            }
+        }
+    }
+  else
+    {
+      for (int64_t x = minX; x <= maxX; x++)
+        {
+          for (int64_t y = minY; y <= maxY; y++)
+            {
+              it = m_cells.find (GetKey (x, y));
+              if (it == m_cells.end ())
+                {
+                  continue;
+                }
+              for (std::vector<uint32_t>::const_iterator i = it->second.begin (); i != it->second.end (); ++i)
+                {
+                  if (CalculateDistance (m_entries[*i].mobility->GetPosition (), position) <= range)
+                    {
+                      ids.push_back (*i);
+                    }
+                }
+            }
+        }
+    }
+  for (std::vector<uint32_t>::const_iterator i = m_moving.begin (); i != m_moving.end (); ++i)
+    {
+      Ptr<MobilityModel> mobility = m_entries[*i].mobility;
+      if (mobility == 0 || CalculateDistance (mobility->GetPosition (), position) <= range)
+        {
+          ids.push_back (*i);
+        }
+    }
+  std::sort (ids.begin (), ids.end ());
+  NS_LOG_LOGIC (ids.size () << " of " << m_entries.size () << " models in range");
+}
+
+} // namespace ns3
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_GRID_H
+#define MOBILITY_GRID_H
+
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ *
+ * \brief A grid of the positions of a set of mobility models, to find
+ * those within a range of a point.
+ *
+ * The channels use it to deliver a transmission only to the receivers
+ * within a range of the transmitter, without computing the distance to all
+ * the receivers.  The models are identified by their order of addition.
+ *
+ * The models which do not move are stored in the square cells of the grid
+ * which hold their position.  The grid follows the course changes of the
+ * models: a model which starts to move, as told by its velocity, is taken
+ * out of the grid, and its distance is computed by each search until it
+ * stops.  Hence the grid assumes that a model with a zero velocity does not
+ * move until its next course change, which is true for the models of this
+ * module.
+ */
+class MobilityGrid : public SimpleRefCount<MobilityGrid>
+{
+public:
+  /**
+   * \param [in] cellSize The side of the cells, in meters, typically the
+   *             range of the searches.
+   */
+  MobilityGrid (double cellSize);
+  ~MobilityGrid ();
+
+  /**
+   * \param [in] mobility The mobility model to add, or 0 for a model
+   *             found by all the searches.
+   * \returns The identifier of the model, the number of models added before.
+   */
+  uint32_t Add (Ptr<MobilityModel> mobility);
+  /**
+   * \returns The number of models added.
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Find the models within a range of a position.
+   *
+   * \param [in] position The position.
+   * \param [in] range The range, in meters.
+   * \param [out] ids The identifiers of the models at most \p range away
+   *              from \p position, and of the null models, in increasing
+   *              order.
+   */
+  void Find (const Vector &position, double range, std::vector<uint32_t> &ids) const;
+
+private:
+  /** A model. */
+  struct Entry
+  {
+    Ptr<MobilityModel> mobility; //!< The model.
+    bool inCell;                 //!< Whether it is stored in a cell.
+    uint64_t cell;               //!< The key of its cell.
+    uint32_t slot;               //!< Its index in its cell or in m_moving.
+  };
+
+  /**
+   * \param [in] x The x coordinate of a cell.
+   * \param [in] y The y coordinate of a cell.
+   * \returns The key of the cell.
+   */
+  static uint64_t GetKey (int64_t x, int64_t y);
+  /**
+   * \param [in] coordinate A coordinate of a position.
+   * \returns The coordinate of its cell.
+   */
+  int64_t GetCell (double coordinate) const;
+  /**
+   * Store a model in its cell, or with the moving models.
+   * \param [in] id The model.
+   */
+  void Insert (uint32_t id);
+  /**
+   * Remove a model from its cell, or from the moving models.
+   * \param [in] id The model.
+   */
+  void Erase (uint32_t id);
+  /**
+   * Move a model after a course change.
+   * \param [in] grid The grid.
+   * \param [in] id The model.
+   * \param [in] mobility The model.
+   */
+  static void CourseChanged (MobilityGrid *grid, uint32_t id, Ptr<const MobilityModel> mobility);
+
+  double m_cellSize;                                          //!< The side of the cells.
+  std::vector<Entry> m_entries;                               //!< The models, by identifier.
+  std::unordered_map<uint64_t, std::vector<uint32_t> > m_cells; //!< The models of each cell.
+  std::vector<uint32_t> m_moving;                             //!< The moving and null models.
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_GRID_H */
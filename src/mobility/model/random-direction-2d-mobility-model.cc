@@ -23,6 +23,7 @@
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "random-direction-2d-mobility-model.h"
 
 namespace ns3 {
@@ -51,11 +52,20 @@ RandomDirection2dMobilityModel::GetTypeId (void)
                    StringValue ("ns3::ConstantRandomVariable[Constant=2.0]"),
                    MakePointerAccessor (&RandomDirection2dMobilityModel::m_pause),
                    MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Lazy",
+                   "Replay the travels and pauses when the position or velocity "
+                   "is queried, instead of scheduling an event for each of them.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RandomDirection2dMobilityModel::m_lazy),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 RandomDirection2dMobilityModel::RandomDirection2dMobilityModel ()
+  : m_lazy (false),
+    m_next (Time::Max ()),
+    m_action (INITIALIZE)
 {
   m_direction = CreateObject <UniformRandomVariable> ();
 }
@@ -63,6 +73,8 @@ RandomDirection2dMobilityModel::RandomDirection2dMobilityModel ()
 void 
 RandomDirection2dMobilityModel::DoDispose (void)
 {
+  m_event.Cancel ();
+  m_notify.Cancel ();
   // chain up.
   MobilityModel::DoDispose ();
 }
@@ -77,45 +89,73 @@ void
 RandomDirection2dMobilityModel::DoInitializePrivate (void)
 {
   double direction = m_direction->GetValue (0, 2 * M_PI);
-  SetDirectionAndSpeed (direction);
+  SetDirectionAndSpeed (direction, Simulator::Now ());
+  NotifyCourseChange ();
 }
 
 void
 RandomDirection2dMobilityModel::BeginPause (void)
 {
-  m_helper.Update ();
+  DoBeginPause (Simulator::Now ());
+  NotifyCourseChange ();
+}
+
+void
+RandomDirection2dMobilityModel::DoBeginPause (Time now)
+{
+  m_helper.Update (now);
   m_helper.Pause ();
   Time pause = Seconds (m_pause->GetValue ());
   m_event.Cancel ();
-  m_event = Simulator::Schedule (pause, &RandomDirection2dMobilityModel::ResetDirectionAndSpeed, this);
-  NotifyCourseChange ();
+  if (m_lazy)
+    {
+      m_next = now + pause;
+      m_action = RESET;
+    }
+  else
+    {
+      m_event = Simulator::Schedule (pause, &RandomDirection2dMobilityModel::ResetDirectionAndSpeed, this);
+    }
 }
 
 void
-RandomDirection2dMobilityModel::SetDirectionAndSpeed (double direction)
+RandomDirection2dMobilityModel::SetDirectionAndSpeed (double direction, Time now)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_helper.UpdateWithBounds (m_bounds);
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   double speed = m_speed->GetValue ();
   const Vector vector (std::cos (direction) * speed,
                        std::sin (direction) * speed,
                        0.0);
-  m_helper.SetVelocity (vector);
+  m_helper.SetVelocity (vector, now);
   m_helper.Unpause ();
   Vector next = m_bounds.CalculateIntersection (position, vector);
   Time delay = Seconds (CalculateDistance (position, next) / speed);
   m_event.Cancel ();
-  m_event = Simulator::Schedule (delay,
-                                 &RandomDirection2dMobilityModel::BeginPause, this);
-  NotifyCourseChange ();
+  if (m_lazy)
+    {
+      m_next = now + delay;
+      m_action = BEGIN_PAUSE;
+    }
+  else
+    {
+      m_event = Simulator::Schedule (delay,
+                                     &RandomDirection2dMobilityModel::BeginPause, this);
+    }
 }
 void
 RandomDirection2dMobilityModel::ResetDirectionAndSpeed (void)
+{
+  DoResetDirectionAndSpeed (Simulator::Now ());
+  NotifyCourseChange ();
+}
+void
+RandomDirection2dMobilityModel::DoResetDirectionAndSpeed (Time now)
 {
   double direction = m_direction->GetValue (0, M_PI);
 
-  m_helper.UpdateWithBounds (m_bounds);
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   switch (m_bounds.GetClosestSide (position))
     {
@@ -132,11 +172,44 @@ RandomDirection2dMobilityModel::ResetDirectionAndSpeed (void)
       direction += 0.0;
       break;
     }
-  SetDirectionAndSpeed (direction);
+  SetDirectionAndSpeed (direction, now);
+}
+void
+RandomDirection2dMobilityModel::Advance (void)
+{
+  Time now = Simulator::Now ();
+  if (m_next > now)
+    {
+      return;
+    }
+  while (m_next <= now)
+    {
+      Time next = m_next;
+      m_next = Time::Max ();
+      switch (m_action)
+        {
+        case INITIALIZE:
+          SetDirectionAndSpeed (m_direction->GetValue (0, 2 * M_PI), next);
+          break;
+        case BEGIN_PAUSE:
+          DoBeginPause (next);
+          break;
+        case RESET:
+          DoResetDirectionAndSpeed (next);
+          break;
+        }
+    }
+  // Notify the new course once the caller is done with the model
+  if (!m_notify.IsRunning ())
+    {
+      m_notify = Simulator::ScheduleNow (&RandomDirection2dMobilityModel::NotifyCourseChange, this);
+    }
 }
 Vector
 RandomDirection2dMobilityModel::DoGetPosition (void) const
 {
+  // Replaying the changes of course does not change the trajectory
+  const_cast<RandomDirection2dMobilityModel *> (this)->Advance ();
   m_helper.UpdateWithBounds (m_bounds);
   return m_helper.GetCurrentPosition ();
 }
@@ -145,11 +218,20 @@ RandomDirection2dMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
   m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&RandomDirection2dMobilityModel::DoInitializePrivate, this);
+  if (m_lazy)
+    {
+      m_next = Simulator::Now ();
+      m_action = INITIALIZE;
+    }
+  else
+    {
+      m_event = Simulator::ScheduleNow (&RandomDirection2dMobilityModel::DoInitializePrivate, this);
+    }
 }
 Vector
 RandomDirection2dMobilityModel::DoGetVelocity (void) const
 {
+  const_cast<RandomDirection2dMobilityModel *> (this)->Advance ();
   return m_helper.GetVelocity ();
 }
 int64_t
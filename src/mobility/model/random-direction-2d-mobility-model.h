@@ -40,6 +40,13 @@ namespace ns3 {
  * then travels in the specific direction until it reaches one of
  * the boundaries of the model. When it reaches the boundary, it pauses,
  * selects a new direction and speed, aso.
+ *
+ * With the Lazy attribute, the model is not driven by events: the end of
+ * the current travel or pause is only recorded, and the travels and pauses
+ * which ended before a query of the position or velocity are replayed, in
+ * order and at their own times, by that query.  The CourseChange trace is
+ * then only fired once the new course is observed, just after the current
+ * event.
  */
 class RandomDirection2dMobilityModel : public MobilityModel
 {
@@ -52,23 +59,45 @@ public:
   RandomDirection2dMobilityModel ();
 
 private:
+  /** The next change of course, in lazy mode */
+  enum Action
+  {
+    INITIALIZE,  //!< pick a random direction
+    BEGIN_PAUSE, //!< pause on the boundary
+    RESET        //!< leave the boundary
+  };
   /**
    * Set a new direction and speed
    */
   void ResetDirectionAndSpeed (void);
+  /**
+   * Set a new direction and speed at a given time
+   * \param now the time of the change
+   */
+  void DoResetDirectionAndSpeed (Time now);
   /**
    * Pause, cancel currently scheduled event, schedule end of pause event
    */
   void BeginPause (void);
   /**
-   * Set new velocity and direction, and schedule next pause event  
+   * Pause at a given time, and schedule or record the end of the pause
+   * \param now the time of the pause
+   */
+  void DoBeginPause (Time now);
+  /**
+   * Set new velocity and direction, and schedule or record the next pause
    * \param direction (radians)
+   * \param now the time of the change
    */
-  void SetDirectionAndSpeed (double direction);
+  void SetDirectionAndSpeed (double direction, Time now);
   /**
    * Sets a new random direction and calls SetDirectionAndSpeed
    */
   void DoInitializePrivate (void);
+  /**
+   * In lazy mode, replay the travels and pauses which ended before now.
+   */
+  void Advance (void);
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
   virtual Vector DoGetPosition (void) const;
@@ -82,6 +111,10 @@ private:
   Ptr<RandomVariableStream> m_pause; //!< a random variable to control pause 
   EventId m_event; //!< event ID of next scheduled event
   ConstantVelocityHelper m_helper; //!< helper for velocity computations
+  bool m_lazy; //!< Whether the changes are replayed on demand instead of scheduled
+  Time m_next; //!< In lazy mode, the time of the next change of course
+  enum Action m_action; //!< In lazy mode, the next change of course
+  EventId m_notify; //!< In lazy mode, the pending CourseChange notification
 };
 
 } // namespace ns3
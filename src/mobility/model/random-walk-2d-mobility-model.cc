@@ -19,6 +19,7 @@
  */
 #include "random-walk-2d-mobility-model.h"
 #include "ns3/enum.h"
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
@@ -70,10 +71,23 @@ RandomWalk2dMobilityModel::GetTypeId (void)
                    "A random variable used to pick the speed (m/s).",
                    StringValue ("ns3::UniformRandomVariable[Min=2.0|Max=4.0]"),
                    MakePointerAccessor (&RandomWalk2dMobilityModel::m_speed),
-                   MakePointerChecker<RandomVariableStream> ());
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Lazy",
+                   "Replay the steps when the position or velocity is queried, "
+                   "instead of scheduling an event at the end of each step.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RandomWalk2dMobilityModel::m_lazy),
+                   MakeBooleanChecker ());
   return tid;
 }
 
+RandomWalk2dMobilityModel::RandomWalk2dMobilityModel ()
+  : m_lazy (false),
+    m_next (Time::Max ()),
+    m_rebound (false)
+{
+}
+
 void
 RandomWalk2dMobilityModel::DoInitialize (void)
 {
@@ -84,13 +98,20 @@ RandomWalk2dMobilityModel::DoInitialize (void)
 void
 RandomWalk2dMobilityModel::DoInitializePrivate (void)
 {
-  m_helper.Update ();
+  BeginWalk (Simulator::Now ());
+  NotifyCourseChange ();
+}
+
+void
+RandomWalk2dMobilityModel::BeginWalk (Time now)
+{
+  m_helper.Update (now);
   double speed = m_speed->GetValue ();
   double direction = m_direction->GetValue ();
   Vector vector (std::cos (direction) * speed,
                  std::sin (direction) * speed,
                  0.0);
-  m_helper.SetVelocity (vector);
+  m_helper.SetVelocity (vector, now);
   m_helper.Unpause ();
 
   Time delayLeft;
@@ -102,11 +123,11 @@ RandomWalk2dMobilityModel::DoInitializePrivate (void)
     {
       delayLeft = Seconds (m_modeDistance / speed); 
     }
-  DoWalk (delayLeft);
+  DoWalk (delayLeft, now);
 }
 
 void
-RandomWalk2dMobilityModel::DoWalk (Time delayLeft)
+RandomWalk2dMobilityModel::DoWalk (Time delayLeft, Time now)
 {
   Vector position = m_helper.GetCurrentPosition ();
   Vector speed = m_helper.GetVelocity ();
@@ -116,22 +137,45 @@ RandomWalk2dMobilityModel::DoWalk (Time delayLeft)
   m_event.Cancel ();
   if (m_bounds.IsInside (nextPosition))
     {
-      m_event = Simulator::Schedule (delayLeft, &RandomWalk2dMobilityModel::DoInitializePrivate, this);
+      if (m_lazy)
+        {
+          m_next = now + delayLeft;
+          m_rebound = false;
+        }
+      else
+        {
+          m_event = Simulator::Schedule (delayLeft, &RandomWalk2dMobilityModel::DoInitializePrivate, this);
+        }
     }
   else
     {
       nextPosition = m_bounds.CalculateIntersection (position, speed);
       Time delay = Seconds ((nextPosition.x - position.x) / speed.x);
-      m_event = Simulator::Schedule (delay, &RandomWalk2dMobilityModel::Rebound, this,
-                                     delayLeft - delay);
+      if (m_lazy)
+        {
+          m_next = now + delay;
+          m_rebound = true;
+          m_timeLeft = delayLeft - delay;
+        }
+      else
+        {
+          m_event = Simulator::Schedule (delay, &RandomWalk2dMobilityModel::Rebound, this,
+                                         delayLeft - delay);
+        }
     }
-  NotifyCourseChange ();
 }
 
 void
 RandomWalk2dMobilityModel::Rebound (Time delayLeft)
 {
-  m_helper.UpdateWithBounds (m_bounds);
+  DoRebound (delayLeft, Simulator::Now ());
+  NotifyCourseChange ();
+}
+
+void
+RandomWalk2dMobilityModel::DoRebound (Time delayLeft, Time now)
+{
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   Vector speed = m_helper.GetVelocity ();
   switch (m_bounds.GetClosestSide (position))
@@ -145,20 +189,52 @@ RandomWalk2dMobilityModel::Rebound (Time delayLeft)
       speed.y = -speed.y;
       break;
     }
-  m_helper.SetVelocity (speed);
+  m_helper.SetVelocity (speed, now);
   m_helper.Unpause ();
-  DoWalk (delayLeft);
+  DoWalk (delayLeft, now);
+}
+
+void
+RandomWalk2dMobilityModel::Advance (void)
+{
+  Time now = Simulator::Now ();
+  if (m_next > now)
+    {
+      return;
+    }
+  while (m_next <= now)
+    {
+      Time next = m_next;
+      m_next = Time::Max ();
+      if (m_rebound)
+        {
+          DoRebound (m_timeLeft, next);
+        }
+      else
+        {
+          BeginWalk (next);
+        }
+    }
+  // Notify the new course once the caller is done with the model
+  if (!m_notify.IsRunning ())
+    {
+      m_notify = Simulator::ScheduleNow (&RandomWalk2dMobilityModel::NotifyCourseChange, this);
+    }
 }
 
 void
 RandomWalk2dMobilityModel::DoDispose (void)
 {
+  m_event.Cancel ();
+  m_notify.Cancel ();
   // chain up
   MobilityModel::DoDispose ();
 }
 Vector
 RandomWalk2dMobilityModel::DoGetPosition (void) const
 {
+  // Replaying the steps does not change the trajectory
+  const_cast<RandomWalk2dMobilityModel *> (this)->Advance ();
   m_helper.UpdateWithBounds (m_bounds);
   return m_helper.GetCurrentPosition ();
 }
@@ -168,11 +244,20 @@ RandomWalk2dMobilityModel::DoSetPosition (const Vector &position)
   NS_ASSERT (m_bounds.IsInside (position));
   m_helper.SetPosition (position);
   m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&RandomWalk2dMobilityModel::DoInitializePrivate, this);
+  if (m_lazy)
+    {
+      m_next = Simulator::Now ();
+      m_rebound = false;
+    }
+  else
+    {
+      m_event = Simulator::ScheduleNow (&RandomWalk2dMobilityModel::DoInitializePrivate, this);
+    }
 }
 Vector
 RandomWalk2dMobilityModel::DoGetVelocity (void) const
 {
+  const_cast<RandomWalk2dMobilityModel *> (this)->Advance ();
   return m_helper.GetVelocity ();
 }
 int64_t
@@ -42,6 +42,13 @@ namespace ns3 {
  * of the model, we rebound on the boundary with a reflexive angle
  * and speed. This model is often identified as a brownian motion
  * model.
+ *
+ * With the Lazy attribute, the walk is not driven by events: the end of
+ * the current step, or the next rebound, is only recorded, and the steps
+ * which ended before a query of the position or velocity are replayed, in
+ * order and at their own times, by that query.  The trajectory is the
+ * same as the one driven by events, but the CourseChange trace is only
+ * fired once the new course is observed, just after the current event.
  */
 class RandomWalk2dMobilityModel : public MobilityModel 
 {
@@ -51,6 +58,7 @@ public:
    * \return the object TypeId
    */
   static TypeId GetTypeId (void);
+  RandomWalk2dMobilityModel ();
   /** An enum representing the different working modes of this module. */
   enum Mode  {
     MODE_DISTANCE,
@@ -63,11 +71,28 @@ private:
    * \param timeLeft The remaining time of the walk
    */
   void Rebound (Time timeLeft);
+  /**
+   * \brief Performs the rebound of the node at a given time
+   * \param timeLeft The remaining time of the walk
+   * \param now The time of the rebound
+   */
+  void DoRebound (Time timeLeft, Time now);
+  /**
+   * Pick a new speed and direction at a given time, and walk
+   * \param now The time of the new step
+   */
+  void BeginWalk (Time now);
   /**
    * Walk according to position and velocity, until distance is reached,
    * time is reached, or intersection with the bounding box
+   * \param timeLeft The remaining time of the walk
+   * \param now The time at which the walk starts
+   */
+  void DoWalk (Time timeLeft, Time now);
+  /**
+   * In lazy mode, replay the steps and rebounds which ended before now.
    */
-  void DoWalk (Time timeLeft);
+  void Advance (void);
   /**
    * Perform initialization of the object before MobilityModel::DoInitialize ()
    */
@@ -87,6 +112,11 @@ private:
   Ptr<RandomVariableStream> m_speed; //!< rv for picking speed
   Ptr<RandomVariableStream> m_direction; //!< rv for picking direction
   Rectangle m_bounds; //!< Bounds of the area to cruise
+  bool m_lazy; //!< Whether the steps are replayed on demand instead of scheduled
+  Time m_next; //!< In lazy mode, the end of the current step or the next rebound
+  bool m_rebound; //!< In lazy mode, whether m_next is a rebound
+  Time m_timeLeft; //!< In lazy mode, the time left after the next rebound
+  EventId m_notify; //!< In lazy mode, the pending CourseChange notification
 };
 
 
@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
+#include "ns3/object-factory.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that a mobility model with the Lazy attribute follows the
+ * same trajectory as the one driven by events, with fewer events.
+ */
+class LazyMobilityTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param typeId The type of the mobility models.
+   * \param position The initial position of the models.
+   * \param speed The speed attribute of the models, or an empty string.
+   */
+  LazyMobilityTestCase (std::string typeId, Vector position, std::string speed);
+  virtual ~LazyMobilityTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the models.
+   * \param lazy Whether the models are lazy.
+   * \param positions The positions of the models at each check.
+   * \param velocities The velocities of the models at each check.
+   * \return The number of events executed.
+   */
+  uint64_t Run (bool lazy, std::vector<Vector> &positions, std::vector<Vector> &velocities);
+  /**
+   * Record the positions and velocities of the models.
+   * \param positions The positions of the models.
+   * \param velocities The velocities of the models.
+   */
+  void Record (std::vector<Vector> *positions, std::vector<Vector> *velocities);
+  /**
+   * Count a course change.
+   * \param mobility The mobility model.
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  std::string m_typeId;                      //!< The type of the models
+  Vector m_position;                         //!< The initial position
+  std::string m_speed;                       //!< The speed of the models
+  std::vector<Ptr<MobilityModel> > m_models; //!< The models
+  uint32_t m_courseChanges;                  //!< Number of course changes
+};
+
+LazyMobilityTestCase::LazyMobilityTestCase (std::string typeId, Vector position, std::string speed)
+  : TestCase ("Check the lazy trajectories of " + typeId),
+    m_typeId (typeId),
+    m_position (position),
+    m_speed (speed),
+    m_courseChanges (0)
+{
+}
+
+LazyMobilityTestCase::~LazyMobilityTestCase ()
+{
+}
+
+void
+LazyMobilityTestCase::Record (std::vector<Vector> *positions, std::vector<Vector> *velocities)
+{
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      positions->push_back (m_models[i]->GetPosition ());
+      velocities->push_back (m_models[i]->GetVelocity ());
+    }
+}
+
+void
+LazyMobilityTestCase::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  m_courseChanges++;
+}
+
+uint64_t
+LazyMobilityTestCase::Run (bool lazy, std::vector<Vector> &positions, std::vector<Vector> &velocities)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (m_typeId);
+  factory.Set ("Lazy", BooleanValue (lazy));
+  if (!m_speed.empty ())
+    {
+      factory.Set ("Speed", StringValue (m_speed));
+    }
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<MobilityModel> model = factory.Create<MobilityModel> ();
+      model->AssignStreams (100 * i);
+      model->SetPosition (m_position);
+      model->Initialize ();
+      model->TraceConnectWithoutContext ("CourseChange",
+                                         MakeCallback (&LazyMobilityTestCase::CourseChanged, this));
+      m_models.push_back (model);
+    }
+  for (uint32_t t = 0; t < 30; t++)
+    {
+      Simulator::Schedule (Seconds (3.7 * t), &LazyMobilityTestCase::Record, this,
+                           &positions, &velocities);
+    }
+  m_courseChanges = 0;
+  Simulator::Stop (Seconds (110));
+  Simulator::Run ();
+  uint64_t events = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+  m_models.clear ();
+  return events;
+}
+
+void
+LazyMobilityTestCase::DoRun (void)
+{
+  std::vector<Vector> positions;
+  std::vector<Vector> velocities;
+  uint64_t events = Run (false, positions, velocities);
+  uint32_t courseChanges = m_courseChanges;
+  std::vector<Vector> lazyPositions;
+  std::vector<Vector> lazyVelocities;
+  uint64_t lazyEvents = Run (true, lazyPositions, lazyVelocities);
+
+  NS_TEST_ASSERT_MSG_EQ (lazyPositions.size (), positions.size (), "Wrong number of positions");
+  for (uint32_t i = 0; i < positions.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (lazyPositions[i].x, positions[i].x, 1e-6, "Wrong x at check " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (lazyPositions[i].y, positions[i].y, 1e-6, "Wrong y at check " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (lazyPositions[i].z, positions[i].z, 1e-6, "Wrong z at check " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (lazyVelocities[i].x, velocities[i].x, 1e-6, "Wrong velocity at check " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (lazyVelocities[i].y, velocities[i].y, 1e-6, "Wrong velocity at check " << i);
+    }
+  NS_TEST_EXPECT_MSG_LT (lazyEvents, events, "Too many events with lazy models");
+  NS_TEST_EXPECT_MSG_GT (m_courseChanges, 0, "No course change notified by lazy models");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (m_courseChanges, courseChanges, "Too many course changes notified");
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Lazy mobility models Test Suite
+ */
+static class LazyMobilityTestSuite : public TestSuite
+{
+public:
+  LazyMobilityTestSuite ()
+    : TestSuite ("lazy-mobility", UNIT)
+  {
+    AddTestCase (new LazyMobilityTestCase ("ns3::RandomWalk2dMobilityModel", Vector (50, 50, 0),
+                                           "ns3::UniformRandomVariable[Min=2.0|Max=40.0]"),
+                 TestCase::QUICK);
+    AddTestCase (new LazyMobilityTestCase ("ns3::RandomDirection2dMobilityModel", Vector (0, 0, 0),
+                                           "ns3::UniformRandomVariable[Min=10.0|Max=20.0]"),
+                 TestCase::QUICK);
+    AddTestCase (new LazyMobilityTestCase ("ns3::GaussMarkovMobilityModel", Vector (0, 0, 50), ""),
+                 TestCase::QUICK);
+  }
+} g_lazyMobilityTestSuite; ///< the test suite
@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/mobility-grid.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the searches of a MobilityGrid against the distances to all
+ * the models, while the models are moved, start and stop.
+ */
+class MobilityGridTestCase : public TestCase
+{
+public:
+  MobilityGridTestCase ();
+  virtual ~MobilityGridTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /**
+   * Compare the models found by the grid with all the models in range.
+   * \param range The range of the searches.
+   */
+  void Check (double range);
+  /** Move some models, and start or stop others. */
+  void Move (void);
+
+  std::vector<Ptr<MobilityModel> > m_models; //!< The models, 0 for a null model
+  Ptr<MobilityGrid> m_grid;                  //!< The grid
+  Ptr<UniformRandomVariable> m_random;       //!< Positions and velocities
+  uint32_t m_nChecks;                        //!< Number of searches checked
+};
+
+MobilityGridTestCase::MobilityGridTestCase ()
+  : TestCase ("Check the searches of a MobilityGrid"),
+    m_nChecks (0)
+{
+}
+
+MobilityGridTestCase::~MobilityGridTestCase ()
+{
+}
+
+void
+MobilityGridTestCase::DoTeardown (void)
+{
+  m_grid = 0;
+  m_models.clear ();
+  m_random = 0;
+}
+
+void
+MobilityGridTestCase::Check (double range)
+{
+  for (uint32_t k = 0; k < 20; k++)
+    {
+      Vector center (m_random->GetValue (-100, 600), m_random->GetValue (-100, 600), 0);
+      std::vector<uint32_t> expected;
+      for (uint32_t i = 0; i < m_models.size (); i++)
+        {
+          if (m_models[i] == 0 || CalculateDistance (m_models[i]->GetPosition (), center) <= range)
+            {
+              expected.push_back (i);
+            }
+        }
+      std::vector<uint32_t> found;
+      m_grid->Find (center, range, found);
+      NS_TEST_ASSERT_MSG_EQ (found.size (), expected.size (),
+                             "Wrong number of models within " << range << " m of " << center
+                             << " at " << Simulator::Now ().As (Time::S));
+      for (uint32_t i = 0; i < found.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (found[i], expected[i], "Wrong model found");
+        }
+      m_nChecks++;
+    }
+}
+
+void
+MobilityGridTestCase::Move (void)
+{
+  for (uint32_t i = 0; i < m_models.size (); i += 3)
+    {
+      if (m_models[i] == 0)
+        {
+          continue;
+        }
+      Ptr<ConstantVelocityMobilityModel> moving = DynamicCast<ConstantVelocityMobilityModel> (m_models[i]);
+      if (moving != 0)
+        {
+          // Stop or start
+          bool stopped = moving->GetVelocity ().x == 0 && moving->GetVelocity ().y == 0;
+          moving->SetVelocity (stopped ? Vector (m_random->GetValue (-20, 20), m_random->GetValue (-20, 20), 0)
+                               : Vector (0, 0, 0));
+        }
+      else
+        {
+          m_models[i]->SetPosition (Vector (m_random->GetValue (0, 500), m_random->GetValue (0, 500), 0));
+        }
+    }
+}
+
+void
+MobilityGridTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  m_grid = Create<MobilityGrid> (50);
+  for (uint32_t i = 0; i < 500; i++)
+    {
+      Ptr<MobilityModel> model;
+      if (i % 50 == 7)
+        {
+          model = 0;
+        }
+      else if (i % 4 == 0)
+        {
+          Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+          moving->SetVelocity (Vector (m_random->GetValue (-20, 20), m_random->GetValue (-20, 20), 0));
+          model = moving;
+        }
+      else
+        {
+          model = CreateObject<ConstantPositionMobilityModel> ();
+        }
+      if (model != 0)
+        {
+          model->SetPosition (Vector (m_random->GetValue (0, 500), m_random->GetValue (0, 500),
+                                      m_random->GetValue (0, 10)));
+        }
+      m_models.push_back (model);
+      NS_TEST_ASSERT_MSG_EQ (m_grid->Add (model), i, "Wrong identifier");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_grid->GetN (), m_models.size (), "Wrong number of models");
+
+  for (uint32_t t = 0; t < 10; t++)
+    {
+      Simulator::Schedule (Seconds (t), &MobilityGridTestCase::Check, this, 50);
+      Simulator::Schedule (Seconds (t), &MobilityGridTestCase::Check, this, 20);
+      Simulator::Schedule (Seconds (t), &MobilityGridTestCase::Check, this, 400);
+      Simulator::Schedule (Seconds (t + 0.5), &MobilityGridTestCase::Move, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_nChecks, 600, "Not all the searches were checked");
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief MobilityGrid Test Suite
+ */
+static class MobilityGridTestSuite : public TestSuite
+{
+public:
+  MobilityGridTestSuite ()
+    : TestSuite ("mobility-grid", UNIT)
+  {
+    AddTestCase (new MobilityGridTestCase (), TestCase::QUICK);
+  }
+} g_mobilityGridTestSuite; ///< the test suite
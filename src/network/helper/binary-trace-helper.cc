@@ -0,0 +1,217 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/queue.h"
+#include "binary-trace-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceHelper");
+
+namespace {
+
+/**
+ * \brief The device whose events are written by a trace sink.
+ */
+struct BinaryTraceHook : public SimpleRefCount<BinaryTraceHook>
+{
+  Ptr<BinaryTraceFile> file;   //!< The trace file
+  Ptr<QueueBase> queue;        //!< The queue of the device, if any
+  uint32_t node;               //!< Node id
+  uint32_t device;             //!< Device index
+  uint32_t linkHeader;         //!< Size of the link header of the packets
+};
+
+/**
+ * \brief Write the record of an event.
+ * \param hook The device.
+ * \param event The event.
+ * \param p The packet.
+ */
+void
+RecordEvent (Ptr<BinaryTraceHook> hook, BinaryTraceRecord::Event event, Ptr<const Packet> p)
+{
+  BinaryTraceRecord record;
+  record.time = Simulator::Now ().GetNanoSeconds ();
+  record.node = hook->node;
+  record.device = hook->device;
+  record.event = event;
+  record.Decode (p, hook->linkHeader);
+  if (hook->queue != 0)
+    {
+      record.queuePackets = hook->queue->GetNPackets ();
+      record.queueBytes = hook->queue->GetNBytes ();
+    }
+  else
+    {
+      record.queuePackets = 0;
+      record.queueBytes = 0;
+    }
+  hook->file->Write (record);
+}
+
+/**
+ * \brief Trace sink of the enqueued packets.
+ * \param hook The device.
+ * \param p The packet.
+ */
+void
+EnqueueSink (Ptr<BinaryTraceHook> hook, Ptr<const Packet> p)
+{
+  RecordEvent (hook, BinaryTraceRecord::ENQUEUE, p);
+}
+
+/**
+ * \brief Trace sink of the dequeued packets.
+ * \param hook The device.
+ * \param p The packet.
+ */
+void
+DequeueSink (Ptr<BinaryTraceHook> hook, Ptr<const Packet> p)
+{
+  RecordEvent (hook, BinaryTraceRecord::DEQUEUE, p);
+}
+
+/**
+ * \brief Trace sink of the dropped packets.
+ * \param hook The device.
+ * \param p The packet.
+ */
+void
+DropSink (Ptr<BinaryTraceHook> hook, Ptr<const Packet> p)
+{
+  RecordEvent (hook, BinaryTraceRecord::DROP, p);
+}
+
+/**
+ * \brief Trace sink of the received packets.
+ * \param hook The device.
+ * \param p The packet.
+ */
+void
+ReceiveSink (Ptr<BinaryTraceHook> hook, Ptr<const Packet> p)
+{
+  RecordEvent (hook, BinaryTraceRecord::RECEIVE, p);
+}
+
+/**
+ * \param nd A device.
+ * \return The size of the link header of the packets traced by the device.
+ */
+uint32_t
+GetLinkHeaderSize (Ptr<NetDevice> nd)
+{
+  static const struct
+  {
+    const char *name;   //!< Type of device
+    uint32_t size;      //!< Size of its link header
+  } links[] = {
+    { "ns3::PointToPointNetDevice", 2 },   // PPP
+    { "ns3::CsmaNetDevice", 14 },          // Ethernet
+  };
+  TypeId tid = nd->GetInstanceTypeId ();
+  for (uint32_t i = 0; i < sizeof (links) / sizeof (links[0]); i++)
+    {
+      TypeId link;
+      if (TypeId::LookupByNameFailSafe (links[i].name, &link) && tid.IsChildOf (link))
+        {
+          return links[i].size;
+        }
+    }
+  return 0;
+}
+
+} // unnamed namespace
+
+Ptr<BinaryTraceFile>
+BinaryTraceHelper::CreateFile (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> (filename);
+  NS_ABORT_MSG_IF (file->Fail (), "BinaryTraceHelper::CreateFile(): Unable to create " << filename);
+  return file;
+}
+
+void
+BinaryTraceHelper::EnableBinary (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd)
+{
+  NS_LOG_FUNCTION (file << nd);
+  Ptr<BinaryTraceHook> hook = Create<BinaryTraceHook> ();
+  hook->file = file;
+  hook->node = nd->GetNode ()->GetId ();
+  hook->device = nd->GetIfIndex ();
+  hook->linkHeader = GetLinkHeaderSize (nd);
+
+  bool hooked = false;
+  PointerValue queue;
+  if (nd->GetAttributeFailSafe ("TxQueue", queue) && queue.Get<QueueBase> () != 0)
+    {
+      hook->queue = queue.Get<QueueBase> ();
+      hooked |= hook->queue->TraceConnectWithoutContext ("Enqueue", MakeBoundCallback (&EnqueueSink, hook));
+      hooked |= hook->queue->TraceConnectWithoutContext ("Dequeue", MakeBoundCallback (&DequeueSink, hook));
+      hooked |= hook->queue->TraceConnectWithoutContext ("Drop", MakeBoundCallback (&DropSink, hook));
+    }
+  hooked |= nd->TraceConnectWithoutContext ("MacRx", MakeBoundCallback (&ReceiveSink, hook));
+  hooked |= nd->TraceConnectWithoutContext ("PhyRxDrop", MakeBoundCallback (&DropSink, hook));
+  if (!hooked)
+    {
+      NS_LOG_WARN ("No trace source to record on device " << hook->device << " of node " << hook->node);
+    }
+}
+
+void
+BinaryTraceHelper::EnableBinary (Ptr<BinaryTraceFile> file, NetDeviceContainer d)
+{
+  for (NetDeviceContainer::Iterator i = d.Begin (); i != d.End (); ++i)
+    {
+      EnableBinary (file, *i);
+    }
+}
+
+void
+BinaryTraceHelper::EnableBinary (Ptr<BinaryTraceFile> file, NodeContainer n)
+{
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      for (uint32_t j = 0; j < (*i)->GetNDevices (); ++j)
+        {
+          EnableBinary (file, (*i)->GetDevice (j));
+        }
+    }
+}
+
+void
+BinaryTraceHelper::EnableBinaryAll (Ptr<BinaryTraceFile> file)
+{
+  EnableBinary (file, NodeContainer::GetGlobal ());
+}
+
+Ptr<BinaryTraceFile>
+BinaryTraceHelper::EnableBinaryAll (std::string filename)
+{
+  Ptr<BinaryTraceFile> file = CreateFile (filename);
+  EnableBinaryAll (file);
+  return file;
+}
+
+} // namespace ns3
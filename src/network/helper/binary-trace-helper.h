@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_HELPER_H
+#define BINARY_TRACE_HELPER_H
+
+#include <string>
+#include "ns3/binary-trace-file.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+
+namespace ns3 {
+
+class NetDevice;
+
+/**
+ * \brief Write the device traces to a compact binary trace file.
+ *
+ * This helper hooks the same trace sources as the ASCII traces of the device
+ * helpers: the Enqueue, Dequeue and Drop traces of the TxQueue of the
+ * devices, and their MacRx and PhyRxDrop traces, when the device has them.
+ * Rather than formatting a context string and the printed packet for each
+ * event, each event is a fixed-width BinaryTraceRecord holding the time,
+ * node, device, the IP addresses, protocol and ECN bits, the TCP or UDP
+ * ports, the TCP sequence number and flags, the packet size and the
+ * length of the device queue.  All the devices can share one file, since the
+ * records identify the node and device.
+ *
+ * The link header is skipped according to the type of device (PPP for the
+ * point-to-point devices, Ethernet for the CSMA devices, none otherwise).
+ *
+ * The binary-trace-convert program of the utils directory converts the files
+ * to CSV, or to one file per column.
+ */
+class BinaryTraceHelper
+{
+public:
+  /**
+   * \brief Create a binary trace file, whose schema header is written.
+   * \param filename The name of the file.
+   * \return The file.
+   */
+  Ptr<BinaryTraceFile> CreateFile (std::string filename);
+
+  /**
+   * \brief Trace the events of a device.
+   * \param file The trace file.
+   * \param nd The device.
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd);
+  /**
+   * \brief Trace the events of a set of devices.
+   * \param file The trace file.
+   * \param d The devices.
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, NetDeviceContainer d);
+  /**
+   * \brief Trace the events of all the devices of a set of nodes.
+   * \param file The trace file.
+   * \param n The nodes.
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, NodeContainer n);
+  /**
+   * \brief Trace the events of all the devices of all the nodes.
+   * \param file The trace file.
+   */
+  void EnableBinaryAll (Ptr<BinaryTraceFile> file);
+  /**
+   * \brief Trace the events of all the devices of all the nodes in a new file.
+   * \param filename The name of the file.
+   * \return The file.
+   */
+  Ptr<BinaryTraceFile> EnableBinaryAll (std::string filename);
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_HELPER_H */
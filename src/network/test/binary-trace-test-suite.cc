@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/binary-trace-helper.h"
+
+using namespace ns3;
+
+/**
+ * \brief Build the bytes of an IPv4 TCP segment.
+ * \param ecn The ECN bits.
+ * \return The packet.
+ */
+static Ptr<Packet>
+CreateTcpPacket (uint8_t ecn)
+{
+  uint8_t bytes[60] = {0};
+  uint8_t *ip = bytes;
+  ip[0] = 0x45;                  // IPv4, 20 bytes
+  ip[1] = ecn;
+  ip[3] = sizeof (bytes);
+  ip[9] = 6;                     // TCP
+  ip[12] = 10; ip[13] = 1; ip[14] = 1; ip[15] = 1;
+  ip[16] = 10; ip[17] = 1; ip[18] = 2; ip[19] = 2;
+  uint8_t *tcp = ip + 20;
+  tcp[0] = 0xc3; tcp[1] = 0x50;  // 50000
+  tcp[2] = 0x00; tcp[3] = 0x50;  // 80
+  tcp[4] = 0x01; tcp[5] = 0x02; tcp[6] = 0x03; tcp[7] = 0x04;
+  tcp[13] = 0x12;                // SYN ACK
+  return Create<Packet> (bytes, sizeof (bytes));
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the decoding of the packet headers.
+ */
+class BinaryTraceDecodeTestCase : public TestCase
+{
+public:
+  BinaryTraceDecodeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceDecodeTestCase::BinaryTraceDecodeTestCase ()
+  : TestCase ("Check the decoding of the packet headers")
+{
+}
+
+void
+BinaryTraceDecodeTestCase::DoRun (void)
+{
+  // IPv4 TCP behind a PPP header
+  Ptr<Packet> p = CreateTcpPacket (3);
+  uint8_t ppp[2] = { 0x00, 0x21 };
+  Ptr<Packet> framed = Create<Packet> (ppp, sizeof (ppp));
+  framed->AddAtEnd (p);
+  BinaryTraceRecord record;
+  record.Decode (framed, 2);
+  NS_TEST_EXPECT_MSG_EQ (record.size, 62, "Size with the link header");
+  NS_TEST_EXPECT_MSG_EQ (uint32_t (record.protocol), 6, "TCP");
+  NS_TEST_EXPECT_MSG_EQ (uint32_t (record.ecn), 3, "CE");
+  NS_TEST_EXPECT_MSG_EQ (record.source, 0x0a010101, "Source address");
+  NS_TEST_EXPECT_MSG_EQ (record.destination, 0x0a010202, "Destination address");
+  NS_TEST_EXPECT_MSG_EQ (record.sourcePort, 50000, "Source port");
+  NS_TEST_EXPECT_MSG_EQ (record.destinationPort, 80, "Destination port");
+  NS_TEST_EXPECT_MSG_EQ (record.sequence, 0x01020304, "Sequence number");
+  NS_TEST_EXPECT_MSG_EQ (uint32_t (record.tcpFlags), 0x12, "TCP flags");
+
+  // IPv6 UDP
+  uint8_t bytes[48] = {0};
+  bytes[0] = 0x60;
+  bytes[1] = 0x10;               // ECT(0)
+  bytes[6] = 17;                 // UDP
+  bytes[40] = 0x04; bytes[41] = 0xd2;  // 1234
+  bytes[42] = 0x00; bytes[43] = 0x35;  // 53
+  record.Decode (Create<Packet> (bytes, sizeof (bytes)), 0);
+  NS_TEST_EXPECT_MSG_EQ (uint32_t (record.protocol), 17, "UDP");
+  NS_TEST_EXPECT_MSG_EQ (uint32_t (record.ecn), 1, "ECT(0)");
+  NS_TEST_EXPECT_MSG_EQ (record.source, 0, "No IPv6 address");
+  NS_TEST_EXPECT_MSG_EQ (record.sourcePort, 1234, "Source port");
+  NS_TEST_EXPECT_MSG_EQ (record.destinationPort, 53, "Destination port");
+  NS_TEST_EXPECT_MSG_EQ (record.sequence, 0, "No sequence number");
+
+  // Not IP
+  record.Decode (Create<Packet> (100), 0);
+  NS_TEST_EXPECT_MSG_EQ (uint32_t (record.protocol), 0, "Not IP");
+  NS_TEST_EXPECT_MSG_EQ (record.size, 100, "Size");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the records written for the devices of a simulation.
+ */
+class BinaryTraceHelperTestCase : public TestCase
+{
+public:
+  BinaryTraceHelperTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceHelperTestCase::BinaryTraceHelperTestCase ()
+  : TestCase ("Check the records of the devices")
+{
+}
+
+void
+BinaryTraceHelperTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+  NetDeviceContainer devices = simple.Install (nodes);
+
+  std::string filename = CreateTempDirFilename ("trace.btr");
+  BinaryTraceHelper helper;
+  Ptr<BinaryTraceFile> file = helper.EnableBinaryAll (filename);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &NetDevice::Send, devices.Get (0),
+                           CreateTcpPacket (0), devices.Get (1)->GetAddress (), 0x0800);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  file->Flush ();
+  NS_TEST_EXPECT_MSG_EQ (file->GetNRecords (), 6, "Three packets enqueued and dequeued");
+
+  BinaryTraceReader reader (filename);
+  NS_TEST_ASSERT_MSG_EQ (reader.Fail (), false, "Cannot read " << filename);
+  NS_TEST_EXPECT_MSG_EQ (reader.GetNFields (), 15, "Fields of the schema");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetFieldName (0), "time", "First field");
+  uint32_t events[4] = {0};
+  uint32_t maxQueue = 0;
+  while (reader.Next ())
+    {
+      BinaryTraceRecord record;
+      reader.GetRecord (record);
+      NS_TEST_ASSERT_MSG_LT (uint32_t (record.event), 4, "Unknown event");
+      events[record.event]++;
+      NS_TEST_EXPECT_MSG_EQ (record.node, nodes.Get (0)->GetId (), "Node of the sender");
+      NS_TEST_EXPECT_MSG_EQ (record.device, 0, "Device of the sender");
+      NS_TEST_EXPECT_MSG_EQ (record.size, 60, "Packet size");
+      NS_TEST_EXPECT_MSG_EQ (record.destinationPort, 80, "Destination port");
+      NS_TEST_EXPECT_MSG_EQ (reader.GetField (0), record.time, "Time through the schema");
+      maxQueue = std::max (maxQueue, record.queuePackets);
+    }
+  NS_TEST_EXPECT_MSG_EQ (events[BinaryTraceRecord::ENQUEUE], 3, "Enqueued packets");
+  NS_TEST_EXPECT_MSG_EQ (events[BinaryTraceRecord::DEQUEUE], 3, "Dequeued packets");
+  NS_TEST_EXPECT_MSG_GT (maxQueue, 0, "The packets wait in the queue");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Binary trace TestSuite
+ */
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite ()
+  : TestSuite ("binary-trace", UNIT)
+{
+  AddTestCase (new BinaryTraceDecodeTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceHelperTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceTestSuite g_binaryTraceTestSuite; //!< Static variable for test initialization
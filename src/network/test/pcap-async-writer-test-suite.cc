@@ -0,0 +1,338 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/packet.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/pcap-file.h"
+#include "ns3/pcap-file-wrapper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that an asynchronous capture writes the same file as a
+ * synchronous one, even when its ring buffer wraps and fills up.
+ */
+class PcapAsyncSameFileTestCase : public TestCase
+{
+public:
+  PcapAsyncSameFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write the same packets to a capture.
+   * \param file The capture.
+   */
+  void WritePackets (Ptr<PcapFileWrapper> file);
+};
+
+PcapAsyncSameFileTestCase::PcapAsyncSameFileTestCase ()
+  : TestCase ("Check that an asynchronous capture writes the same pcap file")
+{
+}
+
+void
+PcapAsyncSameFileTestCase::WritePackets (Ptr<PcapFileWrapper> file)
+{
+  uint8_t data[1500];
+  for (uint32_t i = 0; i < sizeof (data); i++)
+    {
+      data[i] = i & 0xff;
+    }
+  EthernetHeader header;
+  for (uint32_t i = 0; i < 3000; i++)
+    {
+      uint32_t size = (i * 37) % 1400 + 1;
+      Time t = MicroSeconds (1000 * i + 7);
+      switch (i % 3)
+        {
+        case 0:
+          file->Write (t, Create<Packet> (data, size));
+          break;
+        case 1:
+          file->Write (t, header, Create<Packet> (data, size));
+          break;
+        default:
+          file->Write (t, data, size);
+          break;
+        }
+    }
+}
+
+void
+PcapAsyncSameFileTestCase::DoRun (void)
+{
+  std::string syncName = CreateTempDirFilename ("sync.pcap");
+  std::string asyncName = CreateTempDirFilename ("async.pcap");
+
+  Ptr<PcapFileWrapper> sync = CreateObject<PcapFileWrapper> ();
+  sync->Open (syncName, std::ios::out);
+  sync->Init (1, 1000);
+  WritePackets (sync);
+  sync->Close ();
+
+  Ptr<PcapFileWrapper> async = CreateObject<PcapFileWrapper> ();
+  async->SetAttribute ("Asynchronous", BooleanValue (true));
+  async->SetAttribute ("AsyncCaptureSize", UintegerValue (PcapFile::SNAPLEN_DEFAULT));
+  async->SetAttribute ("AsyncBufferSize", UintegerValue (4096));
+  async->Open (asyncName, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (async->Fail (), false, "Cannot open " << asyncName);
+  async->Init (1, 1000);
+  NS_TEST_ASSERT_MSG_EQ (async->Fail (), false, "Cannot initialize " << asyncName);
+  WritePackets (async);
+  async->Close ();
+  NS_TEST_EXPECT_MSG_EQ (async->GetNAsyncDropped (), 0, "No packet should be dropped");
+
+  uint32_t sec = 0;
+  uint32_t usec = 0;
+  uint32_t packets = 0;
+  bool diff = PcapFile::Diff (syncName, asyncName, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Files differ at packet " << packets << " (" << sec << "s " << usec << "us)");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the packets dropped when the ring buffer is full.
+ */
+class PcapAsyncDropTestCase : public TestCase
+{
+public:
+  PcapAsyncDropTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapAsyncDropTestCase::PcapAsyncDropTestCase ()
+  : TestCase ("Check the packets dropped by an asynchronous capture")
+{
+}
+
+void
+PcapAsyncDropTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("drop.pcap");
+  Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  file->SetAttribute ("Asynchronous", BooleanValue (true));
+  file->SetAttribute ("AsyncBufferSize", UintegerValue (0));
+  file->SetAttribute ("AsyncDropWhenFull", BooleanValue (true));
+  file->Open (filename, std::ios::out);
+  file->Init (1);
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      file->Write (MicroSeconds (i), Create<Packet> (1000));
+    }
+  file->Close ();
+
+  PcapFile check;
+  check.Open (filename, std::ios::in);
+  NS_TEST_EXPECT_MSG_EQ (check.GetSnapLen (), 128, "The default captures the headers only");
+  uint8_t data[128];
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+  uint32_t packets = 0;
+  while (true)
+    {
+      check.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      if (check.Fail ())
+        {
+          break;
+        }
+      NS_TEST_EXPECT_MSG_EQ (inclLen, 128, "Packets are truncated to the capture size");
+      NS_TEST_EXPECT_MSG_EQ (origLen, 1000, "The original length is kept");
+      packets++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (packets + file->GetNAsyncDropped (), 10000, "Packets are either written or dropped");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the packets wait for the writer when the ring buffer
+ * is full and they are not dropped.
+ */
+class PcapAsyncStallTestCase : public TestCase
+{
+public:
+  PcapAsyncStallTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapAsyncStallTestCase::PcapAsyncStallTestCase ()
+  : TestCase ("Check the stalls of an asynchronous capture")
+{
+}
+
+void
+PcapAsyncStallTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("stall.pcap");
+  Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  file->SetAttribute ("Asynchronous", BooleanValue (true));
+  // The ring only holds a single record
+  file->SetAttribute ("AsyncBufferSize", UintegerValue (0));
+  file->SetAttribute ("AsyncDropWhenFull", BooleanValue (false));
+  file->Open (filename, std::ios::out);
+  file->Init (1);
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      file->Write (MicroSeconds (i), Create<Packet> (1000));
+    }
+  file->Close ();
+  NS_TEST_EXPECT_MSG_EQ (file->GetNAsyncDropped (), 0, "No packet should be dropped");
+  NS_TEST_EXPECT_MSG_GT (file->GetNAsyncStalls (), 0, "The packets should wait for the writer");
+
+  PcapFile check;
+  check.Open (filename, std::ios::in);
+  uint8_t data[128];
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+  uint32_t packets = 0;
+  while (true)
+    {
+      check.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      if (check.Fail ())
+        {
+          break;
+        }
+      NS_TEST_EXPECT_MSG_EQ (tsUsec, packets, "The packets are written in order");
+      packets++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (packets, 10000, "All the packets should be written");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the blocks of a pcapng file shared by two captures.
+ */
+class PcapAsyncPcapNgTestCase : public TestCase
+{
+public:
+  PcapAsyncPcapNgTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapAsyncPcapNgTestCase::PcapAsyncPcapNgTestCase ()
+  : TestCase ("Check a pcapng file with two interfaces")
+{
+}
+
+void
+PcapAsyncPcapNgTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("capture.pcapng");
+  Ptr<PcapFileWrapper> files[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      files[i] = CreateObject<PcapFileWrapper> ();
+      files[i]->SetAttribute ("PcapNgFile", StringValue (filename));
+      files[i]->Open (i == 0 ? "first" : "second", std::ios::out);
+      NS_TEST_ASSERT_MSG_EQ (files[i]->Fail (), false, "Cannot open the interface " << i);
+      files[i]->Init (i == 0 ? 1 : 9);
+      NS_TEST_ASSERT_MSG_EQ (files[i]->Fail (), false, "Cannot initialize the interface " << i);
+    }
+  for (uint32_t i = 0; i < 30; i++)
+    {
+      files[i % 3 == 0 ? 1 : 0]->Write (Seconds (i) + MicroSeconds (5), Create<Packet> (1000));
+    }
+  files[0]->Close ();
+  files[1]->Close ();
+
+  std::ifstream in (filename.c_str (), std::ios::binary);
+  std::vector<char> bytes ((std::istreambuf_iterator<char> (in)), std::istreambuf_iterator<char> ());
+  std::size_t pos = 0;
+  uint32_t blocks[7] = {0};
+  uint32_t packets[2] = {0};
+  while (pos + 12 <= bytes.size ())
+    {
+      uint32_t type, length, trailer;
+      std::memcpy (&type, &bytes[pos], 4);
+      std::memcpy (&length, &bytes[pos + 4], 4);
+      NS_TEST_ASSERT_MSG_EQ (length % 4, 0, "Blocks are padded to 32 bits");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (pos + length, bytes.size (), "Truncated block");
+      std::memcpy (&trailer, &bytes[pos + length - 4], 4);
+      NS_TEST_ASSERT_MSG_EQ (trailer, length, "Trailing block length");
+      if (type == 0x0A0D0D0A)
+        {
+          NS_TEST_EXPECT_MSG_EQ (pos, 0, "The section header comes first");
+          blocks[0]++;
+        }
+      else if (type == 1 || type == 6)
+        {
+          blocks[type]++;
+        }
+      if (type == 6)
+        {
+          uint32_t epb[5];
+          std::memcpy (epb, &bytes[pos + 8], sizeof (epb));
+          NS_TEST_ASSERT_MSG_LT (epb[0], 2, "Unknown interface");
+          NS_TEST_EXPECT_MSG_EQ (epb[3], 128, "Captured length");
+          NS_TEST_EXPECT_MSG_EQ (epb[4], 1000, "Original length");
+          // interface 1 gets the packets 0, 3, 6..., interface 0 the others
+          uint32_t n = packets[epb[0]]++;
+          uint64_t i = epb[0] == 1 ? 3 * n : n + n / 2 + 1;
+          uint64_t ts = (uint64_t (epb[1]) << 32) | epb[2];
+          NS_TEST_EXPECT_MSG_EQ (ts, i * 1000000 + 5, "Timestamp in microseconds");
+        }
+      pos += length;
+    }
+  NS_TEST_EXPECT_MSG_EQ (pos, bytes.size (), "The file ends with a block");
+  NS_TEST_EXPECT_MSG_EQ (blocks[0], 1, "One section header");
+  NS_TEST_EXPECT_MSG_EQ (blocks[1], 2, "One interface description per capture");
+  NS_TEST_EXPECT_MSG_EQ (packets[0], 20, "Packets of the first interface");
+  NS_TEST_EXPECT_MSG_EQ (packets[1], 10, "Packets of the second interface");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PcapAsyncWriter TestSuite
+ */
+class PcapAsyncWriterTestSuite : public TestSuite
+{
+public:
+  PcapAsyncWriterTestSuite ();
+};
+
+PcapAsyncWriterTestSuite::PcapAsyncWriterTestSuite ()
+  : TestSuite ("pcap-async-writer", UNIT)
+{
+  AddTestCase (new PcapAsyncSameFileTestCase, TestCase::QUICK);
+  AddTestCase (new PcapAsyncDropTestCase, TestCase::QUICK);
+  AddTestCase (new PcapAsyncStallTestCase, TestCase::QUICK);
+  AddTestCase (new PcapAsyncPcapNgTestCase, TestCase::QUICK);
+}
+
+static PcapAsyncWriterTestSuite g_pcapAsyncWriterTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,348 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "binary-trace-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+namespace {
+
+/// Magic string starting the binary trace files
+const char BINARY_TRACE_MAGIC[8] = "ns3btrc";
+/// Byte order mark
+const uint32_t BINARY_TRACE_BYTE_ORDER = 0x01020304;
+/// Version of the format
+const uint32_t BINARY_TRACE_VERSION = 1;
+/// Size of the field names in the schema
+const uint32_t BINARY_TRACE_NAME_SIZE = 16;
+/// Number of records written at once
+const uint32_t BINARY_TRACE_BATCH = 4096;
+
+/// A field of the schema of BinaryTraceRecord
+struct SchemaField
+{
+  const char *name;   //!< Name of the field
+  uint32_t offset;    //!< Offset in the record
+  uint32_t size;      //!< Size in bytes
+};
+
+/// Define a field of the schema
+#define BINARY_TRACE_FIELD(field) \
+  { # field, offsetof (BinaryTraceRecord, field), sizeof (((BinaryTraceRecord *) 0)->field) }
+
+/// The schema of BinaryTraceRecord
+const SchemaField g_schema[] = {
+  BINARY_TRACE_FIELD (time),
+  BINARY_TRACE_FIELD (node),
+  BINARY_TRACE_FIELD (device),
+  BINARY_TRACE_FIELD (event),
+  BINARY_TRACE_FIELD (protocol),
+  BINARY_TRACE_FIELD (ecn),
+  BINARY_TRACE_FIELD (tcpFlags),
+  BINARY_TRACE_FIELD (source),
+  BINARY_TRACE_FIELD (destination),
+  BINARY_TRACE_FIELD (sourcePort),
+  BINARY_TRACE_FIELD (destinationPort),
+  BINARY_TRACE_FIELD (sequence),
+  BINARY_TRACE_FIELD (size),
+  BINARY_TRACE_FIELD (queuePackets),
+  BINARY_TRACE_FIELD (queueBytes),
+};
+
+#undef BINARY_TRACE_FIELD
+
+/**
+ * \param p The first byte of a big endian word.
+ * \return The 16 bit word.
+ */
+uint16_t
+ReadNtoh16 (const uint8_t *p)
+{
+  return (p[0] << 8) | p[1];
+}
+
+/**
+ * \param p The first byte of a big endian word.
+ * \return The 32 bit word.
+ */
+uint32_t
+ReadNtoh32 (const uint8_t *p)
+{
+  return (uint32_t (p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+} // unnamed namespace
+
+void
+BinaryTraceRecord::Decode (Ptr<const Packet> p, uint32_t linkHeader)
+{
+  // Enough for the link header, IPv6 and the start of TCP
+  uint8_t buffer[96];
+  size = p->GetSize ();
+  uint32_t length = p->CopyData (buffer, std::min<uint32_t> (size, sizeof (buffer)));
+  protocol = 0;
+  ecn = 0;
+  tcpFlags = 0;
+  source = 0;
+  destination = 0;
+  sourcePort = 0;
+  destinationPort = 0;
+  sequence = 0;
+  if (length <= linkHeader)
+    {
+      return;
+    }
+
+  const uint8_t *ip = buffer + linkHeader;
+  length -= linkHeader;
+  uint32_t ipHeader;
+  switch (ip[0] >> 4)
+    {
+    case 4:
+      ipHeader = (ip[0] & 0x0f) * 4;
+      if (length < 20 || ipHeader < 20)
+        {
+          return;
+        }
+      ecn = ip[1] & 0x03;
+      protocol = ip[9];
+      source = ReadNtoh32 (ip + 12);
+      destination = ReadNtoh32 (ip + 16);
+      break;
+    case 6:
+      ipHeader = 40;
+      if (length < ipHeader)
+        {
+          return;
+        }
+      ecn = (ip[1] >> 4) & 0x03;
+      protocol = ip[6];
+      break;
+    default:
+      return;
+    }
+
+  const uint8_t *l4 = ip + ipHeader;
+  if ((protocol == 6 || protocol == 17) && length >= ipHeader + 4)
+    {
+      sourcePort = ReadNtoh16 (l4);
+      destinationPort = ReadNtoh16 (l4 + 2);
+    }
+  if (protocol == 6 && length >= ipHeader + 14)
+    {
+      sequence = ReadNtoh32 (l4 + 4);
+      tcpFlags = l4[13];
+    }
+}
+
+BinaryTraceFile::BinaryTraceFile (std::string filename)
+  : m_records (0)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (m_file.fail ())
+    {
+      NS_LOG_WARN ("Cannot open binary trace file " << filename);
+      return;
+    }
+  m_batch.reserve (BINARY_TRACE_BATCH);
+
+  uint32_t header[4] = {
+    BINARY_TRACE_BYTE_ORDER, BINARY_TRACE_VERSION,
+    sizeof (BinaryTraceRecord), sizeof (g_schema) / sizeof (g_schema[0])
+  };
+  m_file.write (BINARY_TRACE_MAGIC, sizeof (BINARY_TRACE_MAGIC));
+  m_file.write (reinterpret_cast<const char *> (header), sizeof (header));
+  for (uint32_t i = 0; i < header[3]; i++)
+    {
+      char name[BINARY_TRACE_NAME_SIZE] = {0};
+      std::strncpy (name, g_schema[i].name, sizeof (name) - 1);
+      m_file.write (name, sizeof (name));
+      m_file.write (reinterpret_cast<const char *> (&g_schema[i].offset), sizeof (uint32_t));
+      m_file.write (reinterpret_cast<const char *> (&g_schema[i].size), sizeof (uint32_t));
+    }
+}
+
+BinaryTraceFile::~BinaryTraceFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+}
+
+void
+BinaryTraceFile::Write (const BinaryTraceRecord &record)
+{
+  m_batch.push_back (record);
+  if (m_batch.size () == BINARY_TRACE_BATCH)
+    {
+      Flush ();
+    }
+}
+
+void
+BinaryTraceFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_batch.empty ())
+    {
+      m_file.write (reinterpret_cast<const char *> (&m_batch[0]),
+                    m_batch.size () * sizeof (BinaryTraceRecord));
+      m_records += m_batch.size ();
+      m_batch.clear ();
+    }
+  m_file.flush ();
+}
+
+bool
+BinaryTraceFile::Fail (void) const
+{
+  return m_file.fail ();
+}
+
+uint64_t
+BinaryTraceFile::GetNRecords (void) const
+{
+  return m_records + m_batch.size ();
+}
+
+BinaryTraceReader::BinaryTraceReader (std::string filename)
+  : m_fail (true)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  char magic[sizeof (BINARY_TRACE_MAGIC)];
+  uint32_t header[4];
+  m_file.read (magic, sizeof (magic));
+  m_file.read (reinterpret_cast<char *> (header), sizeof (header));
+  if (m_file.fail () || std::memcmp (magic, BINARY_TRACE_MAGIC, sizeof (magic)) != 0)
+    {
+      NS_LOG_WARN (filename << " is not a binary trace file");
+      return;
+    }
+  if (header[0] != BINARY_TRACE_BYTE_ORDER || header[1] != BINARY_TRACE_VERSION)
+    {
+      NS_LOG_WARN (filename << " has an unsupported byte order or version");
+      return;
+    }
+  m_record.resize (header[2]);
+  for (uint32_t i = 0; i < header[3]; i++)
+    {
+      char name[BINARY_TRACE_NAME_SIZE];
+      Field field;
+      m_file.read (name, sizeof (name));
+      m_file.read (reinterpret_cast<char *> (&field.offset), sizeof (uint32_t));
+      m_file.read (reinterpret_cast<char *> (&field.size), sizeof (uint32_t));
+      field.name = std::string (name, strnlen (name, sizeof (name)));
+      if (m_file.fail () || field.offset + field.size > header[2]
+          || (field.size != 1 && field.size != 2 && field.size != 4 && field.size != 8))
+        {
+          NS_LOG_WARN (filename << " has an invalid schema");
+          return;
+        }
+      m_fields.push_back (field);
+    }
+  m_fail = false;
+}
+
+bool
+BinaryTraceReader::Fail (void) const
+{
+  return m_fail;
+}
+
+uint32_t
+BinaryTraceReader::GetNFields (void) const
+{
+  return m_fields.size ();
+}
+
+std::string
+BinaryTraceReader::GetFieldName (uint32_t i) const
+{
+  return m_fields[i].name;
+}
+
+uint32_t
+BinaryTraceReader::GetFieldSize (uint32_t i) const
+{
+  return m_fields[i].size;
+}
+
+bool
+BinaryTraceReader::Next (void)
+{
+  if (m_fail)
+    {
+      return false;
+    }
+  m_file.read (&m_record[0], m_record.size ());
+  return !m_file.fail ();
+}
+
+int64_t
+BinaryTraceReader::GetField (uint32_t i) const
+{
+  const char *p = &m_record[m_fields[i].offset];
+  switch (m_fields[i].size)
+    {
+    case 1:
+      return *reinterpret_cast<const uint8_t *> (p);
+    case 2:
+      {
+        uint16_t v;
+        std::memcpy (&v, p, sizeof (v));
+        return v;
+      }
+    case 4:
+      {
+        uint32_t v;
+        std::memcpy (&v, p, sizeof (v));
+        return v;
+      }
+    default:
+      {
+        int64_t v;
+        std::memcpy (&v, p, sizeof (v));
+        return v;
+      }
+    }
+}
+
+void
+BinaryTraceReader::GetRecord (BinaryTraceRecord &record) const
+{
+  std::memset (&record, 0, sizeof (record));
+  for (uint32_t i = 0; i < m_fields.size (); i++)
+    {
+      for (uint32_t j = 0; j < sizeof (g_schema) / sizeof (g_schema[0]); j++)
+        {
+          if (m_fields[i].name == g_schema[j].name && m_fields[i].size == g_schema[j].size)
+            {
+              std::memcpy (reinterpret_cast<char *> (&record) + g_schema[j].offset,
+                           &m_record[m_fields[i].offset], g_schema[j].size);
+            }
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup network
+ *
+ * \brief A fixed-width record of a binary trace file.
+ *
+ * The addresses are only recorded for IPv4 packets; the ports, sequence
+ * number and flags are those of the TCP or UDP header following the IP
+ * header, if any.  The records are written in host byte order.
+ */
+struct BinaryTraceRecord
+{
+  /// Events recorded in a binary trace
+  enum Event
+  {
+    ENQUEUE = 0,   //!< Packet enqueued in the device queue ('+' in ASCII traces)
+    DEQUEUE = 1,   //!< Packet dequeued from the device queue ('-')
+    DROP = 2,      //!< Packet dropped by the queue or the PHY ('d')
+    RECEIVE = 3,   //!< Packet received by the device ('r')
+  };
+
+  int64_t time;              //!< Simulation time in nanoseconds
+  uint32_t node;             //!< Node id
+  uint32_t device;           //!< Device index in the node
+  uint8_t event;             //!< Event, see Event
+  uint8_t protocol;          //!< IP protocol number, zero if not IP
+  uint8_t ecn;               //!< ECN bits of the IP header
+  uint8_t tcpFlags;          //!< TCP flags
+  uint32_t source;           //!< IPv4 source address
+  uint32_t destination;      //!< IPv4 destination address
+  uint16_t sourcePort;       //!< TCP or UDP source port
+  uint16_t destinationPort;  //!< TCP or UDP destination port
+  uint32_t sequence;         //!< TCP sequence number
+  uint32_t size;             //!< Packet size in bytes, link header included
+  uint32_t queuePackets;     //!< Packets in the device queue after the event
+  uint32_t queueBytes;       //!< Bytes in the device queue after the event
+
+  /**
+   * \brief Fill the protocol fields from the headers of a packet.
+   *
+   * \param p The packet.
+   * \param linkHeader The size of the link header preceding the IP header.
+   */
+  void Decode (Ptr<const Packet> p, uint32_t linkHeader);
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief A binary trace file being written.
+ *
+ * The file starts with a schema header: the magic string "ns3btrc", a byte
+ * order mark (0x01020304 in the byte order of the file), the version, the
+ * size of the records and the number of fields, followed by the name, offset
+ * and size of each field of the records.  Readers should locate the fields
+ * through the schema.  The records are written in large batches.
+ *
+ * Like OutputStreamWrapper, this class uses reference counting so that it
+ * can be bound to the trace sinks of several devices.
+ */
+class BinaryTraceFile : public SimpleRefCount<BinaryTraceFile>
+{
+public:
+  /**
+   * \brief Create a trace file and write its schema header.
+   * \param filename The name of the file.
+   */
+  BinaryTraceFile (std::string filename);
+  ~BinaryTraceFile ();
+
+  /**
+   * \brief Append a record.
+   * \param record The record.
+   */
+  void Write (const BinaryTraceRecord &record);
+  /**
+   * \brief Write the buffered records to the file.
+   */
+  void Flush (void);
+  /**
+   * \return True if the file could not be written.
+   */
+  bool Fail (void) const;
+  /**
+   * \return The number of records written.
+   */
+  uint64_t GetNRecords (void) const;
+
+private:
+  std::ofstream m_file;                      //!< The file
+  std::vector<BinaryTraceRecord> m_batch;    //!< Records not written yet
+  uint64_t m_records;                        //!< Number of records written
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief Read the records of a binary trace file through its schema.
+ */
+class BinaryTraceReader
+{
+public:
+  /**
+   * \brief Open a trace file and read its schema header.
+   * \param filename The name of the file.
+   */
+  BinaryTraceReader (std::string filename);
+
+  /**
+   * \return True if the file is not a readable binary trace file.
+   */
+  bool Fail (void) const;
+  /**
+   * \return The number of fields of the records.
+   */
+  uint32_t GetNFields (void) const;
+  /**
+   * \param i The index of a field.
+   * \return The name of the field.
+   */
+  std::string GetFieldName (uint32_t i) const;
+  /**
+   * \param i The index of a field.
+   * \return The size of the field in bytes.
+   */
+  uint32_t GetFieldSize (uint32_t i) const;
+
+  /**
+   * \brief Read the next record.
+   * \return False at the end of the file.
+   */
+  bool Next (void);
+  /**
+   * \param i The index of a field.
+   * \return The value of the field in the current record.
+   */
+  int64_t GetField (uint32_t i) const;
+  /**
+   * \brief Get the fields of the current record known by this version.
+   *
+   * The fields missing from the file are zero.
+   *
+   * \param record The record to fill.
+   */
+  void GetRecord (BinaryTraceRecord &record) const;
+
+private:
+  /// A field of the schema
+  struct Field
+  {
+    std::string name;   //!< Name of the field
+    uint32_t offset;    //!< Offset in the records
+    uint32_t size;      //!< Size in bytes
+  };
+
+  std::ifstream m_file;             //!< The file
+  bool m_fail;                      //!< Whether the header could not be read
+  std::vector<Field> m_fields;      //!< The schema
+  std::vector<char> m_record;       //!< The current record
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
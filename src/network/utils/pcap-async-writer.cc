@@ -0,0 +1,581 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/buffer.h"
+#include "ns3/header.h"
+#include "ns3/packet.h"
+#include "pcap-async-writer.h"
+
+#ifdef HAVE_PTHREAD_H
+#include "ns3/callback.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapAsyncWriter");
+
+namespace {
+
+/// The writer shared by all the captures, if any
+PcapAsyncWriter *g_pcapAsyncWriter = 0;
+
+/// pcapng block types
+enum PcapNgBlock
+{
+  SECTION_HEADER_BLOCK = 0x0A0D0D0A,
+  INTERFACE_DESCRIPTION_BLOCK = 0x00000001,
+  ENHANCED_PACKET_BLOCK = 0x00000006,
+};
+
+/**
+ * \brief Append a 32 bit word in host order.
+ * \param batch The bytes to write.
+ * \param value The word.
+ */
+void
+AppendU32 (std::vector<char> &batch, uint32_t value)
+{
+  const char *p = reinterpret_cast<const char *> (&value);
+  batch.insert (batch.end (), p, p + sizeof (value));
+}
+
+/**
+ * \brief Append a 16 bit word in host order.
+ * \param batch The bytes to write.
+ * \param value The word.
+ */
+void
+AppendU16 (std::vector<char> &batch, uint16_t value)
+{
+  const char *p = reinterpret_cast<const char *> (&value);
+  batch.insert (batch.end (), p, p + sizeof (value));
+}
+
+/**
+ * \brief Append a pcapng option, padded to 32 bits.
+ * \param batch The bytes to write.
+ * \param code The option code.
+ * \param value The value of the option.
+ * \param length The length of the value.
+ */
+void
+AppendOption (std::vector<char> &batch, uint16_t code, const char *value, uint16_t length)
+{
+  AppendU16 (batch, code);
+  AppendU16 (batch, length);
+  batch.insert (batch.end (), value, value + length);
+  batch.resize (batch.size () + ((4 - length % 4) % 4), 0);
+}
+
+/**
+ * \brief Set the total length of the pcapng block at the end of a batch.
+ * \param batch The bytes to write.
+ * \param start The position of the block.
+ */
+void
+EndBlock (std::vector<char> &batch, std::size_t start)
+{
+  uint32_t length = batch.size () - start + sizeof (uint32_t);
+  std::memcpy (&batch[start + sizeof (uint32_t)], &length, sizeof (length));
+  AppendU32 (batch, length);
+}
+
+/**
+ * \brief Flush the captures left open at the end of the program.
+ */
+struct PcapAsyncWriterCleanup
+{
+  ~PcapAsyncWriterCleanup ()
+  {
+    if (g_pcapAsyncWriter != 0)
+      {
+        g_pcapAsyncWriter->Flush ();
+      }
+  }
+} g_pcapAsyncWriterCleanup; //!< Flushes the captures at exit
+
+} // unnamed namespace
+
+/**
+ * \brief A file written by the captures.
+ */
+struct PcapAsyncWriter::Sink
+{
+  std::string filename;       //!< Name of the file
+  std::ofstream file;         //!< The file
+  bool pcapNg;                //!< Whether the file is a pcapng file
+  uint32_t nInterfaces;       //!< Number of interfaces described in the pcapng file
+  uint32_t nCaptures;         //!< Number of open captures writing to the file
+  std::vector<char> batch;    //!< pcapng blocks being written
+};
+
+void
+PcapAsyncWriter::Capture::Write (uint32_t tsSec, uint32_t tsFrac, Ptr<const Packet> p)
+{
+  uint32_t origLen = p->GetSize ();
+  uint32_t inclLen = std::min (origLen, m_snapLen);
+  if (!Reserve (RECORD_HEADER_SIZE + inclLen))
+    {
+      return;
+    }
+  p->CopyData (&m_scratch[0], inclLen);
+  Commit (tsSec, tsFrac, inclLen, origLen);
+}
+
+void
+PcapAsyncWriter::Capture::Write (uint32_t tsSec, uint32_t tsFrac, const Header &header, Ptr<const Packet> p)
+{
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t origLen = headerSize + p->GetSize ();
+  uint32_t inclLen = std::min (origLen, m_snapLen);
+  if (!Reserve (RECORD_HEADER_SIZE + inclLen))
+    {
+      return;
+    }
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t headerLen = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (&m_scratch[0], headerLen);
+  if (inclLen > headerLen)
+    {
+      p->CopyData (&m_scratch[headerLen], inclLen - headerLen);
+    }
+  Commit (tsSec, tsFrac, inclLen, origLen);
+}
+
+void
+PcapAsyncWriter::Capture::Write (uint32_t tsSec, uint32_t tsFrac, uint8_t const *data, uint32_t length)
+{
+  uint32_t inclLen = std::min (length, m_snapLen);
+  if (!Reserve (RECORD_HEADER_SIZE + inclLen))
+    {
+      return;
+    }
+  std::memcpy (&m_scratch[0], data, inclLen);
+  Commit (tsSec, tsFrac, inclLen, length);
+}
+
+uint64_t
+PcapAsyncWriter::Capture::GetNPackets (void) const
+{
+  return m_packets;
+}
+
+uint64_t
+PcapAsyncWriter::Capture::GetNStalls (void) const
+{
+  return m_stalls;
+}
+
+uint64_t
+PcapAsyncWriter::Capture::GetNDropped (void) const
+{
+  return m_dropped;
+}
+
+bool
+PcapAsyncWriter::Capture::Reserve (uint32_t length)
+{
+  uint64_t capacity = m_ring.size ();
+  uint64_t tail = m_tail.load (std::memory_order_relaxed);
+  if (capacity - (tail - m_head.load (std::memory_order_acquire)) >= length)
+    {
+      return true;
+    }
+  if (m_dropWhenFull)
+    {
+      m_dropped++;
+      return false;
+    }
+  m_stalls++;
+  while (capacity - (tail - m_head.load (std::memory_order_acquire)) < length)
+    {
+      m_writer->Wake (this);
+    }
+  return true;
+}
+
+void
+PcapAsyncWriter::Capture::CopyIn (uint64_t pos, uint8_t const *data, uint32_t length)
+{
+  uint64_t start = pos % m_ring.size ();
+  uint64_t first = std::min<uint64_t> (length, m_ring.size () - start);
+  std::memcpy (&m_ring[start], data, first);
+  if (length > first)
+    {
+      std::memcpy (&m_ring[0], data + first, length - first);
+    }
+}
+
+void
+PcapAsyncWriter::Capture::Commit (uint32_t tsSec, uint32_t tsFrac, uint32_t inclLen, uint32_t origLen)
+{
+  // The same layout as the pcap record header, in host order
+  uint32_t header[4] = { tsSec, tsFrac, inclLen, origLen };
+  uint64_t tail = m_tail.load (std::memory_order_relaxed);
+  CopyIn (tail, reinterpret_cast<uint8_t const *> (header), RECORD_HEADER_SIZE);
+  CopyIn (tail + RECORD_HEADER_SIZE, &m_scratch[0], inclLen);
+  uint64_t used = tail - m_head.load (std::memory_order_acquire);
+  uint64_t next = tail + RECORD_HEADER_SIZE + inclLen;
+  m_tail.store (next, std::memory_order_release);
+  m_packets++;
+
+  // Wake the writer up when the ring gets half full, rather than waiting
+  // for its next poll
+  uint64_t half = m_ring.size () / 2;
+  if (used < half && used + (next - tail) >= half)
+    {
+      m_writer->Notify ();
+    }
+}
+
+Ptr<PcapAsyncWriter>
+PcapAsyncWriter::Get (void)
+{
+  if (g_pcapAsyncWriter == 0)
+    {
+      return Ptr<PcapAsyncWriter> (new PcapAsyncWriter (), false);
+    }
+  return Ptr<PcapAsyncWriter> (g_pcapAsyncWriter);
+}
+
+PcapAsyncWriter::PcapAsyncWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  g_pcapAsyncWriter = this;
+#ifdef HAVE_PTHREAD_H
+  m_mutex = new SystemMutex ();
+  m_wake = new SystemCondition ();
+  m_drained = new SystemCondition ();
+  m_running = true;
+  m_thread = Create<SystemThread> (MakeCallback (&PcapAsyncWriter::Run, this));
+  m_thread->Start ();
+#endif
+}
+
+PcapAsyncWriter::~PcapAsyncWriter ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  m_running = false;
+  Notify ();
+  m_thread->Join ();
+  m_thread = 0;
+  delete m_mutex;
+  delete m_wake;
+  delete m_drained;
+#endif
+  for (std::vector<Capture *>::iterator i = m_captures.begin (); i != m_captures.end (); ++i)
+    {
+      Drain (*i);
+      delete *i;
+    }
+  for (std::map<std::string, Sink *>::iterator i = m_sinks.begin (); i != m_sinks.end (); ++i)
+    {
+      delete i->second;
+    }
+  g_pcapAsyncWriter = 0;
+}
+
+PcapAsyncWriter::Sink *
+PcapAsyncWriter::OpenSink (std::string filename, bool pcapNg)
+{
+  NS_LOG_FUNCTION (this << filename << pcapNg);
+  std::map<std::string, Sink *>::iterator i = m_sinks.find (filename);
+  if (i != m_sinks.end ())
+    {
+      NS_ABORT_MSG_IF (i->second->pcapNg != pcapNg, "Capture file " << filename << " is both pcap and pcapng");
+      return i->second;
+    }
+
+  Sink *sink = new Sink;
+  sink->filename = filename;
+  sink->pcapNg = pcapNg;
+  sink->nInterfaces = 0;
+  sink->nCaptures = 0;
+  if (pcapNg)
+    {
+      sink->file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+      std::vector<char> &batch = sink->batch;
+      batch.clear ();
+      AppendU32 (batch, SECTION_HEADER_BLOCK);
+      AppendU32 (batch, 0);
+      AppendU32 (batch, 0x1A2B3C4D);  // byte order magic
+      AppendU16 (batch, 1);           // major version
+      AppendU16 (batch, 0);           // minor version
+      AppendU32 (batch, 0xFFFFFFFF);  // unknown section length
+      AppendU32 (batch, 0xFFFFFFFF);
+      EndBlock (batch, 0);
+      sink->file.write (&batch[0], batch.size ());
+    }
+  else
+    {
+      // The pcap file header was written by PcapFile
+      sink->file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::app);
+    }
+  if (sink->file.fail ())
+    {
+      NS_LOG_WARN ("Cannot open capture file " << filename);
+      delete sink;
+      return 0;
+    }
+  m_sinks[filename] = sink;
+  return sink;
+}
+
+PcapAsyncWriter::Capture *
+PcapAsyncWriter::CreateCapture (Sink *sink, uint32_t snapLen, uint32_t bufferSize, bool dropWhenFull)
+{
+  Capture *capture = new Capture;
+  capture->m_writer = this;
+  capture->m_sink = sink;
+  capture->m_interface = 0;
+  capture->m_snapLen = snapLen;
+  capture->m_nanosecMode = false;
+  capture->m_dropWhenFull = dropWhenFull;
+  // A record must always fit in the ring
+  capture->m_ring.resize (std::max (bufferSize, Capture::RECORD_HEADER_SIZE + snapLen));
+  capture->m_scratch.resize (std::max<uint32_t> (snapLen, 1));
+  capture->m_head.store (0);
+  capture->m_tail.store (0);
+  capture->m_packets = 0;
+  capture->m_stalls = 0;
+  capture->m_dropped = 0;
+  sink->nCaptures++;
+  m_captures.push_back (capture);
+  return capture;
+}
+
+PcapAsyncWriter::Capture *
+PcapAsyncWriter::AddPcapCapture (std::string filename, uint32_t snapLen,
+                                 uint32_t bufferSize, bool dropWhenFull)
+{
+  NS_LOG_FUNCTION (this << filename << snapLen << bufferSize << dropWhenFull);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (*m_mutex);
+#endif
+  Sink *sink = OpenSink (filename, false);
+  if (sink == 0)
+    {
+      return 0;
+    }
+  return CreateCapture (sink, snapLen, bufferSize, dropWhenFull);
+}
+
+PcapAsyncWriter::Capture *
+PcapAsyncWriter::AddPcapNgCapture (std::string filename, std::string name,
+                                   uint32_t dataLinkType, uint32_t snapLen, bool nanosecMode,
+                                   uint32_t bufferSize, bool dropWhenFull)
+{
+  NS_LOG_FUNCTION (this << filename << name << dataLinkType << snapLen << nanosecMode << bufferSize << dropWhenFull);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (*m_mutex);
+#endif
+  Sink *sink = OpenSink (filename, true);
+  if (sink == 0)
+    {
+      return 0;
+    }
+  Capture *capture = CreateCapture (sink, snapLen, bufferSize, dropWhenFull);
+  capture->m_interface = sink->nInterfaces++;
+  capture->m_nanosecMode = nanosecMode;
+
+  // The interfaces are numbered in the order of their descriptions
+  std::vector<char> &batch = sink->batch;
+  batch.clear ();
+  AppendU32 (batch, INTERFACE_DESCRIPTION_BLOCK);
+  AppendU32 (batch, 0);
+  AppendU16 (batch, dataLinkType);
+  AppendU16 (batch, 0);
+  AppendU32 (batch, snapLen);
+  AppendOption (batch, 2, name.c_str (), name.size ());   // if_name
+  if (nanosecMode)
+    {
+      char resolution = 9;
+      AppendOption (batch, 9, &resolution, 1);             // if_tsresol
+    }
+  AppendOption (batch, 0, 0, 0);                           // opt_endofopt
+  EndBlock (batch, 0);
+  sink->file.write (&batch[0], batch.size ());
+  return capture;
+}
+
+void
+PcapAsyncWriter::RemoveCapture (Capture *capture)
+{
+  NS_LOG_FUNCTION (this << capture);
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (*m_mutex);
+#endif
+    Drain (capture);
+    m_captures.erase (std::find (m_captures.begin (), m_captures.end (), capture));
+    Sink *sink = capture->m_sink;
+    if (--sink->nCaptures == 0)
+      {
+        m_sinks.erase (sink->filename);
+        delete sink;
+      }
+  }
+  NS_LOG_INFO ("Capture " << capture << " wrote " << capture->m_packets << " packets, "
+               << capture->m_stalls << " stalls, " << capture->m_dropped << " dropped");
+  delete capture;
+}
+
+void
+PcapAsyncWriter::Flush (void)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (*m_mutex);
+#endif
+  DrainAll ();
+  for (std::map<std::string, Sink *>::iterator i = m_sinks.begin (); i != m_sinks.end (); ++i)
+    {
+      i->second->file.flush ();
+    }
+}
+
+bool
+PcapAsyncWriter::Drain (Capture *capture)
+{
+  uint64_t head = capture->m_head.load (std::memory_order_relaxed);
+  uint64_t tail = capture->m_tail.load (std::memory_order_acquire);
+  if (head == tail)
+    {
+      return false;
+    }
+
+  const std::vector<uint8_t> &ring = capture->m_ring;
+  Sink *sink = capture->m_sink;
+  if (!sink->pcapNg)
+    {
+      // The ring already holds pcap records
+      uint64_t start = head % ring.size ();
+      uint64_t first = std::min<uint64_t> (tail - head, ring.size () - start);
+      sink->file.write (reinterpret_cast<const char *> (&ring[start]), first);
+      if (tail - head > first)
+        {
+          sink->file.write (reinterpret_cast<const char *> (&ring[0]), tail - head - first);
+        }
+    }
+  else
+    {
+      std::vector<char> &batch = sink->batch;
+      batch.clear ();
+      uint64_t pos = head;
+      while (pos < tail)
+        {
+          uint32_t header[4];
+          uint8_t *bytes = reinterpret_cast<uint8_t *> (header);
+          for (uint32_t i = 0; i < Capture::RECORD_HEADER_SIZE; i++)
+            {
+              bytes[i] = ring[(pos + i) % ring.size ()];
+            }
+          pos += Capture::RECORD_HEADER_SIZE;
+          uint32_t inclLen = header[2];
+          uint64_t ts = header[0] * (capture->m_nanosecMode ? 1000000000ULL : 1000000ULL) + header[1];
+
+          std::size_t block = batch.size ();
+          AppendU32 (batch, ENHANCED_PACKET_BLOCK);
+          AppendU32 (batch, 0);
+          AppendU32 (batch, capture->m_interface);
+          AppendU32 (batch, ts >> 32);
+          AppendU32 (batch, ts & 0xFFFFFFFF);
+          AppendU32 (batch, inclLen);
+          AppendU32 (batch, header[3]);
+          uint64_t start = pos % ring.size ();
+          uint64_t first = std::min<uint64_t> (inclLen, ring.size () - start);
+          batch.insert (batch.end (), ring.begin () + start, ring.begin () + start + first);
+          batch.insert (batch.end (), ring.begin (), ring.begin () + (inclLen - first));
+          batch.resize (batch.size () + ((4 - inclLen % 4) % 4), 0);
+          EndBlock (batch, block);
+          pos += inclLen;
+        }
+      sink->file.write (&batch[0], batch.size ());
+    }
+  capture->m_head.store (tail, std::memory_order_release);
+  return true;
+}
+
+bool
+PcapAsyncWriter::DrainAll (void)
+{
+  bool written = false;
+  for (std::vector<Capture *>::iterator i = m_captures.begin (); i != m_captures.end (); ++i)
+    {
+      written |= Drain (*i);
+    }
+  return written;
+}
+
+void
+PcapAsyncWriter::Notify (void)
+{
+#ifdef HAVE_PTHREAD_H
+  m_wake->SetCondition (true);
+  m_wake->Signal ();
+#endif
+}
+
+void
+PcapAsyncWriter::Wake (Capture *capture)
+{
+#ifdef HAVE_PTHREAD_H
+  // Sleep until the writer drains a batch.  The condition is not checked
+  // under its lock, so a batch drained just before the wait is only
+  // noticed by the timeout, after which the ring is checked again.
+  m_drained->SetCondition (false);
+  Notify ();
+  m_drained->TimedWait (1000000);
+#else
+  Drain (capture);
+#endif
+}
+
+void
+PcapAsyncWriter::Run (void)
+{
+#ifdef HAVE_PTHREAD_H
+  while (m_running)
+    {
+      bool written;
+      {
+        CriticalSection cs (*m_mutex);
+        written = DrainAll ();
+      }
+      if (written)
+        {
+          m_drained->SetCondition (true);
+          m_drained->Signal ();
+        }
+      else
+        {
+          m_wake->TimedWait (1000000);
+          m_wake->SetCondition (false);
+        }
+    }
+#endif
+}
+
+} // namespace ns3
@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_ASYNC_WRITER_H
+#define PCAP_ASYNC_WRITER_H
+
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/core-config.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+class SystemThread;
+class SystemMutex;
+class SystemCondition;
+
+/**
+ * \ingroup network
+ *
+ * \brief Write the captures of asynchronous PcapFileWrapper objects from a
+ * background thread.
+ *
+ * Each capture (typically one per device) owns a single-producer,
+ * single-consumer ring buffer.  The simulation thread snapshots the
+ * packets into the ring, truncated to the snapshot length of the
+ * capture, without taking any lock.  The records in the ring are laid out
+ * as pcap records, so that a single writer thread, shared by all the
+ * captures, drains each ring with a few large sequential writes.
+ *
+ * When a ring is full, the simulation thread either waits for the writer
+ * (a stall) or drops the packet, and counts these events.  The captures
+ * can also share a single pcapng file, where each capture is an
+ * interface described by its own Interface Description Block.
+ *
+ * Without thread support, the rings are drained by the simulation
+ * thread, whenever they are full and when the captures are closed.
+ */
+class PcapAsyncWriter : public SimpleRefCount<PcapAsyncWriter>
+{
+  struct Sink;
+
+public:
+  /**
+   * \brief The ring buffer of a capture, and its statistics.
+   */
+  class Capture
+  {
+public:
+    /**
+     * \brief Snapshot a packet into the ring.
+     * \param tsSec The timestamp, seconds part.
+     * \param tsFrac The timestamp, microseconds or nanoseconds part.
+     * \param p The packet.
+     */
+    void Write (uint32_t tsSec, uint32_t tsFrac, Ptr<const Packet> p);
+    /**
+     * \brief Snapshot a header followed by a packet into the ring.
+     * \param tsSec The timestamp, seconds part.
+     * \param tsFrac The timestamp, microseconds or nanoseconds part.
+     * \param header The header.
+     * \param p The packet.
+     */
+    void Write (uint32_t tsSec, uint32_t tsFrac, const Header &header, Ptr<const Packet> p);
+    /**
+     * \brief Snapshot a buffer into the ring.
+     * \param tsSec The timestamp, seconds part.
+     * \param tsFrac The timestamp, microseconds or nanoseconds part.
+     * \param data The buffer.
+     * \param length The length of the buffer.
+     */
+    void Write (uint32_t tsSec, uint32_t tsFrac, uint8_t const *data, uint32_t length);
+
+    /// \return The number of packets written to the ring.
+    uint64_t GetNPackets (void) const;
+    /// \return The number of times the simulation waited for the writer.
+    uint64_t GetNStalls (void) const;
+    /// \return The number of packets dropped because the ring was full.
+    uint64_t GetNDropped (void) const;
+
+private:
+    friend class PcapAsyncWriter;
+    /// Size of the pcap record header
+    static const uint32_t RECORD_HEADER_SIZE = 16;
+
+    /**
+     * \brief Reserve the room of a record, waiting for the writer if needed.
+     * \param length The size of the record, header included.
+     * \return True if the record fits, false if it was dropped.
+     */
+    bool Reserve (uint32_t length);
+    /**
+     * \brief Copy bytes at a position of the ring.
+     * \param pos The position, modulo the capacity.
+     * \param data The bytes.
+     * \param length The number of bytes.
+     */
+    void CopyIn (uint64_t pos, uint8_t const *data, uint32_t length);
+    /**
+     * \brief Copy the record header and the snapshot at the tail of the ring.
+     * \param tsSec The timestamp, seconds part.
+     * \param tsFrac The timestamp, microseconds or nanoseconds part.
+     * \param inclLen The size of the snapshot in m_scratch.
+     * \param origLen The size of the packet.
+     */
+    void Commit (uint32_t tsSec, uint32_t tsFrac, uint32_t inclLen, uint32_t origLen);
+
+    PcapAsyncWriter *m_writer;           //!< The writer draining the ring
+    Sink *m_sink;                        //!< The file of the capture
+    uint32_t m_interface;                //!< Interface id in a pcapng file
+    uint32_t m_snapLen;                  //!< Maximum size of the snapshots
+    bool m_nanosecMode;                  //!< Timestamps in nanoseconds
+    bool m_dropWhenFull;                 //!< Drop rather than wait when the ring is full
+    std::vector<uint8_t> m_ring;         //!< The ring buffer
+    std::vector<uint8_t> m_scratch;      //!< Snapshot being written
+    std::atomic<uint64_t> m_head;        //!< Read position, updated by the writer
+    std::atomic<uint64_t> m_tail;        //!< Write position, updated by the simulation
+    uint64_t m_packets;                  //!< Number of packets written
+    uint64_t m_stalls;                   //!< Number of waits for the writer
+    uint64_t m_dropped;                  //!< Number of packets dropped
+  };
+
+  /**
+   * \return The writer shared by all the captures, created on first use.
+   */
+  static Ptr<PcapAsyncWriter> Get (void);
+
+  ~PcapAsyncWriter ();
+
+  /**
+   * \brief Add a capture appended to a pcap file.
+   *
+   * The file must already hold the pcap file header.
+   *
+   * \param filename The name of the pcap file.
+   * \param snapLen The maximum size of the snapshots.
+   * \param bufferSize The size of the ring buffer in bytes.
+   * \param dropWhenFull Whether to drop the packets rather than wait when the
+   * ring is full.
+   * \return The capture, or null if the file cannot be opened.
+   */
+  Capture * AddPcapCapture (std::string filename, uint32_t snapLen,
+                            uint32_t bufferSize, bool dropWhenFull);
+  /**
+   * \brief Add a capture as a new interface of a pcapng file.
+   *
+   * The file is created by its first capture.
+   *
+   * \param filename The name of the pcapng file.
+   * \param name The name of the interface.
+   * \param dataLinkType The data link type of the interface.
+   * \param snapLen The maximum size of the snapshots.
+   * \param nanosecMode Whether the timestamps are in nanoseconds.
+   * \param bufferSize The size of the ring buffer in bytes.
+   * \param dropWhenFull Whether to drop the packets rather than wait when the
+   * ring is full.
+   * \return The capture, or null if the file cannot be opened.
+   */
+  Capture * AddPcapNgCapture (std::string filename, std::string name,
+                              uint32_t dataLinkType, uint32_t snapLen, bool nanosecMode,
+                              uint32_t bufferSize, bool dropWhenFull);
+  /**
+   * \brief Write the pending records of a capture and delete it.
+   *
+   * The file is closed with its last capture.
+   *
+   * \param capture The capture.
+   */
+  void RemoveCapture (Capture *capture);
+  /**
+   * \brief Write the pending records of all the captures and flush the files.
+   */
+  void Flush (void);
+
+private:
+  PcapAsyncWriter ();
+
+  /**
+   * \brief Open a file, or find the file already opened.
+   * \param filename The name of the file.
+   * \param pcapNg Whether the file is a pcapng file.
+   * \return The file, or null if it cannot be opened.
+   */
+  Sink * OpenSink (std::string filename, bool pcapNg);
+  /**
+   * \brief Create a capture and register it.
+   * \param sink The file of the capture.
+   * \param snapLen The maximum size of the snapshots.
+   * \param bufferSize The size of the ring buffer in bytes.
+   * \param dropWhenFull Whether to drop the packets rather than wait.
+   * \return The capture.
+   */
+  Capture * CreateCapture (Sink *sink, uint32_t snapLen,
+                           uint32_t bufferSize, bool dropWhenFull);
+  /**
+   * \brief Write the records of a capture.
+   * \param capture The capture.
+   * \return True if records were written.
+   */
+  bool Drain (Capture *capture);
+  /**
+   * \brief Write the records of all the captures.
+   * \return True if records were written.
+   */
+  bool DrainAll (void);
+  /**
+   * \brief Wake the writer thread up.
+   */
+  void Notify (void);
+  /**
+   * \brief Wait for the writer to drain a batch of records, or drain a
+   * full ring if there is no writer thread.
+   * \param capture The capture whose ring is full.
+   */
+  void Wake (Capture *capture);
+  /// Body of the writer thread.
+  void Run (void);
+
+  std::map<std::string, Sink *> m_sinks;         //!< Open files, by name
+  std::vector<Capture *> m_captures;             //!< All the captures
+#ifdef HAVE_PTHREAD_H
+  Ptr<SystemThread> m_thread;                    //!< The writer thread
+  SystemMutex *m_mutex;                          //!< Lock of the files and capture list
+  SystemCondition *m_wake;                       //!< Wakes the writer thread up
+  SystemCondition *m_drained;                    //!< Signaled by the writer after a batch
+  std::atomic<bool> m_running;                   //!< Whether the writer thread runs
+#endif
+};
+
+} // namespace ns3
+
+#endif /* PCAP_ASYNC_WRITER_H */
@@ -16,9 +16,11 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
+#include "ns3/string.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
@@ -46,12 +48,47 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("Asynchronous",
+                   "Whether the packets are snapshotted into a ring buffer, written "
+                   "to the file by a background thread (see PcapAsyncWriter).",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_async),
+                   MakeBooleanChecker ())
+    .AddAttribute ("AsyncCaptureSize",
+                   "Maximum length of the packets captured in asynchronous mode; "
+                   "the default keeps the link, IP and transport headers only.",
+                   UintegerValue (128),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_asyncSnapLen),
+                   MakeUintegerChecker<uint32_t> (0, PcapFile::SNAPLEN_DEFAULT))
+    .AddAttribute ("AsyncBufferSize",
+                   "Size in bytes of the ring buffer of an asynchronous capture.",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_asyncBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("AsyncDropWhenFull",
+                   "Whether an asynchronous capture drops the packets, rather than "
+                   "waiting for the background writer, when its ring buffer is full.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asyncDropWhenFull),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PcapNgFile",
+                   "If not empty, the packets are written asynchronously to this "
+                   "pcapng file, shared by all the captures with the same PcapNgFile, "
+                   "instead of the file given to Open.",
+                   StringValue (""),
+                   MakeStringAccessor (&PcapFileWrapper::m_pcapNgFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_asyncMode (false),
+    m_asyncFail (false),
+    m_capture (0),
+    m_asyncStalls (0),
+    m_asyncDropped (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,7 +103,7 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_file.Fail ();
+  return m_file.Fail () || m_asyncFail;
 }
 
 bool 
@@ -86,6 +123,14 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_capture != 0)
+    {
+      m_asyncStalls = m_capture->GetNStalls ();
+      m_asyncDropped = m_capture->GetNDropped ();
+      m_writer->RemoveCapture (m_capture);
+      m_capture = 0;
+      m_writer = 0;
+    }
   m_file.Close ();
 }
 
@@ -93,6 +138,14 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  m_filename = filename;
+  m_asyncMode = (m_async || !m_pcapNgFile.empty ())
+    && (mode & std::ios::out) && !(mode & std::ios::in);
+  if (m_asyncMode && !m_pcapNgFile.empty ())
+    {
+      // the capture is an interface of the pcapng file
+      return;
+    }
   m_file.Open (filename, mode);
 }
 
@@ -105,20 +158,63 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   // a snaplen, we use the one provided.
   //
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
-  if (snapLen != std::numeric_limits<uint32_t>::max ())
+  if (snapLen == std::numeric_limits<uint32_t>::max ())
+    {
+      snapLen = m_snapLen;
+    }
+  if (!m_asyncMode)
+    {
+      m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
+      return;
+    }
+
+  snapLen = std::min (snapLen, m_asyncSnapLen);
+  m_writer = PcapAsyncWriter::Get ();
+  if (m_pcapNgFile.empty ())
     {
+      // Write the file header, then let the writer append the records
       m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
-    } 
+      m_file.Close ();
+      m_capture = m_writer->AddPcapCapture (m_filename, snapLen, m_asyncBufferSize,
+                                            m_asyncDropWhenFull);
+    }
+  else
+    {
+      m_capture = m_writer->AddPcapNgCapture (m_pcapNgFile, m_filename, dataLinkType, snapLen,
+                                              m_nanosecMode, m_asyncBufferSize,
+                                              m_asyncDropWhenFull);
+    }
+  m_asyncFail = (m_capture == 0);
+}
+
+void
+PcapFileWrapper::SplitTime (Time t, uint32_t &s, uint32_t &frac) const
+{
+  if (m_nanosecMode)
+    {
+      uint64_t current = t.GetNanoSeconds ();
+      s    = current / 1000000000;
+      frac = current % 1000000000;
+    }
   else
     {
-      m_file.Init (dataLinkType, m_snapLen, tzCorrection, false, m_nanosecMode);
-    } 
+      uint64_t current = t.GetMicroSeconds ();
+      s    = current / 1000000;
+      frac = current % 1000000;
+    }
 }
 
 void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_capture != 0)
+    {
+      uint32_t s, frac;
+      SplitTime (t, s, frac);
+      m_capture->Write (s, frac, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -139,6 +235,13 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_capture != 0)
+    {
+      uint32_t s, frac;
+      SplitTime (t, s, frac);
+      m_capture->Write (s, frac, header, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -159,6 +262,13 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_capture != 0)
+    {
+      uint32_t s, frac;
+      SplitTime (t, s, frac);
+      m_capture->Write (s, frac, buffer, length);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -256,4 +366,18 @@ PcapFileWrapper::GetDataLinkType (void)
   return m_file.GetDataLinkType ();
 }
 
+uint64_t
+PcapFileWrapper::GetNAsyncStalls (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_capture != 0 ? m_capture->GetNStalls () : m_asyncStalls;
+}
+
+uint64_t
+PcapFileWrapper::GetNAsyncDropped (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_capture != 0 ? m_capture->GetNDropped () : m_asyncDropped;
+}
+
 } // namespace ns3
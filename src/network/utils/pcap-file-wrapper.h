@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcap-async-writer.h"
 
 namespace ns3 {
 
@@ -35,6 +36,14 @@ namespace ns3 {
  * ns-3 interface to the low-level public methods of PcapFile.  Users are
  * encouraged to use this object instead of class ns3::PcapFile in ns-3
  * public APIs.
+ *
+ * When the Asynchronous attribute is set, a file opened for writing is
+ * written by the PcapAsyncWriter: the packets are snapshotted, truncated to
+ * AsyncCaptureSize (the headers only by default), into a ring buffer, and
+ * written to the file by a background thread.  When the PcapNgFile
+ * attribute is set, the capture is rather an interface, named after the
+ * file given to Open, of the pcapng file shared by all the captures with
+ * the same PcapNgFile.
  */
 class PcapFileWrapper : public Object
 {
@@ -220,10 +229,46 @@ public:
    */ 
   uint32_t GetDataLinkType (void);
 
+  /**
+   * \brief Returns the number of times the simulation waited for the
+   * background writer because the ring buffer of the capture was full.
+   *
+   * \returns number of stalls, zero unless the capture is asynchronous
+   */
+  uint64_t GetNAsyncStalls (void) const;
+
+  /**
+   * \brief Returns the number of packets dropped because the ring buffer of
+   * the capture was full (see the AsyncDropWhenFull attribute).
+   *
+   * \returns number of dropped packets, zero unless the capture is asynchronous
+   */
+  uint64_t GetNAsyncDropped (void) const;
+
 private:
+  /**
+   * \brief Split a timestamp into the seconds and fraction fields of a record.
+   * \param t Packet timestamp as ns3::Time.
+   * \param s The seconds.
+   * \param frac The microseconds, or nanoseconds in nanosecond mode.
+   */
+  void SplitTime (Time t, uint32_t &s, uint32_t &frac) const;
+
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  bool     m_async; //!< Write the file from a background thread
+  uint32_t m_asyncSnapLen; //!< max length of saved packets in asynchronous mode
+  uint32_t m_asyncBufferSize; //!< Size of the ring buffer in asynchronous mode
+  bool     m_asyncDropWhenFull; //!< Drop the packets when the ring buffer is full
+  std::string m_pcapNgFile; //!< Shared pcapng file, if any
+  std::string m_filename; //!< Name of the file given to Open
+  bool     m_asyncMode; //!< Whether the open file is written asynchronously
+  bool     m_asyncFail; //!< Whether the asynchronous capture failed to open
+  Ptr<PcapAsyncWriter> m_writer; //!< Background writer
+  PcapAsyncWriter::Capture *m_capture; //!< Asynchronous capture, if any
+  uint64_t m_asyncStalls; //!< Stalls of the closed asynchronous capture
+  uint64_t m_asyncDropped; //!< Drops of the closed asynchronous capture
 };
 
 } // namespace ns3
@@ -48,6 +48,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv4-packet-info-tag.h"
+#include <algorithm>
+#include <unordered_map>
 
 /********** Useful macros **********/
 
@@ -199,6 +201,7 @@ RoutingProtocol::GetTypeId (void)
 RoutingProtocol::RoutingProtocol (void)
   : m_routingTableAssociation (0),
   m_ipv4 (0),
+  m_linksExpirationTime (Time::Max ()),
   m_helloTimer (Timer::CANCEL_ON_DESTROY),
   m_tcTimer (Timer::CANCEL_ON_DESTROY),
   m_midTimer (Timer::CANCEL_ON_DESTROY),
@@ -319,6 +322,7 @@ void RoutingProtocol::DoInitialize ()
           if (addr != loopback)
             {
               m_mainAddress = addr;
+              m_state.SetModified (true);
               break;
             }
         }
@@ -404,6 +408,7 @@ void RoutingProtocol::DoInitialize ()
 void RoutingProtocol::SetMainInterface (uint32_t interface)
 {
   m_mainAddress = m_ipv4->GetAddress (interface, 0).GetLocal ();
+  m_state.SetModified (true);
 }
 
 void RoutingProtocol::SetInterfaceExclusions (std::set<uint32_t> exceptions)
@@ -963,6 +968,17 @@ RoutingProtocol::GetMainAddress (Ipv4Address iface_addr) const
 void
 RoutingProtocol::RoutingTableComputation  (void)
 {
+  // The routing table only depends on the sets of the state and on the
+  // links that have not expired yet
+  if (!m_state.IsModified () && Simulator::Now () <= m_linksExpirationTime)
+    {
+      NS_LOG_DEBUG (Simulator::Now ().As (Time::S) << " : Node " << m_mainAddress
+                                                   << ": RoutingTableComputation skipped, nothing changed");
+      return;
+    }
+  m_state.SetModified (false);
+  m_linksExpirationTime = Time::Max ();
+
   NS_LOG_DEBUG (Simulator::Now ().As (Time::S) << " : Node " << m_mainAddress
                                                << ": RoutingTableComputation begin...");
 
@@ -994,6 +1010,7 @@ RoutingProtocol::RoutingTableComputation  (void)
                   NS_LOG_LOGIC ("Link tuple matches neighbor " << nb_tuple.neighborMainAddr
                                                                << " => adding routing table entry to neighbor");
                   lt = &link_tuple;
+                  m_linksExpirationTime = std::min (m_linksExpirationTime, link_tuple.time);
                   AddEntry (link_tuple.neighborIfaceAddr,
                             link_tuple.neighborIfaceAddr,
                             link_tuple.localIfaceAddr,
@@ -1111,58 +1128,75 @@ RoutingProtocol::RoutingTableComputation  (void)
         }
     }
 
-  for (uint32_t h = 2;; h++)
+  // 3.1. The topology set is searched by the last addresses of its tuples,
+  // one hop count after the other, starting with the 2-hop neighbors.
+  const TopologySet &topology = m_state.GetTopologySet ();
+  std::unordered_map<Ipv4Address, std::vector<uint32_t>, Ipv4AddressHash> topologyByLastAddr;
+  for (uint32_t i = 0; i < topology.size (); i++)
     {
-      bool added = false;
-
-      // 3.1. For each topology entry in the topology table, if its
+      topologyByLastAddr[topology[i].lastAddr].push_back (i);
+    }
+  std::vector<Ipv4Address> lastAddrs;
+  for (std::map<Ipv4Address, RoutingTableEntry>::const_iterator it = m_table.begin ();
+       it != m_table.end (); it++)
+    {
+      if (it->second.distance == 2)
+        {
+          lastAddrs.push_back (it->first);
+        }
+    }
+  for (uint32_t h = 2; !lastAddrs.empty (); h++)
+    {
+      // For each topology entry in the topology table, if its
       // T_dest_addr does not correspond to R_dest_addr of any
       // route entry in the routing table AND its T_last_addr
       // corresponds to R_dest_addr of a route entry whose R_dist
       // is equal to h, then a new route entry MUST be recorded in
-      // the routing table (if it does not already exist)
-      const TopologySet &topology = m_state.GetTopologySet ();
-      for (TopologySet::const_iterator it = topology.begin ();
-           it != topology.end (); it++)
+      // the routing table (if it does not already exist).  The
+      // tuples are considered in the order of the topology set.
+      std::vector<uint32_t> positions;
+      for (std::vector<Ipv4Address>::const_iterator it = lastAddrs.begin ();
+           it != lastAddrs.end (); it++)
+        {
+          std::unordered_map<Ipv4Address, std::vector<uint32_t>, Ipv4AddressHash>::const_iterator tuples =
+            topologyByLastAddr.find (*it);
+          if (tuples != topologyByLastAddr.end ())
+            {
+              positions.insert (positions.end (), tuples->second.begin (), tuples->second.end ());
+            }
+        }
+      std::sort (positions.begin (), positions.end ());
+      lastAddrs.clear ();
+      for (std::vector<uint32_t>::const_iterator it = positions.begin ();
+           it != positions.end (); it++)
         {
-          const TopologyTuple &topology_tuple = *it;
+          const TopologyTuple &topology_tuple = topology[*it];
           NS_LOG_LOGIC ("Looking at topology tuple: " << topology_tuple);
 
           RoutingTableEntry destAddrEntry, lastAddrEntry;
-          bool have_destAddrEntry = Lookup (topology_tuple.destAddr, destAddrEntry);
-          bool have_lastAddrEntry = Lookup (topology_tuple.lastAddr, lastAddrEntry);
-          if (!have_destAddrEntry && have_lastAddrEntry && lastAddrEntry.distance == h)
-            {
-              NS_LOG_LOGIC ("Adding routing table entry based on the topology tuple.");
-              // then a new route entry MUST be recorded in
-              //                the routing table (if it does not already exist) where:
-              //                     R_dest_addr  = T_dest_addr;
-              //                     R_next_addr  = R_next_addr of the recorded
-              //                                    route entry where:
-              //                                    R_dest_addr == T_last_addr
-              //                     R_dist       = h+1; and
-              //                     R_iface_addr = R_iface_addr of the recorded
-              //                                    route entry where:
-              //                                       R_dest_addr == T_last_addr.
-              AddEntry (topology_tuple.destAddr,
-                        lastAddrEntry.nextAddr,
-                        lastAddrEntry.interface,
-                        h + 1);
-              added = true;
-            }
-          else
+          if (Lookup (topology_tuple.destAddr, destAddrEntry))
             {
               NS_LOG_LOGIC ("NOT adding routing table entry based on the topology tuple: "
-                            "have_destAddrEntry=" << have_destAddrEntry
-                                                  << " have_lastAddrEntry=" << have_lastAddrEntry
-                                                  << " lastAddrEntry.distance=" << (int) lastAddrEntry.distance
-                                                  << " (h=" << h << ")");
+                            "have_destAddrEntry=1 (h=" << h << ")");
+              continue;
             }
-        }
-
-      if (!added)
-        {
-          break;
+          NS_LOG_LOGIC ("Adding routing table entry based on the topology tuple.");
+          Lookup (topology_tuple.lastAddr, lastAddrEntry);
+          // then a new route entry MUST be recorded in
+          //                the routing table (if it does not already exist) where:
+          //                     R_dest_addr  = T_dest_addr;
+          //                     R_next_addr  = R_next_addr of the recorded
+          //                                    route entry where:
+          //                                    R_dest_addr == T_last_addr
+          //                     R_dist       = h+1; and
+          //                     R_iface_addr = R_iface_addr of the recorded
+          //                                    route entry where:
+          //                                       R_dest_addr == T_last_addr.
+          AddEntry (topology_tuple.destAddr,
+                    lastAddrEntry.nextAddr,
+                    lastAddrEntry.interface,
+                    h + 1);
+          lastAddrs.push_back (topology_tuple.destAddr);
         }
     }
 
@@ -1475,6 +1509,7 @@ RoutingProtocol::ProcessMid (const olsr::MessageHeader &msg,
   // 3. (not part of the RFC) iterate over all NeighborTuple's and
   // TwoHopNeighborTuples, update the neighbor addresses taking into account
   // the new MID information.
+  m_state.SetModified (true);
   NeighborSet &neighbors = m_state.GetNeighbors ();
   for (NeighborSet::iterator neighbor = neighbors.begin (); neighbor != neighbors.end (); neighbor++)
     {
@@ -2014,6 +2049,7 @@ RoutingProtocol::LinkSensing (const olsr::MessageHeader &msg,
       NS_LOG_LOGIC ("Existing link tuple already exists => will update it");
       updated = true;
     }
+  Time time = link_tuple->time;
 
   link_tuple->asymTime = now + msg.GetVTime ();
   for (std::vector<olsr::MessageHeader::Hello::LinkMessage>::const_iterator linkMessage =
@@ -2113,6 +2149,11 @@ RoutingProtocol::LinkSensing (const olsr::MessageHeader &msg,
       NS_LOG_DEBUG ("Link tuple updated: " << int (updated));
     }
   link_tuple->time = std::max (link_tuple->time, link_tuple->asymTime);
+  // The routing table depends on the links that have not expired
+  if (time < now || link_tuple->time < time)
+    {
+      m_state.SetModified (true);
+    }
 
   if (updated)
     {
@@ -2136,9 +2177,10 @@ RoutingProtocol::PopulateNeighborSet (const olsr::MessageHeader &msg,
                                       const olsr::MessageHeader::Hello &hello)
 {
   NeighborTuple *nb_tuple = m_state.FindNeighborTuple (msg.GetOriginatorAddress ());
-  if (nb_tuple != NULL)
+  if (nb_tuple != NULL && nb_tuple->willingness != hello.willingness)
     {
       nb_tuple->willingness = hello.willingness;
+      m_state.SetModified (true);
     }
 }
 
@@ -2461,6 +2503,10 @@ RoutingProtocol::LinkTupleUpdated (const LinkTuple &tuple, uint8_t willingness)
           NS_LOG_DEBUG (*nb_tuple << "->status = STATUS_NOT_SYM; changed:"
                                   << int (statusBefore != nb_tuple->status));
         }
+      if (statusBefore != nb_tuple->status)
+        {
+          m_state.SetModified (true);
+        }
     }
   else
     {
@@ -3060,18 +3106,26 @@ bool RoutingProtocol::RouteInput  (Ptr<const Packet> p,
 void
 RoutingProtocol::NotifyInterfaceUp (uint32_t i)
 {
+  // The interfaces of the routes may change
+  m_state.SetModified (true);
 }
 void
 RoutingProtocol::NotifyInterfaceDown (uint32_t i)
 {
+  // The interfaces of the routes may change
+  m_state.SetModified (true);
 }
 void
 RoutingProtocol::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
+  // The interfaces of the routes may change
+  m_state.SetModified (true);
 }
 void
 RoutingProtocol::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
+  // The interfaces of the routes may change
+  m_state.SetModified (true);
 }
 
 
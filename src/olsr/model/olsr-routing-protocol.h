@@ -258,6 +258,7 @@ private:
 
   OlsrState m_state;  //!< Internal state with all needed data structs.
   Ptr<Ipv4> m_ipv4;   //!< IPv4 object the routing is linked to.
+  Time m_linksExpirationTime; //!< Earliest expiration time of the links used by the routing table.
 
   /**
    * \brief Clears the routing table and frees the memory assigned to each one of its entries.
@@ -393,6 +394,9 @@ private:
 
   /**
    * \brief Creates the routing table of the node following \RFC{3626} hints.
+   *
+   * The routing table is left as is when neither the sets of the state nor
+   * the links it uses have changed since the last computation.
    */
   void RoutingTableComputation (void);
 
@@ -27,6 +27,7 @@
 ///
 
 #include "olsr-state.h"
+#include <algorithm>
 
 
 namespace ns3 {
@@ -159,6 +160,7 @@ OlsrState::EraseNeighborTuple (const NeighborTuple &tuple)
       if (*it == tuple)
         {
           m_neighborSet.erase (it);
+          m_modified = true;
           break;
         }
     }
@@ -173,6 +175,7 @@ OlsrState::EraseNeighborTuple (const Ipv4Address &mainAddr)
       if (it->neighborMainAddr == mainAddr)
         {
           it = m_neighborSet.erase (it);
+          m_modified = true;
           break;
         }
     }
@@ -188,10 +191,12 @@ OlsrState::InsertNeighborTuple (NeighborTuple const &tuple)
         {
           // Update it
           *it = tuple;
+          m_modified = true;
           return;
         }
     }
   m_neighborSet.push_back (tuple);
+  m_modified = true;
 }
 
 /********** Neighbor 2 Hop Set Manipulation **********/
@@ -221,6 +226,7 @@ OlsrState::EraseTwoHopNeighborTuple (const TwoHopNeighborTuple &tuple)
       if (*it == tuple)
         {
           m_twoHopNeighborSet.erase (it);
+          m_modified = true;
           break;
         }
     }
@@ -237,6 +243,7 @@ OlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr,
           && it->twoHopNeighborAddr == twoHopNeighborAddr)
         {
           it = m_twoHopNeighborSet.erase (it);
+          m_modified = true;
         }
       else
         {
@@ -254,6 +261,7 @@ OlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr)
       if (it->neighborMainAddr == neighborMainAddr)
         {
           it = m_twoHopNeighborSet.erase (it);
+          m_modified = true;
         }
       else
         {
@@ -266,6 +274,7 @@ void
 OlsrState::InsertTwoHopNeighborTuple (TwoHopNeighborTuple const &tuple)
 {
   m_twoHopNeighborSet.push_back (tuple);
+  m_modified = true;
 }
 
 /********** MPR Set Manipulation **********/
@@ -293,34 +302,42 @@ OlsrState::GetMprSet () const
 DuplicateTuple*
 OlsrState::FindDuplicateTuple (Ipv4Address const &addr, uint16_t sequenceNumber)
 {
-  for (DuplicateSet::iterator it = m_duplicateSet.begin ();
-       it != m_duplicateSet.end (); it++)
+  std::unordered_map<uint64_t, uint32_t>::const_iterator it =
+    m_duplicateIndex.find (GetDuplicateKey (addr, sequenceNumber));
+  if (it == m_duplicateIndex.end ())
     {
-      if (it->address == addr && it->sequenceNumber == sequenceNumber)
-        {
-          return &(*it);
-        }
+      return NULL;
     }
-  return NULL;
+  return &m_duplicateSet[it->second];
 }
 
 void
 OlsrState::EraseDuplicateTuple (const DuplicateTuple &tuple)
 {
-  for (DuplicateSet::iterator it = m_duplicateSet.begin ();
-       it != m_duplicateSet.end (); it++)
+  // The order of the duplicate set does not matter: the last tuple is moved
+  // to the position of the erased one.
+  std::unordered_map<uint64_t, uint32_t>::iterator it =
+    m_duplicateIndex.find (GetDuplicateKey (tuple.address, tuple.sequenceNumber));
+  if (it == m_duplicateIndex.end ())
     {
-      if (*it == tuple)
-        {
-          m_duplicateSet.erase (it);
-          break;
-        }
+      return;
+    }
+  uint32_t position = it->second;
+  m_duplicateIndex.erase (it);
+  if (position != m_duplicateSet.size () - 1)
+    {
+      std::swap (m_duplicateSet[position], m_duplicateSet.back ());
+      m_duplicateIndex[GetDuplicateKey (m_duplicateSet[position].address,
+                                        m_duplicateSet[position].sequenceNumber)] = position;
     }
+  m_duplicateSet.pop_back ();
 }
 
 void
 OlsrState::InsertDuplicateTuple (DuplicateTuple const &tuple)
 {
+  m_duplicateIndex.insert (std::make_pair (GetDuplicateKey (tuple.address, tuple.sequenceNumber),
+                                           m_duplicateSet.size ()));
   m_duplicateSet.push_back (tuple);
 }
 
@@ -370,6 +387,7 @@ OlsrState::EraseLinkTuple (const LinkTuple &tuple)
       if (*it == tuple)
         {
           m_linkSet.erase (it);
+          m_modified = true;
           break;
         }
     }
@@ -379,21 +397,48 @@ LinkTuple&
 OlsrState::InsertLinkTuple (LinkTuple const &tuple)
 {
   m_linkSet.push_back (tuple);
+  m_modified = true;
   return m_linkSet.back ();
 }
 
 /********** Topology Set Manipulation **********/
 
+const std::vector<uint32_t>*
+OlsrState::FindTopologyPositions (Ipv4Address const &lastAddr)
+{
+  if (!m_topologyIndexed)
+    {
+      m_topologyIndex.clear ();
+      for (uint32_t i = 0; i < m_topologySet.size (); i++)
+        {
+          m_topologyIndex[m_topologySet[i].lastAddr].push_back (i);
+        }
+      m_topologyIndexed = true;
+    }
+  std::unordered_map<Ipv4Address, std::vector<uint32_t>, Ipv4AddressHash>::const_iterator it =
+    m_topologyIndex.find (lastAddr);
+  if (it == m_topologyIndex.end ())
+    {
+      return NULL;
+    }
+  return &it->second;
+}
+
 TopologyTuple*
 OlsrState::FindTopologyTuple (Ipv4Address const &destAddr,
                               Ipv4Address const &lastAddr)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  const std::vector<uint32_t> *positions = FindTopologyPositions (lastAddr);
+  if (positions == NULL)
     {
-      if (it->destAddr == destAddr && it->lastAddr == lastAddr)
+      return NULL;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
+    {
+      if (m_topologySet[*it].destAddr == destAddr)
         {
-          return &(*it);
+          return &m_topologySet[*it];
         }
     }
   return NULL;
@@ -402,12 +447,17 @@ OlsrState::FindTopologyTuple (Ipv4Address const &destAddr,
 TopologyTuple*
 OlsrState::FindNewerTopologyTuple (Ipv4Address const & lastAddr, uint16_t ansn)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  const std::vector<uint32_t> *positions = FindTopologyPositions (lastAddr);
+  if (positions == NULL)
+    {
+      return NULL;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
     {
-      if (it->lastAddr == lastAddr && it->sequenceNumber > ansn)
+      if (m_topologySet[*it].sequenceNumber > ansn)
         {
-          return &(*it);
+          return &m_topologySet[*it];
         }
     }
   return NULL;
@@ -416,12 +466,21 @@ OlsrState::FindNewerTopologyTuple (Ipv4Address const & lastAddr, uint16_t ansn)
 void
 OlsrState::EraseTopologyTuple (const TopologyTuple &tuple)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  const std::vector<uint32_t> *positions = FindTopologyPositions (tuple.lastAddr);
+  if (positions == NULL)
     {
-      if (*it == tuple)
+      return;
+    }
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end (); it++)
+    {
+      if (m_topologySet[*it] == tuple)
         {
-          m_topologySet.erase (it);
+          // The positions of the next tuples change: the set is indexed
+          // again on the next search.
+          m_topologySet.erase (m_topologySet.begin () + *it);
+          m_topologyIndexed = false;
+          m_modified = true;
           break;
         }
     }
@@ -430,6 +489,21 @@ OlsrState::EraseTopologyTuple (const TopologyTuple &tuple)
 void
 OlsrState::EraseOlderTopologyTuples (const Ipv4Address &lastAddr, uint16_t ansn)
 {
+  const std::vector<uint32_t> *positions = FindTopologyPositions (lastAddr);
+  if (positions == NULL)
+    {
+      return;
+    }
+  bool older = false;
+  for (std::vector<uint32_t>::const_iterator it = positions->begin ();
+       it != positions->end () && !older; it++)
+    {
+      older = m_topologySet[*it].sequenceNumber < ansn;
+    }
+  if (!older)
+    {
+      return;
+    }
   for (TopologySet::iterator it = m_topologySet.begin ();
        it != m_topologySet.end (); )
     {
@@ -442,12 +516,19 @@ OlsrState::EraseOlderTopologyTuples (const Ipv4Address &lastAddr, uint16_t ansn)
           it++;
         }
     }
+  m_topologyIndexed = false;
+  m_modified = true;
 }
 
 void
 OlsrState::InsertTopologyTuple (TopologyTuple const &tuple)
 {
+  if (m_topologyIndexed)
+    {
+      m_topologyIndex[tuple.lastAddr].push_back (m_topologySet.size ());
+    }
   m_topologySet.push_back (tuple);
+  m_modified = true;
 }
 
 /********** Interface Association Set Manipulation **********/
@@ -489,6 +570,7 @@ OlsrState::EraseIfaceAssocTuple (const IfaceAssocTuple &tuple)
       if (*it == tuple)
         {
           m_ifaceAssocSet.erase (it);
+          m_modified = true;
           break;
         }
     }
@@ -498,6 +580,7 @@ void
 OlsrState::InsertIfaceAssocTuple (const IfaceAssocTuple &tuple)
 {
   m_ifaceAssocSet.push_back (tuple);
+  m_modified = true;
 }
 
 std::vector<Ipv4Address>
@@ -540,6 +623,7 @@ OlsrState::EraseAssociationTuple (const AssociationTuple &tuple)
       if (*it == tuple)
         {
           m_associationSet.erase (it);
+          m_modified = true;
           break;
         }
     }
@@ -549,6 +633,7 @@ void
 OlsrState::InsertAssociationTuple (const AssociationTuple &tuple)
 {
   m_associationSet.push_back (tuple);
+  m_modified = true;
 }
 
 void
@@ -560,6 +645,7 @@ OlsrState::EraseAssociation (const Association &tuple)
       if (*it == tuple)
         {
           m_associations.erase (it);
+          m_modified = true;
           break;
         }
     }
@@ -569,6 +655,7 @@ void
 OlsrState::InsertAssociation (const Association &tuple)
 {
   m_associations.push_back (tuple);
+  m_modified = true;
 }
 
 }
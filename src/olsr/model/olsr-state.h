@@ -25,6 +25,7 @@
 #define OLSR_STATE_H
 
 #include "olsr-repositories.h"
+#include <unordered_map>
 
 namespace ns3 {
 namespace olsr {
@@ -46,11 +47,39 @@ protected:
   IfaceAssocSet m_ifaceAssocSet;        //!< Interface Association Set (\RFC{3626}, section 4.1).
   AssociationSet m_associationSet; //!<	Association Set (\RFC{3626}, section12.2). Associations obtained from HNA messages generated by other nodes.
   Associations m_associations;  //!< The node's local Host Network Associations that will be advertised using HNA messages.
+  /// Positions in the Topology Set of the tuples of each last address, in the order of the set.
+  std::unordered_map<Ipv4Address, std::vector<uint32_t>, Ipv4AddressHash> m_topologyIndex;
+  bool m_topologyIndexed; //!< Whether m_topologyIndex matches the Topology Set.
+  /// Positions in the Duplicate Set of the tuples of each address and sequence number.
+  std::unordered_map<uint64_t, uint32_t> m_duplicateIndex;
+  bool m_modified; //!< Whether the sets used by the routing table computation were modified.
 
 public:
   OlsrState ()
+    : m_topologyIndexed (true),
+      m_modified (true)
   {
   }
+  /**
+   * Checks whether the sets used by the routing table computation, i.e. the
+   * link, neighbor, 2-hop neighbor, topology, interface association and
+   * association sets and the local associations, were modified by this class
+   * since the last call to SetModified.
+   * \returns True if the sets were modified.
+   */
+  bool IsModified () const
+  {
+    return m_modified;
+  }
+  /**
+   * Sets whether the sets used by the routing table computation were
+   * modified, e.g. when their tuples are modified in place.
+   * \param modified Whether the sets were modified.
+   */
+  void SetModified (bool modified)
+  {
+    m_modified = modified;
+  }
 
   // MPR selector
 
@@ -427,6 +456,24 @@ public:
   std::vector<Ipv4Address>
   FindNeighborInterfaces (const Ipv4Address &neighborMainAddr) const;
 
+private:
+  /**
+   * Finds the positions in the topology set of the tuples of a last address,
+   * indexing the topology set again if tuples were erased.
+   * \param lastAddr The address of the node previous to the destinations.
+   * \returns The positions of the tuples, or a null pointer if there is none.
+   */
+  const std::vector<uint32_t>* FindTopologyPositions (const Ipv4Address &lastAddr);
+  /**
+   * Gets the key of a tuple in the duplicate set index.
+   * \param address The duplicate tuple address.
+   * \param sequenceNumber The duplicate tuple sequence number.
+   * \returns The key.
+   */
+  static uint64_t GetDuplicateKey (const Ipv4Address &address, uint16_t sequenceNumber)
+  {
+    return (static_cast<uint64_t> (address.Get ()) << 16) | sequenceNumber;
+  }
 };
 
 }
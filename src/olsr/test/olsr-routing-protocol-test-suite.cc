@@ -178,6 +178,104 @@ OlsrMprTestCase::DoRun ()
   NS_TEST_EXPECT_MSG_EQ ((mpr.find ("10.0.0.9") == mpr.end ()), true, "Node 1 must NOT select node 8 as MPR");
 }
 
+/**
+ * \ingroup olsr-test
+ * \ingroup tests
+ *
+ * Testcase for the hashed searches of the topology and duplicate sets
+ */
+class OlsrStateTestCase : public TestCase
+{
+public:
+  OlsrStateTestCase ();
+  ~OlsrStateTestCase ();
+  virtual void DoRun (void);
+};
+
+OlsrStateTestCase::OlsrStateTestCase ()
+  : TestCase ("Check the searches of the OLSR topology and duplicate sets")
+{
+}
+OlsrStateTestCase::~OlsrStateTestCase ()
+{
+}
+void
+OlsrStateTestCase::DoRun ()
+{
+  OlsrState state;
+  NS_TEST_EXPECT_MSG_EQ (state.IsModified (), true, "A new state must be computed");
+  state.SetModified (false);
+
+  // Topology tuples from 10.0.0.1 to 10.0.0.4, advertising 10.0.1.x
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      TopologyTuple tuple;
+      tuple.lastAddr = Ipv4Address (0x0a000001 + i % 4);
+      tuple.destAddr = Ipv4Address (0x0a000100 + i);
+      tuple.sequenceNumber = 1 + i % 4;
+      state.InsertTopologyTuple (tuple);
+    }
+  NS_TEST_EXPECT_MSG_EQ (state.IsModified (), true, "The insertions must modify the state");
+  NS_TEST_EXPECT_MSG_EQ ((state.FindTopologyTuple (Ipv4Address ("10.0.1.5"), Ipv4Address ("10.0.0.2")) != 0), true,
+                         "The tuple must be found");
+  NS_TEST_EXPECT_MSG_EQ ((state.FindTopologyTuple (Ipv4Address ("10.0.1.5"), Ipv4Address ("10.0.0.1")) == 0), true,
+                         "The tuple must not be found");
+  NS_TEST_EXPECT_MSG_EQ ((state.FindNewerTopologyTuple (Ipv4Address ("10.0.0.3"), 2) != 0), true,
+                         "A newer tuple must be found");
+  NS_TEST_EXPECT_MSG_EQ ((state.FindNewerTopologyTuple (Ipv4Address ("10.0.0.3"), 3) == 0), true,
+                         "No newer tuple must be found");
+
+  // Erase the tuples of 10.0.0.2, then a tuple of 10.0.0.3
+  state.SetModified (false);
+  state.EraseOlderTopologyTuples (Ipv4Address ("10.0.0.2"), 2);
+  NS_TEST_EXPECT_MSG_EQ (state.IsModified (), false, "No tuple must be erased");
+  state.EraseOlderTopologyTuples (Ipv4Address ("10.0.0.2"), 3);
+  NS_TEST_EXPECT_MSG_EQ (state.IsModified (), true, "Tuples must be erased");
+  TopologyTuple tuple = *state.FindTopologyTuple (Ipv4Address ("10.0.1.6"), Ipv4Address ("10.0.0.3"));
+  state.EraseTopologyTuple (tuple);
+  NS_TEST_EXPECT_MSG_EQ (state.GetTopologySet ().size (), 29, "Wrong number of tuples");
+  NS_TEST_EXPECT_MSG_EQ ((state.FindTopologyTuple (Ipv4Address ("10.0.1.6"), Ipv4Address ("10.0.0.3")) == 0), true,
+                         "The erased tuple must not be found");
+  NS_TEST_EXPECT_MSG_EQ ((state.FindNewerTopologyTuple (Ipv4Address ("10.0.0.2"), 0) == 0), true,
+                         "The erased tuples must not be found");
+
+  // The order of the insertions must be kept, and the remaining tuples found
+  const TopologySet &topology = state.GetTopologySet ();
+  for (uint32_t i = 0; i < topology.size (); i++)
+    {
+      if (i > 0)
+        {
+          NS_TEST_EXPECT_MSG_LT (topology[i - 1].destAddr.Get (), topology[i].destAddr.Get (), "Wrong order");
+        }
+      NS_TEST_EXPECT_MSG_EQ (state.FindTopologyTuple (topology[i].destAddr, topology[i].lastAddr), &topology[i],
+                             "Wrong tuple found");
+    }
+
+  // Duplicate tuples, some of which are erased
+  for (uint16_t i = 0; i < 50; i++)
+    {
+      DuplicateTuple duplicate;
+      duplicate.address = Ipv4Address (0x0a000001 + i % 5);
+      duplicate.sequenceNumber = i;
+      state.InsertDuplicateTuple (duplicate);
+    }
+  for (uint16_t i = 0; i < 50; i += 3)
+    {
+      DuplicateTuple *duplicate = state.FindDuplicateTuple (Ipv4Address (0x0a000001 + i % 5), i);
+      NS_TEST_ASSERT_MSG_EQ ((duplicate != 0), true, "The duplicate tuple must be found");
+      state.EraseDuplicateTuple (*duplicate);
+    }
+  for (uint16_t i = 0; i < 50; i++)
+    {
+      DuplicateTuple *duplicate = state.FindDuplicateTuple (Ipv4Address (0x0a000001 + i % 5), i);
+      NS_TEST_EXPECT_MSG_EQ ((duplicate != 0), (i % 3 != 0), "Wrong search of the duplicate tuple " << i);
+      if (duplicate != 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (duplicate->sequenceNumber, i, "Wrong duplicate tuple found");
+        }
+    }
+}
+
 /**
  * \ingroup olsr-test
  * \ingroup tests
@@ -194,6 +292,7 @@ OlsrProtocolTestSuite::OlsrProtocolTestSuite ()
   : TestSuite ("routing-olsr", UNIT)
 {
   AddTestCase (new OlsrMprTestCase (), TestCase::QUICK);
+  AddTestCase (new OlsrStateTestCase (), TestCase::QUICK);
 }
 
 static OlsrProtocolTestSuite g_olsrProtocolTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cached-propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/callback.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CachedPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model",
+                   "The deterministic model computing the received powers which are cached.",
+                   StringValue ("ns3::LogDistancePropagationLossModel"),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("MaxSize",
+                   "The number of received powers beyond which the cache is cleared.",
+                   UintegerValue (1000000),
+                   MakeUintegerAccessor (&CachedPropagationLossModel::m_maxSize),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_hits (0),
+    m_misses (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+  m_model = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::Clear (void)
+{
+  for (uint32_t id = 0; id < m_mobilities.size (); id++)
+    {
+      m_mobilities[id].mobility->TraceDisconnectWithoutContext
+        ("CourseChange", MakeBoundCallback (&CachedPropagationLossModel::CourseChanged, this, id));
+    }
+  m_mobilities.clear ();
+  m_ids.clear ();
+  m_cache.clear ();
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  m_cache.clear ();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+uint64_t
+CachedPropagationLossModel::GetHits (void) const
+{
+  return m_hits;
+}
+
+uint64_t
+CachedPropagationLossModel::GetMisses (void) const
+{
+  return m_misses;
+}
+
+double
+CachedPropagationLossModel::GetHitRatio (void) const
+{
+  if (m_hits + m_misses == 0)
+    {
+      return 0;
+    }
+  return static_cast<double> (m_hits) / (m_hits + m_misses);
+}
+
+uint32_t
+CachedPropagationLossModel::GetN (void) const
+{
+  return m_cache.size ();
+}
+
+uint32_t
+CachedPropagationLossModel::GetId (Ptr<MobilityModel> mobility) const
+{
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = m_ids.find (PeekPointer (mobility));
+  if (it != m_ids.end ())
+    {
+      return it->second;
+    }
+  uint32_t id = m_mobilities.size ();
+  Vector velocity = mobility->GetVelocity ();
+  Mobility entry;
+  entry.mobility = mobility;
+  entry.generation = 0;
+  entry.isStatic = velocity.x == 0 && velocity.y == 0 && velocity.z == 0;
+  m_mobilities.push_back (entry);
+  m_ids[PeekPointer (mobility)] = id;
+  mobility->TraceConnectWithoutContext
+    ("CourseChange", MakeBoundCallback (&CachedPropagationLossModel::CourseChanged,
+                                        const_cast<CachedPropagationLossModel *> (this), id));
+  NS_LOG_LOGIC ("mobility model " << mobility << " has id " << id);
+  return id;
+}
+
+void
+CachedPropagationLossModel::CourseChanged (CachedPropagationLossModel *model, uint32_t id, Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (model << id << mobility);
+  Mobility &entry = model->m_mobilities[id];
+  Vector velocity = mobility->GetVelocity ();
+  entry.generation++;
+  entry.isStatic = velocity.x == 0 && velocity.y == 0 && velocity.z == 0;
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No model computes the received powers");
+  uint32_t aId = GetId (a);
+  uint32_t bId = GetId (b);
+  const Mobility &aEntry = m_mobilities[aId];
+  const Mobility &bEntry = m_mobilities[bId];
+  if (!aEntry.isStatic || !bEntry.isStatic)
+    {
+      m_misses++;
+      return m_model->CalcRxPower (txPowerDbm, a, b);
+    }
+
+  uint64_t key = (static_cast<uint64_t> (aId) << 32) | bId;
+  std::unordered_map<uint64_t, Entry>::iterator it = m_cache.find (key);
+  if (it != m_cache.end ()
+      && it->second.txPowerDbm == txPowerDbm
+      && it->second.aGeneration == aEntry.generation
+      && it->second.bGeneration == bEntry.generation)
+    {
+      m_hits++;
+      return it->second.rxPowerDbm;
+    }
+
+  m_misses++;
+  double rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+  if (it == m_cache.end ())
+    {
+      if (m_cache.size () >= m_maxSize)
+        {
+          NS_LOG_LOGIC ("clear the " << m_cache.size () << " received powers");
+          m_cache.clear ();
+        }
+      it = m_cache.insert (std::make_pair (key, Entry ())).first;
+    }
+  it->second.txPowerDbm = txPowerDbm;
+  it->second.rxPowerDbm = rxPowerDbm;
+  it->second.aGeneration = aEntry.generation;
+  it->second.bGeneration = bEntry.generation;
+  return rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_model == 0)
+    {
+      return 0;
+    }
+  return m_model->AssignStreams (stream);
+}
+
+} // namespace ns3
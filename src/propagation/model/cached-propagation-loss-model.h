@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include "propagation-loss-model.h"
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Cache the received powers computed by another propagation loss
+ * model between static nodes.
+ *
+ * The received power computed by the model given by the Model attribute,
+ * and by the models chained after it, is kept for each ordered pair of
+ * mobility models and reused while the transmit power is the same and
+ * neither model has changed course. A mobility model is static while its
+ * velocity is zero: the received powers involving a moving model are not
+ * cached, and the CourseChange trace of each model invalidates the powers
+ * cached for it, as when it is moved or starts to move.
+ *
+ * The models computing the cached powers must be deterministic. The random
+ * fading models, such as ns3::NakagamiPropagationLossModel, are chained
+ * after this model with SetNext, so that they are applied to each cached
+ * power:
+ *
+ * \code
+ *   Ptr<CachedPropagationLossModel> cache = CreateObject<CachedPropagationLossModel> ();
+ *   cache->SetAttribute ("Model", PointerValue (CreateObject<LogDistancePropagationLossModel> ()));
+ *   cache->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+ * \endcode
+ *
+ * The PropagationLossModel interface has no frequency: a model is
+ * configured for one frequency, hence the powers cached by one instance
+ * are for the frequency of its model.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the model computing the received powers
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+  /**
+   * \return the model computing the received powers
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+
+  /**
+   * \return the number of received powers found in the cache
+   */
+  uint64_t GetHits (void) const;
+  /**
+   * \return the number of received powers computed by the model
+   */
+  uint64_t GetMisses (void) const;
+  /**
+   * \return the ratio of the received powers found in the cache, or 0
+   *         before any power is computed
+   */
+  double GetHitRatio (void) const;
+  /**
+   * \return the number of received powers in the cache
+   */
+  uint32_t GetN (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  CachedPropagationLossModel (const CachedPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  CachedPropagationLossModel & operator = (const CachedPropagationLossModel &);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /// A mobility model seen by the cache
+  struct Mobility
+  {
+    Ptr<MobilityModel> mobility; //!< The model
+    uint32_t generation;         //!< Incremented at each course change
+    bool isStatic;               //!< Whether the velocity of the model is zero
+  };
+
+  /// A cached received power
+  struct Entry
+  {
+    double txPowerDbm;   //!< The transmit power
+    double rxPowerDbm;   //!< The received power
+    uint32_t aGeneration; //!< The generation of the transmitter
+    uint32_t bGeneration; //!< The generation of the receiver
+  };
+
+  /**
+   * Get the identifier of a mobility model, and connect to its CourseChange
+   * trace the first time it is seen.
+   * \param mobility the mobility model
+   * \return the identifier of the model
+   */
+  uint32_t GetId (Ptr<MobilityModel> mobility) const;
+
+  /**
+   * Invalidate the received powers cached for a mobility model.
+   * \param model the cache
+   * \param id the identifier of the mobility model
+   * \param mobility the mobility model
+   */
+  static void CourseChanged (CachedPropagationLossModel *model, uint32_t id, Ptr<const MobilityModel> mobility);
+
+  /** Disconnect from the mobility models and clear the cache. */
+  void Clear (void);
+
+  Ptr<PropagationLossModel> m_model; //!< The model computing the received powers
+  uint32_t m_maxSize; //!< The number of received powers beyond which the cache is cleared
+  mutable std::unordered_map<const MobilityModel *, uint32_t> m_ids; //!< The identifiers of the mobility models
+  mutable std::vector<Mobility> m_mobilities; //!< The mobility models, by identifier
+  mutable std::unordered_map<uint64_t, Entry> m_cache; //!< The received powers, by pair of identifiers
+  mutable uint64_t m_hits; //!< The number of received powers found in the cache
+  mutable uint64_t m_misses; //!< The number of received powers computed
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
@@ -22,7 +22,11 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/cached-propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
 #include "ns3/simulator.h"
 
 using namespace ns3;
@@ -436,6 +440,106 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Compare the received powers of the cache with those of the model
+   * \param txPowerDbm the transmit power
+   * \param hits the expected number of hits
+   * \param misses the expected number of misses
+   */
+  void Check (double txPowerDbm, uint64_t hits, uint64_t misses);
+
+  Ptr<CachedPropagationLossModel> m_cache; //!< The cache
+  Ptr<PropagationLossModel> m_reference; //!< The model without a cache
+  Ptr<MobilityModel> m_a; //!< A static model
+  Ptr<MobilityModel> m_b; //!< A static model, moved during the test
+  Ptr<ConstantVelocityMobilityModel> m_c; //!< A moving model, stopped during the test
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoTeardown (void)
+{
+  m_cache = 0;
+  m_reference = 0;
+  m_a = 0;
+  m_b = 0;
+  m_c = 0;
+}
+
+void
+CachedPropagationLossModelTestCase::Check (double txPowerDbm, uint64_t hits, uint64_t misses)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_cache->CalcRxPower (txPowerDbm, m_a, m_b), m_reference->CalcRxPower (txPowerDbm, m_a, m_b),
+                         "Got unexpected rcv power from a to b at " << Simulator::Now ().As (Time::S));
+  NS_TEST_EXPECT_MSG_EQ (m_cache->CalcRxPower (txPowerDbm, m_b, m_c), m_reference->CalcRxPower (txPowerDbm, m_b, m_c),
+                         "Got unexpected rcv power from b to c at " << Simulator::Now ().As (Time::S));
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetHits (), hits, "Wrong number of hits at " << Simulator::Now ().As (Time::S));
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetMisses (), misses, "Wrong number of misses at " << Simulator::Now ().As (Time::S));
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  m_a = CreateObject<ConstantPositionMobilityModel> ();
+  m_a->SetPosition (Vector (0, 0, 0));
+  m_b = CreateObject<ConstantPositionMobilityModel> ();
+  m_b->SetPosition (Vector (50, 0, 0));
+  m_c = CreateObject<ConstantVelocityMobilityModel> ();
+  m_c->SetPosition (Vector (0, 30, 0));
+  m_c->SetVelocity (Vector (10, 0, 0));
+
+  m_reference = CreateObject<ThreeLogDistancePropagationLossModel> ();
+  m_cache = CreateObject<CachedPropagationLossModel> ();
+  m_cache->SetAttribute ("Model", PointerValue (m_reference));
+
+  // a and b are static, c moves
+  Simulator::Schedule (Seconds (1), &CachedPropagationLossModelTestCase::Check, this, 16, 0, 2);
+  Simulator::Schedule (Seconds (2), &CachedPropagationLossModelTestCase::Check, this, 16, 1, 3);
+  Simulator::Schedule (Seconds (3), &CachedPropagationLossModelTestCase::Check, this, 20, 1, 5);
+  // b is moved
+  Simulator::Schedule (Seconds (4), &MobilityModel::SetPosition, m_b, Vector (0, 80, 0));
+  Simulator::Schedule (Seconds (5), &CachedPropagationLossModelTestCase::Check, this, 20, 1, 7);
+  Simulator::Schedule (Seconds (6), &CachedPropagationLossModelTestCase::Check, this, 20, 2, 8);
+  // c stops
+  Simulator::Schedule (Seconds (7), &ConstantVelocityMobilityModel::SetVelocity, m_c, Vector (0, 0, 0));
+  Simulator::Schedule (Seconds (8), &CachedPropagationLossModelTestCase::Check, this, 20, 3, 9);
+  Simulator::Schedule (Seconds (9), &CachedPropagationLossModelTestCase::Check, this, 20, 5, 9);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_cache->GetHitRatio (), 5.0 / 14, 1e-9, "Wrong hit ratio");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetN (), 2, "Wrong number of cached powers");
+
+  // a random model chained after the cache is applied to each cached power
+  Ptr<RandomPropagationLossModel> fading = CreateObject<RandomPropagationLossModel> ();
+  fading->SetAttribute ("Variable", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=10.0]"));
+  m_cache->SetNext (fading);
+  double first = m_cache->CalcRxPower (20, m_a, m_b);
+  double second = m_cache->CalcRxPower (20, m_a, m_b);
+  NS_TEST_EXPECT_MSG_NE (first, second, "The fading is not applied to each cached power");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetHits (), 7, "Wrong number of hits with fading");
+  double rxPowerDbm = m_reference->CalcRxPower (20, m_a, m_b);
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (first, rxPowerDbm, "Got unexpected rcv power with fading");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (first, rxPowerDbm - 10, "Got unexpected rcv power with fading");
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +554,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -37,6 +37,7 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/antenna-model.h>
 #include <ns3/angles.h>
+#include <ns3/mobility-grid.h>
 #include "multi-model-spectrum-channel.h"
 
 namespace ns3 {
@@ -79,7 +80,8 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 }
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
-  : m_numDevices {0}
+  : m_numDevices {0},
+    m_maxRange {0}
 {
   NS_LOG_FUNCTION (this);
 }
@@ -100,7 +102,15 @@ MultiModelSpectrumChannel::GetTypeId (void)
     .SetParent<SpectrumChannel> ()
     .SetGroupName ("Spectrum")
     .AddConstructor<MultiModelSpectrumChannel> ()
-
+    .AddAttribute ("MaxRange",
+                   "The distance in meters beyond which the receivers are not "
+                   "considered by the transmissions, or 0 to consider all the "
+                   "receivers.  A positive range lets the channel find the "
+                   "receivers with a grid of their positions, instead of computing "
+                   "the propagation loss to each of them.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
   ;
   return tid;
 }
@@ -128,6 +138,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       if (phyIt != rxInfoIterator->second.m_rxPhys.end ())
         {
           rxInfoIterator->second.m_rxPhys.erase (phyIt);
+          rxInfoIterator->second.m_grid = 0;
           --m_numDevices;
           break; // there should be at most one entry
         }       
@@ -168,6 +179,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
     {
       // spectrum model is already known, just add the device to the corresponding list
       rxInfoIterator->second.m_rxPhys.push_back (phy);
+      rxInfoIterator->second.m_grid = 0;
     }
 }
 
@@ -235,7 +247,7 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
-  for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+  for (RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
     {
@@ -260,10 +272,29 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
         }
 
-      for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhys.end ();
-           ++rxPhyIterator)
+      const std::vector<Ptr<SpectrumPhy> > &rxPhys = rxInfoIterator->second.m_rxPhys;
+      std::size_t nRxPhys = rxPhys.size ();
+      std::vector<uint32_t> inRange;
+      bool culled = m_maxRange > 0 && txMobility;
+      if (culled)
+        {
+          // only the receivers within range are considered
+          Ptr<MobilityGrid> &grid = rxInfoIterator->second.m_grid;
+          if (grid == 0)
+            {
+              grid = Create<MobilityGrid> (m_maxRange);
+              for (auto rxPhyIterator = rxPhys.begin (); rxPhyIterator != rxPhys.end (); ++rxPhyIterator)
+                {
+                  grid->Add ((*rxPhyIterator)->GetMobility ());
+                }
+            }
+          grid->Find (txMobility->GetPosition (), m_maxRange, inRange);
+          nRxPhys = inRange.size ();
+        }
+
+      for (std::size_t k = 0; k < nRxPhys; ++k)
         {
+          auto rxPhyIterator = rxPhys.begin () + (culled ? inRange[k] : k);
           NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
                          "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
 
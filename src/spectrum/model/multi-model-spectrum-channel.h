@@ -27,6 +27,7 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/mobility-grid.h>
 #include <map>
 #include <set>
 
@@ -81,6 +82,7 @@ public:
 
   Ptr<const SpectrumModel> m_rxSpectrumModel;  //!< Rx Spectrum model.
   std::vector<Ptr<SpectrumPhy> > m_rxPhys;     //!< Container of the Rx Spectrum phy objects.
+  Ptr<MobilityGrid> m_grid;                    //!< Positions of the Rx Spectrum phy objects, or 0.
 };
 
 /**
@@ -102,6 +104,12 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * \note When the MaxRange attribute is positive, a transmission only
+ * reaches the receivers within this distance of the transmitter, found
+ * with a MobilityGrid of each set of receivers.  The propagation models
+ * and the traces are not invoked for the other receivers, hence random
+ * propagation models draw different values than without a range.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -169,6 +177,11 @@ private:
    */
   std::size_t m_numDevices;
 
+  /**
+   * Range of the transmissions, or 0 for all the receivers.
+   */
+  double m_maxRange;
+
 };
 
 
@@ -83,16 +83,20 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
   Ptr<SpectrumValue> tvvf = Create<SpectrumValue> (m_toSpectrumModel);
 
   Values::iterator tvit = tvvf->ValuesBegin ();
+  Values::const_iterator fvit = fvvf->ConstValuesBegin ();
+  const size_t *colInd = m_conversionColInd.data ();
+  const double *matrix = m_conversionMatrix.data ();
   size_t i = 0; // Index of conversion coefficient
 
   for (std::vector<size_t>::const_iterator convIt = m_conversionRowPtr.begin ();
        convIt != m_conversionRowPtr.end ();
        ++convIt)
     {
+      NS_ASSERT (*convIt <= m_conversionMatrix.size ());
       double sum = 0;
       while (i < *convIt)
         {
-          sum += (*fvvf)[m_conversionColInd.at (i)] * m_conversionMatrix.at (i);
+          sum += fvit[colInd[i]] * matrix[i];
           i++;
         }
       *tvit = sum;
@@ -147,6 +147,9 @@ private:
 
   Ptr<SpectrumErrorModel> m_errorModel; //!< Error model
 
+  SpectrumValue m_interf; //!< Interference and noise of the last chunk, reused by each chunk
+  SpectrumValue m_sinr;   //!< SINR of the last chunk, reused by each chunk
+
 
 
 };
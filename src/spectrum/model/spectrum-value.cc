@@ -41,13 +41,15 @@ SpectrumValue::SpectrumValue (Ptr<const SpectrumModel> sof)
 double&
 SpectrumValue::operator[] (size_t index)
 {
-  return m_values.at (index);
+  NS_ASSERT_MSG (index < m_values.size (), "Index " << index << " out of range");
+  return m_values[index];
 }
 
 const double&
 SpectrumValue::operator[] (size_t index) const
 {
-  return m_values.at (index);
+  NS_ASSERT_MSG (index < m_values.size (), "Index " << index << " out of range");
+  return m_values[index];
 }
 
 
@@ -106,17 +108,14 @@ SpectrumValue::ConstBandsEnd () const
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
+      v[i] += xv[i];
     }
 }
 
@@ -124,12 +123,11 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 += s;
-      ++it1;
+      v[i] += s;
     }
 }
 
@@ -138,17 +136,14 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
+      v[i] -= xv[i];
     }
 }
 
@@ -164,17 +159,14 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
+      v[i] *= xv[i];
     }
 }
 
@@ -182,12 +174,11 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 *= s;
-      ++it1;
+      v[i] *= s;
     }
 }
 
@@ -197,17 +188,14 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
+      v[i] /= xv[i];
     }
 }
 
@@ -216,12 +204,11 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 /= s;
-      ++it1;
+      v[i] /= s;
     }
 }
 
@@ -231,12 +218,44 @@ SpectrumValue::Divide (double s)
 void
 SpectrumValue::ChangeSign ()
 {
-  Values::iterator it1 = m_values.begin ();
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
+    {
+      v[i] = -v[i];
+    }
+}
+
 
-  while (it1 != m_values.end ())
+void
+SpectrumValue::AddScaled (const SpectrumValue& x, double s)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 = -(*it1);
-      ++it1;
+      v[i] += xv[i] * s;
+    }
+}
+
+
+void
+SpectrumValue::MultiplyAdd (const SpectrumValue& x, const SpectrumValue& y)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_spectrumModel == y.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  NS_ASSERT (m_values.size () == y.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  const double *yv = y.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
+    {
+      v[i] += xv[i] * yv[i];
     }
 }
 
@@ -280,12 +299,11 @@ void
 SpectrumValue::Pow (double exp)
 {
   NS_LOG_FUNCTION (this << exp);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 = std::pow (*it1, exp);
-      ++it1;
+      v[i] = std::pow (v[i], exp);
     }
 }
 
@@ -294,12 +312,11 @@ void
 SpectrumValue::Exp (double base)
 {
   NS_LOG_FUNCTION (this << base);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 = std::pow (base, *it1);
-      ++it1;
+      v[i] = std::pow (base, v[i]);
     }
 }
 
@@ -308,12 +325,11 @@ void
 SpectrumValue::Log10 ()
 {
   NS_LOG_FUNCTION (this);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 = std::log10 (*it1);
-      ++it1;
+      v[i] = std::log10 (v[i]);
     }
 }
 
@@ -321,12 +337,11 @@ void
 SpectrumValue::Log2 ()
 {
   NS_LOG_FUNCTION (this);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 = log2 (*it1);
-      ++it1;
+      v[i] = log2 (v[i]);
     }
 }
 
@@ -335,12 +350,11 @@ void
 SpectrumValue::Log ()
 {
   NS_LOG_FUNCTION (this);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 = std::log (*it1);
-      ++it1;
+      v[i] = std::log (v[i]);
     }
 }
 
@@ -348,11 +362,11 @@ double
 Norm (const SpectrumValue& x)
 {
   double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  const double *v = x.m_values.data ();
+  const size_t n = x.m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      s += (*it1) * (*it1);
-      ++it1;
+      s += v[i] * v[i];
     }
   return std::sqrt (s);
 }
@@ -362,11 +376,11 @@ double
 Sum (const SpectrumValue& x)
 {
   double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  const double *v = x.m_values.data ();
+  const size_t n = x.m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      s += (*it1);
-      ++it1;
+      s += v[i];
     }
   return s;
 }
@@ -389,17 +403,15 @@ Prod (const SpectrumValue& x)
 double
 Integral (const SpectrumValue& arg)
 {
+  NS_ASSERT (arg.m_spectrumModel->GetNumBands () == arg.m_values.size ());
   double i = 0;
-  Values::const_iterator vit = arg.ConstValuesBegin ();
+  const double *v = arg.m_values.data ();
+  const size_t n = arg.m_values.size ();
   Bands::const_iterator bit = arg.ConstBandsBegin ();
-  while (vit != arg.ConstValuesEnd ())
+  for (size_t k = 0; k < n; k++, ++bit)
     {
-      NS_ASSERT (bit != arg.ConstBandsEnd ());
-      i += (*vit) * (bit->fh - bit->fl);
-      ++vit;
-      ++bit;
+      i += v[k] * (bit->fh - bit->fl);
     }
-  NS_ASSERT (bit == arg.ConstBandsEnd ());
   return i;
 }
 
@@ -664,12 +676,11 @@ SpectrumValue::operator/= (double rhs)
 SpectrumValue&
 SpectrumValue::operator= (double rhs)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 = rhs;
-      ++it1;
+      v[i] = rhs;
     }
   return *this;
 }
@@ -54,6 +54,14 @@ typedef std::vector<double> Values;
  * The intended use of this class is to represent frequency-dependent
  * things, such as power spectral densities, frequency-dependent
  * propagation losses, spectral masks, etc.
+ *
+ * The binary operators return a new SpectrumValue, whose values are
+ * allocated on the heap.  Code evaluated for each signal or each chunk
+ * should rather use the compound assignment operators and the fused
+ * AddScaled and MultiplyAdd, which work in place on the contiguous values
+ * with loops the compiler can vectorize.  The copy assignment of a
+ * SpectrumValue with the same SpectrumModel reuses the values of the
+ * target too.
  */
 class SpectrumValue : public SimpleRefCount<SpectrumValue>
 {
@@ -84,6 +92,8 @@ public:
   /**
    * Access value at given frequency index
    *
+   * The index is only checked by an assertion, i.e. in the debug builds.
+   *
    * @param index the given frequency index
    *
    * @return reference to the value
@@ -93,6 +103,8 @@ public:
   /**
    * Access value at given frequency index
    *
+   * The index is only checked by an assertion, i.e. in the debug builds.
+   *
    * @param index the given frequency index
    *
    * @return const reference to the value
@@ -514,6 +526,29 @@ public:
    */
   Ptr<SpectrumValue> Copy () const;
 
+  /**
+   * Add a scaled SpectrumValue to this one, element by element, without
+   * the temporary built by <tt>*this += x * s</tt>.  The compiler may fuse
+   * the multiplication and the addition, which then round once, so that
+   * the results may differ from <tt>*this += x * s</tt> in the last ulp.
+   *
+   * \param x the SpectrumValue to add, with the same SpectrumModel
+   * \param s the scale of \p x
+   */
+  void AddScaled (const SpectrumValue& x, double s);
+
+  /**
+   * Add the product of two SpectrumValues to this one, element by element,
+   * without the temporary built by <tt>*this += x * y</tt>.  The compiler
+   * may fuse the multiplication and the addition, which then round once,
+   * so that the results may differ from <tt>*this += x * y</tt> in the
+   * last ulp.
+   *
+   * \param x the first factor, with the same SpectrumModel
+   * \param y the second factor, with the same SpectrumModel
+   */
+  void MultiplyAdd (const SpectrumValue& x, const SpectrumValue& y);
+
   /**
    *  TracedCallback signature for SpectrumValue.
    *
@@ -45,6 +45,33 @@ static const double offSetAlpha[20] = {
   0.0447,-0.0447,0.1413,-0.1413,0.2492,-0.2492,0.3715,-0.3715,0.5129,-0.5129,0.6797,-0.6797,0.8844,-0.8844,1.1481,-1.1481,1.5195,-1.5195,2.1551,-2.1551
 };
 
+/**
+ * Get the subcluster of a ray of one of the two strongest clusters (7.5-28)
+ * \param mIndex the index of the ray in its cluster
+ * \return the subcluster of the ray, 1, 2 or 3
+ */
+static uint8_t
+GetSubCluster (uint8_t mIndex)
+{
+  switch (mIndex)
+    {
+    case 9:
+    case 10:
+    case 11:
+    case 12:
+    case 17:
+    case 18:
+      return 2;
+    case 13:
+    case 14:
+    case 15:
+    case 16:
+      return 3;
+    default:                        //case 1,2,3,4,5,6,7,8,19,20
+      return 1;
+    }
+}
+
 /*
  * The cross correlation matrix is constructed according to table 7.5-6.
  * All the square root matrix is being generated using the Cholesky decomposition
@@ -811,6 +838,139 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
   return channelMatrix;
 }
 
+MatrixBasedChannelModel::Complex3DVector
+ThreeGppChannelModel::CalcClusterCoefficients (const Rays &rays, const DoubleVector &clusterPower,
+                                               uint8_t cluster1st, uint8_t cluster2nd,
+                                               Ptr<const ThreeGppAntennaArrayModel> uAntenna,
+                                               Ptr<const ThreeGppAntennaArrayModel> sAntenna)
+{
+  NS_LOG_FUNCTION (uAntenna << sAntenna);
+
+  uint8_t numCluster = clusterPower.size ();
+  uint8_t raysPerCluster = rays.m_raysPerCluster;
+  NS_ASSERT (rays.m_aoa.size () == static_cast<size_t> (numCluster) * raysPerCluster);
+
+  // order the rays so that those of each cluster, and of each subcluster of
+  // the two strongest clusters, are contiguous. The clusters come first, with
+  // the first subcluster of the strongest clusters, then the second and third
+  // subclusters, in the order they are stored in H_usn (7.5-28)
+  std::vector<uint32_t> order; // the index in rays of each ordered ray
+  std::vector<uint32_t> segments; // the first ordered ray of each cluster, and the end
+  DoubleVector scale; // the amplitude of the rays of each cluster
+  order.reserve (rays.m_aoa.size ());
+  for (uint8_t nIndex = 0; nIndex < numCluster; nIndex++)
+    {
+      bool strongest = nIndex == cluster1st || nIndex == cluster2nd;
+      segments.push_back (order.size ());
+      scale.push_back (sqrt (clusterPower[nIndex] / raysPerCluster));
+      for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+        {
+          if (!strongest || GetSubCluster (mIndex) == 1)
+            {
+              order.push_back (nIndex * raysPerCluster + mIndex);
+            }
+        }
+    }
+  for (uint8_t nIndex = 0; nIndex < numCluster; nIndex++)
+    {
+      if (nIndex != cluster1st && nIndex != cluster2nd)
+        {
+          continue;
+        }
+      for (uint8_t sub = 2; sub <= 3; sub++)
+        {
+          segments.push_back (order.size ());
+          scale.push_back (sqrt (clusterPower[nIndex] / raysPerCluster));
+          for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+            {
+              if (GetSubCluster (mIndex) == sub)
+                {
+                  order.push_back (nIndex * raysPerCluster + mIndex);
+                }
+            }
+        }
+    }
+  segments.push_back (order.size ());
+
+  uint64_t uSize = uAntenna->GetNumberOfElements ();
+  uint64_t sSize = sAntenna->GetNumberOfElements ();
+  std::vector<Vector> uLoc, sLoc;
+  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+    {
+      uLoc.push_back (uAntenna->GetElementLocation (uIndex));
+    }
+  for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+    {
+      sLoc.push_back (sAntenna->GetElementLocation (sIndex));
+    }
+
+  // the coefficient of a ray for the element pair u,s (7.5-22) is the product
+  // of a receive term, the polarization term times exp (i rxPhaseDiff), and
+  // of a transmit term, exp (i txPhaseDiff). These terms are computed once per
+  // ray and element, and stored as real and imaginary parts, element by element
+  uint64_t numRays = order.size ();
+  DoubleVector rxRe (uSize * numRays), rxIm (uSize * numRays);
+  DoubleVector txRe (sSize * numRays), txIm (sSize * numRays);
+  for (uint64_t i = 0; i < numRays; i++)
+    {
+      uint32_t r = order[i];
+      double k = rays.m_xpr[r];
+
+      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
+      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rays.m_aoa[r], rays.m_zoa[r]));
+      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rays.m_aod[r], rays.m_zod[r]));
+
+      std::complex<double> polarization = exp (std::complex<double> (0, rays.m_phase[0][r])) * rxFieldPatternTheta * txFieldPatternTheta
+        + exp (std::complex<double> (0, rays.m_phase[1][r])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi
+        + exp (std::complex<double> (0, rays.m_phase[2][r])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta
+        + exp (std::complex<double> (0, rays.m_phase[3][r])) * rxFieldPatternPhi * txFieldPatternPhi;
+
+      //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
+      Vector rxDir (sin (rays.m_zoa[r]) * cos (rays.m_aoa[r]), sin (rays.m_zoa[r]) * sin (rays.m_aoa[r]), cos (rays.m_zoa[r]));
+      for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+        {
+          double rxPhaseDiff = 2 * M_PI * (rxDir.x * uLoc[uIndex].x + rxDir.y * uLoc[uIndex].y + rxDir.z * uLoc[uIndex].z);
+          std::complex<double> rx = polarization * exp (std::complex<double> (0, rxPhaseDiff));
+          rxRe[uIndex * numRays + i] = rx.real ();
+          rxIm[uIndex * numRays + i] = rx.imag ();
+        }
+      Vector txDir (sin (rays.m_zod[r]) * cos (rays.m_aod[r]), sin (rays.m_zod[r]) * sin (rays.m_aod[r]), cos (rays.m_zod[r]));
+      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+          double txPhaseDiff = 2 * M_PI * (txDir.x * sLoc[sIndex].x + txDir.y * sLoc[sIndex].y + txDir.z * sLoc[sIndex].z);
+          txRe[sIndex * numRays + i] = cos (txPhaseDiff);
+          txIm[sIndex * numRays + i] = sin (txPhaseDiff);
+        }
+    }
+
+  // sum the products of the terms of the rays of each cluster, for each
+  // element pair
+  uint64_t numSegments = segments.size () - 1;
+  Complex3DVector H_usn (uSize, Complex2DVector (sSize, ThreeGppAntennaArrayModel::ComplexVector (numSegments)));
+  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+    {
+      const double *ur = rxRe.data () + uIndex * numRays;
+      const double *ui = rxIm.data () + uIndex * numRays;
+      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+          const double *sr = txRe.data () + sIndex * numRays;
+          const double *si = txIm.data () + sIndex * numRays;
+          for (uint64_t g = 0; g < numSegments; g++)
+            {
+              double re = 0;
+              double im = 0;
+              for (uint32_t i = segments[g]; i < segments[g + 1]; i++)
+                {
+                  re += ur[i] * sr[i] - ui[i] * si[i];
+                  im += ur[i] * si[i] + ui[i] * sr[i];
+                }
+              H_usn[uIndex][sIndex][g] = std::complex<double> (re, im) * scale[g];
+            }
+        }
+    }
+  return H_usn;
+}
+
 Ptr<ThreeGppChannelModel::ThreeGppChannelMatrix>
 ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
                                      Ptr<const ThreeGppAntennaArrayModel> sAntenna,
@@ -1139,10 +1299,14 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
         }
     }
 
-  double rayAoa_radian[numReducedCluster][raysPerCluster]; //rayAoa_radian[n][m], where n is cluster index, m is ray index
-  double rayAod_radian[numReducedCluster][raysPerCluster]; //rayAod_radian[n][m], where n is cluster index, m is ray index
-  double rayZoa_radian[numReducedCluster][raysPerCluster]; //rayZoa_radian[n][m], where n is cluster index, m is ray index
-  double rayZod_radian[numReducedCluster][raysPerCluster]; //rayZod_radian[n][m], where n is cluster index, m is ray index
+  // the rays of all the clusters, the ray m of the cluster n is at the index
+  // n * raysPerCluster + m
+  Rays rays;
+  rays.m_raysPerCluster = raysPerCluster;
+  rays.m_aoa.resize (numReducedCluster * raysPerCluster);
+  rays.m_aod.resize (numReducedCluster * raysPerCluster);
+  rays.m_zoa.resize (numReducedCluster * raysPerCluster);
+  rays.m_zod.resize (numReducedCluster * raysPerCluster);
 
   for (uint8_t nInd = 0; nInd < numReducedCluster; nInd++)
     {
@@ -1160,7 +1324,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
 
             }
           NS_ASSERT_MSG (tempAoa >= 0 && tempAoa <= 360, "the AOA should be the range of [0,360]");
-          rayAoa_radian[nInd][mInd] = tempAoa * M_PI / 180;
+          rays.m_aoa[nInd * raysPerCluster + mInd] = tempAoa * M_PI / 180;
 
           double tempAod = clusterAod[nInd] + table3gpp->m_cASD * offSetAlpha[mInd];
           while (tempAod > 360)
@@ -1173,7 +1337,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
               tempAod += 360;
             }
           NS_ASSERT_MSG (tempAod >= 0 && tempAod <= 360, "the AOD should be the range of [0,360]");
-          rayAod_radian[nInd][mInd] = tempAod * M_PI / 180;
+          rays.m_aod[nInd * raysPerCluster + mInd] = tempAod * M_PI / 180;
 
           double tempZoa = clusterZoa[nInd] + table3gpp->m_cZSA * offSetAlpha[mInd]; //(7.5-18)
 
@@ -1193,7 +1357,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
             }
 
           NS_ASSERT_MSG (tempZoa >= 0&&tempZoa <= 180, "the ZOA should be the range of [0,180]");
-          rayZoa_radian[nInd][mInd] = tempZoa * M_PI / 180;
+          rays.m_zoa[nInd * raysPerCluster + mInd] = tempZoa * M_PI / 180;
 
           double tempZod = clusterZod[nInd] + 0.375 * pow (10,table3gpp->m_uLgZSD) * offSetAlpha[mInd];             //(7.5-20)
 
@@ -1211,7 +1375,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
               tempZod = 360 - tempZod;
             }
           NS_ASSERT_MSG (tempZod >= 0&&tempZod <= 180, "the ZOD should be the range of [0,180]");
-          rayZod_radian[nInd][mInd] = tempZod * M_PI / 180;
+          rays.m_zod[nInd * raysPerCluster + mInd] = tempZod * M_PI / 180;
         }
     }
   DoubleVector angle_degree;
@@ -1293,34 +1457,38 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   //shuffle all the arrays to perform random coupling
   for (uint8_t cIndex = 0; cIndex < numReducedCluster; cIndex++)
     {
-      Shuffle (&rayAod_radian[cIndex][0], &rayAod_radian[cIndex][raysPerCluster]);
-      Shuffle (&rayAoa_radian[cIndex][0], &rayAoa_radian[cIndex][raysPerCluster]);
-      Shuffle (&rayZod_radian[cIndex][0], &rayZod_radian[cIndex][raysPerCluster]);
-      Shuffle (&rayZoa_radian[cIndex][0], &rayZoa_radian[cIndex][raysPerCluster]);
+      Shuffle (rays.m_aod.data () + cIndex * raysPerCluster, rays.m_aod.data () + (cIndex + 1) * raysPerCluster);
+      Shuffle (rays.m_aoa.data () + cIndex * raysPerCluster, rays.m_aoa.data () + (cIndex + 1) * raysPerCluster);
+      Shuffle (rays.m_zod.data () + cIndex * raysPerCluster, rays.m_zod.data () + (cIndex + 1) * raysPerCluster);
+      Shuffle (rays.m_zoa.data () + cIndex * raysPerCluster, rays.m_zoa.data () + (cIndex + 1) * raysPerCluster);
     }
 
   //Step 9: Generate the cross polarization power ratios
   //Step 10: Draw initial phases
-  Double2DVector crossPolarizationPowerRatios; // vector containing the cross polarization power ratios, as defined by 7.5-21
-  Double3DVector clusterPhase; //rayAoa_radian[n][m], where n is cluster index, m is ray index
+  Double3DVector clusterPhase; //clusterPhase[n][m], where n is cluster index, m is ray index
+  rays.m_xpr.reserve (numReducedCluster * raysPerCluster);
+  for (uint8_t pInd = 0; pInd < 4; pInd++)
+    {
+      rays.m_phase[pInd].reserve (numReducedCluster * raysPerCluster);
+    }
   for (uint8_t nInd = 0; nInd < numReducedCluster; nInd++)
     {
-      DoubleVector temp; // used to store the XPR values
       Double2DVector temp2; // used to store the PHI values for all the possible combination of polarization
       for (uint8_t mInd = 0; mInd < raysPerCluster; mInd++)
         {
           double uXprLinear = pow (10, table3gpp->m_uXpr / 10); // convert to linear
           double sigXprLinear = pow (10, table3gpp->m_sigXpr / 10); // convert to linear
 
-          temp.push_back (std::pow (10, (m_normalRv->GetValue () * sigXprLinear + uXprLinear) / 10));
+          // the cross polarization power ratio, as defined by 7.5-21
+          rays.m_xpr.push_back (std::pow (10, (m_normalRv->GetValue () * sigXprLinear + uXprLinear) / 10));
           DoubleVector temp3; // used to store the PHI valuse
           for (uint8_t pInd = 0; pInd < 4; pInd++)
             {
               temp3.push_back (m_uniformRv->GetValue (-1 * M_PI, M_PI));
+              rays.m_phase[pInd].push_back (temp3.back ());
             }
           temp2.push_back (temp3);
         }
-      crossPolarizationPowerRatios.push_back (temp);
       clusterPhase.push_back (temp2);
     }
   channelParams->m_clusterPhase = clusterPhase;
@@ -1355,133 +1523,19 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
 
   NS_LOG_INFO ("1st strongest cluster:" << (int)cluster1st << ", 2nd strongest cluster:" << (int)cluster2nd);
 
-  Complex3DVector H_usn;  //channel coffecient H_usn[u][s][n];
   // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
   // the total cluster will be numReducedCLuster + 4.
+  Complex3DVector H_usn = CalcClusterCoefficients (rays, clusterPower, cluster1st, cluster2nd,
+                                                   uAntenna, sAntenna); //channel coffecient H_usn[u][s][n];
 
-  H_usn.resize (uSize);
-  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
-    {
-      H_usn[uIndex].resize (sSize);
-      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
-        {
-          H_usn[uIndex][sIndex].resize (numReducedCluster);
-        }
-    }
-
-  // The following for loops computes the channel coefficients
   for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
       Vector uLoc = uAntenna->GetElementLocation (uIndex);
 
       for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
-
           Vector sLoc = sAntenna->GetElementLocation (sIndex);
 
-          for (uint8_t nIndex = 0; nIndex < numReducedCluster; nIndex++)
-            {
-              //Compute the N-2 weakest cluster, only vertical polarization. (7.5-22)
-              if (nIndex != cluster1st && nIndex != cluster2nd)
-                {
-                  std::complex<double> rays (0,0);
-                  for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
-                    {
-                      DoubleVector initialPhase = clusterPhase[nIndex][mIndex];
-                      double k = crossPolarizationPowerRatios[nIndex][mIndex];
-                      //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoa_radian[nIndex][mIndex]) * cos (rayAoa_radian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoa_radian[nIndex][mIndex]) * sin (rayAoa_radian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoa_radian[nIndex][mIndex]) * uLoc.z);
-
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZod_radian[nIndex][mIndex]) * cos (rayAod_radian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZod_radian[nIndex][mIndex]) * sin (rayAod_radian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZod_radian[nIndex][mIndex]) * sLoc.z);
-                      // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center anngle of each cluster.
-
-                      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoa_radian[nIndex][mIndex], rayZoa_radian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAod_radian[nIndex][mIndex], rayZod_radian[nIndex][mIndex]));
-
-                      rays += (exp (std::complex<double> (0, initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                               +exp (std::complex<double> (0, initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                               +exp (std::complex<double> (0, initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                               +exp (std::complex<double> (0, initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                        * exp (std::complex<double> (0, rxPhaseDiff))
-                        * exp (std::complex<double> (0, txPhaseDiff));
-                    }
-                  rays *= sqrt (clusterPower[nIndex] / raysPerCluster);
-                  H_usn[uIndex][sIndex][nIndex] = rays;
-                }
-              else  //(7.5-28)
-                {
-                  std::complex<double> raysSub1 (0,0);
-                  std::complex<double> raysSub2 (0,0);
-                  std::complex<double> raysSub3 (0,0);
-
-                  for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
-                    {
-                      double k = crossPolarizationPowerRatios[nIndex][mIndex];
-
-                      //ZML:Just remind me that the angle offsets for the 3 subclusters were not generated correctly.
-
-                      DoubleVector initialPhase = clusterPhase[nIndex][mIndex];
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoa_radian[nIndex][mIndex]) * cos (rayAoa_radian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoa_radian[nIndex][mIndex]) * sin (rayAoa_radian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoa_radian[nIndex][mIndex]) * uLoc.z);
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZod_radian[nIndex][mIndex]) * cos (rayAod_radian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZod_radian[nIndex][mIndex]) * sin (rayAod_radian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZod_radian[nIndex][mIndex]) * sLoc.z);
-
-                      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoa_radian[nIndex][mIndex], rayZoa_radian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAod_radian[nIndex][mIndex], rayZod_radian[nIndex][mIndex]));
-
-                      switch (mIndex)
-                        {
-                        case 9:
-                        case 10:
-                        case 11:
-                        case 12:
-                        case 17:
-                        case 18:
-                          raysSub2 += (exp (std::complex<double> (0, initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                                       +exp (std::complex<double> (0, initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                            * exp (std::complex<double> (0, rxPhaseDiff))
-                            * exp (std::complex<double> (0, txPhaseDiff));
-                          break;
-                        case 13:
-                        case 14:
-                        case 15:
-                        case 16:
-                          raysSub3 += (exp (std::complex<double> (0, initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                                       +exp (std::complex<double> (0, initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                            * exp (std::complex<double> (0, rxPhaseDiff))
-                            * exp (std::complex<double> (0, txPhaseDiff));
-                          break;
-                        default:                        //case 1,2,3,4,5,6,7,8,19,20
-                          raysSub1 += (exp (std::complex<double> (0, initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                                       +exp (std::complex<double> (0, initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                            * exp (std::complex<double> (0, rxPhaseDiff))
-                            * exp (std::complex<double> (0, txPhaseDiff));
-                          break;
-                        }
-                    }
-                  raysSub1 *= sqrt (clusterPower[nIndex] / raysPerCluster);
-                  raysSub2 *= sqrt (clusterPower[nIndex] / raysPerCluster);
-                  raysSub3 *= sqrt (clusterPower[nIndex] / raysPerCluster);
-                  H_usn[uIndex][sIndex][nIndex] = raysSub1;
-                  H_usn[uIndex][sIndex].push_back (raysSub2);
-                  H_usn[uIndex][sIndex].push_back (raysSub3);
-
-                }
-            }
           if (los) //(7.5-29) && (7.5-30)
             {
               std::complex<double> ray (0,0);
@@ -128,6 +128,46 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * The rays of the clusters of a channel realization, stored as a structure
+   * of arrays: the values of the ray m of the cluster n are at the index
+   * n * m_raysPerCluster + m of each array
+   */
+  struct Rays
+  {
+    uint8_t m_raysPerCluster = 0; //!< the number of rays per cluster
+    DoubleVector m_aoa; //!< the azimuth angles of arrival, in radians
+    DoubleVector m_zoa; //!< the zenith angles of arrival, in radians
+    DoubleVector m_aod; //!< the azimuth angles of departure, in radians
+    DoubleVector m_zod; //!< the zenith angles of departure, in radians
+    DoubleVector m_xpr; //!< the cross polarization power ratios, linear (7.5-21)
+    DoubleVector m_phase[4]; //!< the initial random phases, for each combination of polarization
+  };
+
+  /**
+   * Compute the NLOS channel coefficients of each cluster for each receiver
+   * and transmitter element pair u,s, as described by 7.5-22 and 7.5-28.
+   * The two strongest clusters are divided into 3 subclusters: the first
+   * takes the place of the cluster, the second and the third are appended,
+   * in the order of the clusters.
+   *
+   * The field patterns and the phases of the rays are computed once per ray
+   * and element, and the coefficient of each element pair is the complex dot
+   * product of a receive and a transmit vector over the rays of the cluster.
+   *
+   * \param rays the rays of the clusters
+   * \param clusterPower the power of each cluster
+   * \param cluster1st the strongest cluster
+   * \param cluster2nd the second strongest cluster
+   * \param uAntenna the u node antenna array
+   * \param sAntenna the s node antenna array
+   * \return the channel coefficients H_usn[u][s][n]
+   */
+  static Complex3DVector CalcClusterCoefficients (const Rays &rays, const DoubleVector &clusterPower,
+                                                  uint8_t cluster1st, uint8_t cluster2nd,
+                                                  Ptr<const ThreeGppAntennaArrayModel> uAntenna,
+                                                  Ptr<const ThreeGppAntennaArrayModel> sAntenna);
+
 private:
   /**
    * \brief Shuffle the elements of a simple sequence container of type double
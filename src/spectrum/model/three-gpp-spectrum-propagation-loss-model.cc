@@ -30,6 +30,7 @@
 #include "ns3/string.h"
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include <map>
 
 namespace ns3 {
@@ -39,6 +40,9 @@ NS_LOG_COMPONENT_DEFINE ("ThreeGppSpectrumPropagationLossModel");
 NS_OBJECT_ENSURE_REGISTERED (ThreeGppSpectrumPropagationLossModel);
 
 ThreeGppSpectrumPropagationLossModel::ThreeGppSpectrumPropagationLossModel ()
+  : m_longTermCacheSize (1000),
+    m_longTermHits (0),
+    m_longTermMisses (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -53,6 +57,7 @@ ThreeGppSpectrumPropagationLossModel::DoDispose ()
 {
   m_deviceAntennaMap.clear ();
   m_longTermMap.clear ();
+  m_longTermList.clear ();
   m_channelModel->Dispose ();
   m_channelModel = nullptr;
 }
@@ -70,6 +75,12 @@ ThreeGppSpectrumPropagationLossModel::GetTypeId (void)
                   MakePointerAccessor (&ThreeGppSpectrumPropagationLossModel::SetChannelModel,
                                        &ThreeGppSpectrumPropagationLossModel::GetChannelModel),
       MakePointerChecker<MatrixBasedChannelModel> ())
+    .AddAttribute ("LongTermCacheSize",
+                   "The maximum number of long term components kept in the cache. "
+                   "The least recently used component is evicted when the cache is full.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&ThreeGppSpectrumPropagationLossModel::m_longTermCacheSize),
+                   MakeUintegerChecker<uint32_t> (1))
     ;
   return tid;
 }
@@ -93,6 +104,24 @@ ThreeGppSpectrumPropagationLossModel::AddDevice (Ptr<NetDevice> n, Ptr<const Thr
   m_deviceAntennaMap.insert (std::make_pair (n->GetNode ()->GetId (), a));
 }
 
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheHits (void) const
+{
+  return m_longTermHits;
+}
+
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheMisses (void) const
+{
+  return m_longTermMisses;
+}
+
+uint32_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheSize (void) const
+{
+  return m_longTermList.size ();
+}
+
 double
 ThreeGppSpectrumPropagationLossModel::GetFrequency () const
 {
@@ -148,7 +177,7 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannel
 
 Ptr<SpectrumValue>
 ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                                           ThreeGppAntennaArrayModel::ComplexVector longTerm,
+                                                           const ThreeGppAntennaArrayModel::ComplexVector &longTerm,
                                                            Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
                                                            const ns3::Vector &sSpeed, const ns3::Vector &uSpeed) const
 {
@@ -163,6 +192,7 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
   // NOTE the update of Doppler is simplified by only taking the center angle of
   // each cluster in to consideration.
   double slotTime = Simulator::Now ().GetSeconds ();
+  double frequency = GetFrequency ();
   ThreeGppAntennaArrayModel::ComplexVector doppler;
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
@@ -174,7 +204,7 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
                                          + (sin (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * cos (params->m_angle[MatrixBasedChannelModel::AOD_INDEX][cIndex] * M_PI / 180) * sSpeed.x
                                          + sin (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * sin (params->m_angle[MatrixBasedChannelModel::AOD_INDEX][cIndex] * M_PI / 180) * sSpeed.y
                                          + cos (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * sSpeed.z))
-        * slotTime * GetFrequency () / 3e8;
+        * slotTime * frequency / 3e8;
       doppler.push_back (exp (std::complex<double> (0, temp_doppler)));
     }
 
@@ -201,73 +231,85 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
   return tempPsd;
 }
 
-ThreeGppAntennaArrayModel::ComplexVector
+const ThreeGppAntennaArrayModel::ComplexVector &
 ThreeGppSpectrumPropagationLossModel::GetLongTerm (uint32_t aId, uint32_t bId,
                                                    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
                                                    const ThreeGppAntennaArrayModel::ComplexVector &aW,
                                                    const ThreeGppAntennaArrayModel::ComplexVector &bW) const
 {
-  ThreeGppAntennaArrayModel::ComplexVector longTerm; // vector containing the long term component for each cluster
-
   // check if the channel matrix was generated considering a as the s-node and
   // b as the u-node or viceversa
-  ThreeGppAntennaArrayModel::ComplexVector sW, uW;
-  if (!channelMatrix->IsReverse (aId, bId))
-  {
-    sW = aW;
-    uW = bW;
-  }
-  else
-  {
-    sW = bW;
-    uW = aW;
-  }
+  bool reverse = channelMatrix->IsReverse (aId, bId);
+  const ThreeGppAntennaArrayModel::ComplexVector &sW = reverse ? bW : aW;
+  const ThreeGppAntennaArrayModel::ComplexVector &uW = reverse ? aW : bW;
 
   // compute the long term key, the key is unique for each tx-rx pair
   uint32_t x1 = std::min (aId, bId);
   uint32_t x2 = std::max (aId, bId);
   uint32_t longTermId = MatrixBasedChannelModel::GetKey (x1, x2);
 
-  bool update = false; // indicates whether the long term has to be updated
-  bool notFound = false; // indicates if the long term has not been computed yet
-
-  // look for the long term in the map and check if it is valid
-  if (m_longTermMap.find (longTermId) != m_longTermMap.end ())
-  {
-    NS_LOG_DEBUG ("found the long term component in the map");
-    longTerm = m_longTermMap[longTermId]->m_longTerm;
-
-    // check if the channel matrix has been updated
-    // or the s beam has been changed
-    // or the u beam has been changed
-    update = (m_longTermMap[longTermId]->m_channel->m_generatedTime != channelMatrix->m_generatedTime
-              || m_longTermMap[longTermId]->m_sW != sW
-              || m_longTermMap[longTermId]->m_uW != uW);
-
-  }
-  else
-  {
-    NS_LOG_DEBUG ("long term component NOT found");
-    notFound = true;
-  }
-
-  if (update || notFound)
+  // hash the key and the beamforming vectors
+  m_hasher.clear ();
+  m_hasher.GetHash64 (reinterpret_cast<const char *> (&longTermId), sizeof (longTermId));
+  m_hasher.GetHash64 (reinterpret_cast<const char *> (sW.data ()), sW.size () * sizeof (sW[0]));
+  uint64_t hash = m_hasher.GetHash64 (reinterpret_cast<const char *> (uW.data ()), uW.size () * sizeof (uW[0]));
+
+  // look for the long term in the cache
+  Ptr<LongTerm> longTermItem;
+  auto range = m_longTermMap.equal_range (hash);
+  for (auto it = range.first; it != range.second; ++it)
     {
-      NS_LOG_DEBUG ("compute the long term");
-      // compute the long term component
-      longTerm = CalcLongTerm (channelMatrix, sW, uW);
-
-      // store the long term
-      Ptr<LongTerm> longTermItem = Create<LongTerm> ();
-      longTermItem->m_longTerm = longTerm;
-      longTermItem->m_channel = channelMatrix;
+      Ptr<LongTerm> item = *it->second;
+      if (item->m_linkId == longTermId && item->m_sW == sW && item->m_uW == uW)
+        {
+          // move it to the front of the cache
+          m_longTermList.splice (m_longTermList.begin (), m_longTermList, it->second);
+          longTermItem = item;
+          break;
+        }
+    }
+
+  if (longTermItem != nullptr
+      && longTermItem->m_channel->m_generatedTime == channelMatrix->m_generatedTime)
+    {
+      NS_LOG_DEBUG ("found the long term component in the cache");
+      m_longTermHits++;
+      return longTermItem->m_longTerm;
+    }
+
+  NS_LOG_DEBUG ("compute the long term");
+  m_longTermMisses++;
+  if (longTermItem == nullptr)
+    {
+      // evict the least recently used long term if the cache is full
+      if (m_longTermList.size () >= m_longTermCacheSize)
+        {
+          Ptr<LongTerm> last = m_longTermList.back ();
+          range = m_longTermMap.equal_range (last->m_hash);
+          for (auto it = range.first; it != range.second; ++it)
+            {
+              if (*it->second == last)
+                {
+                  m_longTermMap.erase (it);
+                  break;
+                }
+            }
+          m_longTermList.pop_back ();
+        }
+
+      longTermItem = Create<LongTerm> ();
       longTermItem->m_sW = sW;
       longTermItem->m_uW = uW;
-
-      m_longTermMap[longTermId] = longTermItem;
+      longTermItem->m_linkId = longTermId;
+      longTermItem->m_hash = hash;
+      m_longTermList.push_front (longTermItem);
+      m_longTermMap.insert (std::make_pair (hash, m_longTermList.begin ()));
     }
 
-  return longTerm;
+  // compute the long term component for the current channel matrix
+  longTermItem->m_longTerm = CalcLongTerm (channelMatrix, sW, uW);
+  longTermItem->m_channel = channelMatrix;
+  return longTermItem->m_longTerm;
 }
 
 Ptr<SpectrumValue>
@@ -307,7 +349,7 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const Sp
   ThreeGppAntennaArrayModel::ComplexVector bW = bAntenna->GetBeamformingVector ();
 
   // retrieve the long term component
-  ThreeGppAntennaArrayModel::ComplexVector longTerm = GetLongTerm (aId, bId, channelMatrix, aW, bW);
+  const ThreeGppAntennaArrayModel::ComplexVector &longTerm = GetLongTerm (aId, bId, channelMatrix, aW, bW);
 
   // apply the beamforming gain
   rxPsd = CalcBeamformingGain (rxPsd, longTerm, channelMatrix, a->GetVelocity (), b->GetVelocity ());
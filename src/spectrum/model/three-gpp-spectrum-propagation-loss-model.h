@@ -24,9 +24,11 @@
 
 #include "ns3/spectrum-propagation-loss-model.h"
 #include <complex.h>
+#include <list>
 #include <map>
 #include <unordered_map>
 #include "ns3/matrix-based-channel-model.h"
+#include "ns3/hash.h"
 
 namespace ns3 {
 
@@ -115,9 +117,12 @@ public:
    * the product between the cluster matrices and the TX and RX beamforming
    * vectors (w_rx^T H^n_ab w_tx), and accounts for the Doppler component and
    * the propagation delay.
-   * To reduce the computational load, the long term component associated with
-   * a certain channel is cached and recomputed only when the channel realization
-   * is updated, or when the beamforming vectors change.
+   * To reduce the computational load, the long term components are kept in a
+   * least recently used cache, keyed by the pair of nodes and by their
+   * beamforming vectors, of at most LongTermCacheSize entries. A long term
+   * component is recomputed only when the channel realization is updated, or
+   * when the beamforming vectors are not found in the cache, so that the
+   * devices can alternate between several beams without recomputing it.
    *
    * \param txPsd tx PSD
    * \param a first node mobility model
@@ -129,6 +134,25 @@ public:
                                                            Ptr<const MobilityModel> a,
                                                            Ptr<const MobilityModel> b) const override;
 
+  /**
+   * Get the number of long term components found in the cache
+   * \return the number of cache hits
+   */
+  uint64_t GetLongTermCacheHits (void) const;
+
+  /**
+   * Get the number of long term components computed, because they were not
+   * found in the cache or were computed for an older channel realization
+   * \return the number of cache misses
+   */
+  uint64_t GetLongTermCacheMisses (void) const;
+
+  /**
+   * Get the number of long term components in the cache
+   * \return the size of the cache
+   */
+  uint32_t GetLongTermCacheSize (void) const;
+
 private:
   /**
    * Data structure that stores the long term component for a tx-rx pair
@@ -139,8 +163,13 @@ private:
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> m_channel; //!< pointer to the channel matrix used to compute the long term
     ThreeGppAntennaArrayModel::ComplexVector m_sW; //!< the beamforming vector for the node s used to compute the long term
     ThreeGppAntennaArrayModel::ComplexVector m_uW; //!< the beamforming vector for the node u used to compute the long term
+    uint32_t m_linkId; //!< the key of the pair of nodes
+    uint64_t m_hash; //!< the hash of the link key and of the beamforming vectors
   };
 
+  /// the long term components, the most recently used first
+  typedef std::list<Ptr<LongTerm> > LongTermList;
+
   /**
    * Get the operating frequency
    * \return the operating frequency in Hz
@@ -148,9 +177,10 @@ private:
   double GetFrequency () const;
 
   /**
-   * Looks for the long term component in m_longTermMap. If found, checks
+   * Looks for the long term component in the cache. If found, checks
    * whether it has to be updated. If not found or if it has to be updated,
-   * calls the method CalcLongTerm to compute it.
+   * calls the method CalcLongTerm to compute it, and evicts the least recently
+   * used component if the cache is full.
    * \param aId id of the first node
    * \param bId id of the second node
    * \param channelMatrix the channel matrix
@@ -158,10 +188,10 @@ private:
    * \param bW the beamforming vector of the second device
    * \return vector containing the long term compoenent for each cluster
    */
-  ThreeGppAntennaArrayModel::ComplexVector GetLongTerm (uint32_t aId, uint32_t bId,
-                                                        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                                        const ThreeGppAntennaArrayModel::ComplexVector &aW,
-                                                        const ThreeGppAntennaArrayModel::ComplexVector &bW) const;
+  const ThreeGppAntennaArrayModel::ComplexVector & GetLongTerm (uint32_t aId, uint32_t bId,
+                                                              Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                                              const ThreeGppAntennaArrayModel::ComplexVector &aW,
+                                                              const ThreeGppAntennaArrayModel::ComplexVector &bW) const;
   /**
    * Computes the long term component
    * \param channelMatrix the channel matrix H
@@ -183,12 +213,17 @@ private:
    * \return the rx PSD
    */
   Ptr<SpectrumValue> CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                          ThreeGppAntennaArrayModel::ComplexVector longTerm,
+                                          const ThreeGppAntennaArrayModel::ComplexVector &longTerm,
                                           Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
                                           const Vector &sSpeed, const Vector &uSpeed) const;
 
   std::unordered_map <uint32_t, Ptr<const ThreeGppAntennaArrayModel> > m_deviceAntennaMap; //!< map containig the <node, antenna> associations
-  mutable std::unordered_map < uint32_t, Ptr<const LongTerm> > m_longTermMap; //!< map containing the long term components
+  mutable LongTermList m_longTermList; //!< the cached long term components, the most recently used first
+  mutable std::unordered_multimap<uint64_t, LongTermList::iterator> m_longTermMap; //!< the cached long term components, by hash
+  uint32_t m_longTermCacheSize; //!< the maximum number of cached long term components
+  mutable uint64_t m_longTermHits; //!< the number of long term components found in the cache
+  mutable uint64_t m_longTermMisses; //!< the number of long term components computed
+  mutable Hasher m_hasher; //!< the hasher of the keys of the long term components
   Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
 };
 } // namespace ns3
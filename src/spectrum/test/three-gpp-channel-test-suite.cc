@@ -34,6 +34,7 @@
 #include "ns3/channel-condition-model.h"
 #include "ns3/three-gpp-spectrum-propagation-loss-model.h"
 #include "ns3/wifi-spectrum-value-helper.h"
+#include "ns3/random-variable-stream.h"
 
 using namespace ns3;
 
@@ -543,6 +544,325 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun ()
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup spectrum
+ *
+ * Test case for ThreeGppChannelModel::CalcClusterCoefficients, which checks
+ * the coefficients of random rays against a scalar computation of 7.5-22 and
+ * 7.5-28, element pair by element pair and ray by ray
+ */
+class ThreeGppClusterCoefficientsTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppClusterCoefficientsTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppClusterCoefficientsTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Compare the coefficients of random rays with the scalar computation
+   * \param numCluster the number of clusters
+   * \param cluster1st the strongest cluster
+   * \param cluster2nd the second strongest cluster
+   */
+  void Check (uint8_t numCluster, uint8_t cluster1st, uint8_t cluster2nd);
+
+  /**
+   * Compute the coefficients ray by ray, for each element pair
+   * \param rays the rays
+   * \param clusterPower the power of each cluster
+   * \param cluster1st the strongest cluster
+   * \param cluster2nd the second strongest cluster
+   * \return the channel coefficients H_usn[u][s][n]
+   */
+  MatrixBasedChannelModel::Complex3DVector CalcReference (const ThreeGppChannelModel::Rays &rays,
+                                                          const MatrixBasedChannelModel::DoubleVector &clusterPower,
+                                                          uint8_t cluster1st, uint8_t cluster2nd) const;
+
+  Ptr<UniformRandomVariable> m_random; //!< the random angles, phases and powers
+  Ptr<ThreeGppAntennaArrayModel> m_uAntenna; //!< the u node antenna array
+  Ptr<ThreeGppAntennaArrayModel> m_sAntenna; //!< the s node antenna array
+};
+
+ThreeGppClusterCoefficientsTest::ThreeGppClusterCoefficientsTest ()
+  : TestCase ("Check the cluster coefficients computed by the ThreeGppChannelModel")
+{
+}
+
+ThreeGppClusterCoefficientsTest::~ThreeGppClusterCoefficientsTest ()
+{
+}
+
+MatrixBasedChannelModel::Complex3DVector
+ThreeGppClusterCoefficientsTest::CalcReference (const ThreeGppChannelModel::Rays &rays,
+                                                const MatrixBasedChannelModel::DoubleVector &clusterPower,
+                                                uint8_t cluster1st, uint8_t cluster2nd) const
+{
+  uint8_t raysPerCluster = rays.m_raysPerCluster;
+  uint64_t uSize = m_uAntenna->GetNumberOfElements ();
+  uint64_t sSize = m_sAntenna->GetNumberOfElements ();
+  MatrixBasedChannelModel::Complex3DVector H_usn (uSize);
+  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+    {
+      Vector uLoc = m_uAntenna->GetElementLocation (uIndex);
+      H_usn[uIndex].resize (sSize);
+      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+          Vector sLoc = m_sAntenna->GetElementLocation (sIndex);
+          H_usn[uIndex][sIndex].resize (clusterPower.size ());
+          for (uint8_t nIndex = 0; nIndex < clusterPower.size (); nIndex++)
+            {
+              std::complex<double> sub[3];
+              for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+                {
+                  uint32_t r = nIndex * raysPerCluster + mIndex;
+                  double k = rays.m_xpr[r];
+                  double rxPhaseDiff = 2 * M_PI * (sin (rays.m_zoa[r]) * cos (rays.m_aoa[r]) * uLoc.x
+                                                   + sin (rays.m_zoa[r]) * sin (rays.m_aoa[r]) * uLoc.y
+                                                   + cos (rays.m_zoa[r]) * uLoc.z);
+                  double txPhaseDiff = 2 * M_PI * (sin (rays.m_zod[r]) * cos (rays.m_aod[r]) * sLoc.x
+                                                   + sin (rays.m_zod[r]) * sin (rays.m_aod[r]) * sLoc.y
+                                                   + cos (rays.m_zod[r]) * sLoc.z);
+                  double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
+                  std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = m_uAntenna->GetElementFieldPattern (Angles (rays.m_aoa[r], rays.m_zoa[r]));
+                  std::tie (txFieldPatternPhi, txFieldPatternTheta) = m_sAntenna->GetElementFieldPattern (Angles (rays.m_aod[r], rays.m_zod[r]));
+                  std::complex<double> ray = (exp (std::complex<double> (0, rays.m_phase[0][r])) * rxFieldPatternTheta * txFieldPatternTheta
+                                              + exp (std::complex<double> (0, rays.m_phase[1][r])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi
+                                              + exp (std::complex<double> (0, rays.m_phase[2][r])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta
+                                              + exp (std::complex<double> (0, rays.m_phase[3][r])) * rxFieldPatternPhi * txFieldPatternPhi)
+                    * exp (std::complex<double> (0, rxPhaseDiff))
+                    * exp (std::complex<double> (0, txPhaseDiff));
+                  uint8_t subIndex = 0;
+                  if (nIndex == cluster1st || nIndex == cluster2nd)
+                    {
+                      if ((mIndex >= 9 && mIndex <= 12) || mIndex == 17 || mIndex == 18)
+                        {
+                          subIndex = 1;
+                        }
+                      else if (mIndex >= 13 && mIndex <= 16)
+                        {
+                          subIndex = 2;
+                        }
+                    }
+                  sub[subIndex] += ray;
+                }
+              double amplitude = sqrt (clusterPower[nIndex] / raysPerCluster);
+              H_usn[uIndex][sIndex][nIndex] = sub[0] * amplitude;
+              if (nIndex == cluster1st || nIndex == cluster2nd)
+                {
+                  H_usn[uIndex][sIndex].push_back (sub[1] * amplitude);
+                  H_usn[uIndex][sIndex].push_back (sub[2] * amplitude);
+                }
+            }
+        }
+    }
+  return H_usn;
+}
+
+void
+ThreeGppClusterCoefficientsTest::Check (uint8_t numCluster, uint8_t cluster1st, uint8_t cluster2nd)
+{
+  ThreeGppChannelModel::Rays rays;
+  rays.m_raysPerCluster = 20;
+  MatrixBasedChannelModel::DoubleVector clusterPower;
+  for (uint8_t nIndex = 0; nIndex < numCluster; nIndex++)
+    {
+      clusterPower.push_back (m_random->GetValue (0, 1));
+      for (uint8_t mIndex = 0; mIndex < rays.m_raysPerCluster; mIndex++)
+        {
+          rays.m_aoa.push_back (m_random->GetValue (0, 2 * M_PI));
+          rays.m_zoa.push_back (m_random->GetValue (0, M_PI));
+          rays.m_aod.push_back (m_random->GetValue (0, 2 * M_PI));
+          rays.m_zod.push_back (m_random->GetValue (0, M_PI));
+          rays.m_xpr.push_back (m_random->GetValue (1, 100));
+          for (uint8_t pIndex = 0; pIndex < 4; pIndex++)
+            {
+              rays.m_phase[pIndex].push_back (m_random->GetValue (-M_PI, M_PI));
+            }
+        }
+    }
+
+  MatrixBasedChannelModel::Complex3DVector expected = CalcReference (rays, clusterPower, cluster1st, cluster2nd);
+  MatrixBasedChannelModel::Complex3DVector H_usn = ThreeGppChannelModel::CalcClusterCoefficients (rays, clusterPower,
+                                                                                                  cluster1st, cluster2nd,
+                                                                                                  m_uAntenna, m_sAntenna);
+  uint8_t numSub = cluster1st == cluster2nd ? 2 : 4;
+  NS_TEST_ASSERT_MSG_EQ (H_usn.size (), expected.size (), "Wrong number of u elements");
+  for (uint64_t uIndex = 0; uIndex < H_usn.size (); uIndex++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (H_usn[uIndex].size (), expected[uIndex].size (), "Wrong number of s elements");
+      for (uint64_t sIndex = 0; sIndex < H_usn[uIndex].size (); sIndex++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (H_usn[uIndex][sIndex].size (), numCluster + numSub, "Wrong number of clusters");
+          NS_TEST_ASSERT_MSG_EQ (H_usn[uIndex][sIndex].size (), expected[uIndex][sIndex].size (), "Wrong number of clusters");
+          for (uint64_t nIndex = 0; nIndex < H_usn[uIndex][sIndex].size (); nIndex++)
+            {
+              std::complex<double> h = H_usn[uIndex][sIndex][nIndex];
+              std::complex<double> e = expected[uIndex][sIndex][nIndex];
+              NS_TEST_EXPECT_MSG_LT (std::abs (h - e), 1e-10 * (1 + std::abs (e)),
+                                     "Wrong coefficient " << h << " instead of " << e << " for u=" << uIndex
+                                     << " s=" << sIndex << " n=" << nIndex);
+            }
+        }
+    }
+}
+
+void
+ThreeGppClusterCoefficientsTest::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  m_uAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (2),
+                                                                      "NumRows", UintegerValue (4),
+                                                                      "BearingAngle", DoubleValue (0.3));
+  m_sAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (4),
+                                                                      "NumRows", UintegerValue (2),
+                                                                      "DowntiltAngle", DoubleValue (0.2));
+  Check (12, 3, 7);
+  Check (12, 5, 0);
+  Check (8, 0, 0);
+  Check (1, 0, 0);
+}
+
+/**
+ * \ingroup spectrum
+ *
+ * Test case for the cache of long term components of the
+ * ThreeGppSpectrumPropagationLossModel: the devices alternate between
+ * several beams, the components of the recently used beams are found in
+ * the cache, with the same rx PSD, and the cache does not grow beyond its
+ * size
+ */
+class ThreeGppLongTermCacheTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppLongTermCacheTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppLongTermCacheTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Get a beamforming vector steered in the horizontal plane
+   * \param antenna the antenna array
+   * \param phi the azimuth angle of the beam
+   * \return the beamforming vector
+   */
+  static ThreeGppAntennaArrayModel::ComplexVector GetBeam (Ptr<ThreeGppAntennaArrayModel> antenna, double phi);
+};
+
+ThreeGppLongTermCacheTest::ThreeGppLongTermCacheTest ()
+  : TestCase ("Check the cache of long term components of the ThreeGppSpectrumPropagationLossModel")
+{
+}
+
+ThreeGppLongTermCacheTest::~ThreeGppLongTermCacheTest ()
+{
+}
+
+ThreeGppAntennaArrayModel::ComplexVector
+ThreeGppLongTermCacheTest::GetBeam (Ptr<ThreeGppAntennaArrayModel> antenna, double phi)
+{
+  ThreeGppAntennaArrayModel::ComplexVector beam;
+  double power = 1 / sqrt (antenna->GetNumberOfElements ());
+  for (uint64_t ind = 0; ind < antenna->GetNumberOfElements (); ind++)
+    {
+      Vector loc = antenna->GetElementLocation (ind);
+      double phase = -2 * M_PI * (cos (phi) * loc.x + sin (phi) * loc.y);
+      beam.push_back (exp (std::complex<double> (0, phase)) * power);
+    }
+  return beam;
+}
+
+void
+ThreeGppLongTermCacheTest::DoRun (void)
+{
+  Ptr<ThreeGppSpectrumPropagationLossModel> lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+  lossModel->SetAttribute ("LongTermCacheSize", UintegerValue (2));
+  lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (2.4e9));
+  lossModel->SetChannelModelAttribute ("Scenario", StringValue ("UMa"));
+  lossModel->SetChannelModelAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  nodes.Get (0)->AddDevice (txDev);
+  txDev->SetNode (nodes.Get (0));
+  nodes.Get (1)->AddDevice (rxDev);
+  rxDev->SetNode (nodes.Get (1));
+
+  Ptr<MobilityModel> txMob = CreateObject<ConstantPositionMobilityModel> ();
+  txMob->SetPosition (Vector (0.0, 0.0, 10.0));
+  Ptr<MobilityModel> rxMob = CreateObject<ConstantPositionMobilityModel> ();
+  rxMob->SetPosition (Vector (15.0, 0.0, 10.0));
+  nodes.Get (0)->AggregateObject (txMob);
+  nodes.Get (1)->AggregateObject (rxMob);
+
+  Ptr<ThreeGppAntennaArrayModel> txAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (4), "NumRows", UintegerValue (4));
+  Ptr<ThreeGppAntennaArrayModel> rxAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (4), "NumRows", UintegerValue (4));
+  lossModel->AddDevice (txDev, txAntenna);
+  lossModel->AddDevice (rxDev, rxAntenna);
+  rxAntenna->SetBeamformingVector (GetBeam (rxAntenna, M_PI));
+
+  WifiSpectrumValue5MhzFactory sf;
+  Ptr<SpectrumValue> txPsd = sf.CreateTxPowerSpectralDensity (0.1, 1);
+
+  // sweep the tx beams A, B, A, C, A, B with a cache of 2 components
+  double beams[] = {0, 0.5, 0, 1, 0, 0.5};
+  uint64_t hits[] = {0, 0, 1, 1, 2, 2};
+  std::vector<Ptr<SpectrumValue> > rxPsds;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      txAntenna->SetBeamformingVector (GetBeam (txAntenna, beams[i]));
+      rxPsds.push_back (lossModel->DoCalcRxPowerSpectralDensity (txPsd, txMob, rxMob));
+      NS_TEST_ASSERT_MSG_EQ (lossModel->GetLongTermCacheHits (), hits[i], "Wrong number of hits for beam " << i);
+      NS_TEST_ASSERT_MSG_EQ (lossModel->GetLongTermCacheMisses (), i + 1 - hits[i], "Wrong number of misses for beam " << i);
+      NS_TEST_ASSERT_MSG_EQ (lossModel->GetLongTermCacheSize (), std::min<uint32_t> (i + 1, 2), "Wrong size of the cache");
+    }
+
+  // the same beams give the same rx PSD, whether found in the cache or not
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      for (uint32_t j = 0; j < 6; j++)
+        {
+          bool equal = true;
+          for (uint32_t k = 0; k < txPsd->GetSpectrumModel ()->GetNumBands (); k++)
+            {
+              equal = equal && (*rxPsds[i])[k] == (*rxPsds[j])[k];
+            }
+          NS_TEST_EXPECT_MSG_EQ (equal, (beams[i] == beams[j]), "Wrong rx PSD for the beams " << i << " and " << j);
+        }
+    }
+
+  // the reverse link uses the same component
+  lossModel->DoCalcRxPowerSpectralDensity (txPsd, rxMob, txMob);
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetLongTermCacheHits (), 3, "The component of the reverse link is not found");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup spectrum
  *
@@ -563,6 +883,8 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite ()
   AddTestCase (new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
   AddTestCase (new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
   AddTestCase (new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppClusterCoefficientsTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppLongTermCacheTest, TestCase::QUICK);
 }
 
 static ThreeGppChannelTestSuite myTestSuite;
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "dctcp-queue-disc.h"
+#include "ns3/object-factory.h"
+#include "ns3/drop-tail-queue.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DctcpQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (DctcpQueueDisc);
+
+TypeId DctcpQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DctcpQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<DctcpQueueDisc> ()
+    .AddAttribute ("MaxSize",
+                   "The max queue size",
+                   QueueSizeValue (QueueSize ("1000p")),
+                   MakeQueueSizeAccessor (&QueueDisc::SetMaxSize,
+                                          &QueueDisc::GetMaxSize),
+                   MakeQueueSizeChecker ())
+    .AddAttribute ("MarkingThreshold",
+                   "The backlog (in packets or bytes) at or above which arriving "
+                   "packets are marked (K). A value not smaller than MaxSize "
+                   "disables backlog-based marking",
+                   QueueSizeValue (QueueSize ("65p")),
+                   MakeQueueSizeAccessor (&DctcpQueueDisc::m_markingThreshold),
+                   MakeQueueSizeChecker ())
+    .AddAttribute ("SojournThreshold",
+                   "The sojourn time above which departing packets are marked",
+                   TimeValue (Time::Max ()),
+                   MakeTimeAccessor (&DctcpQueueDisc::m_sojournThreshold),
+                   MakeTimeChecker ())
+    .AddAttribute ("UseEcn",
+                   "True to mark ECN capable packets instead of dropping them",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&DctcpQueueDisc::m_useEcn),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+DctcpQueueDisc::DctcpQueueDisc ()
+  : QueueDisc (QueueDiscSizePolicy::SINGLE_INTERNAL_QUEUE)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DctcpQueueDisc::~DctcpQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+DctcpQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  if (GetCurrentSize () + item > GetMaxSize ())
+    {
+      NS_LOG_LOGIC ("Queue full -- dropping pkt");
+      DropBeforeEnqueue (item, LIMIT_EXCEEDED_DROP);
+      return false;
+    }
+
+  uint32_t backlog = (m_markingThreshold.GetUnit () == QueueSizeUnit::PACKETS
+                      ? GetNPackets () : GetNBytes ());
+
+  if (backlog >= m_markingThreshold.GetValue ())
+    {
+      if (!m_useEcn || !Mark (item, THRESHOLD_EXCEEDED_MARK))
+        {
+          NS_LOG_LOGIC ("Backlog " << backlog << " exceeds K -- dropping pkt");
+          DropBeforeEnqueue (item, THRESHOLD_EXCEEDED_DROP);
+          return false;
+        }
+      NS_LOG_LOGIC ("Backlog " << backlog << " exceeds K -- marking pkt");
+    }
+
+  bool retval = GetInternalQueue (0)->Enqueue (item);
+
+  // If Queue::Enqueue fails, QueueDisc::DropBeforeEnqueue is called by the
+  // internal queue because QueueDisc::AddInternalQueue sets the trace callback
+
+  NS_LOG_LOGIC ("Number packets " << GetInternalQueue (0)->GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << GetInternalQueue (0)->GetNBytes ());
+
+  return retval;
+}
+
+Ptr<QueueDiscItem>
+DctcpQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<QueueDiscItem> item = GetInternalQueue (0)->Dequeue ();
+
+  if (!item)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  if (m_useEcn && m_sojournThreshold != Time::Max ()
+      && Simulator::Now () - item->GetTimeStamp () > m_sojournThreshold
+      && Mark (item, SOJOURN_EXCEEDED_MARK))
+    {
+      NS_LOG_LOGIC ("Marking due to SojournThreshold " << m_sojournThreshold.GetSeconds ());
+    }
+
+  return item;
+}
+
+Ptr<const QueueDiscItem>
+DctcpQueueDisc::DoPeek (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<const QueueDiscItem> item = GetInternalQueue (0)->Peek ();
+
+  if (!item)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  return item;
+}
+
+bool
+DctcpQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNQueueDiscClasses () > 0)
+    {
+      NS_LOG_ERROR ("DctcpQueueDisc cannot have classes");
+      return false;
+    }
+
+  if (GetNPacketFilters () > 0)
+    {
+      NS_LOG_ERROR ("DctcpQueueDisc needs no packet filter");
+      return false;
+    }
+
+  if (GetNInternalQueues () == 0)
+    {
+      // add a DropTail queue
+      AddInternalQueue (CreateObjectWithAttributes<DropTailQueue<QueueDiscItem> >
+                          ("MaxSize", QueueSizeValue (GetMaxSize ())));
+    }
+
+  if (GetNInternalQueues () != 1)
+    {
+      NS_LOG_ERROR ("DctcpQueueDisc needs 1 internal queue");
+      return false;
+    }
+
+  return true;
+}
+
+void
+DctcpQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+} // namespace ns3
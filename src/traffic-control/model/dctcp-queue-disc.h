@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DCTCP_QUEUE_DISC_H
+#define DCTCP_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Step-marking queue disc for DCTCP and D2TCP
+ *
+ * A FIFO queue disc implementing the switch side of DCTCP: an arriving
+ * packet is CE-marked if the instantaneous backlog is at least K, and a
+ * departing packet is CE-marked if its sojourn time exceeds a threshold.
+ * K can be expressed either in packets or in bytes, independently of the
+ * unit used for the queue disc capacity. Unlike RedQueueDisc configured
+ * with QW = 1 and MinTh = MaxTh, no average queue length, idle time or
+ * marking probability is computed per packet.
+ *
+ * Packets that exceed the backlog threshold but cannot be marked (because
+ * they are not ECN capable or UseEcn is false) are dropped. The sojourn
+ * time threshold only marks packets, it never drops them.
+ */
+class DctcpQueueDisc : public QueueDisc
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief DctcpQueueDisc constructor
+   */
+  DctcpQueueDisc ();
+
+  virtual ~DctcpQueueDisc ();
+
+  // Reasons for dropping packets
+  static constexpr const char* LIMIT_EXCEEDED_DROP = "Queue disc limit exceeded";  //!< Packet dropped due to queue disc limit exceeded
+  static constexpr const char* THRESHOLD_EXCEEDED_DROP = "Marking threshold exceeded (non-ECT drop)";  //!< Non-ECT packet dropped because the backlog exceeds K
+  // Reasons for marking packets
+  static constexpr const char* THRESHOLD_EXCEEDED_MARK = "Marking threshold exceeded";  //!< Packet marked because the backlog exceeds K
+  static constexpr const char* SOJOURN_EXCEEDED_MARK = "Sojourn time threshold exceeded";  //!< Packet marked because its sojourn time exceeds the threshold
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual Ptr<const QueueDiscItem> DoPeek (void);
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  QueueSize m_markingThreshold;   //!< Backlog at or above which arriving packets are marked (K)
+  Time m_sojournThreshold;        //!< Sojourn time above which departing packets are marked
+  bool m_useEcn;                  //!< True to mark ECN capable packets, false to drop them
+};
+
+} // namespace ns3
+
+#endif /* DCTCP_QUEUE_DISC_H */
@@ -0,0 +1,569 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/uinteger.h"
+#include "ns3/integer.h"
+#include "ns3/simulator.h"
+#include "htb-queue-disc.h"
+#include <algorithm>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("HtbQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (HtbClass);
+
+TypeId HtbClass::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HtbClass")
+    .SetParent<QueueDiscClass> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<HtbClass> ()
+    .AddAttribute ("Rate",
+                   "The rate assured to the class",
+                   DataRateValue (DataRate ("1Mbps")),
+                   MakeDataRateAccessor (&HtbClass::m_rate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Ceil",
+                   "The maximum rate of the class, including the rate borrowed "
+                   "from its ancestors. Zero means equal to Rate",
+                   DataRateValue (DataRate ("0bps")),
+                   MakeDataRateAccessor (&HtbClass::m_ceil),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Burst",
+                   "The size (bytes) of the bucket of the assured rate. Zero means "
+                   "the amount of bytes sent at Rate in 1 ms, with a minimum of 3000",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_burst),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Cburst",
+                   "The size (bytes) of the bucket of the ceil rate. Zero means "
+                   "the amount of bytes sent at Ceil in 1 ms, with a minimum of 3000",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_cburst),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Priority",
+                   "The priority of the class when sending at the same level (0 is the highest)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_priority),
+                   MakeUintegerChecker<uint32_t> (0, HtbQueueDisc::MAX_LEVELS - 1))
+    .AddAttribute ("Quantum",
+                   "The DRR quantum (bytes) of the class. Zero means one tenth of "
+                   "the bytes sent at Rate in one second, between 1000 and 200000",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_quantum),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Parent",
+                   "The identifier of the parent inner class, or -1 for top level classes",
+                   IntegerValue (-1),
+                   MakeIntegerAccessor (&HtbClass::m_parent),
+                   MakeIntegerChecker<int32_t> (-1))
+  ;
+  return tid;
+}
+
+HtbClass::HtbClass ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+HtbClass::~HtbClass ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DataRate
+HtbClass::GetRate (void) const
+{
+  return m_rate;
+}
+
+DataRate
+HtbClass::GetCeil (void) const
+{
+  return (m_ceil.GetBitRate () > 0 ? m_ceil : m_rate);
+}
+
+uint32_t
+HtbClass::GetBurst (void) const
+{
+  return (m_burst > 0 ? m_burst : std::max<uint64_t> (3000, m_rate.GetBitRate () / 8000));
+}
+
+uint32_t
+HtbClass::GetCburst (void) const
+{
+  return (m_cburst > 0 ? m_cburst : std::max<uint64_t> (3000, GetCeil ().GetBitRate () / 8000));
+}
+
+uint32_t
+HtbClass::GetPriority (void) const
+{
+  return m_priority;
+}
+
+uint32_t
+HtbClass::GetQuantum (void) const
+{
+  if (m_quantum > 0)
+    {
+      return m_quantum;
+    }
+  return std::min<uint64_t> (std::max<uint64_t> (m_rate.GetBitRate () / 80, 1000), 200000);
+}
+
+int32_t
+HtbClass::GetParent (void) const
+{
+  return m_parent;
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (HtbQueueDisc);
+
+constexpr uint32_t HtbQueueDisc::MAX_LEVELS;
+constexpr uint32_t HtbQueueDisc::NONE;
+
+/// Lower bound of the tokens of a class (60 seconds, in ps)
+static const int64_t HTB_MIN_TOKENS = -60000000000000LL;
+
+TypeId HtbQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HtbQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<HtbQueueDisc> ()
+    .AddAttribute ("DefaultClass",
+                   "The leaf class of the packets not classified by any filter",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbQueueDisc::m_defaultClass),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+HtbQueueDisc::HtbQueueDisc ()
+  : QueueDisc (QueueDiscSizePolicy::NO_LIMITS),
+    m_activeLists (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+HtbQueueDisc::~HtbQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+HtbQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_id);
+  m_innerClasses.clear ();
+  m_state.clear ();
+  m_waitQueue = std::priority_queue<WaitEntry, std::vector<WaitEntry>, std::greater<WaitEntry> > ();
+  QueueDisc::DoDispose ();
+}
+
+uint32_t
+HtbQueueDisc::AddInnerClass (Ptr<HtbClass> cl)
+{
+  NS_LOG_FUNCTION (this << cl);
+  NS_ABORT_MSG_IF (cl->GetQueueDisc () != 0, "Inner classes cannot have an attached queue disc");
+  m_innerClasses.push_back (cl);
+  return m_innerClasses.size () - 1;
+}
+
+std::size_t
+HtbQueueDisc::GetNInnerClasses (void) const
+{
+  return m_innerClasses.size ();
+}
+
+Ptr<HtbClass>
+HtbQueueDisc::GetInnerClass (std::size_t i) const
+{
+  NS_ASSERT (i < m_innerClasses.size ());
+  return m_innerClasses[i];
+}
+
+uint32_t
+HtbQueueDisc::GetLevel (uint32_t leaf, int64_t now, int64_t &wait) const
+{
+  wait = std::numeric_limits<int64_t>::max ();
+  uint32_t c = leaf;
+  for (uint32_t level = 0; ; level++)
+    {
+      const ClassState &s = m_state[c];
+      int64_t diff = now - s.checkpoint;
+      int64_t ctokens = std::min (s.ctokens + diff, s.cbuffer);
+      if (ctokens < 0)
+        {
+          // neither this class nor its descendants can exceed the ceil rate
+          wait = std::min (wait, -ctokens);
+          return NONE;
+        }
+      int64_t tokens = std::min (s.tokens + diff, s.buffer);
+      if (tokens >= 0)
+        {
+          return level;
+        }
+      wait = std::min (wait, -tokens);
+      if (s.parent == NONE)
+        {
+          return NONE;
+        }
+      c = s.parent;
+    }
+}
+
+void
+HtbQueueDisc::Link (uint32_t leaf, uint32_t list)
+{
+  ClassState &s = m_state[leaf];
+  s.list = list;
+  uint32_t head = m_head[list];
+  if (head == NONE)
+    {
+      s.prev = s.next = leaf;
+      m_head[list] = leaf;
+      m_activeLists |= (uint64_t (1) << list);
+      return;
+    }
+  // append at the tail, i.e., right before the head
+  uint32_t tail = m_state[head].prev;
+  s.prev = tail;
+  s.next = head;
+  m_state[tail].next = leaf;
+  m_state[head].prev = leaf;
+}
+
+void
+HtbQueueDisc::Unlink (uint32_t leaf)
+{
+  ClassState &s = m_state[leaf];
+  if (s.list == NONE)
+    {
+      return;
+    }
+  if (s.next == leaf)
+    {
+      m_head[s.list] = NONE;
+      m_activeLists &= ~(uint64_t (1) << s.list);
+    }
+  else
+    {
+      m_state[s.prev].next = s.next;
+      m_state[s.next].prev = s.prev;
+      if (m_head[s.list] == leaf)
+        {
+          m_head[s.list] = s.next;
+        }
+    }
+  s.list = NONE;
+}
+
+void
+HtbQueueDisc::Schedule (uint32_t leaf, int64_t now)
+{
+  ClassState &s = m_state[leaf];
+  int64_t wait;
+  uint32_t level = GetLevel (leaf, now, wait);
+  s.generation++;
+
+  if (level != NONE)
+    {
+      NS_LOG_LOGIC ("Leaf " << leaf << " can send at level " << level);
+      Link (leaf, level * MAX_LEVELS + s.priority);
+    }
+  if (level != 0 && wait != std::numeric_limits<int64_t>::max ())
+    {
+      NS_LOG_LOGIC ("Leaf " << leaf << " may send at a lower level in " << wait << " ps");
+      m_waitQueue.push ({now + wait, leaf, s.generation});
+    }
+}
+
+void
+HtbQueueDisc::Charge (uint32_t leaf, uint32_t level, uint32_t bytes, int64_t now)
+{
+  uint32_t c = leaf;
+  for (uint32_t h = 0; c != NONE; h++)
+    {
+      ClassState &s = m_state[c];
+      int64_t diff = now - s.checkpoint;
+      s.tokens = std::min (s.tokens + diff, s.buffer);
+      if (h >= level)
+        {
+          // the classes from the lender up pay for the assured rate; the
+          // borrowers below only refresh their tokens
+          s.tokens = std::max (s.tokens - bytes * s.psPerByte, HTB_MIN_TOKENS);
+        }
+      s.ctokens = std::max (std::min (s.ctokens + diff, s.cbuffer) - bytes * s.cpsPerByte,
+                            HTB_MIN_TOKENS);
+      s.checkpoint = now;
+      c = s.parent;
+    }
+}
+
+bool
+HtbQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  uint32_t leaf = m_defaultClass;
+  int32_t ret = Classify (item);
+
+  if (ret == PacketFilter::PF_NO_MATCH)
+    {
+      NS_LOG_DEBUG ("No filter has been able to classify this packet, using the default class.");
+    }
+  else if (ret >= 0 && static_cast<uint32_t> (ret) < GetNQueueDiscClasses ())
+    {
+      leaf = ret;
+    }
+
+  if (leaf >= GetNQueueDiscClasses ())
+    {
+      NS_LOG_LOGIC ("No class for the packet -- dropping pkt");
+      DropBeforeEnqueue (item, UNCLASSIFIED_DROP);
+      return false;
+    }
+
+  bool retval = GetQueueDiscClass (leaf)->GetQueueDisc ()->Enqueue (item);
+
+  // If Queue::Enqueue fails, QueueDisc::Drop is called by the child queue disc
+  // because QueueDisc::AddQueueDiscClass sets the drop callback
+
+  if (retval && !m_state[leaf].active)
+    {
+      m_state[leaf].active = true;
+      Schedule (leaf, Simulator::Now ().GetPicoSeconds ());
+    }
+
+  return retval;
+}
+
+Ptr<QueueDiscItem>
+HtbQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  int64_t now = Simulator::Now ().GetPicoSeconds ();
+
+  // reschedule the leaves whose waiting time has elapsed
+  while (!m_waitQueue.empty () && m_waitQueue.top ().time <= now)
+    {
+      WaitEntry e = m_waitQueue.top ();
+      m_waitQueue.pop ();
+      if (m_state[e.leaf].active && m_state[e.leaf].generation == e.generation)
+        {
+          Unlink (e.leaf);
+          Schedule (e.leaf, now);
+        }
+    }
+
+  uint32_t skipped = 0;
+  while (m_activeLists != 0)
+    {
+      // lowest level first, then highest priority
+      uint32_t list = __builtin_ctzll (m_activeLists);
+      uint32_t level = list / MAX_LEVELS;
+      uint32_t leaf = m_head[list];
+      ClassState &s = m_state[leaf];
+      int64_t wait;
+
+      // the level changes when the leaf or its ancestors are charged
+      if (GetLevel (leaf, now, wait) != level)
+        {
+          Unlink (leaf);
+          Schedule (leaf, now);
+          continue;
+        }
+
+      Ptr<QueueDisc> child = GetQueueDiscClass (leaf)->GetQueueDisc ();
+      Ptr<QueueDiscItem> item = child->Dequeue ();
+
+      if (!item)
+        {
+          if (child->GetNPackets () == 0)
+            {
+              Unlink (leaf);
+              s.active = false;
+              s.generation++;
+            }
+          else if (++skipped <= GetNQueueDiscClasses ())
+            {
+              // the child queue disc is holding its packets back
+              m_head[list] = s.next;
+            }
+          else
+            {
+              break;
+            }
+          continue;
+        }
+
+      NS_LOG_LOGIC ("Popped from leaf " << leaf << " at level " << level << ": " << item);
+
+      s.deficit -= item->GetSize ();
+      if (s.deficit < 0)
+        {
+          s.deficit += s.quantum;
+          m_head[list] = s.next;
+        }
+
+      Charge (leaf, level, item->GetSize (), now);
+
+      if (child->GetNPackets () == 0)
+        {
+          Unlink (leaf);
+          s.active = false;
+          s.generation++;
+        }
+      else if (GetLevel (leaf, now, wait) != level)
+        {
+          Unlink (leaf);
+          Schedule (leaf, now);
+        }
+
+      return item;
+    }
+
+  // no leaf can send: wake up when the first one may send again
+  if (!m_waitQueue.empty ())
+    {
+      Time delay = PicoSeconds (m_waitQueue.top ().time - now);
+      if (m_id.IsExpired () || Simulator::GetDelayLeft (m_id) > delay)
+        {
+          Simulator::Cancel (m_id);
+          m_id = Simulator::Schedule (delay, &QueueDisc::Run, this);
+          NS_LOG_LOGIC ("Waking Event Scheduled in " << delay);
+        }
+    }
+
+  NS_LOG_LOGIC ("No packet can be sent");
+  return 0;
+}
+
+bool
+HtbQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNInternalQueues () > 0)
+    {
+      NS_LOG_ERROR ("HtbQueueDisc cannot have internal queues");
+      return false;
+    }
+
+  if (GetNQueueDiscClasses () == 0)
+    {
+      NS_LOG_ERROR ("HtbQueueDisc needs at least one leaf class");
+      return false;
+    }
+
+  if (GetNQueueDiscClasses () + m_innerClasses.size () >= NONE)
+    {
+      NS_LOG_ERROR ("Too many classes");
+      return false;
+    }
+
+  std::vector<uint32_t> depth (m_innerClasses.size ());
+  for (std::size_t i = 0; i < m_innerClasses.size (); i++)
+    {
+      int32_t parent = m_innerClasses[i]->GetParent ();
+      if (parent >= static_cast<int32_t> (i))
+        {
+          NS_LOG_ERROR ("The parent of inner class " << i << " must be added before it");
+          return false;
+        }
+      depth[i] = (parent < 0 ? 1 : depth[parent] + 1);
+    }
+
+  for (std::size_t i = 0; i < GetNQueueDiscClasses (); i++)
+    {
+      Ptr<HtbClass> cl = DynamicCast<HtbClass> (GetQueueDiscClass (i));
+      if (!cl)
+        {
+          NS_LOG_ERROR ("The classes of HtbQueueDisc must be HtbClass objects");
+          return false;
+        }
+      int32_t parent = cl->GetParent ();
+      if (parent >= static_cast<int32_t> (m_innerClasses.size ()))
+        {
+          NS_LOG_ERROR ("The parent of leaf class " << i << " is not an inner class");
+          return false;
+        }
+      if (parent >= 0 && depth[parent] >= MAX_LEVELS)
+        {
+          NS_LOG_ERROR ("The class hierarchy cannot be deeper than " << MAX_LEVELS << " levels");
+          return false;
+        }
+    }
+
+  for (std::size_t i = 0; i < GetNQueueDiscClasses () + m_innerClasses.size (); i++)
+    {
+      Ptr<HtbClass> cl = (i < GetNQueueDiscClasses ()
+                          ? DynamicCast<HtbClass> (GetQueueDiscClass (i))
+                          : m_innerClasses[i - GetNQueueDiscClasses ()]);
+      if (cl->GetRate ().GetBitRate () == 0 || cl->GetCeil () < cl->GetRate ())
+        {
+          NS_LOG_ERROR ("The rate of a class must be positive and not greater than its ceil");
+          return false;
+        }
+    }
+
+  return true;
+}
+
+void
+HtbQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t nLeaves = GetNQueueDiscClasses ();
+  int64_t now = Simulator::Now ().GetPicoSeconds ();
+
+  m_state.resize (nLeaves + m_innerClasses.size ());
+  for (uint32_t i = 0; i < m_state.size (); i++)
+    {
+      Ptr<HtbClass> cl = (i < nLeaves
+                          ? DynamicCast<HtbClass> (GetQueueDiscClass (i))
+                          : m_innerClasses[i - nLeaves]);
+      ClassState &s = m_state[i];
+      s.parent = (cl->GetParent () < 0 ? NONE : nLeaves + cl->GetParent ());
+      s.psPerByte = std::max<int64_t> (8000000000000LL / cl->GetRate ().GetBitRate (), 1);
+      s.cpsPerByte = std::max<int64_t> (8000000000000LL / cl->GetCeil ().GetBitRate (), 1);
+      s.buffer = cl->GetBurst () * s.psPerByte;
+      s.cbuffer = cl->GetCburst () * s.cpsPerByte;
+      s.tokens = s.buffer;
+      s.ctokens = s.cbuffer;
+      s.checkpoint = now;
+      s.priority = cl->GetPriority ();
+      s.quantum = cl->GetQuantum ();
+      s.deficit = 0;
+      s.prev = s.next = s.list = NONE;
+      s.generation = 0;
+      s.active = false;
+    }
+
+  std::fill (m_head, m_head + MAX_LEVELS * MAX_LEVELS, NONE);
+  m_activeLists = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,255 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HTB_QUEUE_DISC_H
+#define HTB_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include <vector>
+#include <queue>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A class of the HTB queue disc
+ *
+ * Each class has an assured rate and a ceil rate, each enforced by means of a
+ * token bucket, a priority and a DRR quantum. Leaf classes are added to the
+ * HTB queue disc as queue disc classes (and hence have a child queue disc),
+ * while inner classes are added by means of HtbQueueDisc::AddInnerClass and
+ * have no child queue disc. The Parent attribute of a class is the identifier
+ * of its parent inner class, or -1 for top level classes.
+ */
+class HtbClass : public QueueDiscClass
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  HtbClass ();
+  virtual ~HtbClass ();
+
+  /**
+   * \return the assured rate of this class
+   */
+  DataRate GetRate (void) const;
+  /**
+   * \return the ceil rate of this class
+   */
+  DataRate GetCeil (void) const;
+  /**
+   * \return the size (bytes) of the bucket of the assured rate
+   */
+  uint32_t GetBurst (void) const;
+  /**
+   * \return the size (bytes) of the bucket of the ceil rate
+   */
+  uint32_t GetCburst (void) const;
+  /**
+   * \return the priority of this class (0 is the highest)
+   */
+  uint32_t GetPriority (void) const;
+  /**
+   * \return the DRR quantum (bytes) of this class
+   */
+  uint32_t GetQuantum (void) const;
+  /**
+   * \return the identifier of the parent inner class, or -1 for top level classes
+   */
+  int32_t GetParent (void) const;
+
+private:
+  DataRate m_rate;          //!< Assured rate
+  DataRate m_ceil;          //!< Ceil rate
+  uint32_t m_burst;         //!< Size of the bucket of the assured rate
+  uint32_t m_cburst;        //!< Size of the bucket of the ceil rate
+  uint32_t m_priority;      //!< Priority
+  uint32_t m_quantum;       //!< DRR quantum
+  int32_t m_parent;         //!< Parent inner class
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Hierarchical token bucket queue disc
+ *
+ * HtbQueueDisc shares the link among a hierarchy of classes, modelled after
+ * the Linux HTB scheduler. A class whose assured rate tokens are available
+ * can send at its own level; a class whose assured rate is exhausted but whose
+ * ceil allows it can borrow from the closest ancestor having assured rate
+ * tokens available. Among the leaf classes that can send, those that do not
+ * need to borrow are served first, then those borrowing from the closest
+ * ancestor, and so on; ties are broken by priority and then by deficit round
+ * robin.
+ *
+ * Backlogged leaf classes are kept in one round robin list per (borrowing
+ * level, priority) pair and a 64-bit bitmap tracks the non-empty lists, so
+ * that selecting the class to serve takes constant time regardless of the
+ * number of classes. Leaf classes that cannot send are parked in a queue
+ * ordered by the time at which they may send again. The depth of the class
+ * hierarchy and the number of priorities are therefore limited to 8.
+ *
+ * Packets are assigned to leaf classes by the packet filters; packets that
+ * no filter classifies go to the class identified by the DefaultClass
+ * attribute.
+ */
+class HtbQueueDisc : public QueueDisc
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief HtbQueueDisc constructor
+   */
+  HtbQueueDisc ();
+
+  virtual ~HtbQueueDisc ();
+
+  /**
+   * \brief Add an inner class to the hierarchy
+   *
+   * The parent of an inner class must have been added before the class itself.
+   *
+   * \param cl the inner class, which must have no queue disc attached
+   * \return the identifier of the inner class
+   */
+  uint32_t AddInnerClass (Ptr<HtbClass> cl);
+
+  /**
+   * \return the number of inner classes
+   */
+  std::size_t GetNInnerClasses (void) const;
+
+  /**
+   * \brief Get the i-th inner class
+   * \param i the identifier of the inner class
+   * \return the i-th inner class
+   */
+  Ptr<HtbClass> GetInnerClass (std::size_t i) const;
+
+  /// Maximum depth of the class hierarchy and maximum number of priorities
+  static constexpr uint32_t MAX_LEVELS = 8;
+
+  // Reasons for dropping packets
+  static constexpr const char* UNCLASSIFIED_DROP = "No class for the packet";  //!< The default class does not exist
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /// Value used for unused parent and list links
+  static constexpr uint32_t NONE = 0xffffffff;
+
+  /// Scheduling state of a (leaf or inner) class
+  struct ClassState
+  {
+    uint32_t parent;      //!< Index of the parent class, or NONE
+    int64_t psPerByte;    //!< Picoseconds needed to send a byte at the assured rate
+    int64_t cpsPerByte;   //!< Picoseconds needed to send a byte at the ceil rate
+    int64_t buffer;       //!< Assured rate bucket size (ps)
+    int64_t cbuffer;      //!< Ceil rate bucket size (ps)
+    int64_t tokens;       //!< Assured rate tokens (ps)
+    int64_t ctokens;      //!< Ceil rate tokens (ps)
+    int64_t checkpoint;   //!< Time of the last token update (ps)
+    uint32_t priority;    //!< Priority
+    int32_t quantum;      //!< DRR quantum (bytes)
+    int32_t deficit;      //!< DRR deficit (bytes)
+    uint32_t prev;        //!< Previous leaf in the round robin list
+    uint32_t next;        //!< Next leaf in the round robin list
+    uint32_t list;        //!< Round robin list the leaf belongs to, or NONE
+    uint32_t generation;  //!< Incremented whenever the leaf is rescheduled
+    bool active;          //!< Whether the leaf is backlogged
+  };
+
+  /// Entry of the queue of the leaf classes that cannot send
+  struct WaitEntry
+  {
+    int64_t time;         //!< Time (ps) at which the leaf may send at a lower level
+    uint32_t leaf;        //!< Index of the leaf class
+    uint32_t generation;  //!< Generation of the leaf when the entry was added
+    /**
+     * \param o the other entry
+     * \return true if this entry expires after the other one
+     */
+    bool operator> (const WaitEntry &o) const
+    {
+      return time > o.time;
+    }
+  };
+
+  /**
+   * \brief Compute the level at which a leaf can currently send
+   * \param leaf the index of the leaf class
+   * \param now the current time (ps)
+   * \param wait set to the time (ps) after which the level may decrease
+   * \return the level (number of ancestors to borrow from) or NONE
+   */
+  uint32_t GetLevel (uint32_t leaf, int64_t now, int64_t &wait) const;
+  /**
+   * \brief Insert a backlogged leaf in the list matching its current level
+   * or in the wait queue
+   * \param leaf the index of the leaf class
+   * \param now the current time (ps)
+   */
+  void Schedule (uint32_t leaf, int64_t now);
+  /**
+   * \brief Append a leaf to a round robin list
+   * \param leaf the index of the leaf class
+   * \param list the index of the list
+   */
+  void Link (uint32_t leaf, uint32_t list);
+  /**
+   * \brief Remove a leaf from its round robin list, if any
+   * \param leaf the index of the leaf class
+   */
+  void Unlink (uint32_t leaf);
+  /**
+   * \brief Charge the transmission of a packet to a leaf and its ancestors
+   * \param leaf the index of the leaf class
+   * \param level the level at which the leaf was served
+   * \param bytes the size of the packet
+   * \param now the current time (ps)
+   */
+  void Charge (uint32_t leaf, uint32_t level, uint32_t bytes, int64_t now);
+
+  std::vector<Ptr<HtbClass> > m_innerClasses;     //!< Inner classes
+  uint32_t m_defaultClass;                        //!< Class of unclassified packets
+  std::vector<ClassState> m_state;                //!< Leaf classes followed by inner classes
+  uint32_t m_head[MAX_LEVELS * MAX_LEVELS];       //!< Head of each round robin list
+  uint64_t m_activeLists;                         //!< Bitmap of the non-empty round robin lists
+  /// Leaf classes that cannot send, ordered by the time they may send again
+  std::priority_queue<WaitEntry, std::vector<WaitEntry>, std::greater<WaitEntry> > m_waitQueue;
+  EventId m_id;                                   //!< EventId of the scheduled queue waking event
+};
+
+} // namespace ns3
+
+#endif /* HTB_QUEUE_DISC_H */
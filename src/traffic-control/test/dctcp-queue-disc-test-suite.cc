@@ -0,0 +1,346 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/dctcp-queue-disc.h"
+#include "ns3/red-queue-disc.h"
+#include "ns3/packet.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Dctcp Queue Disc Test Item
+ */
+class DctcpQueueDiscTestItem : public QueueDiscItem
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param p the packet
+   * \param addr the address
+   * \param ecnCapable ECN capable flag
+   */
+  DctcpQueueDiscTestItem (Ptr<Packet> p, const Address & addr, bool ecnCapable);
+  virtual ~DctcpQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+
+private:
+  DctcpQueueDiscTestItem ();
+  /**
+   * \brief Copy constructor
+   * Disable default implementation to avoid misuse
+   */
+  DctcpQueueDiscTestItem (const DctcpQueueDiscTestItem &);
+  /**
+   * \brief Assignment operator
+   * \return this object
+   * Disable default implementation to avoid misuse
+   */
+  DctcpQueueDiscTestItem &operator = (const DctcpQueueDiscTestItem &);
+  bool m_ecnCapablePacket; ///< ECN capable packet?
+};
+
+DctcpQueueDiscTestItem::DctcpQueueDiscTestItem (Ptr<Packet> p, const Address & addr, bool ecnCapable)
+  : QueueDiscItem (p, addr, 0),
+    m_ecnCapablePacket (ecnCapable)
+{
+}
+
+DctcpQueueDiscTestItem::~DctcpQueueDiscTestItem ()
+{
+}
+
+void
+DctcpQueueDiscTestItem::AddHeader (void)
+{
+}
+
+bool
+DctcpQueueDiscTestItem::Mark (void)
+{
+  return m_ecnCapablePacket;
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check marking and dropping based on the instantaneous backlog
+ */
+class DctcpQueueDiscBacklogTestCase : public TestCase
+{
+public:
+  DctcpQueueDiscBacklogTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Run the test with the given threshold unit
+   * \param mode the unit of the marking threshold
+   * \param ecnCapable ECN capable flag of the enqueued packets
+   */
+  void RunBacklogTest (QueueSizeUnit mode, bool ecnCapable);
+};
+
+DctcpQueueDiscBacklogTestCase::DctcpQueueDiscBacklogTestCase ()
+  : TestCase ("Sanity check on the backlog threshold of the dctcp queue disc")
+{
+}
+
+void
+DctcpQueueDiscBacklogTestCase::RunBacklogTest (QueueSizeUnit mode, bool ecnCapable)
+{
+  uint32_t pktSize = 1000;
+  uint32_t modeSize = (mode == QueueSizeUnit::PACKETS ? 1 : pktSize);
+  Address dest;
+
+  // the capacity is expressed in packets while K may be expressed in bytes
+  Ptr<DctcpQueueDisc> queue = CreateObject<DctcpQueueDisc> ();
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("MaxSize", QueueSizeValue (QueueSize ("20p"))),
+                         true, "Verify that we can actually set the attribute MaxSize");
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("MarkingThreshold",
+                                                      QueueSizeValue (QueueSize (mode, 5 * modeSize))),
+                         true, "Verify that we can actually set the attribute MarkingThreshold");
+  queue->Initialize ();
+
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      queue->Enqueue (Create<DctcpQueueDiscTestItem> (Create<Packet> (pktSize), dest, ecnCapable));
+    }
+
+  QueueDisc::Stats st = queue->GetStats ();
+  if (ecnCapable)
+    {
+      NS_TEST_EXPECT_MSG_EQ (st.GetNMarkedPackets (DctcpQueueDisc::THRESHOLD_EXCEEDED_MARK), 5,
+                             "Packets arriving with a backlog of at least K should be marked");
+      NS_TEST_EXPECT_MSG_EQ (st.GetNDroppedPackets (DctcpQueueDisc::THRESHOLD_EXCEEDED_DROP), 0,
+                             "ECN capable packets should not be dropped");
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 10, "All the packets should have been enqueued");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (st.GetNMarkedPackets (DctcpQueueDisc::THRESHOLD_EXCEEDED_MARK), 0,
+                             "Non ECN capable packets cannot be marked");
+      NS_TEST_EXPECT_MSG_EQ (st.GetNDroppedPackets (DctcpQueueDisc::THRESHOLD_EXCEEDED_DROP), 5,
+                             "Non ECN capable packets exceeding K should be dropped");
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 5, "The backlog should not exceed K");
+    }
+
+  // the queue drains below K, hence new packets are not marked
+  while (queue->GetNPackets () > 3)
+    {
+      queue->Dequeue ();
+    }
+  uint32_t marked = st.GetNMarkedPackets (DctcpQueueDisc::THRESHOLD_EXCEEDED_MARK);
+  queue->Enqueue (Create<DctcpQueueDiscTestItem> (Create<Packet> (pktSize), dest, ecnCapable));
+  st = queue->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (st.GetNMarkedPackets (DctcpQueueDisc::THRESHOLD_EXCEEDED_MARK), marked,
+                         "A packet arriving with a backlog below K should not be marked");
+}
+
+void
+DctcpQueueDiscBacklogTestCase::DoRun (void)
+{
+  RunBacklogTest (QueueSizeUnit::PACKETS, true);
+  RunBacklogTest (QueueSizeUnit::BYTES, true);
+  RunBacklogTest (QueueSizeUnit::PACKETS, false);
+  RunBacklogTest (QueueSizeUnit::BYTES, false);
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check marking based on the sojourn time
+ */
+class DctcpQueueDiscSojournTestCase : public TestCase
+{
+public:
+  DctcpQueueDiscSojournTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Enqueue a packet
+   * \param queue the queue disc
+   */
+  void Enqueue (Ptr<DctcpQueueDisc> queue);
+  /**
+   * Dequeue a packet
+   * \param queue the queue disc
+   */
+  void Dequeue (Ptr<DctcpQueueDisc> queue);
+};
+
+DctcpQueueDiscSojournTestCase::DctcpQueueDiscSojournTestCase ()
+  : TestCase ("Sanity check on the sojourn time threshold of the dctcp queue disc")
+{
+}
+
+void
+DctcpQueueDiscSojournTestCase::Enqueue (Ptr<DctcpQueueDisc> queue)
+{
+  Address dest;
+  queue->Enqueue (Create<DctcpQueueDiscTestItem> (Create<Packet> (1000), dest, true));
+}
+
+void
+DctcpQueueDiscSojournTestCase::Dequeue (Ptr<DctcpQueueDisc> queue)
+{
+  Ptr<QueueDiscItem> item = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ ((item != 0), true, "A packet should have been dequeued");
+}
+
+void
+DctcpQueueDiscSojournTestCase::DoRun (void)
+{
+  Ptr<DctcpQueueDisc> queue = CreateObject<DctcpQueueDisc> ();
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("MarkingThreshold", QueueSizeValue (QueueSize ("1000p"))),
+                         true, "Verify that we can actually set the attribute MarkingThreshold");
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("SojournThreshold", TimeValue (MicroSeconds (100))),
+                         true, "Verify that we can actually set the attribute SojournThreshold");
+  queue->Initialize ();
+
+  // four packets arrive at time 0 and leave every 50us: the sojourn time of
+  // the last two exceeds 100us
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Simulator::Schedule (Seconds (0), &DctcpQueueDiscSojournTestCase::Enqueue, this, queue);
+      Simulator::Schedule (MicroSeconds (50 * (i + 1)), &DctcpQueueDiscSojournTestCase::Dequeue, this, queue);
+    }
+  Simulator::Run ();
+
+  QueueDisc::Stats st = queue->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (st.GetNMarkedPackets (DctcpQueueDisc::SOJOURN_EXCEEDED_MARK), 2,
+                         "Packets whose sojourn time exceeds the threshold should be marked");
+  NS_TEST_EXPECT_MSG_EQ (st.GetNMarkedPackets (DctcpQueueDisc::THRESHOLD_EXCEEDED_MARK), 0,
+                         "No packet should be marked because of the backlog");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check that the dctcp queue disc marks the same packets as
+ * RedQueueDisc with QW = 1 and MinTh = MaxTh = K
+ */
+class DctcpQueueDiscRedEquivalenceTestCase : public TestCase
+{
+public:
+  DctcpQueueDiscRedEquivalenceTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Run the test with the given unit
+   * \param mode the unit of the queue capacity and of the threshold
+   */
+  void RunEquivalenceTest (QueueSizeUnit mode);
+};
+
+DctcpQueueDiscRedEquivalenceTestCase::DctcpQueueDiscRedEquivalenceTestCase ()
+  : TestCase ("Check that the dctcp queue disc marks like RED with QW = 1 and MinTh = MaxTh")
+{
+}
+
+void
+DctcpQueueDiscRedEquivalenceTestCase::RunEquivalenceTest (QueueSizeUnit mode)
+{
+  uint32_t pktSize = 1000;
+  uint32_t modeSize = (mode == QueueSizeUnit::PACKETS ? 1 : pktSize);
+  uint32_t k = 20;
+  Address dest;
+
+  Ptr<RedQueueDisc> red = CreateObject<RedQueueDisc> ();
+  red->SetAttribute ("MaxSize", QueueSizeValue (QueueSize (mode, 1000 * modeSize)));
+  red->SetAttribute ("MeanPktSize", UintegerValue (pktSize));
+  red->SetAttribute ("QW", DoubleValue (1));
+  red->SetAttribute ("MinTh", DoubleValue (k * modeSize));
+  red->SetAttribute ("MaxTh", DoubleValue (k * modeSize));
+  red->SetAttribute ("Gentle", BooleanValue (false));
+  red->SetAttribute ("UseEcn", BooleanValue (true));
+  red->SetAttribute ("UseHardDrop", BooleanValue (false));
+  red->Initialize ();
+
+  Ptr<DctcpQueueDisc> dctcp = CreateObject<DctcpQueueDisc> ();
+  dctcp->SetAttribute ("MaxSize", QueueSizeValue (QueueSize (mode, 1000 * modeSize)));
+  dctcp->SetAttribute ("MarkingThreshold", QueueSizeValue (QueueSize (mode, k * modeSize)));
+  dctcp->Initialize ();
+
+  // a bursty arrival pattern: the queue repeatedly builds up beyond K and
+  // drains below it, mixing ECN capable and non ECN capable packets
+  uint32_t state = 12345;
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      state = state * 1103515245 + 12345;
+      uint32_t r = (state >> 16) % 100;
+      bool ecnCapable = (r % 7 != 0);
+      if (r < 40 + 20 * ((i / 500) % 2))
+        {
+          bool redRet = red->Enqueue (Create<DctcpQueueDiscTestItem> (Create<Packet> (pktSize), dest, ecnCapable));
+          bool dctcpRet = dctcp->Enqueue (Create<DctcpQueueDiscTestItem> (Create<Packet> (pktSize), dest, ecnCapable));
+          NS_TEST_EXPECT_MSG_EQ (redRet, dctcpRet, "Both queue discs should accept or reject packet " << i);
+        }
+      else
+        {
+          red->Dequeue ();
+          dctcp->Dequeue ();
+        }
+      NS_TEST_EXPECT_MSG_EQ (red->GetNPackets (), dctcp->GetNPackets (), "Backlogs differ at step " << i);
+    }
+
+  QueueDisc::Stats redSt = red->GetStats ();
+  QueueDisc::Stats dctcpSt = dctcp->GetStats ();
+  NS_TEST_EXPECT_MSG_GT (dctcpSt.nTotalMarkedPackets, 0, "Some packets should have been marked");
+  NS_TEST_EXPECT_MSG_EQ (redSt.nTotalMarkedPackets, dctcpSt.nTotalMarkedPackets,
+                         "Both queue discs should mark the same number of packets");
+  NS_TEST_EXPECT_MSG_EQ (redSt.nTotalDroppedPackets, dctcpSt.nTotalDroppedPackets,
+                         "Both queue discs should drop the same number of packets");
+}
+
+void
+DctcpQueueDiscRedEquivalenceTestCase::DoRun (void)
+{
+  RunEquivalenceTest (QueueSizeUnit::PACKETS);
+  RunEquivalenceTest (QueueSizeUnit::BYTES);
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Dctcp Queue Disc Test Suite
+ */
+static class DctcpQueueDiscTestSuite : public TestSuite
+{
+public:
+  DctcpQueueDiscTestSuite ()
+    : TestSuite ("dctcp-queue-disc", UNIT)
+  {
+    AddTestCase (new DctcpQueueDiscBacklogTestCase (), TestCase::QUICK);
+    AddTestCase (new DctcpQueueDiscSojournTestCase (), TestCase::QUICK);
+    AddTestCase (new DctcpQueueDiscRedEquivalenceTestCase (), TestCase::QUICK);
+  }
+} g_dctcpQueueTestSuite; ///< the test suite
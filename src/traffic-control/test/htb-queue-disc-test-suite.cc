@@ -0,0 +1,285 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/htb-queue-disc.h"
+#include "ns3/fifo-queue-disc.h"
+#include "ns3/packet-filter.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/integer.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Test Item
+ */
+class HtbQueueDiscTestItem : public QueueDiscItem
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param p the packet
+   * \param cl the leaf class the packet belongs to
+   */
+  HtbQueueDiscTestItem (Ptr<Packet> p, uint32_t cl);
+  virtual ~HtbQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+  /**
+   * \return the leaf class the packet belongs to
+   */
+  uint32_t GetClass (void) const;
+
+private:
+  HtbQueueDiscTestItem ();
+  /**
+   * \brief Copy constructor
+   * Disable default implementation to avoid misuse
+   */
+  HtbQueueDiscTestItem (const HtbQueueDiscTestItem &);
+  /**
+   * \brief Assignment operator
+   * \return this object
+   * Disable default implementation to avoid misuse
+   */
+  HtbQueueDiscTestItem &operator = (const HtbQueueDiscTestItem &);
+  uint32_t m_class; ///< leaf class
+};
+
+HtbQueueDiscTestItem::HtbQueueDiscTestItem (Ptr<Packet> p, uint32_t cl)
+  : QueueDiscItem (p, Address (), 0),
+    m_class (cl)
+{
+}
+
+HtbQueueDiscTestItem::~HtbQueueDiscTestItem ()
+{
+}
+
+void
+HtbQueueDiscTestItem::AddHeader (void)
+{
+}
+
+bool
+HtbQueueDiscTestItem::Mark (void)
+{
+  return false;
+}
+
+uint32_t
+HtbQueueDiscTestItem::GetClass (void) const
+{
+  return m_class;
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Packet filter returning the class stored in the test items
+ */
+class HtbQueueDiscTestFilter : public PacketFilter
+{
+private:
+  virtual bool CheckProtocol (Ptr<QueueDiscItem> item) const
+  {
+    return (DynamicCast<HtbQueueDiscTestItem> (item) != 0);
+  }
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const
+  {
+    return DynamicCast<HtbQueueDiscTestItem> (item)->GetClass ();
+  }
+};
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check the rates obtained by backlogged classes
+ */
+class HtbQueueDiscRateTestCase : public TestCase
+{
+public:
+  HtbQueueDiscRateTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Create a leaf class
+   * \param queue the queue disc
+   * \param rate the assured rate
+   * \param ceil the ceil rate
+   * \param prio the priority
+   * \param parent the parent inner class
+   */
+  void AddLeaf (Ptr<HtbQueueDisc> queue, std::string rate, std::string ceil, uint32_t prio, int32_t parent);
+  /**
+   * Dequeue a packet every transmission time of the link and keep the
+   * backlogged classes busy
+   * \param queue the queue disc
+   * \param backlogged the backlogged leaf classes
+   * \param txTime the transmission time of a packet
+   */
+  void Transmit (Ptr<HtbQueueDisc> queue, std::vector<uint32_t> backlogged, Time txTime);
+  /**
+   * Account for a packet sent on the link
+   * \param item the packet
+   */
+  void Sent (Ptr<QueueDiscItem> item);
+  /**
+   * Run a scenario for 10 seconds on a 10 Mbps link
+   * \param queue the queue disc
+   * \param backlogged the backlogged leaf classes
+   */
+  void RunScenario (Ptr<HtbQueueDisc> queue, std::vector<uint32_t> backlogged);
+  std::vector<uint64_t> m_bytes; ///< bytes sent by each leaf class
+};
+
+HtbQueueDiscRateTestCase::HtbQueueDiscRateTestCase ()
+  : TestCase ("Check the rates obtained by the classes of the HTB queue disc")
+{
+}
+
+void
+HtbQueueDiscRateTestCase::AddLeaf (Ptr<HtbQueueDisc> queue, std::string rate, std::string ceil,
+                                   uint32_t prio, int32_t parent)
+{
+  Ptr<HtbClass> cl = CreateObjectWithAttributes<HtbClass> ("Rate", StringValue (rate),
+                                                           "Ceil", StringValue (ceil),
+                                                           "Priority", UintegerValue (prio),
+                                                           "Quantum", UintegerValue (1500),
+                                                           "Parent", IntegerValue (parent));
+  cl->SetQueueDisc (CreateObject<FifoQueueDisc> ());
+  queue->AddQueueDiscClass (cl);
+}
+
+void
+HtbQueueDiscRateTestCase::Sent (Ptr<QueueDiscItem> item)
+{
+  m_bytes[DynamicCast<HtbQueueDiscTestItem> (item)->GetClass ()] += item->GetSize ();
+}
+
+void
+HtbQueueDiscRateTestCase::Transmit (Ptr<HtbQueueDisc> queue, std::vector<uint32_t> backlogged, Time txTime)
+{
+  for (uint32_t cl : backlogged)
+    {
+      while (queue->GetQueueDiscClass (cl)->GetQueueDisc ()->GetNPackets () < 5)
+        {
+          queue->Enqueue (Create<HtbQueueDiscTestItem> (Create<Packet> (1000), cl));
+        }
+    }
+  Ptr<QueueDiscItem> item = queue->Dequeue ();
+  if (item)
+    {
+      Sent (item);
+    }
+  if (Simulator::Now () + txTime < Seconds (10))
+    {
+      Simulator::Schedule (txTime, &HtbQueueDiscRateTestCase::Transmit, this, queue, backlogged, txTime);
+    }
+}
+
+void
+HtbQueueDiscRateTestCase::RunScenario (Ptr<HtbQueueDisc> queue, std::vector<uint32_t> backlogged)
+{
+  queue->AddPacketFilter (CreateObject<HtbQueueDiscTestFilter> ());
+  // packets sent when the queue disc wakes up after waiting for tokens
+  queue->SetSendCallback ([this] (Ptr<QueueDiscItem> item) { Sent (item); });
+  queue->Initialize ();
+  m_bytes.assign (queue->GetNQueueDiscClasses (), 0);
+  // 1000 byte packets on a 10 Mbps link
+  Simulator::Schedule (Seconds (0), &HtbQueueDiscRateTestCase::Transmit, this,
+                       queue, backlogged, MicroSeconds (800));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+HtbQueueDiscRateTestCase::DoRun (void)
+{
+  Ptr<HtbQueueDisc> queue;
+
+  // test 1: the classes get their assured rate and borrow the excess bandwidth
+  queue = CreateObject<HtbQueueDisc> ();
+  queue->AddInnerClass (CreateObjectWithAttributes<HtbClass> ("Rate", StringValue ("10Mbps")));
+  AddLeaf (queue, "6Mbps", "10Mbps", 0, 0);
+  AddLeaf (queue, "2Mbps", "10Mbps", 0, 0);
+  RunScenario (queue, {0, 1});
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (m_bytes[0] * 8 / 10 / 1e6, 5.9, "Class 0 should get at least its rate");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (m_bytes[1] * 8 / 10 / 1e6, 2.1, "Class 1 should get its rate and borrow");
+  NS_TEST_EXPECT_MSG_EQ_TOL ((m_bytes[0] + m_bytes[1]) * 8 / 10 / 1e6, 10, 0.2, "The link should be fully used");
+
+  // test 2: a class cannot exceed its ceil even if the link is idle
+  queue = CreateObject<HtbQueueDisc> ();
+  queue->AddInnerClass (CreateObjectWithAttributes<HtbClass> ("Rate", StringValue ("10Mbps")));
+  AddLeaf (queue, "2Mbps", "5Mbps", 0, 0);
+  AddLeaf (queue, "2Mbps", "10Mbps", 0, 0);
+  RunScenario (queue, {0});
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_bytes[0] * 8 / 10 / 1e6, 5, 0.2, "Class 0 should be limited by its ceil");
+  NS_TEST_EXPECT_MSG_EQ (m_bytes[1], 0, "Class 1 is not backlogged");
+
+  // test 3: the excess bandwidth goes to the class with the highest priority
+  queue = CreateObject<HtbQueueDisc> ();
+  queue->AddInnerClass (CreateObjectWithAttributes<HtbClass> ("Rate", StringValue ("10Mbps")));
+  AddLeaf (queue, "1Mbps", "10Mbps", 1, 0);
+  AddLeaf (queue, "1Mbps", "10Mbps", 0, 0);
+  RunScenario (queue, {0, 1});
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_bytes[0] * 8 / 10 / 1e6, 1, 0.2, "Class 0 should only get its rate");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_bytes[1] * 8 / 10 / 1e6, 9, 0.2, "Class 1 should get the excess bandwidth");
+
+  // test 4: two tenants share the link according to their rates; within each
+  // tenant, the classes share the rate of the tenant
+  queue = CreateObject<HtbQueueDisc> ();
+  queue->AddInnerClass (CreateObjectWithAttributes<HtbClass> ("Rate", StringValue ("10Mbps")));
+  queue->AddInnerClass (CreateObjectWithAttributes<HtbClass> ("Rate", StringValue ("8Mbps"),
+                                                              "Ceil", StringValue ("10Mbps"),
+                                                              "Parent", IntegerValue (0)));
+  queue->AddInnerClass (CreateObjectWithAttributes<HtbClass> ("Rate", StringValue ("2Mbps"),
+                                                              "Ceil", StringValue ("10Mbps"),
+                                                              "Parent", IntegerValue (0)));
+  AddLeaf (queue, "1Mbps", "10Mbps", 0, 1);
+  AddLeaf (queue, "1Mbps", "10Mbps", 0, 1);
+  AddLeaf (queue, "1Mbps", "10Mbps", 0, 2);
+  RunScenario (queue, {0, 1, 2});
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_bytes[0] * 8 / 10 / 1e6, 4, 0.2, "Class 0 should get half of the rate of tenant 1");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_bytes[1] * 8 / 10 / 1e6, 4, 0.2, "Class 1 should get half of the rate of tenant 1");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_bytes[2] * 8 / 10 / 1e6, 2, 0.2, "Class 2 should get the rate of tenant 2");
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Test Suite
+ */
+static class HtbQueueDiscTestSuite : public TestSuite
+{
+public:
+  HtbQueueDiscTestSuite ()
+    : TestSuite ("htb-queue-disc", UNIT)
+  {
+    AddTestCase (new HtbQueueDiscRateTestCase (), TestCase::QUICK);
+  }
+} g_htbQueueTestSuite; ///< the test suite
@@ -28,6 +28,7 @@
 #include "wifi-utils.h"
 #include "wifi-ppdu.h"
 #include "wifi-psdu.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -225,13 +226,16 @@ InterferenceHelper::AppendEvent (Ptr<Event> event)
   if (!m_rxing)
     {
       m_firstPower = previousPowerStart;
-      // Always leave the first zero power noise event in the list
-      m_niChanges.erase (++(m_niChanges.begin ()),
+      // Always leave the first zero power noise event in the list; only the
+      // changes after the start of the event are moved
+      m_niChanges.erase (m_niChanges.begin () + 1,
                          GetNextPosition (event->GetStartTime ()));
     }
   auto first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event));
+  // The second insertion, after the first one, invalidates its iterator
+  auto firstIndex = first - m_niChanges.begin ();
   auto last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event));
-  for (auto i = first; i != last; ++i)
+  for (auto i = m_niChanges.begin () + firstIndex; i != last; ++i)
     {
       i->second.AddPower (event->GetRxPowerW ());
     }
@@ -264,19 +268,21 @@ double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const
 {
   double noiseInterferenceW = m_firstPower;
-  auto it = m_niChanges.find (event->GetStartTime ());
+  auto start = Find (event->GetStartTime ());
+  auto it = start;
   for (; it != m_niChanges.end () && it->first < Simulator::Now (); ++it)
     {
       noiseInterferenceW = it->second.GetPower () - event->GetRxPowerW ();
     }
-  it = m_niChanges.find (event->GetStartTime ());
+  it = start;
   for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it);
-  ni->emplace (event->GetStartTime (), NiChange (0, event));
+  // The changes between the start and the end of the event are in time order
+  ni->emplace_back (event->GetStartTime (), NiChange (0, event));
   while (++it != m_niChanges.end () && it->second.GetEvent () != event)
     {
-      ni->insert (*it);
+      ni->push_back (*it);
     }
-  ni->emplace (event->GetEndTime (), NiChange (0, event));
+  ni->emplace_back (event->GetEndTime (), NiChange (0, event));
   NS_ASSERT_MSG (noiseInterferenceW >= 0, "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
   return noiseInterferenceW;
 }
@@ -807,6 +813,65 @@ InterferenceHelper::CalculateHtPhyHeaderSnrPer (Ptr<Event> event) const
   return snrPer;
 }
 
+struct InterferenceHelper::SnrPer
+InterferenceHelper::CalculateAbstractedSnrPer (Ptr<Event> event) const
+{
+  NS_LOG_FUNCTION (this << *event);
+  double powerW = event->GetRxPowerW ();
+  double noiseInterferenceW = m_firstPower;
+  auto it = Find (event->GetStartTime ());
+  for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it);
+  // The changes between the start and the end of the event are in time order
+  while (++it != m_niChanges.end () && it->second.GetEvent () != event)
+    {
+      noiseInterferenceW = std::max (noiseInterferenceW, it->second.GetPower () - powerW);
+    }
+  const WifiTxVector txVector = event->GetTxVector ();
+  double snr = CalculateSnr (powerW, noiseInterferenceW, txVector);
+
+  // The non-HT PHY header, then the HT-SIG or SIG-A, training and SIG-B
+  // fields, decoded with the same modes as by CalculateNonHtPhyHeaderPer
+  // and CalculateHtPhyHeaderPer
+  WifiPreamble preamble = txVector.GetPreambleType ();
+  double psr = CalculateChunkSuccessRate (snr, WifiPhy::GetPhyHeaderDuration (txVector),
+                                          WifiPhy::GetPhyHeaderMode (txVector), txVector);
+  WifiMode mcsHeaderMode;
+  bool mcsHeader = true;
+  if (preamble == WIFI_PREAMBLE_HT_MF || preamble == WIFI_PREAMBLE_HT_GF)
+    {
+      mcsHeaderMode = WifiPhy::GetHtPhyHeaderMode ();
+    }
+  else if (preamble == WIFI_PREAMBLE_VHT_SU || preamble == WIFI_PREAMBLE_VHT_MU)
+    {
+      mcsHeaderMode = WifiPhy::GetVhtPhyHeaderMode ();
+    }
+  else if (preamble == WIFI_PREAMBLE_HE_SU || preamble == WIFI_PREAMBLE_HE_MU)
+    {
+      mcsHeaderMode = WifiPhy::GetHePhyHeaderMode ();
+    }
+  else
+    {
+      mcsHeader = false;
+    }
+  if (mcsHeader)
+    {
+      Time mcsHeaderDuration = WifiPhy::CalculatePhyPreambleAndHeaderDuration (txVector)
+        - WifiPhy::GetPhyPreambleDuration (txVector) - WifiPhy::GetPhyHeaderDuration (txVector);
+      psr *= CalculateChunkSuccessRate (snr, mcsHeaderDuration, mcsHeaderMode, txVector);
+    }
+
+  struct SnrPer snrPer;
+  snrPer.snr = snr;
+  snrPer.per = 1 - psr;
+  return snrPer;
+}
+
+double
+InterferenceHelper::CalculateAbstractedPayloadPer (double snr, WifiTxVector txVector, Time duration) const
+{
+  return 1 - CalculatePayloadChunkSuccessRate (snr, duration, txVector);
+}
+
 void
 InterferenceHelper::EraseEvents (void)
 {
@@ -820,7 +885,22 @@ InterferenceHelper::EraseEvents (void)
 InterferenceHelper::NiChanges::const_iterator
 InterferenceHelper::GetNextPosition (Time moment) const
 {
-  return m_niChanges.upper_bound (moment);
+  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), moment,
+                           [] (const Time &t, const NiChanges::value_type &change)
+                           { return t < change.first; });
+}
+
+InterferenceHelper::NiChanges::const_iterator
+InterferenceHelper::Find (Time moment) const
+{
+  auto it = std::lower_bound (m_niChanges.begin (), m_niChanges.end (), moment,
+                              [] (const NiChanges::value_type &change, const Time &t)
+                              { return change.first < t; });
+  if (it != m_niChanges.end () && it->first != moment)
+    {
+      return m_niChanges.end ();
+    }
+  return it;
 }
 
 InterferenceHelper::NiChanges::const_iterator
@@ -23,7 +23,8 @@
 
 #include "ns3/nstime.h"
 #include "wifi-tx-vector.h"
-#include <map>
+#include <utility>
+#include <vector>
 
 namespace ns3 {
 
@@ -227,6 +228,28 @@ public:
    * \return struct of SNR and PER
    */
   struct InterferenceHelper::SnrPer CalculateHtPhyHeaderSnrPer (Ptr<Event> event) const;
+  /**
+   * Calculate the lowest SNIR over the whole event, and the PER of its PHY
+   * headers at this SNIR, for the reception of a PPDU at frame granularity.
+   * The noise and interference are read once from the NiChanges of the
+   * event, without any PER computation per chunk.
+   *
+   * \param event the event corresponding to the first time the corresponding PPDU arrives
+   *
+   * \return struct of the lowest SNR and the PER of the PHY headers
+   */
+  struct InterferenceHelper::SnrPer CalculateAbstractedSnrPer (Ptr<Event> event) const;
+  /**
+   * Calculate the PER of a part of the PHY payload at a constant SNIR,
+   * for the reception of a PPDU at frame granularity.
+   *
+   * \param snr the SNIR, as returned by CalculateAbstractedSnrPer
+   * \param txVector the TXVECTOR of the PPDU
+   * \param duration the duration of the part of the PHY payload
+   *
+   * \return the PER of the part of the PHY payload
+   */
+  double CalculateAbstractedPayloadPer (double snr, WifiTxVector txVector, Time duration) const;
 
   /**
    * Notify that RX has started.
@@ -307,9 +330,12 @@ private:
   };
 
   /**
-   * typedef for a multimap of NiChanges
+   * typedef for the NiChanges with their time, sorted by time.  The
+   * NiChanges of a same time are kept in their order of insertion.  A
+   * sorted vector is used rather than a multimap, since the changes are
+   * few, mostly added at the end and erased at the beginning.
    */
-  typedef std::multimap<Time, NiChange> NiChanges;
+  typedef std::vector<std::pair<Time, NiChange> > NiChanges;
 
   /**
    * Append the given Event.
@@ -401,8 +427,17 @@ private:
   NiChanges::const_iterator GetPreviousPosition (Time moment) const;
 
   /**
-   * Add NiChange to the list at the appropriate position and
-   * return the iterator of the new event.
+   * Returns an iterator to the first NiChange at moment
+   *
+   * \param moment time to check from
+   * \returns an iterator to the list of NiChanges, or its end if there is
+   *          no NiChange at moment
+   */
+  NiChanges::const_iterator Find (Time moment) const;
+
+  /**
+   * Add NiChange to the list at the appropriate position, after the
+   * NiChanges of the same moment, and return the iterator of the new event.
    *
    * \param moment time to check from
    * \param change the NiChange to add
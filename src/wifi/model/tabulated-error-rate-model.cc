@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "tabulated-error-rate-model.h"
+#include "nist-error-rate-model.h"
+#include "wifi-tx-vector.h"
+#include "wifi-utils.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TabulatedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TabulatedErrorRateModel);
+
+/// The highest value of the tables interpolated: log (-log (1 - 0.1)), for
+/// an error rate of 0.1 per bit
+static const double MAX_LOG = -2.2503673273124454;
+
+TypeId
+TabulatedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TabulatedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TabulatedErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model which is tabulated, a NistErrorRateModel by default.",
+                   PointerValue (),
+                   MakePointerAccessor (&TabulatedErrorRateModel::m_model),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The lowest SNR of the tables, in dB.",
+                   DoubleValue (-10),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_minSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The highest SNR of the tables, in dB.",
+                   DoubleValue (60),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_maxSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Resolution",
+                   "The step of the SNRs of the tables, in dB.",
+                   DoubleValue (0.02),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_resolution),
+                   MakeDoubleChecker<double> (1e-6))
+  ;
+  return tid;
+}
+
+TabulatedErrorRateModel::TabulatedErrorRateModel ()
+  : m_model (CreateObject<NistErrorRateModel> ())
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TabulatedErrorRateModel::~TabulatedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TabulatedErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_model = 0;
+  m_tables.clear ();
+  ErrorRateModel::DoDispose ();
+}
+
+const std::vector<double> &
+TabulatedErrorRateModel::GetTable (WifiMode mode, WifiTxVector txVector) const
+{
+  uint64_t key = (static_cast<uint64_t> (mode.GetUid ()) << 40)
+    | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 24)
+    | (static_cast<uint64_t> (txVector.GetGuardInterval ()) << 8)
+    | txVector.GetNss ();
+  std::unordered_map<uint64_t, std::vector<double> >::iterator it = m_tables.find (key);
+  if (it != m_tables.end ())
+    {
+      return it->second;
+    }
+  NS_LOG_DEBUG ("Tabulating " << mode << " with " << txVector);
+  std::vector<double> &table = m_tables[key];
+  uint32_t n = 1;
+  if (m_maxSnr > m_minSnr)
+    {
+      n += static_cast<uint32_t> ((m_maxSnr - m_minSnr) / m_resolution);
+    }
+  table.reserve (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double snr = DbToRatio (m_minSnr + i * m_resolution);
+      // 1 - p, as rounded by the model
+      double success = m_model->GetChunkSuccessRate (mode, txVector, snr, 1);
+      table.push_back (std::log (-std::log (success)));
+    }
+  return table;
+}
+
+double
+TabulatedErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetMode () << snr << nbits);
+  if (nbits == 0)
+    {
+      return 1.0;
+    }
+  double x = snr > 0 ? (RatioToDb (snr) - m_minSnr) / m_resolution : -1;
+  const std::vector<double> &table = GetTable (mode, txVector);
+  if (x < 0 || x >= table.size () - 1)
+    {
+      return m_model->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  double a = table[i];
+  double b = table[i + 1];
+  if (std::isinf (a) && a < 0 && std::isinf (b) && b < 0)
+    {
+      // The model never loses a bit at both SNRs
+      return 1.0;
+    }
+  if (!std::isfinite (a) || !std::isfinite (b) || std::max (a, b) > MAX_LOG)
+    {
+      // The error rate of a bit is too high, or too close to 0 or 1 at one
+      // of the SNRs, to be interpolated accurately
+      return m_model->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  double l = a + (x - i) * (b - a);
+  // exp (nbits * log (1 - p)), as the models compute pow (1 - p, nbits)
+  return std::exp (-std::exp (l) * nbits);
+}
+
+} //namespace ns3
@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TABULATED_ERROR_RATE_MODEL_H
+#define TABULATED_ERROR_RATE_MODEL_H
+
+#include "error-rate-model.h"
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * An error rate model which interpolates the chunk success rates of
+ * another model in tables, instead of evaluating its series and special
+ * functions for each chunk.
+ *
+ * The models of this module compute the success rate of a chunk of n bits
+ * as \f$ (1 - p)^n \f$, where p is the error rate of a bit after decoding.
+ * Hence a table holds \f$ \log (-\log (1 - p)) \f$ for each SNR between
+ * the MinSnr and MaxSnr attributes, with a step of Resolution dB, and the
+ * success rate of a chunk is computed from the value interpolated at its
+ * SNR, whatever its size.  This logarithm is nearly linear in the SNR in
+ * dB where p is below 0.1, so that the default resolution of 0.02 dB keeps
+ * the relative error on p around 0.01%.  The chunks whose SNR is outside
+ * of the tables, or next to a p above 0.1, 0 or 1, are computed by the
+ * other model.
+ *
+ * The table of a mode is computed when a chunk of the mode is first
+ * evaluated, for its channel width, guard interval and number of spatial
+ * streams.
+ */
+class TabulatedErrorRateModel : public ErrorRateModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TabulatedErrorRateModel ();
+  virtual ~TabulatedErrorRateModel ();
+
+  double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+
+private:
+  void DoDispose (void);
+  /**
+   * Get the table of a mode, computing it if needed.
+   *
+   * \param mode the Wi-Fi mode
+   * \param txVector TXVECTOR of the overall transmission
+   *
+   * \return the logarithms of the opposites of the logarithms of the
+   *         success rates of a bit, at each SNR of the table
+   */
+  const std::vector<double> & GetTable (WifiMode mode, WifiTxVector txVector) const;
+
+  Ptr<ErrorRateModel> m_model; //!< the model which is tabulated
+  double m_minSnr;             //!< the SNR of the first entry of the tables, in dB
+  double m_maxSnr;             //!< the highest SNR of the tables, in dB
+  double m_resolution;         //!< the step of the SNRs of the tables, in dB
+  /// the tables, by mode, channel width, guard interval and number of spatial streams
+  mutable std::unordered_map<uint64_t, std::vector<double> > m_tables;
+};
+
+} //namespace ns3
+
+#endif /* TABULATED_ERROR_RATE_MODEL_H */
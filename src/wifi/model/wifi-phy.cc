@@ -411,6 +411,14 @@ WifiPhy::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&WifiPhy::m_preambleDetectionModel),
                    MakePointerChecker <PreambleDetectionModel> ())
+    .AddAttribute ("Abstraction",
+                   "If true, the PPDUs are received at frame granularity: the preamble "
+                   "detection is decided at the start of a PPDU, and its PHY headers and "
+                   "MPDUs at its end, from the lowest SNIR over the PPDU, without the "
+                   "events of the PHY headers and of the MPDUs of an A-MPDU.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WifiPhy::m_abstraction),
+                   MakeBooleanChecker ())
     .AddAttribute ("PostReceptionErrorModel",
                    "An optional packet error model can be added to the receive "
                    "packet process after any propagation-based (SNR-based) error "
@@ -2978,7 +2986,7 @@ WifiPhy::StartReceivePayload (Ptr<Event> event)
   WifiTxVector txVector = event->GetTxVector ();
   WifiMode txMode = txVector.GetMode ();
   bool canReceivePayload;
-  if (txMode.GetModulationClass () >= WIFI_MOD_CLASS_HT)
+  if (txMode.GetModulationClass () >= WIFI_MOD_CLASS_HT && !m_abstraction)
     {
       InterferenceHelper::SnrPer snrPer;
       snrPer = m_interference.CalculateHtPhyHeaderSnrPer (event);
@@ -2987,7 +2995,8 @@ WifiPhy::StartReceivePayload (Ptr<Event> event)
     }
   else
     {
-      //If we are here, this means non-HT PHY header was already successfully received
+      //If we are here, this means non-HT PHY header was already successfully received,
+      //or that the PHY headers are decided with the payload at the end of the PPDU
       canReceivePayload = true;
     }
   Time payloadDuration = event->GetEndTime () - event->GetStartTime () - CalculatePhyPreambleAndHeaderDuration (txVector);
@@ -3011,7 +3020,7 @@ WifiPhy::StartReceivePayload (Ptr<Event> event)
       else
         {
           m_statusPerMpdu.clear();
-          if (event->GetPsdu ()->GetNMpdus () > 1)
+          if (event->GetPsdu ()->GetNMpdus () > 1 && !m_abstraction)
             {
               ScheduleEndOfMpdus (event);
             }
@@ -3102,7 +3111,11 @@ WifiPhy::EndReceive (Ptr<Event> event)
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
 
   Ptr<const WifiPsdu> psdu = event->GetPsdu ();
-  if (psdu->GetNMpdus () == 1)
+  if (m_abstraction)
+    {
+      DecideAbstractedReception (event);
+    }
+  else if (psdu->GetNMpdus () == 1)
     {
       //We do not enter here for A-MPDU since this is done in WifiPhy::EndOfMpdu
       std::pair<bool, SignalNoiseDbm> rxInfo = GetReceptionStatus (psdu, event, NanoSeconds (0), psduDuration);
@@ -3129,6 +3142,58 @@ WifiPhy::EndReceive (Ptr<Event> event)
   MaybeCcaBusyDuration ();
 }
 
+void
+WifiPhy::DecideAbstractedReception (Ptr<Event> event)
+{
+  NS_LOG_FUNCTION (this << *event);
+  Ptr<const WifiPsdu> psdu = event->GetPsdu ();
+  WifiTxVector txVector = event->GetTxVector ();
+  InterferenceHelper::SnrPer snrPer = m_interference.CalculateAbstractedSnrPer (event);
+  m_signalNoise.signal = WToDbm (event->GetRxPowerW ());
+  m_signalNoise.noise = WToDbm (event->GetRxPowerW () / snrPer.snr);
+  bool headerReceived = m_random->GetValue () > snrPer.per;
+  NS_LOG_DEBUG ("lowest snr(dB)=" << RatioToDb (snrPer.snr) << ", PHY header per=" << snrPer.per
+                << ", PHY header received: " << headerReceived);
+
+  //Same durations of the MPDUs as in WifiPhy::ScheduleEndOfMpdus
+  Time psduDuration = event->GetEndTime () - event->GetStartTime () - CalculatePhyPreambleAndHeaderDuration (txVector);
+  Time remainingAmpduDuration = psduDuration;
+  MpduType mpdutype = FIRST_MPDU_IN_AGGREGATE;
+  uint32_t totalAmpduSize = 0;
+  double totalAmpduNumSymbols = 0.0;
+  size_t nMpdus = psdu->GetNMpdus ();
+  auto mpdu = psdu->begin ();
+  for (size_t i = 0; i < nMpdus && mpdu != psdu->end (); ++i, ++mpdu)
+    {
+      Time mpduDuration = psduDuration;
+      if (nMpdus > 1)
+        {
+          mpduDuration = GetPayloadDuration (psdu->GetAmpduSubframeSize (i), txVector,
+                                             GetPhyBand (), mpdutype, true, totalAmpduSize, totalAmpduNumSymbols);
+          remainingAmpduDuration -= mpduDuration;
+          if (i == (nMpdus - 1) && !remainingAmpduDuration.IsZero ())
+            {
+              mpduDuration += remainingAmpduDuration;
+            }
+          mpdutype = (i + 1 == (nMpdus - 1)) ? LAST_MPDU_IN_AGGREGATE : MIDDLE_MPDU_IN_AGGREGATE;
+        }
+      bool received = false;
+      if (headerReceived)
+        {
+          double per = m_interference.CalculateAbstractedPayloadPer (snrPer.snr, txVector, mpduDuration);
+          received = m_random->GetValue () > per
+            && !(m_postReceptionErrorModel && m_postReceptionErrorModel->IsCorrupt ((*mpdu)->GetPacket ()->Copy ()));
+          NS_LOG_DEBUG ("MPDU #" << i << ": duration: " << mpduDuration.GetNanoSeconds () << "ns"
+                        << ", per=" << per << ", correct reception: " << received);
+        }
+      m_statusPerMpdu.push_back (received);
+      if (received && nMpdus > 1)
+        {
+          m_state->ContinueRxNextMpdu (Create<WifiPsdu> (*mpdu, false), snrPer.snr, txVector);
+        }
+    }
+}
+
 std::pair<bool, SignalNoiseDbm>
 WifiPhy::GetReceptionStatus (Ptr<const WifiPsdu> psdu, Ptr<Event> event, Time relativeMpduStart, Time mpduDuration)
 {
@@ -4496,6 +4561,32 @@ WifiPhy::StartRx (Ptr<Event> event, double rxPowerW)
   NS_LOG_DEBUG ("sync to signal (power=" << rxPowerW << "W)");
   m_interference.NotifyRxStart (); //We need to notify it now so that it starts recording events
 
+  if (m_abstraction)
+    {
+      //The preamble detection is decided now, and the PHY headers with the
+      //payload at the end of the PPDU, so that only the start and the end of
+      //the payload are scheduled, keeping the timing of the states
+      double snr = m_interference.CalculateSnr (event);
+      if (m_preambleDetectionModel && !m_preambleDetectionModel->IsPreambleDetected (rxPowerW, snr, m_channelWidth))
+        {
+          NS_LOG_DEBUG ("Drop packet because PHY preamble detection failed");
+          NotifyRxDrop (event->GetPsdu (), PREAMBLE_DETECT_FAILURE);
+          m_interference.NotifyRxEnd ();
+          if (event->GetEndTime () > (Simulator::Now () + m_state->GetDelayUntilIdle ()))
+            {
+              MaybeCcaBusyDuration ();
+            }
+          return;
+        }
+      NotifyRxBegin (event->GetPsdu ());
+      m_timeLastPreambleDetected = Simulator::Now ();
+      Time preambleAndHeaderDuration = CalculatePhyPreambleAndHeaderDuration (event->GetTxVector ());
+      m_state->SwitchMaybeToCcaBusy (preambleAndHeaderDuration);
+      m_endPhyRxEvent = Simulator::Schedule (preambleAndHeaderDuration, &WifiPhy::StartReceivePayload, this, event);
+      m_currentEvent = event;
+      return;
+    }
+
   if (!m_endPreambleDetectionEvent.IsRunning ())
     {
       Time startOfPreambleDuration = GetPreambleDetectionDuration ();
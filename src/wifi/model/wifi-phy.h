@@ -1899,6 +1899,15 @@ private:
    */
   void ScheduleEndOfMpdus (Ptr<Event> event);
 
+  /**
+   * Decide at once the reception of the PHY headers and of each MPDU of a
+   * PPDU received at frame granularity, from the lowest SNIR over the PPDU,
+   * and forward the MPDUs of an A-MPDU that were successfully received.
+   *
+   * \param event the event holding incoming PPDU's information
+   */
+  void DecideAbstractedReception (Ptr<Event> event);
+
   /**
    * The trace source fired when a packet begins the transmission process on
    * the medium.
@@ -2097,6 +2106,7 @@ private:
   Ptr<WifiRadioEnergyModel> m_wifiRadioEnergyModel;     //!< Wifi radio energy model
   Ptr<ErrorModel> m_postReceptionErrorModel;            //!< Error model for receive packet events
   Time m_timeLastPreambleDetected;                      //!< Record the time the last preamble was detected
+  bool m_abstraction;                                   //!< Flag if the PPDUs are received at frame granularity
 
   std::vector <EventId> m_endOfMpduEvents; //!< the end of MPDU events (only used for A-MPDUs)
 
@@ -32,6 +32,8 @@ class YansWifiPhy;
 class Packet;
 class Time;
 class WifiPpdu;
+class MobilityModel;
+class MobilityGrid;
 
 /**
  * \brief a channel to interconnect ns3::YansWifiPhy objects.
@@ -41,6 +43,12 @@ class WifiPpdu;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * \note When the MaxRange attribute is positive, a transmission only
+ * reaches the PHYs within this distance of the sender, found with a
+ * MobilityGrid of their positions.  The propagation models are not invoked
+ * for the other PHYs, hence random propagation models draw different
+ * values than without a range.
  */
 class YansWifiChannel : public Channel
 {
@@ -82,7 +90,10 @@ public:
    * This method should not be invoked by normal users. It is
    * currently invoked only from YansWifiPhy::StartTx.  The channel
    * attempts to deliver the PPDU to all other YansWifiPhy objects
-   * on the channel (except for the sender).
+   * on the channel (except for the sender), or only to those within
+   * the MaxRange attribute when it is positive.  The PPDU is not
+   * delivered to the PHYs which would drop it as below their
+   * sensitivity.
    */
   void Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const;
 
@@ -114,10 +125,24 @@ private:
    * \param txPowerDbm the TX power associated to the packet being sent (dBm)
    */
   static void Receive (Ptr<YansWifiPhy> receiver, Ptr<WifiPpdu> ppdu, double txPowerDbm);
+  /**
+   * Schedule the reception of a PPDU by a YansWifiPhy, unless it is the
+   * sender, it is on another channel or the signal is too weak.
+   *
+   * \param sender the PHY object from which the packet is originating
+   * \param senderMobility the mobility model of the sender
+   * \param receiver the PHY object which may receive the packet
+   * \param ppdu the PPDU to send
+   * \param txPowerDbm the TX power associated to the packet, in dBm
+   */
+  void SendTo (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+               Ptr<YansWifiPhy> receiver, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const;
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_maxRange;                   //!< Range of the transmissions, or 0
+  mutable Ptr<MobilityGrid> m_grid;    //!< Positions of the YansWifiPhys, built by Send
 };
 
 } //namespace ns3
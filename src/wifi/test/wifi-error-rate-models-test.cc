@@ -21,6 +21,9 @@
 #include "ns3/test.h"
 #include "ns3/nist-error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/tabulated-error-rate-model.h"
+#include "ns3/pointer.h"
 #include "ns3/wifi-phy.h"
 #include "ns3/wifi-utils.h"
 
@@ -291,6 +294,88 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case Tabulated
+ */
+class WifiErrorRateModelsTestCaseTabulated : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTabulated ();
+  virtual ~WifiErrorRateModelsTestCaseTabulated ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the tabulated success rates of a model with the model.
+   *
+   * \param model the model
+   * \param modes the modes to compare
+   * \param txVector the TXVECTOR of the chunks
+   */
+  void Compare (Ptr<ErrorRateModel> model, const std::vector<WifiMode> &modes, WifiTxVector txVector);
+};
+
+WifiErrorRateModelsTestCaseTabulated::WifiErrorRateModelsTestCaseTabulated ()
+  : TestCase ("WifiErrorRateModel test case tabulated")
+{
+}
+
+WifiErrorRateModelsTestCaseTabulated::~WifiErrorRateModelsTestCaseTabulated ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTabulated::Compare (Ptr<ErrorRateModel> model, const std::vector<WifiMode> &modes,
+                                               WifiTxVector txVector)
+{
+  Ptr<TabulatedErrorRateModel> tabulated = CreateObject<TabulatedErrorRateModel> ();
+  tabulated->SetAttribute ("ErrorRateModel", PointerValue (model));
+  const uint64_t sizes[] = {1, 100 * 8, 2000 * 8, 65535 * 8};
+  for (std::vector<WifiMode>::const_iterator mode = modes.begin (); mode != modes.end (); ++mode)
+    {
+      txVector.SetMode (*mode);
+      // Below, within and beyond the tables
+      for (double snr = -15; snr < 65; snr += 0.37)
+        {
+          for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++)
+            {
+              double expected = model->GetChunkSuccessRate (*mode, txVector, DbToRatio (snr), sizes[i]);
+              double ps = tabulated->GetChunkSuccessRate (*mode, txVector, DbToRatio (snr), sizes[i]);
+              NS_TEST_ASSERT_MSG_EQ_TOL (ps, expected, 1e-4, "Wrong success rate of " << sizes[i] << " bits of "
+                                         << *mode << " at " << snr << " dB");
+            }
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (tabulated->GetChunkSuccessRate (modes[0], txVector, 0, 0), 1, "Wrong success rate of no bits");
+}
+
+void
+WifiErrorRateModelsTestCaseTabulated::DoRun (void)
+{
+  std::vector<WifiMode> modes;
+  modes.push_back (WifiPhy::GetDsssRate1Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate11Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate6Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate18Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate54Mbps ());
+  WifiTxVector txVector;
+  txVector.SetChannelWidth (20);
+  Compare (CreateObject<NistErrorRateModel> (), modes, txVector);
+  Compare (CreateObject<YansErrorRateModel> (), modes, txVector);
+
+  modes.clear ();
+  modes.push_back (WifiPhy::GetHtMcs0 ());
+  modes.push_back (WifiPhy::GetHtMcs7 ());
+  modes.push_back (WifiPhy::GetVhtMcs9 ());
+  txVector.SetChannelWidth (40);
+  txVector.SetNss (2);
+  Compare (CreateObject<NistErrorRateModel> (), modes, txVector);
+  Compare (CreateObject<YansErrorRateModel> (), modes, txVector);
+}
+
 class TestInterferenceHelper : public InterferenceHelper
 {
 public:
@@ -468,6 +553,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseMimo, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTabulated, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite
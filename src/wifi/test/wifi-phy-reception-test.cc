@@ -20,6 +20,7 @@
 
 #include "ns3/log.h"
 #include "ns3/test.h"
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
@@ -2278,6 +2279,219 @@ TestAmpduReception::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Reception of the PPDUs at frame granularity
+ */
+class TestAbstractedReception : public TestCase
+{
+public:
+  TestAbstractedReception ();
+  virtual ~TestAbstractedReception ();
+
+protected:
+  virtual void DoSetup (void);
+  Ptr<SpectrumWifiPhy> m_phy; ///< Phy
+  /**
+   * Send packet function
+   * \param rxPowerDbm the transmit power in dBm
+   */
+  void SendPacket (double rxPowerDbm);
+  /**
+   * Spectrum wifi receive success function
+   * \param psdu the PSDU
+   * \param snr the SNR
+   * \param txVector the transmit vector
+   * \param statusPerMpdu reception status per MPDU
+   */
+  void RxSuccess (Ptr<WifiPsdu> psdu, double snr, WifiTxVector txVector, std::vector<bool> statusPerMpdu);
+  /**
+   * Spectrum wifi receive failure function
+   * \param psdu the PSDU
+   */
+  void RxFailure (Ptr<WifiPsdu> psdu);
+  uint32_t m_countRxSuccess; ///< count RX success
+  uint32_t m_countRxFailure; ///< count RX failure
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Schedule now to check  the PHY state
+   * \param expectedState the expected PHY state
+   */
+  void CheckPhyState (WifiPhyState expectedState);
+  /**
+   * Check the PHY state now
+   * \param expectedState the expected PHY state
+   */
+  void DoCheckPhyState (WifiPhyState expectedState);
+  /**
+   * Check the number of received packets
+   * \param expectedSuccessCount the number of successfully received packets
+   * \param expectedFailureCount the number of unsuccessfully received packets
+   */
+  void CheckRxPacketCount (uint32_t expectedSuccessCount, uint32_t expectedFailureCount);
+};
+
+TestAbstractedReception::TestAbstractedReception ()
+  : TestCase ("Reception of the PPDUs at frame granularity"),
+    m_countRxSuccess (0),
+    m_countRxFailure (0)
+{
+}
+
+void
+TestAbstractedReception::SendPacket (double rxPowerDbm)
+{
+  WifiTxVector txVector = WifiTxVector (WifiPhy::GetHeMcs7 (), 0, WIFI_PREAMBLE_HE_SU, 800, 1, 1, 0, 20, false, false);
+
+  Ptr<Packet> pkt = Create<Packet> (1000);
+  WifiMacHeader hdr;
+
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+
+  Ptr<WifiPsdu> psdu = Create<WifiPsdu> (pkt, hdr);
+  Time txDuration = m_phy->CalculateTxDuration (psdu->GetSize (), txVector, m_phy->GetPhyBand ());
+
+  Ptr<WifiPpdu> ppdu = Create<WifiPpdu> (psdu, txVector, txDuration, WIFI_PHY_BAND_5GHZ);
+
+  Ptr<SpectrumValue> txPowerSpectrum = WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (FREQUENCY, CHANNEL_WIDTH, DbmToW (rxPowerDbm), GUARD_WIDTH);
+
+  Ptr<WifiSpectrumSignalParameters> txParams = Create<WifiSpectrumSignalParameters> ();
+  txParams->psd = txPowerSpectrum;
+  txParams->txPhy = 0;
+  txParams->duration = txDuration;
+  txParams->ppdu = ppdu;
+
+  m_phy->StartRx (txParams);
+}
+
+void
+TestAbstractedReception::CheckPhyState (WifiPhyState expectedState)
+{
+  //This is needed to make sure PHY state will be checked as the last event if a state change occured at the exact same time as the check
+  Simulator::ScheduleNow (&TestAbstractedReception::DoCheckPhyState, this, expectedState);
+}
+
+void
+TestAbstractedReception::DoCheckPhyState (WifiPhyState expectedState)
+{
+  WifiPhyState currentState;
+  PointerValue ptr;
+  m_phy->GetAttribute ("State", ptr);
+  Ptr <WifiPhyStateHelper> state = DynamicCast <WifiPhyStateHelper> (ptr.Get<WifiPhyStateHelper> ());
+  currentState = state->GetState ();
+  NS_LOG_FUNCTION (this << currentState);
+  NS_TEST_ASSERT_MSG_EQ (currentState, expectedState, "PHY State " << currentState << " does not match expected state " << expectedState << " at " << Simulator::Now ());
+}
+
+void
+TestAbstractedReception::CheckRxPacketCount (uint32_t expectedSuccessCount, uint32_t expectedFailureCount)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_countRxSuccess, expectedSuccessCount, "Didn't receive right number of successful packets");
+  NS_TEST_ASSERT_MSG_EQ (m_countRxFailure, expectedFailureCount, "Didn't receive right number of unsuccessful packets");
+}
+
+void
+TestAbstractedReception::RxSuccess (Ptr<WifiPsdu> psdu, double snr, WifiTxVector txVector, std::vector<bool> statusPerMpdu)
+{
+  NS_LOG_FUNCTION (this << *psdu << snr << txVector);
+  m_countRxSuccess++;
+}
+
+void
+TestAbstractedReception::RxFailure (Ptr<WifiPsdu> psdu)
+{
+  NS_LOG_FUNCTION (this << *psdu);
+  m_countRxFailure++;
+}
+
+TestAbstractedReception::~TestAbstractedReception ()
+{
+  m_phy = 0;
+}
+
+void
+TestAbstractedReception::DoSetup (void)
+{
+  m_phy = CreateObject<SpectrumWifiPhy> ();
+  m_phy->SetAttribute ("Abstraction", BooleanValue (true));
+  m_phy->ConfigureStandardAndBand (WIFI_PHY_STANDARD_80211ax, WIFI_PHY_BAND_5GHZ);
+  Ptr<ErrorRateModel> error = CreateObject<NistErrorRateModel> ();
+  m_phy->SetErrorRateModel (error);
+  m_phy->SetChannelNumber (CHANNEL_NUMBER);
+  m_phy->SetFrequency (FREQUENCY);
+  m_phy->SetReceiveOkCallback (MakeCallback (&TestAbstractedReception::RxSuccess, this));
+  m_phy->SetReceiveErrorCallback (MakeCallback (&TestAbstractedReception::RxFailure, this));
+
+  Ptr<ThresholdPreambleDetectionModel> preambleDetectionModel = CreateObject<ThresholdPreambleDetectionModel> ();
+  preambleDetectionModel->SetAttribute ("Threshold", DoubleValue (4));
+  preambleDetectionModel->SetAttribute ("MinimumRssi", DoubleValue (-82));
+  m_phy->SetPreambleDetectionModel (preambleDetectionModel);
+}
+
+void
+TestAbstractedReception::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  int64_t streamNumber = 0;
+  m_phy->AssignStreams (streamNumber);
+
+  //RX power > CCA-ED > CCA-PD
+  double rxPowerDbm = -50;
+
+  // CASE 1: send one packet and check PHY state:
+  // the preamble is detected at the start of the packet, so that PHY state should be CCA_BUSY
+  // from the start, then RX from the end of the PHY header, as with the detailed reception.
+
+  Simulator::Schedule (Seconds (1.0), &TestAbstractedReception::SendPacket, this, rxPowerDbm);
+  Simulator::Schedule (Seconds (1.0), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::CCA_BUSY);
+  Simulator::Schedule (Seconds (1.0) + NanoSeconds (43999), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::CCA_BUSY);
+  Simulator::Schedule (Seconds (1.0) + NanoSeconds (44000), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::RX);
+  // Since it takes 152.8us to transmit the packet, PHY should be back to IDLE at time 152.8us
+  Simulator::Schedule (Seconds (1.0) + NanoSeconds (152799), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::RX);
+  Simulator::Schedule (Seconds (1.0) + NanoSeconds (152800), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::IDLE);
+  // Packet should have been successfully received
+  Simulator::Schedule (Seconds (1.1), &TestAbstractedReception::CheckRxPacketCount, this, 1, 0);
+
+  // CASE 2: send one packet and a much weaker one (below CCA-ED) during its payload:
+  // the lowest SNR is still high enough to decode the modulation.
+
+  Simulator::Schedule (Seconds (2.0), &TestAbstractedReception::SendPacket, this, rxPowerDbm);
+  Simulator::Schedule (Seconds (2.0) + MicroSeconds (100), &TestAbstractedReception::SendPacket, this, rxPowerDbm - 30);
+  Simulator::Schedule (Seconds (2.0) + NanoSeconds (152799), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::RX);
+  Simulator::Schedule (Seconds (2.0) + NanoSeconds (152800), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::IDLE);
+  Simulator::Schedule (Seconds (2.1), &TestAbstractedReception::CheckRxPacketCount, this, 2, 0);
+
+  // CASE 3: send one packet and a 6 dB weaker one during its payload:
+  // the packet is decided at the lowest SNR (around 6 dB, too low to decode the modulation),
+  // so that it should be marked as a failure at its end.
+
+  Simulator::Schedule (Seconds (3.0), &TestAbstractedReception::SendPacket, this, rxPowerDbm);
+  Simulator::Schedule (Seconds (3.0) + MicroSeconds (100), &TestAbstractedReception::SendPacket, this, rxPowerDbm - 6);
+  // PHY should be CCA_BUSY after the end of the first packet, until the end of the second one at 252.8us
+  Simulator::Schedule (Seconds (3.0) + NanoSeconds (152799), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::RX);
+  Simulator::Schedule (Seconds (3.0) + NanoSeconds (152800), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::CCA_BUSY);
+  Simulator::Schedule (Seconds (3.0) + NanoSeconds (252799), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::CCA_BUSY);
+  Simulator::Schedule (Seconds (3.0) + NanoSeconds (252800), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::IDLE);
+  Simulator::Schedule (Seconds (3.1), &TestAbstractedReception::CheckRxPacketCount, this, 2, 1);
+
+  // CASE 4: send one packet below the minimum RSSI of the preamble detection:
+  // it should be dropped at its start, without any state change nor failure.
+
+  Simulator::Schedule (Seconds (4.0), &TestAbstractedReception::SendPacket, this, -85);
+  Simulator::Schedule (Seconds (4.0) + MicroSeconds (1), &TestAbstractedReception::CheckPhyState, this, WifiPhyState::IDLE);
+  Simulator::Schedule (Seconds (4.1), &TestAbstractedReception::CheckRxPacketCount, this, 2, 1);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -2298,6 +2512,7 @@ WifiPhyReceptionTestSuite::WifiPhyReceptionTestSuite ()
   AddTestCase (new TestSimpleFrameCaptureModel, TestCase::QUICK);
   AddTestCase (new TestPhyHeadersReception, TestCase::QUICK);
   AddTestCase (new TestAmpduReception, TestCase::QUICK);
+  AddTestCase (new TestAbstractedReception, TestCase::QUICK);
 }
 
 static WifiPhyReceptionTestSuite wifiPhyReceptionTestSuite; ///< the test suite
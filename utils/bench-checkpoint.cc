@@ -0,0 +1,250 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the checkpoints on an incast
+// scenario: 'senders' hosts send bulk TCP flows through a switch to a
+// receiver, and the rate of the bottleneck link is altered after 'warmup'
+// seconds, with 'variants' rates.  The variants are first run from the
+// start of the simulation, one after the other, then continued from a
+// checkpoint at 'warmup' seconds.  Both ways must receive the same number
+// of bytes for each variant, which the program checks, and the CPU time
+// of both ways is reported.
+// Sample usage:  ./waf --run 'bench-checkpoint --variants=8 --warmup=2 --stop=3'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/checkpoint.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/data-rate.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+#include <iostream>
+#include <vector>
+#include <stdlib.h> // for exit ()
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+using namespace ns3;
+
+/** The result of a variant, sent to the benchmark through a pipe. */
+struct Result
+{
+  uint32_t checkpoint;  //!< 1 if continued from the checkpoint.
+  uint32_t variant;     //!< The variant.
+  uint64_t rx;          //!< The bytes received.
+};
+
+static uint32_t g_variants = 4;        //!< Number of variants
+static Ptr<PointToPointNetDevice> g_bottleneck; //!< Device of the bottleneck link
+static Ptr<PacketSink> g_sink;         //!< Receiver
+
+/**
+ * Set the rate of the bottleneck link.
+ * \param [in] variant The variant.
+ */
+static void
+SetVariant (uint32_t variant)
+{
+  g_bottleneck->SetAttribute ("DataRate",
+                              DataRateValue (DataRate ((variant + 1) * 100000000ULL / g_variants)));
+}
+
+/**
+ * Create the incast scenario.
+ * \param [in] senders The number of senders.
+ */
+static void
+Build (uint32_t senders)
+{
+  NodeContainer hosts;
+  hosts.Create (senders);
+  Ptr<Node> sw = CreateObject<Node> ();
+  Ptr<Node> receiver = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (hosts);
+  internet.Install (sw);
+  internet.Install (receiver);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("10us"));
+  Ipv4AddressHelper address ("10.1.0.0", "255.255.255.0");
+  for (uint32_t i = 0; i < senders; i++)
+    {
+      address.Assign (p2p.Install (hosts.Get (i), sw));
+      address.NewNetwork ();
+    }
+  NetDeviceContainer bottleneck = p2p.Install (sw, receiver);
+  g_bottleneck = DynamicCast<PointToPointNetDevice> (bottleneck.Get (0));
+  Ipv4InterfaceContainer interfaces = address.Assign (bottleneck);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 5000;
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  g_sink = DynamicCast<PacketSink> (sink.Install (receiver).Get (0));
+  BulkSendHelper bulk ("ns3::TcpSocketFactory", InetSocketAddress (interfaces.GetAddress (1), port));
+  bulk.SetAttribute ("MaxBytes", UintegerValue (0));
+  ApplicationContainer apps = bulk.Install (hosts);
+  apps.Start (Seconds (0.1));
+}
+
+/**
+ * Report the result of this process and exit.
+ * \param [in] fd The pipe to the benchmark.
+ * \param [in] checkpoint Whether the variant was continued from the checkpoint.
+ * \param [in] variant The variant.
+ */
+static void
+Report (int fd, bool checkpoint, uint32_t variant)
+{
+  Result result;
+  result.checkpoint = checkpoint;
+  result.variant = variant;
+  result.rx = g_sink->GetTotalRx ();
+  g_bottleneck = 0;
+  g_sink = 0;
+  Simulator::Destroy ();
+  bool ok = write (fd, &result, sizeof (result)) == sizeof (result);
+  exit (ok && Checkpoint::Wait () == 0 ? 0 : 1);
+}
+
+/**
+ * \returns The CPU time of the terminated children, in ms.
+ */
+static double
+ChildrenCpuMs (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_CHILDREN, &usage);
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e3
+         + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-3;
+}
+
+/**
+ * Wait for a child of the benchmark.
+ * \param [in] pid The child.
+ * \returns \c true if it succeeded.
+ */
+static bool
+WaitFor (pid_t pid)
+{
+  int status;
+  return waitpid (pid, &status, 0) == pid && WIFEXITED (status) && WEXITSTATUS (status) == 0;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t senders = 8;
+  double warmup = 2;
+  double stop = 3;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the checkpoints on an incast scenario");
+  cmd.AddValue ("senders", "number of senders", senders);
+  cmd.AddValue ("variants", "number of rates of the bottleneck link", g_variants);
+  cmd.AddValue ("warmup", "time of the checkpoint, in seconds", warmup);
+  cmd.AddValue ("stop", "end of the simulation, in seconds", stop);
+  cmd.Parse (argc, argv);
+
+  if (senders == 0 || g_variants == 0 || warmup <= 0 || stop <= warmup)
+    {
+      std::cerr << "Error-- senders and variants must be positive, and 0 < warmup < stop" << std::endl;
+      exit (1);
+    }
+  if (!Checkpoint::IsSupported ())
+    {
+      std::cerr << "Error-- checkpoints are not supported on this system" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-checkpoint with " << senders << " senders, "
+            << g_variants << " variants" << std::endl;
+
+  int fds[2];
+  if (pipe (fds) != 0)
+    {
+      std::cerr << "Error-- cannot create the pipe" << std::endl;
+      exit (1);
+    }
+  std::cout.flush ();
+
+  uint32_t failed = 0;
+  SystemWallClockMs time;
+  double cpu = ChildrenCpuMs ();
+  time.Start ();
+  for (uint32_t i = 0; i < g_variants; i++)
+    {
+      pid_t pid = fork ();
+      if (pid == 0)
+        {
+          close (fds[0]);
+          Build (senders);
+          Simulator::Schedule (Seconds (warmup), &SetVariant, i);
+          Simulator::Stop (Seconds (stop));
+          Simulator::Run ();
+          Report (fds[1], false, i);
+        }
+      failed += pid < 0 || !WaitFor (pid);
+    }
+  uint64_t delay = time.End ();
+  std::cout << "From the start: " << delay << " ms, "
+            << ChildrenCpuMs () - cpu << " ms of CPU" << std::endl;
+
+  cpu = ChildrenCpuMs ();
+  time.Start ();
+  pid_t pid = fork ();
+  if (pid == 0)
+    {
+      close (fds[0]);
+      Build (senders);
+      Checkpoint::Schedule (Seconds (warmup), g_variants, MakeCallback (&SetVariant));
+      Simulator::Stop (Seconds (stop));
+      Simulator::Run ();
+      Report (fds[1], true, Checkpoint::GetVariant ());
+    }
+  failed += pid < 0 || !WaitFor (pid);
+  delay = time.End ();
+  std::cout << "From the checkpoint: " << delay << " ms, "
+            << ChildrenCpuMs () - cpu << " ms of CPU" << std::endl;
+  close (fds[1]);
+
+  // Compare the bytes received by each variant
+  std::vector<std::vector<uint64_t> > rx (2, std::vector<uint64_t> (g_variants, 0));
+  Result result;
+  while (read (fds[0], &result, sizeof (result)) == sizeof (result))
+    {
+      rx[result.checkpoint][result.variant] = result.rx;
+    }
+  close (fds[0]);
+  uint32_t errors = 0;
+  for (uint32_t i = 0; i < g_variants; i++)
+    {
+      std::cout << "Variant " << i << ": " << rx[0][i] << " bytes from the start, "
+                << rx[1][i] << " bytes from the checkpoint" << std::endl;
+      errors += rx[0][i] == 0 || rx[0][i] != rx[1][i];
+    }
+  std::cout << "Failed processes: " << failed << ", different results: " << errors << std::endl;
+  return failed + errors == 0 ? 0 : 1;
+}
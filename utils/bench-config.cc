@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the resolution of Config paths
+// when connecting trace sinks to the devices of 'n' nodes, one node at a
+// time (as done by setup loops) and with a single wildcard path.
+// Sample usage:  ./waf --run 'bench-config --n=10000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/config.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include <iostream>
+#include <sstream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static uint32_t g_drops = 0;
+
+static void
+PhyRxDrop (Ptr<const Packet> p)
+{
+  g_drops++;
+}
+
+static void
+PhyRxDropWithContext (std::string context, Ptr<const Packet> p)
+{
+  g_drops++;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t devices = 2;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the resolution of Config paths");
+  cmd.AddValue ("n", "number of nodes", n);
+  cmd.AddValue ("devices", "number of devices per node", devices);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of nodes must be specified " <<
+        "by command-line argument --n=(number of nodes)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-config with n=" << n << " nodes, "
+            << devices << " devices per node" << std::endl;
+
+  NodeContainer nodes;
+  nodes.Create (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = 0; j < devices; j++)
+        {
+          nodes.Get (i)->AddDevice (CreateObject<SimpleNetDevice> ());
+        }
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      std::ostringstream oss;
+      oss << "/NodeList/" << i << "/DeviceList/*/$ns3::SimpleNetDevice/PhyRxDrop";
+      Config::ConnectWithoutContext (oss.str (), MakeCallback (&PhyRxDrop));
+    }
+  uint64_t delay = time.End ();
+  std::cout << n << " paths with an explicit node index: " << delay << " ms" << std::endl;
+
+  time.Start ();
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/PhyRxDrop",
+                   MakeCallback (&PhyRxDropWithContext));
+  delay = time.End ();
+  std::cout << "1 wildcard path with context: " << delay << " ms" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the lookups of the protocols
+// aggregated to a node with a full internet stack, as done by the
+// protocols and applications with node->GetObject<T> (), 'n' times per
+// protocol.  The search of the aggregates, walking the parents of their
+// TypeIds, is timed for reference, and the hit rate of the lookup cache of
+// the aggregates is reported.
+// Sample usage:  ./waf --run 'bench-get-object --n=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/node.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/simulator.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * The search of Object::DoGetObject, without its cache.
+ * \param [in] node The node.
+ * \param [in] tid The TypeId looked up.
+ * \return The aggregate of this TypeId.
+ */
+static Ptr<const Object>
+Search (Ptr<Node> node, TypeId tid)
+{
+  TypeId objectTid = Object::GetTypeId ();
+  Object::AggregateIterator i = node->GetAggregateIterator ();
+  while (i.HasNext ())
+    {
+      Ptr<const Object> current = i.Next ();
+      TypeId cur = current->GetInstanceTypeId ();
+      while (cur != tid && cur != objectTid)
+        {
+          cur = cur.GetParent ();
+        }
+      if (cur == tid)
+        {
+          return current;
+        }
+    }
+  return 0;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the lookups of the aggregates of a node");
+  cmd.AddValue ("n", "number of lookups per protocol", n);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of lookups must be positive" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-get-object with n=" << n << " lookups" << std::endl;
+
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+
+  uint64_t hits = Object::GetNCacheHits ();
+  uint64_t misses = Object::GetNCacheMisses ();
+  uint64_t found = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      found += node->GetObject<Ipv4> () != 0;
+      found += node->GetObject<Ipv4L3Protocol> () != 0;
+      found += node->GetObject<Ipv6L3Protocol> () != 0;
+      found += node->GetObject<TcpL4Protocol> () != 0;
+      found += node->GetObject<UdpL4Protocol> () != 0;
+      found += node->GetObject<TrafficControlLayer> () != 0;
+    }
+  uint64_t delay = time.End ();
+  hits = Object::GetNCacheHits () - hits;
+  misses = Object::GetNCacheMisses () - misses;
+  std::cout << "GetObject: " << delay << " ms, " << found << " found, "
+            << hits << " cache hits, " << misses << " cache misses, hit rate "
+            << (hits + misses == 0 ? 0 : 100.0 * hits / (hits + misses)) << "%" << std::endl;
+
+  TypeId tids[] = {
+    Ipv4::GetTypeId (), Ipv4L3Protocol::GetTypeId (), Ipv6L3Protocol::GetTypeId (),
+    TcpL4Protocol::GetTypeId (), UdpL4Protocol::GetTypeId (), TrafficControlLayer::GetTypeId ()
+  };
+  found = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = 0; j < sizeof (tids) / sizeof (tids[0]); j++)
+        {
+          found += Search (node, tids[j]) != 0;
+        }
+    }
+  delay = time.End ();
+  std::cout << "Search of the aggregates: " << delay << " ms, " << found << " found" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the Time arithmetic done by the
+// models, such as the ratio of two Time values and the scaling of a Time by
+// a double, on 'n' random operands.  With the native int128_t
+// implementation, each operation is also run through the reference long
+// division and long double conversion, and the results are compared bit
+// for bit.
+// Sample usage:  ./waf --run 'bench-int64x64 --n=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/nstime.h"
+#include "ns3/int64x64.h"
+#include <iostream>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * \param [in,out] seed The state of the generator.
+ * \return The next 64 bits random value.
+ */
+static uint64_t
+Next (uint64_t & seed)
+{
+  seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+  uint64_t x = seed;
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  return x;
+}
+
+#if defined (INT64X64_USE_128) && !defined (PYTHON_SCAN)
+
+/**
+ * \param [in] v A value.
+ * \return Its raw Q64.64 bits.
+ */
+static int128_t
+Raw (const int64x64_t & v)
+{
+  return (static_cast<int128_t> (v.GetHigh ()) << 64) | v.GetLow ();
+}
+
+/**
+ * The long division of int64x64_t::Udiv, without the fast path.
+ * \param [in] a Numerator.
+ * \param [in] b Denominator.
+ * \return The Q64.64 representation of `a / b`.
+ */
+static uint128_t
+ReferenceUdiv (uint128_t a, uint128_t b)
+{
+  const uint128_t HIGH_BIT = static_cast<uint128_t> (1) << 127;
+  uint128_t rem = a;
+  uint128_t den = b;
+  uint128_t quo = rem / den;
+  rem = rem % den;
+  uint128_t result = quo;
+  const uint64_t DIGITS = 64;
+  uint64_t digis = 0;
+  uint64_t shift = 0;
+  while ( (shift < DIGITS) && !(den & 0x1))
+    {
+      ++shift;
+      den >>= 1;
+    }
+  while ( (digis < DIGITS) && (rem != 0) )
+    {
+      while ( (digis + shift < DIGITS) && !(rem & HIGH_BIT))
+        {
+          ++shift;
+          rem <<= 1;
+        }
+      while ( (digis + shift < DIGITS) && ( !(den & 0x1) || (rem < den) ) )
+        {
+          ++shift;
+          den >>= 1;
+        }
+      quo = rem / den;
+      rem = rem % den;
+      result <<= shift;
+      result += quo;
+      digis += shift;
+      shift = 0;
+    }
+  if (digis < DIGITS)
+    {
+      result <<= DIGITS - digis;
+    }
+  return result;
+}
+
+/**
+ * \param [in] a Numerator.
+ * \param [in] b Denominator.
+ * \return The raw bits of `a / b` through the reference long division.
+ */
+static int128_t
+ReferenceDiv (const int64x64_t & a, const int64x64_t & b)
+{
+  int128_t sa = Raw (a);
+  int128_t sb = Raw (b);
+  uint128_t ua = sa < 0 ? -sa : sa;
+  uint128_t ub = sb < 0 ? -sb : sb;
+  int128_t result = ReferenceUdiv (ua, ub);
+  return (sa < 0) != (sb < 0) ? -result : result;
+}
+
+/**
+ * \param [in] value A double.
+ * \return The raw bits of its conversion through long double.
+ */
+static int128_t
+ReferenceDouble (double value)
+{
+  return Raw (int64x64_t (static_cast<long double> (value)));
+}
+
+#endif /* INT64X64_USE_128 */
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the Time arithmetic");
+  cmd.AddValue ("n", "number of operands", n);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of operands must be positive" << std::endl;
+      exit (1);
+    }
+
+  // Times from 1 ns to about 10 s, ratios as found in the models
+  std::vector<Time> times (n);
+  std::vector<Time> periods (n);
+  std::vector<double> scales (n);
+  uint64_t seed = 1;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      times[i] = NanoSeconds (1 + Next (seed) % 10000000000ULL);
+      periods[i] = NanoSeconds (1 + Next (seed) % 100000000ULL);
+      scales[i] = (Next (seed) >> 11) / 9007199254740992.0 * 4.0;
+    }
+  std::cout << "Running bench-int64x64 with n=" << n << " operands" << std::endl;
+
+  SystemWallClockMs time;
+  double sum = 0;
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += (times[i] / periods[i]).GetDouble ();
+    }
+  std::cout << "Time / Time: " << time.End () << " ms" << std::endl;
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += (times[i] * scales[i]).GetDouble ();
+    }
+  std::cout << "Time * double: " << time.End () << " ms" << std::endl;
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += (times[i] / periods[i].GetInteger ()).GetDouble ();
+    }
+  std::cout << "Time / integer: " << time.End () << " ms" << std::endl;
+
+  uint32_t errors = 0;
+#if defined (INT64X64_USE_128) && !defined (PYTHON_SCAN)
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += int64x64_t (ReferenceDiv (int64x64_t (times[i].GetInteger ()),
+                                       int64x64_t (periods[i].GetInteger ())) >> 64,
+                         0).GetDouble ();
+    }
+  std::cout << "Reference long division: " << time.End () << " ms" << std::endl;
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += static_cast<double> (ReferenceDouble (scales[i]) >> 64);
+    }
+  std::cout << "Reference long double conversion: " << time.End () << " ms" << std::endl;
+
+  // The operands of the benchmark, then random bits with integer divisors
+  for (uint32_t i = 0; i < n; i++)
+    {
+      int64x64_t a = times[i].GetInteger ();
+      int64x64_t b = periods[i].GetInteger ();
+      errors += Raw (a / b) != ReferenceDiv (a, b);
+      errors += Raw (int64x64_t (scales[i])) != ReferenceDouble (scales[i]);
+      a = int64x64_t (static_cast<int64_t> (Next (seed)) >> (Next (seed) % 64), Next (seed));
+      b = int64x64_t (static_cast<int64_t> (Next (seed)) >> (1 + Next (seed) % 63));
+      if (b != 0)
+        {
+          errors += Raw (a / b) != ReferenceDiv (a, b);
+        }
+      double d = static_cast<int64_t> (Next (seed)) / static_cast<double> (1ULL << (Next (seed) % 64));
+      errors += Raw (int64x64_t (d)) != ReferenceDouble (d);
+    }
+  std::cout << "Results different from the reference: " << errors << std::endl;
+#endif /* INT64X64_USE_128 */
+
+  // Keep the loops
+  std::cout << "Checksum: " << sum << std::endl;
+  return errors == 0 ? 0 : 1;
+}
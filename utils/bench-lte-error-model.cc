@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the LTE MI error model: for 'n'
+// random SINR vectors over 'bandwidth' RBs, it evaluates the PCFICH+PDCCH
+// error, the error of a transport block over random RBs, with and without
+// HARQ history, and the CQI feedbacks of the MI based AMC.  The time of
+// each kind of evaluation is reported, with a checksum of the results
+// which must not change with the implementation of the error model.
+// Sample usage:  ./waf --run 'bench-lte-error-model --n=20000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/lte-mi-error-model.h"
+#include "ns3/lte-amc.h"
+#include "ns3/lte-spectrum-value-helper.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/random-variable-stream.h"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 5000;
+  uint16_t bandwidth = 50;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the LTE MI error model");
+  cmd.AddValue ("n", "number of SINR vectors", n);
+  cmd.AddValue ("bandwidth", "number of RBs", bandwidth);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || (bandwidth != 6 && bandwidth != 15 && bandwidth != 25
+                 && bandwidth != 50 && bandwidth != 75 && bandwidth != 100))
+    {
+      std::cerr << "Error-- at least one vector and an LTE bandwidth are needed" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-lte-error-model with n=" << n << " vectors of " << bandwidth << " RBs" << std::endl;
+
+  Ptr<SpectrumModel> model = LteSpectrumValueHelper::GetSpectrumModel (100, bandwidth);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<SpectrumValue> sinrs;
+  std::vector<std::vector<int> > maps;
+  std::vector<uint8_t> mcss;
+  for (uint32_t k = 0; k < n; k++)
+    {
+      SpectrumValue sinr (model);
+      double mean = random->GetValue (-12, 20);
+      for (uint16_t i = 0; i < bandwidth; i++)
+        {
+          sinr[i] = std::pow (10.0, (mean + random->GetValue (-5, 5)) / 10);
+        }
+      sinrs.push_back (sinr);
+      std::vector<int> map;
+      uint16_t start = random->GetInteger (0, bandwidth - 1);
+      uint16_t length = random->GetInteger (1, bandwidth - start);
+      for (uint16_t i = start; i < start + length; i++)
+        {
+          map.push_back (i);
+        }
+      maps.push_back (map);
+      mcss.push_back (random->GetInteger (0, 28));
+    }
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+
+  SystemWallClockMs time;
+  double sum = 0;
+  time.Start ();
+  for (uint32_t k = 0; k < n; k++)
+    {
+      sum += LteMiErrorModel::GetPcfichPdcchError (sinrs[k]);
+    }
+  uint64_t delay = time.End ();
+  std::cout << "PCFICH+PDCCH: " << delay << " ms, checksum " << std::setprecision (17) << sum << std::endl;
+
+  sum = 0;
+  time.Start ();
+  for (uint32_t k = 0; k < n; k++)
+    {
+      uint16_t size = amc->GetDlTbSizeFromMcs (mcss[k], maps[k].size ()) / 8;
+      HarqProcessInfoList_t history;
+      TbStats_t stats = LteMiErrorModel::GetTbDecodificationStats (sinrs[k], maps[k], size, mcss[k], history);
+      sum += stats.tbler + stats.mi;
+      HarqProcessInfoElement_t element;
+      element.m_mi = stats.mi;
+      element.m_rv = 0;
+      element.m_infoBits = size * 8;
+      element.m_codeBits = size * 8 / 0.5;
+      history.push_back (element);
+      stats = LteMiErrorModel::GetTbDecodificationStats (sinrs[(k + 1) % n], maps[k], size, mcss[k], history);
+      sum += stats.tbler + stats.mi;
+    }
+  delay = time.End ();
+  std::cout << "Transport blocks: " << delay << " ms, checksum " << sum << std::endl;
+
+  sum = 0;
+  time.Start ();
+  for (uint32_t k = 0; k < n; k++)
+    {
+      std::vector<int> cqi = amc->CreateCqiFeedbacks (sinrs[k], 3);
+      for (uint32_t i = 0; i < cqi.size (); i++)
+        {
+          sum = sum * 7 + cqi[i];
+          sum = std::fmod (sum, 1e9);
+        }
+    }
+  delay = time.End ();
+  std::cout << "CQI feedbacks: " << delay << " ms, checksum " << sum << std::endl;
+  return 0;
+}
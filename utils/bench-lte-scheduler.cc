@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark an LTE MAC scheduler with many
+// UEs: one eNB with a 100 RB bandwidth serves saturated downlink bearers
+// to UEs spread between 100 m and 'maxDistance' meters, for 'duration'
+// seconds.  The number of UEs is doubled from 'minUes' to 'maxUes', and
+// the time of each run is reported with the number and total size of the
+// transport blocks scheduled, and a checksum of the allocations which
+// changes with any scheduling decision.
+// Sample usage:  ./waf --run 'bench-lte-scheduler --minUes=25 --maxUes=200'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-enb-net-device.h"
+#include "ns3/lte-enb-mac.h"
+#include "ns3/lte-common.h"
+#include "ns3/eps-bearer.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/config.h"
+#include "ns3/simulator.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static uint64_t g_blocks = 0;   //!< Transport blocks scheduled
+static uint64_t g_bytes = 0;    //!< Size of the transport blocks scheduled
+static uint64_t g_checksum = 0; //!< Checksum of the allocations
+
+/**
+ * Account for a downlink allocation.
+ * \param [in] info The allocation.
+ */
+static void
+DlScheduling (DlSchedulingCallbackInfo info)
+{
+  g_blocks++;
+  g_bytes += info.sizeTb1 + info.sizeTb2;
+  g_checksum = g_checksum * 31 + info.rnti * 1000003ULL + info.mcsTb1 * 101 + info.sizeTb1;
+}
+
+/**
+ * Run the cell.
+ * \param [in] nUes The number of UEs.
+ * \param [in] scheduler The type of the scheduler.
+ * \param [in] maxDistance The maximum distance of the UEs.
+ * \param [in] duration The duration of the simulation.
+ */
+static void
+Run (uint32_t nUes, std::string scheduler, double maxDistance, double duration)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
+  lteHelper->SetSchedulerType (scheduler);
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (1);
+  ueNodes.Create (nUes);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (100),
+                                 "DeltaX", DoubleValue ((maxDistance - 100) / nUes),
+                                 "GridWidth", UintegerValue (nUes));
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->Attach (ueDevs, enbDevs.Get (0));
+  lteHelper->ActivateDataRadioBearer (ueDevs, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+  lteHelper->AssignStreams (enbDevs, 0);
+  lteHelper->AssignStreams (ueDevs, 1000);
+
+  enbDevs.Get (0)->GetObject<LteEnbNetDevice> ()->GetMac ()
+    ->TraceConnectWithoutContext ("DlScheduling", MakeCallback (&DlScheduling));
+
+  g_blocks = 0;
+  g_bytes = 0;
+  g_checksum = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  uint64_t delay = time.End ();
+  std::cout << "ues=" << nUes << " " << scheduler << ": " << delay << " ms, "
+            << g_blocks << " blocks, " << g_bytes << " bytes, checksum " << g_checksum << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t minUes = 25;
+  uint32_t maxUes = 100;
+  std::string scheduler = "ns3::PfFfMacScheduler";
+  double maxDistance = 3000;
+  double duration = 0.5;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark an LTE MAC scheduler with many UEs");
+  cmd.AddValue ("minUes", "smallest number of UEs", minUes);
+  cmd.AddValue ("maxUes", "largest number of UEs", maxUes);
+  cmd.AddValue ("scheduler", "type of the MAC scheduler", scheduler);
+  cmd.AddValue ("maxDistance", "largest distance of a UE to the eNB, in meters", maxDistance);
+  cmd.AddValue ("duration", "duration of the simulation, in seconds", duration);
+  cmd.Parse (argc, argv);
+
+  if (minUes == 0 || maxUes < minUes || maxDistance <= 100 || duration <= 0)
+    {
+      std::cerr << "Error-- at least one UE, a distance above 100 m and a positive duration are needed" << std::endl;
+      exit (1);
+    }
+
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+  Config::SetDefault ("ns3::LteEnbNetDevice::DlBandwidth", UintegerValue (100));
+  Config::SetDefault ("ns3::LteEnbNetDevice::UlBandwidth", UintegerValue (100));
+  Config::SetDefault ("ns3::LteEnbRrc::SrsPeriodicity", UintegerValue (320));
+  std::cout << "Running bench-lte-scheduler with " << scheduler << std::endl;
+
+  for (uint32_t nUes = minUes; nUes <= maxUes; nUes *= 2)
+    {
+      Run (nUes, scheduler, maxDistance, duration);
+    }
+  return 0;
+}
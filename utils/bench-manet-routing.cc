@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the routing tables of OLSR and AODV
+// in large MANETs: 'n' ad hoc stations, 'spacing' m apart on a grid and
+// moving at 'speed' m/s, run the 'protocol' for 'duration' seconds, while
+// 'flows' pairs of stations exchange a packet every second.  The time and
+// events of the simulation are reported, with the packets received, the
+// routes of all the stations at the end of the simulation and a checksum of
+// their routing tables, so that the runs of two builds can be compared.
+// Sample usage:  ./waf --run 'bench-manet-routing --protocol=aodv --n=1000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/rectangle.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4.h"
+#include "ns3/olsr-helper.h"
+#include "ns3/aodv-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/packet.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static uint64_t g_received = 0; //!< Packets received
+
+/**
+ * Count the packets received by a socket.
+ * \param [in] socket The socket.
+ */
+static void
+Receive (Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      g_received++;
+    }
+}
+
+/**
+ * Send a packet every second.
+ * \param [in] socket The socket.
+ * \param [in] to The destination.
+ */
+static void
+Send (Ptr<Socket> socket, InetSocketAddress to)
+{
+  socket->SendTo (Create<Packet> (64), 0, to);
+  Simulator::Schedule (Seconds (1), &Send, socket, to);
+}
+
+/**
+ * Run the stations.
+ * \param [in] protocol The routing protocol, olsr or aodv.
+ * \param [in] n The number of stations.
+ * \param [in] spacing The distance between the stations.
+ * \param [in] speed The speed of the stations.
+ * \param [in] flows The number of flows.
+ * \param [in] duration The duration of the simulation.
+ */
+static void
+Run (std::string protocol, uint32_t n, double spacing, double speed,
+     uint32_t flows, double duration)
+{
+  NodeContainer nodes;
+  nodes.Create (n);
+
+  uint32_t side = std::ceil (std::sqrt (n));
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (spacing),
+                                 "DeltaY", DoubleValue (spacing),
+                                 "GridWidth", UintegerValue (side));
+  if (speed > 0)
+    {
+      std::ostringstream oss;
+      oss << "ns3::ConstantRandomVariable[Constant=" << speed << "]";
+      mobility.SetMobilityModel ("ns3::RandomWalk2dMobilityModel",
+                                 "Bounds", RectangleValue (Rectangle (0, side * spacing, 0, side * spacing)),
+                                 "Speed", StringValue (oss.str ()));
+    }
+  mobility.Install (nodes);
+
+  // No frame can be received beyond about 220 m with the default log
+  // distance propagation loss
+  YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default ();
+  Ptr<YansWifiChannel> channel = channelHelper.Create ();
+  channel->SetAttribute ("MaxRange", DoubleValue (250));
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  int64_t stream = wifi.AssignStreams (devices, 0);
+  stream += mobility.AssignStreams (nodes, stream);
+
+  InternetStackHelper internet;
+  OlsrHelper olsr;
+  AodvHelper aodv;
+  if (protocol == "olsr")
+    {
+      internet.SetRoutingHelper (olsr);
+    }
+  else
+    {
+      internet.SetRoutingHelper (aodv);
+    }
+  internet.Install (nodes);
+  stream += protocol == "olsr" ? olsr.AssignStreams (nodes, stream) : aodv.AssignStreams (nodes, stream);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.0.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (stream);
+  for (uint32_t i = 0; i < flows; i++)
+    {
+      uint32_t from = random->GetInteger (0, n - 1);
+      uint32_t to = (from + random->GetInteger (1, n - 1)) % n;
+      Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (to), UdpSocketFactory::GetTypeId ());
+      sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9 + i));
+      sink->SetRecvCallback (MakeCallback (&Receive));
+      Ptr<Socket> source = Socket::CreateSocket (nodes.Get (from), UdpSocketFactory::GetTypeId ());
+      Simulator::Schedule (Seconds (random->GetValue (1, 2)), &Send, source,
+                           InetSocketAddress (interfaces.GetAddress (to), 9 + i));
+    }
+
+  g_received = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  uint64_t delay = time.End ();
+
+  // Count the routes of the printed tables, whose lines start with the
+  // destination
+  std::ostringstream tables;
+  Ptr<OutputStreamWrapper> wrapper = Create<OutputStreamWrapper> (&tables);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      nodes.Get (i)->GetObject<Ipv4> ()->GetRoutingProtocol ()->PrintRoutingTable (wrapper);
+    }
+  uint64_t routes = 0;
+  std::istringstream lines (tables.str ());
+  std::string line;
+  while (std::getline (lines, line))
+    {
+      if (!line.empty () && line[0] >= '0' && line[0] <= '9')
+        {
+          routes++;
+        }
+    }
+  std::cout << protocol << ": " << delay << " ms, "
+            << Simulator::GetEventCount () << " events, "
+            << g_received << " packets received, "
+            << routes << " routes, tables checksum "
+            << std::hash<std::string> () (tables.str ()) << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  std::string protocol = "olsr";
+  uint32_t n = 500;
+  double spacing = 35;
+  double speed = 0;
+  uint32_t flows = 20;
+  double duration = 20;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the routing tables of OLSR and AODV in large MANETs");
+  cmd.AddValue ("protocol", "routing protocol, olsr or aodv", protocol);
+  cmd.AddValue ("n", "number of stations", n);
+  cmd.AddValue ("spacing", "distance between the stations, in meters", spacing);
+  cmd.AddValue ("speed", "speed of the stations, in m/s", speed);
+  cmd.AddValue ("flows", "number of flows", flows);
+  cmd.AddValue ("duration", "duration of the simulation, in seconds", duration);
+  cmd.Parse (argc, argv);
+
+  if ((protocol != "olsr" && protocol != "aodv") || n < 2 || spacing <= 0 || speed < 0 || duration <= 0)
+    {
+      std::cerr << "Error-- the protocol must be olsr or aodv, with at least two stations,"
+                << " a positive spacing and duration" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-manet-routing with n=" << n << " stations" << std::endl;
+
+  Run (protocol, n, spacing, speed, flows, duration);
+  return 0;
+}
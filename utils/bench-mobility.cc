@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the lazy random mobility models:
+// 'n' nodes follow a random walk which changes course every 'step'
+// seconds, and the positions of all the nodes are queried every 'period'
+// seconds during 'duration' seconds.  The simulation is run with the walks
+// driven by events, then with the Lazy attribute; the positions must be
+// the same, which the program checks, and the events and times of both
+// runs are reported.
+// Sample usage:  ./waf --run 'bench-mobility --n=1000 --step=0.1 --period=1'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/random-walk-2d-mobility-model.h"
+#include "ns3/node-container.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/nstime.h"
+#include "ns3/rectangle.h"
+#include "ns3/double.h"
+#include "ns3/position-allocator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include <cmath>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * Query the positions of all the nodes.
+ * \param [in] nodes The nodes.
+ * \param [in] period The period of the queries.
+ * \param [out] sum The sum of the coordinates of the positions.
+ */
+static void
+Query (NodeContainer nodes, Time period, double *sum)
+{
+  std::vector<Vector> positions;
+  MobilityHelper::GetPositions (nodes, positions);
+  for (std::vector<Vector>::const_iterator it = positions.begin (); it != positions.end (); ++it)
+    {
+      *sum += it->x + it->y;
+    }
+  Simulator::Schedule (period, &Query, nodes, period, sum);
+}
+
+/**
+ * Run the walks.
+ * \param n The number of nodes.
+ * \param lazy Whether the walks are lazy.
+ * \param step The duration of a step of the walks, in seconds.
+ * \param period The period of the queries, in seconds.
+ * \param duration The duration of the simulation, in seconds.
+ * \returns The sum of the coordinates of the positions queried.
+ */
+static double
+Run (uint32_t n, bool lazy, double step, double period, double duration)
+{
+  NodeContainer nodes;
+  nodes.Create (n);
+  MobilityHelper mobility;
+  Ptr<RandomRectanglePositionAllocator> positions = CreateObject<RandomRectanglePositionAllocator> ();
+  positions->SetX (CreateObjectWithAttributes<UniformRandomVariable> ("Max", DoubleValue (100)));
+  positions->SetY (CreateObjectWithAttributes<UniformRandomVariable> ("Max", DoubleValue (100)));
+  positions->AssignStreams (1000000);
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::RandomWalk2dMobilityModel",
+                             "Bounds", RectangleValue (Rectangle (0, 100, 0, 100)),
+                             "Mode", EnumValue (RandomWalk2dMobilityModel::MODE_TIME),
+                             "Time", TimeValue (Seconds (step)),
+                             "Lazy", BooleanValue (lazy));
+  mobility.Install (nodes);
+  mobility.AssignStreams (nodes, 0);
+
+  double sum = 0;
+  Simulator::Schedule (Seconds (period), &Query, nodes, Seconds (period), &sum);
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  uint64_t delay = time.End ();
+  std::cout << "n=" << n << (lazy ? " lazy: " : " events: ") << delay << " ms, "
+            << Simulator::GetEventCount () << " events" << std::endl;
+  Simulator::Destroy ();
+  return sum;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 200;
+  double step = 0.1;
+  double period = 1;
+  double duration = 100;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the lazy random walks against the walks driven by events");
+  cmd.AddValue ("n", "number of nodes", n);
+  cmd.AddValue ("step", "duration of a step of the walks, in seconds", step);
+  cmd.AddValue ("period", "period of the queries of the positions, in seconds", period);
+  cmd.AddValue ("duration", "duration of the simulation, in seconds", duration);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || step <= 0 || period <= 0 || duration <= 0)
+    {
+      std::cerr << "Error-- at least one node, a positive step, period and duration are needed" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-mobility with n=" << n << " nodes" << std::endl;
+
+  double events = Run (n, false, step, period, duration);
+  double lazy = Run (n, true, step, period, duration);
+  std::cout << "Difference of the positions: " << std::fabs (events - lazy) << " m" << std::endl;
+  return std::fabs (events - lazy) <= 1e-6 * n * duration / period ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the per-packet cost of the
+// enqueue/dequeue operations of ECN marking queue discs and of the HTB
+// queue disc with many classes, for various numbers of packets 'n'
+// Sample usage:  ./waf --run 'bench-queue-disc --n=1000000 --classes=1000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/red-queue-disc.h"
+#include "ns3/dctcp-queue-disc.h"
+#include "ns3/htb-queue-disc.h"
+#include "ns3/fifo-queue-disc.h"
+#include "ns3/packet-filter.h"
+#include "ns3/integer.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <limits>
+#include <algorithm>
+
+using namespace ns3;
+
+/// Queue disc item that can always be marked
+class BenchQueueDiscItem : public QueueDiscItem
+{
+public:
+  /**
+   * Constructor
+   * \param p the packet
+   * \param cl the class of the packet
+   */
+  BenchQueueDiscItem (Ptr<Packet> p, uint32_t cl = 0)
+    : QueueDiscItem (p, Address (), 0),
+      m_class (cl) {}
+  virtual void AddHeader (void) {}
+  virtual bool Mark (void) {
+    return true;
+  }
+  /**
+   * \return the class of the packet
+   */
+  uint32_t GetClass (void) const {
+    return m_class;
+  }
+private:
+  uint32_t m_class; ///< class of the packet
+};
+
+/// Packet filter returning the class stored in the bench items
+class BenchPacketFilter : public PacketFilter
+{
+private:
+  virtual bool CheckProtocol (Ptr<QueueDiscItem> item) const {
+    return true;
+  }
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const {
+    return static_cast<BenchQueueDiscItem *> (PeekPointer (item))->GetClass ();
+  }
+};
+
+/// Marking threshold (K), in packets
+static const uint32_t g_k = 20;
+/// Number of packets enqueued back to back before the queue is drained
+static const uint32_t g_burst = 2 * g_k;
+
+static void
+benchQueueDisc (Ptr<QueueDisc> q, uint32_t n)
+{
+  Ptr<Packet> p = Create<Packet> (1448);
+  for (uint32_t i = 0; i < n; i += g_burst)
+    {
+      for (uint32_t j = 0; j < g_burst; j++)
+        {
+          q->Enqueue (Create<BenchQueueDiscItem> (p));
+        }
+      for (uint32_t j = 0; j < g_burst; j++)
+        {
+          q->Dequeue ();
+        }
+    }
+}
+
+static Ptr<QueueDisc>
+createRed (void)
+{
+  Ptr<RedQueueDisc> q = CreateObject<RedQueueDisc> ();
+  q->SetAttribute ("MaxSize", QueueSizeValue (QueueSize ("1000p")));
+  q->SetAttribute ("MeanPktSize", UintegerValue (1500));
+  q->SetAttribute ("QW", DoubleValue (1));
+  q->SetAttribute ("MinTh", DoubleValue (g_k));
+  q->SetAttribute ("MaxTh", DoubleValue (g_k));
+  q->SetAttribute ("Gentle", BooleanValue (false));
+  q->SetAttribute ("UseEcn", BooleanValue (true));
+  q->SetAttribute ("UseHardDrop", BooleanValue (false));
+  q->Initialize ();
+  return q;
+}
+
+static Ptr<QueueDisc>
+createDctcp (void)
+{
+  Ptr<DctcpQueueDisc> q = CreateObject<DctcpQueueDisc> ();
+  q->SetAttribute ("MaxSize", QueueSizeValue (QueueSize ("1000p")));
+  q->SetAttribute ("MarkingThreshold", QueueSizeValue (QueueSize (QueueSizeUnit::PACKETS, g_k)));
+  q->Initialize ();
+  return q;
+}
+
+static Ptr<QueueDisc>
+createDctcpSojourn (void)
+{
+  Ptr<QueueDisc> q = createDctcp ();
+  q->SetAttribute ("SojournThreshold", TimeValue (MicroSeconds (100)));
+  return q;
+}
+
+/// Number of HTB leaf classes
+static uint32_t g_classes = 1000;
+/// Number of HTB leaf classes per tenant (inner class), 0 for a flat hierarchy
+static uint32_t g_classesPerTenant = 0;
+
+static void
+benchHtb (Ptr<QueueDisc> q, uint32_t n)
+{
+  Ptr<Packet> p = Create<Packet> (1448);
+  uint32_t cl = 0;
+  for (uint32_t i = 0; i < n; i += g_burst)
+    {
+      // spread each burst over many classes, so that the set of backlogged
+      // classes keeps changing
+      for (uint32_t j = 0; j < g_burst; j++)
+        {
+          cl = (cl + 7) % g_classes;
+          q->Enqueue (Create<BenchQueueDiscItem> (p, cl));
+        }
+      for (uint32_t j = 0; j < g_burst; j++)
+        {
+          q->Dequeue ();
+        }
+    }
+}
+
+static Ptr<QueueDisc>
+createHtb (void)
+{
+  // rates and buckets large enough for classes never to run out of tokens,
+  // because the simulation time does not advance
+  Ptr<HtbQueueDisc> q = CreateObject<HtbQueueDisc> ();
+  q->AddPacketFilter (CreateObject<BenchPacketFilter> ());
+  uint32_t nTenants = (g_classesPerTenant > 0 ? (g_classes + g_classesPerTenant - 1) / g_classesPerTenant : 0);
+  if (nTenants > 0)
+    {
+      q->AddInnerClass (CreateObjectWithAttributes<HtbClass> ("Rate", DataRateValue (DataRate ("1000Gbps")),
+                                                              "Burst", UintegerValue (4000000000U),
+                                                              "Cburst", UintegerValue (4000000000U)));
+    }
+  for (uint32_t i = 0; i < nTenants; i++)
+    {
+      q->AddInnerClass (CreateObjectWithAttributes<HtbClass> ("Rate", DataRateValue (DataRate ("100Gbps")),
+                                                              "Ceil", DataRateValue (DataRate ("1000Gbps")),
+                                                              "Burst", UintegerValue (4000000000U),
+                                                              "Cburst", UintegerValue (4000000000U),
+                                                              "Parent", IntegerValue (0)));
+    }
+  for (uint32_t i = 0; i < g_classes; i++)
+    {
+      Ptr<HtbClass> cl = CreateObjectWithAttributes<HtbClass> ("Rate", DataRateValue (DataRate ("10Gbps")),
+                                                               "Ceil", DataRateValue (DataRate ("1000Gbps")),
+                                                               "Burst", UintegerValue (4000000000U),
+                                                               "Cburst", UintegerValue (4000000000U),
+                                                               "Priority", UintegerValue (i % 4),
+                                                               "Parent", IntegerValue (nTenants > 0 ? 1 + i / g_classesPerTenant : -1));
+      cl->SetQueueDisc (CreateObject<FifoQueueDisc> ());
+      q->AddQueueDiscClass (cl);
+    }
+  q->Initialize ();
+  return q;
+}
+
+static void
+runBench (Ptr<QueueDisc> (*create) (void), void (*bench) (Ptr<QueueDisc>, uint32_t),
+          uint32_t n, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  uint32_t marked = 0;
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      Ptr<QueueDisc> q = create ();
+      SystemWallClockMs time;
+      time.Start ();
+      (*bench) (q, n);
+      uint64_t delay = time.End ();
+      minDelay = std::min (minDelay, delay);
+      marked = q->GetStats ().nTotalMarkedPackets;
+      q->Dispose ();
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max<uint64_t> (minDelay, 1);
+  std::cout << ps << " packets/s"
+            << " (" << minDelay << " ms elapsed, "
+            << marked << " marked)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark ECN marking queue discs");
+  cmd.AddValue ("n", "number of packets", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.AddValue ("classes", "number of HTB leaf classes", g_classes);
+  cmd.AddValue ("classes-per-tenant", "number of HTB leaf classes per inner class", g_classesPerTenant);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of packets must be specified " <<
+        "by command-line argument --n=(number of packets)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-queue-disc with n=" << n << std::endl;
+  std::cout << "Bursts of " << g_burst << " packets, K=" << g_k << " packets." << std::endl;
+
+  runBench (&createRed, &benchQueueDisc, n, minIterations, "RedQueueDisc (QW=1, MinTh=MaxTh=K)");
+  runBench (&createDctcp, &benchQueueDisc, n, minIterations, "DctcpQueueDisc");
+  runBench (&createDctcpSojourn, &benchQueueDisc, n, minIterations, "DctcpQueueDisc with sojourn threshold");
+
+  std::cout << "HTB with " << g_classes << " leaf classes";
+  if (g_classesPerTenant > 0)
+    {
+      std::cout << ", " << g_classesPerTenant << " per inner class";
+    }
+  std::cout << "." << std::endl;
+  runBench (&createHtb, &benchHtb, n, minIterations, "HtbQueueDisc");
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the per-sample cost of the random
+// variables used for workloads, sampled one value at a time by GetValue and
+// by batches of 'batch' values by GetValues.  Both ways must draw the same
+// values from the same stream, which the program checks.
+// Sample usage:  ./waf --run 'bench-random-variable --n=10000000 --zipf=1000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/object-factory.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * \param [in] x The random variable.
+ * \param [in] name The name of the distribution.
+ * \param [in] n The number of values.
+ * \param [in] batch The size of the batches.
+ * \return The number of values different between the two ways.
+ */
+static uint32_t
+Bench (Ptr<RandomVariableStream> x, std::string name, uint32_t n, uint32_t batch)
+{
+  std::vector<double> single (n);
+  std::vector<double> batched (n);
+  SystemWallClockMs time;
+
+  x->SetStream (1);
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      single[i] = x->GetValue ();
+    }
+  double singleMs = time.End ();
+
+  x->SetStream (1);
+  time.Start ();
+  for (uint32_t i = 0; i < n; i += batch)
+    {
+      x->GetValues (&batched[i], std::min (batch, n - i));
+    }
+  double batchedMs = time.End ();
+
+  uint32_t errors = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      errors += single[i] != batched[i];
+    }
+  std::cout << std::left << std::setw (12) << name << std::right
+            << " GetValue: " << std::setw (8) << singleMs * 1e6 / n << " ns/value"
+            << "  GetValues: " << std::setw (8) << batchedMs * 1e6 / n << " ns/value"
+            << "  different: " << errors << std::endl;
+  return errors;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+  uint32_t batch = 256;
+  uint32_t zipf = 1000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the sampling of the random variables");
+  cmd.AddValue ("n", "number of values per distribution", n);
+  cmd.AddValue ("batch", "number of values per call to GetValues", batch);
+  cmd.AddValue ("zipf", "n of the Zipf distribution", zipf);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || batch == 0)
+    {
+      std::cerr << "Error-- number of values and batch size must be positive" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-random-variable with n=" << n
+            << " values, batches of " << batch << std::endl;
+
+  uint32_t errors = 0;
+  errors += Bench (CreateObjectWithAttributes<UniformRandomVariable> ("Min", DoubleValue (0),
+                                                                      "Max", DoubleValue (100)),
+                   "Uniform", n, batch);
+  errors += Bench (CreateObjectWithAttributes<ExponentialRandomVariable> ("Mean", DoubleValue (0.001)),
+                   "Exponential", n, batch);
+  errors += Bench (CreateObjectWithAttributes<ZipfRandomVariable> ("N", IntegerValue (zipf),
+                                                                   "Alpha", DoubleValue (1.0)),
+                   "Zipf", n, batch);
+
+  // Flow sizes of a web search workload
+  Ptr<EmpiricalRandomVariable> empirical = CreateObject<EmpiricalRandomVariable> ();
+  const double sizes[] = { 6, 6, 13, 19, 33, 53, 133, 667, 1333, 3333, 6667, 20000 };
+  const double cdf[] = { 0, 0.15, 0.2, 0.3, 0.4, 0.53, 0.6, 0.7, 0.8, 0.9, 0.97, 1 };
+  for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++)
+    {
+      empirical->CDF (sizes[i], cdf[i]);
+    }
+  errors += Bench (empirical, "Empirical", n, batch);
+  empirical->SetInterpolate (true);
+  errors += Bench (empirical, "Interpolated", n, batch);
+
+  return errors == 0 ? 0 : 1;
+}
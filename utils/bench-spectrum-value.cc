@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the SpectrumValue arithmetic of
+// the interference models on a model of 100 resource blocks of 180 kHz,
+// as used by LTE, and on a model of 1000 bins of 10 kHz.  Each of 'n'
+// chunks, or 'n' / 10 chunks with the 1000 bins, computes the interference and the SINR of a signal, and adds
+// the SINR weighted by the duration of the chunk to a sum, first with
+// the binary operators, which allocate a SpectrumValue for each result,
+// then in place, with the compound operators and AddScaled.  The program
+// checks that both ways compute the same values, and reports the time
+// of both.
+// Sample usage:  ./waf --run 'bench-spectrum-value --n=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/spectrum-model.h"
+#include "ns3/spectrum-value.h"
+#include <cmath>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * Compute the chunks with the binary operators.
+ * \param [in] all The power of all the signals.
+ * \param [in] rx The power of the received signal.
+ * \param [in] noise The power of the noise.
+ * \param [in] n The number of chunks.
+ * \param [out] sinr The SINR of the last chunk.
+ * \returns The sum of the weighted SINRs.
+ */
+static SpectrumValue
+RunTemporaries (const SpectrumValue &all, const SpectrumValue &rx, const SpectrumValue &noise,
+                uint32_t n, SpectrumValue &sinr)
+{
+  SpectrumValue sum (all.GetSpectrumModel ());
+  for (uint32_t i = 0; i < n; i++)
+    {
+      SpectrumValue interf = all - rx + noise;
+      sinr = rx / interf;
+      sum += sinr * (1e-3 / (1 + i % 7));
+    }
+  return sum;
+}
+
+/**
+ * Compute the chunks in place.
+ * \param [in] all The power of all the signals.
+ * \param [in] rx The power of the received signal.
+ * \param [in] noise The power of the noise.
+ * \param [in] n The number of chunks.
+ * \param [out] sinr The SINR of the last chunk.
+ * \returns The sum of the weighted SINRs.
+ */
+static SpectrumValue
+RunInPlace (const SpectrumValue &all, const SpectrumValue &rx, const SpectrumValue &noise,
+            uint32_t n, SpectrumValue &sinr)
+{
+  SpectrumValue sum (all.GetSpectrumModel ());
+  SpectrumValue interf;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      interf = all;
+      interf -= rx;
+      interf += noise;
+      sinr = rx;
+      sinr /= interf;
+      sum.AddScaled (sinr, 1e-3 / (1 + i % 7));
+    }
+  return sum;
+}
+
+/**
+ * Run both ways on a model.
+ * \param [in] name The name of the model.
+ * \param [in] bands The number of bands.
+ * \param [in] width The width of the bands, in Hz.
+ * \param [in] n The number of chunks.
+ * \returns \c true if both ways computed the same values.
+ */
+static bool
+Run (const char *name, uint32_t bands, double width, uint32_t n)
+{
+  std::vector<double> centers;
+  for (uint32_t i = 0; i < bands; i++)
+    {
+      centers.push_back (2.11e9 + (i + 0.5) * width);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (centers);
+  SpectrumValue all (model), rx (model), noise (model);
+  for (uint32_t i = 0; i < bands; i++)
+    {
+      rx[i] = 1e-13 * (1 + i % 5);
+      all[i] = rx[i] + 3e-14 * (1 + i % 3);
+      noise[i] = 4e-21;
+    }
+
+  SpectrumValue sinr1, sinr2;
+  SystemWallClockMs time;
+  time.Start ();
+  SpectrumValue sum1 = RunTemporaries (all, rx, noise, n, sinr1);
+  uint64_t temporaries = time.End ();
+  time.Start ();
+  SpectrumValue sum2 = RunInPlace (all, rx, noise, n, sinr2);
+  uint64_t inPlace = time.End ();
+
+  // The fused multiply-add of AddScaled may round once instead of twice
+  bool same = true;
+  for (uint32_t i = 0; i < bands; i++)
+    {
+      same = same && sinr1[i] == sinr2[i]
+        && std::abs (sum1[i] - sum2[i]) <= 1e-12 * std::abs (sum1[i]);
+    }
+  std::cout << name << ": temporaries " << temporaries << " ms, in place "
+            << inPlace << " ms, " << (same ? "same values" : "DIFFERENT VALUES") << std::endl;
+  return same;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 200000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the SpectrumValue arithmetic of the interference models");
+  cmd.AddValue ("n", "number of chunks", n);
+  cmd.Parse (argc, argv);
+
+  if (n < 10)
+    {
+      std::cerr << "Error-- at least 10 chunks are needed" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-spectrum-value with n=" << n << " chunks" << std::endl;
+
+  bool same = Run ("100 RBs", 100, 180e3, n);
+  same = Run ("1000 bins", 1000, 10e3, n / 10) && same;
+  return same ? 0 : 1;
+}
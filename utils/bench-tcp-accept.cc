@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the rate of the connections
+// accepted by a TCP server, as with the short requests of a web server:
+// a client opens 'n' connections, one every 'interval', sends a request
+// of 'size' bytes on each and closes it, and the server accepts the
+// connections, reads the requests and closes its side.  The closed
+// connections stay in TIME_WAIT for the rest of the run, so that the
+// lookups of the server see a growing number of connections on its port.
+// Sample usage:  ./waf --run 'bench-tcp-accept --n=10000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static uint32_t g_accepted = 0;  //!< Connections accepted by the server
+static uint32_t g_requests = 0;  //!< Requests read by the server
+static uint32_t g_connected = 0; //!< Connections established by the client
+static uint32_t g_failed = 0;    //!< Connections failed
+
+/**
+ * Read a request and close the connection.
+ * \param [in] socket The server side of the connection.
+ */
+static void
+Read (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      if (packet->GetSize () == 0)
+        {
+          break;
+        }
+      g_requests++;
+    }
+  socket->Close ();
+}
+
+/**
+ * Accept a connection.
+ * \param [in] socket The server side of the connection.
+ * \param [in] from The address of the client.
+ */
+static void
+Accept (Ptr<Socket> socket, const Address &from)
+{
+  g_accepted++;
+  socket->SetRecvCallback (MakeCallback (&Read));
+}
+
+/**
+ * Send the request and close the connection.
+ * \param [in] socket The client side of the connection.
+ * \param [in] size The size of the request.
+ */
+static void
+Connected (uint32_t size, Ptr<Socket> socket)
+{
+  g_connected++;
+  socket->Send (Create<Packet> (size));
+  socket->Close ();
+}
+
+/**
+ * Count a connection which failed.
+ * \param [in] socket The client side of the connection.
+ */
+static void
+Failed (Ptr<Socket> socket)
+{
+  g_failed++;
+}
+
+/**
+ * Open a connection.
+ * \param [in] node The client.
+ * \param [in] server The address of the server.
+ * \param [in] size The size of the request.
+ */
+static void
+Connect (Ptr<Node> node, Address server, uint32_t size)
+{
+  Ptr<Socket> socket = Socket::CreateSocket (node, TcpSocketFactory::GetTypeId ());
+  if (socket->Bind () == -1)
+    {
+      // No ephemeral port left
+      g_failed++;
+      return;
+    }
+  socket->SetConnectCallback (MakeBoundCallback (&Connected, size),
+                              MakeCallback (&Failed));
+  socket->Connect (server);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000;
+  uint32_t size = 200;
+  Time interval = MicroSeconds (100);
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the connections accepted by a TCP server");
+  cmd.AddValue ("n", "number of connections (at most the 16384 ephemeral ports)", n);
+  cmd.AddValue ("size", "size of the requests", size);
+  cmd.AddValue ("interval", "time between the connections", interval);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || size == 0)
+    {
+      std::cerr << "Error-- number of connections and size must be positive" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-tcp-accept with n=" << n << " connections, one every "
+            << interval.As (Time::US) << std::endl;
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper link;
+  link.SetChannelAttribute ("Delay", StringValue ("10us"));
+  link.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  NetDeviceContainer devices = link.Install (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  Ptr<Socket> server = Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ());
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), 80));
+  server->Listen ();
+  server->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                             MakeCallback (&Accept));
+
+  Address to = InetSocketAddress (interfaces.GetAddress (0), 80);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Simulator::Schedule (interval * i, &Connect, nodes.Get (1), to, size);
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (interval * n + Seconds (10));
+  Simulator::Run ();
+  uint64_t delay = time.End ();
+  std::cout << "Accepted " << g_accepted << " connections, " << g_connected << " connected, "
+            << g_failed << " failed, " << g_requests << " requests read" << std::endl;
+  std::cout << "Run: " << delay << " ms, "
+            << (delay == 0 ? 0 : g_accepted * 1000.0 / delay) << " connections/s" << std::endl;
+
+  Simulator::Destroy ();
+  return g_accepted == n ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the generation of the channel
+// matrices of a ThreeGppChannelModel, and the cache of long term components
+// of a ThreeGppSpectrumPropagationLossModel.  A base station with an array
+// of 'bsSize' x 'bsSize' elements serves 'n' user equipments with arrays of
+// 2 x 2 elements, spread around it in the UMa scenario.  The program first
+// computes the rx PSD of each user equipment, which generates its channel
+// matrix, then sweeps 'beams' beams of the base station towards each user
+// equipment for 'rounds' rounds, and reports the times of both phases and
+// the hits and misses of the cache.
+// Sample usage:  ./waf --run 'bench-three-gpp-channel --n=20 --bsSize=8 --beams=4'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/three-gpp-antenna-array-model.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/wifi-spectrum-value-helper.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/node-container.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include <cmath>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * Get a beamforming vector steered in the horizontal plane.
+ * \param [in] antenna The antenna array.
+ * \param [in] phi The azimuth angle of the beam.
+ * \returns The beamforming vector.
+ */
+static ThreeGppAntennaArrayModel::ComplexVector
+GetBeam (Ptr<ThreeGppAntennaArrayModel> antenna, double phi)
+{
+  ThreeGppAntennaArrayModel::ComplexVector beam;
+  double power = 1 / std::sqrt (antenna->GetNumberOfElements ());
+  for (uint64_t ind = 0; ind < antenna->GetNumberOfElements (); ind++)
+    {
+      Vector loc = antenna->GetElementLocation (ind);
+      double phase = -2 * M_PI * (std::cos (phi) * loc.x + std::sin (phi) * loc.y);
+      beam.push_back (std::exp (std::complex<double> (0, phase)) * power);
+    }
+  return beam;
+}
+
+/**
+ * Create a node with a device, a mobility model and an antenna array.
+ * \param [in] lossModel The loss model.
+ * \param [in] position The position of the node.
+ * \param [in] antenna The antenna array.
+ * \returns The mobility model of the node.
+ */
+static Ptr<MobilityModel>
+CreateNode (Ptr<ThreeGppSpectrumPropagationLossModel> lossModel, Vector position,
+            Ptr<ThreeGppAntennaArrayModel> antenna)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  node->AddDevice (device);
+  device->SetNode (node);
+  Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  mobility->SetPosition (position);
+  node->AggregateObject (mobility);
+  lossModel->AddDevice (device, antenna);
+  return mobility;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 20;
+  uint32_t bsSize = 8;
+  uint32_t beams = 4;
+  uint32_t rounds = 100;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the channel matrices and the long term components of the 3GPP channel model");
+  cmd.AddValue ("n", "number of user equipments", n);
+  cmd.AddValue ("bsSize", "number of rows and columns of the array of the base station", bsSize);
+  cmd.AddValue ("beams", "number of beams swept towards each user equipment", beams);
+  cmd.AddValue ("rounds", "number of sweeps of the beams", rounds);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || bsSize == 0 || beams == 0)
+    {
+      std::cerr << "Error-- at least one user equipment, array element and beam are needed" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-three-gpp-channel with n=" << n << " user equipments" << std::endl;
+
+  Ptr<ThreeGppSpectrumPropagationLossModel> lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+  lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (28e9));
+  lossModel->SetChannelModelAttribute ("Scenario", StringValue ("UMa"));
+  lossModel->SetChannelModelAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+
+  Ptr<ThreeGppAntennaArrayModel> bsAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel>
+      ("NumColumns", UintegerValue (bsSize), "NumRows", UintegerValue (bsSize));
+  Ptr<MobilityModel> bsMobility = CreateNode (lossModel, Vector (0, 0, 25), bsAntenna);
+  std::vector<Ptr<MobilityModel> > ueMobility;
+  std::vector<double> ueAngle;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double angle = 2 * M_PI * i / n;
+      Ptr<ThreeGppAntennaArrayModel> ueAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel>
+          ("NumColumns", UintegerValue (2), "NumRows", UintegerValue (2));
+      ueAntenna->SetBeamformingVector (GetBeam (ueAntenna, angle + M_PI));
+      ueMobility.push_back (CreateNode (lossModel, Vector (100 * std::cos (angle), 100 * std::sin (angle), 1.5), ueAntenna));
+      ueAngle.push_back (angle);
+    }
+
+  WifiSpectrumValue5MhzFactory sf;
+  Ptr<SpectrumValue> txPsd = sf.CreateTxPowerSpectralDensity (0.1, 1);
+
+  SystemWallClockMs time;
+  time.Start ();
+  bsAntenna->SetBeamformingVector (GetBeam (bsAntenna, 0));
+  for (uint32_t i = 0; i < n; i++)
+    {
+      lossModel->DoCalcRxPowerSpectralDensity (txPsd, bsMobility, ueMobility[i]);
+    }
+  uint64_t generation = time.End ();
+  std::cout << "channel generation: " << generation << " ms for " << n << " channels" << std::endl;
+
+  std::vector<ThreeGppAntennaArrayModel::ComplexVector> bsBeams;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t b = 0; b < beams; b++)
+        {
+          bsBeams.push_back (GetBeam (bsAntenna, ueAngle[i] + 0.1 * b));
+        }
+    }
+  uint64_t hits = lossModel->GetLongTermCacheHits ();
+  uint64_t misses = lossModel->GetLongTermCacheMisses ();
+  time.Start ();
+  for (uint32_t r = 0; r < rounds; r++)
+    {
+      for (uint32_t i = 0; i < n; i++)
+        {
+          for (uint32_t b = 0; b < beams; b++)
+            {
+              bsAntenna->SetBeamformingVector (bsBeams[i * beams + b]);
+              lossModel->DoCalcRxPowerSpectralDensity (txPsd, bsMobility, ueMobility[i]);
+            }
+        }
+    }
+  uint64_t sweep = time.End ();
+  hits = lossModel->GetLongTermCacheHits () - hits;
+  misses = lossModel->GetLongTermCacheMisses () - misses;
+  std::cout << "beam sweep: " << sweep << " ms, " << hits << " hits, " << misses << " misses, hit rate "
+            << (hits + misses > 0 ? static_cast<double> (hits) / (hits + misses) : 0) << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the reception of the PPDUs at
+// frame granularity by the WifiPhy: 'n' ad hoc stations, 30 m apart, each
+// send a frame of 'size' bytes every 'interval' ms to the next station, at
+// 24 Mbps and with acknowledgments, for 'duration' seconds.  The
+// simulation is run with the detailed reception of the PPDUs, then with
+// the "Abstraction" attribute of the PHYs set, and the events, times,
+// frames received and retransmissions of both runs are reported.  The
+// abstracted reception decides the PPDUs at the lowest SINR over their
+// duration, so that it can only lose more frames, when they are
+// interfered during a part of their duration.
+// Sample usage:  ./waf --run 'bench-wifi-abstraction --n=1000 --interval=500'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/packet.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/config.h"
+#include "ns3/simulator.h"
+#include <cmath>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static uint64_t g_received = 0; //!< Frames received
+static uint64_t g_retries = 0;  //!< Data frames retransmitted
+
+/**
+ * Count a received frame.
+ * \returns true
+ */
+static bool
+Receive (Ptr<NetDevice>, Ptr<const Packet>, uint16_t, const Address &)
+{
+  g_received++;
+  return true;
+}
+
+/**
+ * Count a retransmitted data frame.
+ * \param [in] context The context.
+ * \param [in] address The address of the receiver.
+ */
+static void
+Retry (std::string context, Mac48Address address)
+{
+  g_retries++;
+}
+
+/**
+ * Send a frame periodically to the next station.
+ * \param [in] device The device.
+ * \param [in] to The next station.
+ * \param [in] size The size of the frames.
+ * \param [in] interval The interval between the frames.
+ */
+static void
+Send (Ptr<NetDevice> device, Address to, uint32_t size, Time interval)
+{
+  device->Send (Create<Packet> (size), to, 0x0800);
+  Simulator::Schedule (interval, &Send, device, to, size, interval);
+}
+
+/**
+ * Run the stations.
+ * \param [in] abstraction Whether the PPDUs are received at frame granularity.
+ * \param [in] n The number of stations.
+ * \param [in] size The size of the frames.
+ * \param [in] interval The interval between the frames of a station, in ms.
+ * \param [in] duration The duration of the simulation.
+ */
+static void
+Run (bool abstraction, uint32_t n, uint32_t size, double interval, double duration)
+{
+  NodeContainer nodes;
+  nodes.Create (n);
+
+  uint32_t side = std::ceil (std::sqrt (n));
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (30),
+                                 "DeltaY", DoubleValue (30),
+                                 "GridWidth", UintegerValue (side));
+  mobility.Install (nodes);
+
+  // No frame can be received beyond about 220 m with the default log
+  // distance propagation loss
+  YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default ();
+  Ptr<YansWifiChannel> channel = channelHelper.Create ();
+  channel->SetAttribute ("MaxRange", DoubleValue (250));
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  phy.Set ("Abstraction", BooleanValue (abstraction));
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate24Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 0);
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/RemoteStationManager/MacTxDataFailed",
+                   MakeCallback (&Retry));
+
+  Ptr<UniformRandomVariable> start = CreateObject<UniformRandomVariable> ();
+  start->SetStream (1000000);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      devices.Get (i)->SetReceiveCallback (MakeCallback (&Receive));
+      Simulator::Schedule (MicroSeconds (start->GetValue (0, interval * 1000)), &Send,
+                           devices.Get (i), devices.Get ((i + 1) % n)->GetAddress (),
+                           size, MicroSeconds (interval * 1000));
+    }
+
+  g_received = 0;
+  g_retries = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  uint64_t delay = time.End ();
+  std::cout << (abstraction ? "abstracted: " : "detailed: ") << delay << " ms, "
+            << Simulator::GetEventCount () << " events, "
+            << g_received << " frames received, "
+            << g_retries << " retransmissions" << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 200;
+  uint32_t size = 1000;
+  double interval = 200;
+  double duration = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the reception of the PPDUs at frame granularity");
+  cmd.AddValue ("n", "number of stations", n);
+  cmd.AddValue ("size", "size of the frames, in bytes", size);
+  cmd.AddValue ("interval", "interval between the frames of a station, in ms", interval);
+  cmd.AddValue ("duration", "duration of the simulation, in seconds", duration);
+  cmd.Parse (argc, argv);
+
+  if (n < 2 || size == 0 || interval <= 0 || duration <= 0)
+    {
+      std::cerr << "Error-- at least two stations, a positive size, interval and duration are needed" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-wifi-abstraction with n=" << n << " stations" << std::endl;
+
+  Run (false, n, size, interval, duration);
+  Run (true, n, size, interval, duration);
+  return 0;
+}
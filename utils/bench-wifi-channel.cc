@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the deliveries of a YansWifiChannel
+// to many stations: 'n' ad hoc stations, spread with a constant density,
+// each broadcast a frame every 100 ms for 'duration' seconds.  The
+// simulation is run with all the stations considered by each transmission,
+// then with the stations within 'range' meters found by the grid of the
+// channel.  With the default log distance propagation loss, no frame can be
+// received beyond about 220 m, so that both runs must receive the same
+// frames, which the program checks, and the events and times of both runs
+// are reported.
+// Sample usage:  ./waf --run 'bench-wifi-channel --n=500 --duration=2'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/packet.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include <cmath>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static uint64_t g_received = 0; //!< Frames received
+
+/**
+ * Count a received frame.
+ * \returns true
+ */
+static bool
+Receive (Ptr<NetDevice>, Ptr<const Packet>, uint16_t, const Address &)
+{
+  g_received++;
+  return true;
+}
+
+/**
+ * Broadcast a frame every 100 ms.
+ * \param [in] device The device.
+ */
+static void
+Broadcast (Ptr<NetDevice> device)
+{
+  device->Send (Create<Packet> (200), device->GetBroadcast (), 0x0800);
+  Simulator::Schedule (MilliSeconds (100), &Broadcast, device);
+}
+
+/**
+ * Run the stations.
+ * \param [in] n The number of stations.
+ * \param [in] range The range of the channel, or 0.
+ * \param [in] duration The duration of the simulation.
+ */
+static void
+Run (uint32_t n, double range, double duration)
+{
+  NodeContainer nodes;
+  nodes.Create (n);
+
+  // 30 m between the stations
+  uint32_t side = std::ceil (std::sqrt (n));
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (30),
+                                 "DeltaY", DoubleValue (30),
+                                 "GridWidth", UintegerValue (side));
+  mobility.Install (nodes);
+
+  YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default ();
+  Ptr<YansWifiChannel> channel = channelHelper.Create ();
+  channel->SetAttribute ("MaxRange", DoubleValue (range));
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 0);
+
+  Ptr<UniformRandomVariable> start = CreateObject<UniformRandomVariable> ();
+  start->SetStream (1000000);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      devices.Get (i)->SetReceiveCallback (MakeCallback (&Receive));
+      Simulator::Schedule (MilliSeconds (start->GetValue (0, 100)), &Broadcast, devices.Get (i));
+    }
+
+  g_received = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  uint64_t delay = time.End ();
+  std::cout << "n=" << n << (range > 0 ? " grid: " : " all: ") << delay << " ms, "
+            << Simulator::GetEventCount () << " events, "
+            << g_received << " frames received" << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 200;
+  double range = 250;
+  double duration = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the deliveries of a Wi-Fi channel to many stations");
+  cmd.AddValue ("n", "number of stations", n);
+  cmd.AddValue ("range", "range of the channel, in meters", range);
+  cmd.AddValue ("duration", "duration of the simulation, in seconds", duration);
+  cmd.Parse (argc, argv);
+
+  if (n < 2 || range <= 0 || duration <= 0)
+    {
+      std::cerr << "Error-- at least two stations, a positive range and duration are needed" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-wifi-channel with n=" << n << " stations" << std::endl;
+
+  Run (n, 0, duration);
+  uint64_t all = g_received;
+  Run (n, range, duration);
+  uint64_t grid = g_received;
+  std::cout << "Different frames received: " << (all > grid ? all - grid : grid - all) << std::endl;
+  return all == grid ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the error rate models on a dense
+// BSS: 'n' ad hoc stations, 2 m apart, each broadcast a frame of 'size'
+// bytes every 'interval' ms at 54 Mbps for 'duration' seconds, so that
+// most receptions are interfered.  The simulation is run with the
+// NistErrorRateModel, then with the TabulatedErrorRateModel tabulating
+// it, and the events, times and frames received of both runs are
+// reported.  The success rates of both models differ slightly, hence so
+// may a few random drops.
+// Sample usage:  ./waf --run 'bench-wifi-error-rate --n=50 --duration=5'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/packet.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include <cmath>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static uint64_t g_received = 0; //!< Frames received
+
+/**
+ * Count a received frame.
+ * \returns true
+ */
+static bool
+Receive (Ptr<NetDevice>, Ptr<const Packet>, uint16_t, const Address &)
+{
+  g_received++;
+  return true;
+}
+
+/**
+ * Broadcast a frame periodically.
+ * \param [in] device The device.
+ * \param [in] size The size of the frames.
+ * \param [in] interval The interval between the frames.
+ */
+static void
+Broadcast (Ptr<NetDevice> device, uint32_t size, Time interval)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x0800);
+  Simulator::Schedule (interval, &Broadcast, device, size, interval);
+}
+
+/**
+ * Run the stations.
+ * \param [in] model The error rate model.
+ * \param [in] n The number of stations.
+ * \param [in] size The size of the frames.
+ * \param [in] interval The interval between the frames of a station, in ms.
+ * \param [in] duration The duration of the simulation.
+ */
+static void
+Run (std::string model, uint32_t n, uint32_t size, double interval, double duration)
+{
+  NodeContainer nodes;
+  nodes.Create (n);
+
+  uint32_t side = std::ceil (std::sqrt (n));
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (2),
+                                 "DeltaY", DoubleValue (2),
+                                 "GridWidth", UintegerValue (side));
+  mobility.Install (nodes);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  phy.SetErrorRateModel (model);
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate54Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 0);
+
+  Ptr<UniformRandomVariable> start = CreateObject<UniformRandomVariable> ();
+  start->SetStream (1000000);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      devices.Get (i)->SetReceiveCallback (MakeCallback (&Receive));
+      Simulator::Schedule (MicroSeconds (start->GetValue (0, interval * 1000)), &Broadcast,
+                           devices.Get (i), size, MicroSeconds (interval * 1000));
+    }
+
+  g_received = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  uint64_t delay = time.End ();
+  std::cout << model << ": " << delay << " ms, "
+            << Simulator::GetEventCount () << " events, "
+            << g_received << " frames received" << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 30;
+  uint32_t size = 1000;
+  double interval = 10;
+  double duration = 2;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the error rate models on a dense BSS");
+  cmd.AddValue ("n", "number of stations", n);
+  cmd.AddValue ("size", "size of the frames, in bytes", size);
+  cmd.AddValue ("interval", "interval between the frames of a station, in ms", interval);
+  cmd.AddValue ("duration", "duration of the simulation, in seconds", duration);
+  cmd.Parse (argc, argv);
+
+  if (n < 2 || size == 0 || interval <= 0 || duration <= 0)
+    {
+      std::cerr << "Error-- at least two stations, a positive size, interval and duration are needed" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-wifi-error-rate with n=" << n << " stations" << std::endl;
+
+  Run ("ns3::NistErrorRateModel", n, size, interval, duration);
+  Run ("ns3::TabulatedErrorRateModel", n, size, interval, duration);
+  return 0;
+}
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts the binary traces written by BinaryTraceHelper,
+// either to a CSV file with a header line, or to a directory holding one
+// file per column: each column is the raw array of the values of a field,
+// in host byte order, with the width given by the schema.csv file of the
+// directory.
+// Sample usage:
+//   ./waf --run 'binary-trace-convert --input=incast.btr --output=incast.csv'
+//   ./waf --run 'binary-trace-convert --input=incast.btr --format=columns --output=incast'
+
+#include "ns3/command-line.h"
+#include "ns3/system-path.h"
+#include "ns3/binary-trace-file.h"
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  std::string format = "csv";
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Convert a binary trace file to CSV or to columns");
+  cmd.AddValue ("input", "binary trace file", input);
+  cmd.AddValue ("output", "CSV file, or directory of the columns", output);
+  cmd.AddValue ("format", "csv or columns", format);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty () || (format != "csv" && format != "columns"))
+    {
+      std::cerr << cmd;
+      exit (1);
+    }
+
+  BinaryTraceReader reader (input);
+  if (reader.Fail ())
+    {
+      std::cerr << input << " is not a binary trace file" << std::endl;
+      exit (1);
+    }
+
+  uint64_t records = 0;
+  if (format == "csv")
+    {
+      std::ofstream csv (output.c_str ());
+      for (uint32_t i = 0; i < reader.GetNFields (); i++)
+        {
+          csv << (i == 0 ? "" : ",") << reader.GetFieldName (i);
+        }
+      csv << std::endl;
+      while (reader.Next ())
+        {
+          for (uint32_t i = 0; i < reader.GetNFields (); i++)
+            {
+              if (i != 0)
+                {
+                  csv << ',';
+                }
+              csv << reader.GetField (i);
+            }
+          csv << '\n';
+          records++;
+        }
+    }
+  else
+    {
+      SystemPath::MakeDirectories (output);
+      std::vector<std::ofstream *> columns;
+      std::ofstream schema ((output + "/schema.csv").c_str ());
+      schema << "name,file,bytes" << std::endl;
+      for (uint32_t i = 0; i < reader.GetNFields (); i++)
+        {
+          std::string name = reader.GetFieldName (i) + ".bin";
+          schema << reader.GetFieldName (i) << "," << name << "," << reader.GetFieldSize (i) << std::endl;
+          columns.push_back (new std::ofstream ((output + "/" + name).c_str (), std::ios::binary));
+        }
+      while (reader.Next ())
+        {
+          for (uint32_t i = 0; i < reader.GetNFields (); i++)
+            {
+              int64_t value = reader.GetField (i);
+              uint8_t u8 = value;
+              uint16_t u16 = value;
+              uint32_t u32 = value;
+              const void *p = &value;
+              switch (reader.GetFieldSize (i))
+                {
+                case 1:
+                  p = &u8;
+                  break;
+                case 2:
+                  p = &u16;
+                  break;
+                case 4:
+                  p = &u32;
+                  break;
+                }
+              columns[i]->write (static_cast<const char *> (p), reader.GetFieldSize (i));
+            }
+          records++;
+        }
+      for (uint32_t i = 0; i < columns.size (); i++)
+        {
+          delete columns[i];
+        }
+    }
+
+  std::cout << "Converted " << records << " records" << std::endl;
+  return 0;
+}